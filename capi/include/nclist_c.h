@@ -0,0 +1,329 @@
+#ifndef NCLIST_C_H
+#define NCLIST_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file nclist_c.h
+ * @brief C interface for foreign-language bindings.
+ *
+ * This exposes pre-compiled instantiations of the **nclist** templates for 32-bit subject interval indices and 32-bit integer, 64-bit integer or double-precision positions,
+ * denoted by the `i32`, `i64` and `f64` suffixes respectively.
+ * All functions operate on caller-provided contiguous arrays, so that bindings from other languages (e.g., R, Python) can search a whole batch of queries in a single call.
+ * No C++ exceptions are thrown across the interface; errors are reported as a `nclist_status`, and a description can be obtained with `nclist_last_error()`.
+ */
+
+#if defined(_WIN32) && defined(NCLIST_C_SHARED)
+#  ifdef NCLIST_C_BUILDING
+#    define NCLIST_C_EXPORT __declspec(dllexport)
+#  else
+#    define NCLIST_C_EXPORT __declspec(dllimport)
+#  endif
+#elif defined(__GNUC__)
+#  define NCLIST_C_EXPORT __attribute__((visibility("default")))
+#else
+#  define NCLIST_C_EXPORT
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Status code returned by each function.
+ *
+ * - `NCLIST_OK`: the function completed successfully.
+ * - `NCLIST_ERROR_INVALID_ARGUMENT`: an argument was invalid, e.g., a `NULL` pointer or an unknown overlap type.
+ * - `NCLIST_ERROR_BUFFER_TOO_SMALL`: a caller-provided buffer was too small, see `nclist_save_size_i32()`.
+ * - `NCLIST_ERROR_INVALID_FORMAT`: a buffer passed to `nclist_load_i32()` (or its equivalent for other types) does not contain a valid index.
+ * - `NCLIST_ERROR_OUT_OF_MEMORY`: memory allocation failed.
+ * - `NCLIST_ERROR_UNKNOWN`: some other error occurred.
+ */
+typedef enum {
+    NCLIST_OK = 0,
+    NCLIST_ERROR_INVALID_ARGUMENT = 1,
+    NCLIST_ERROR_BUFFER_TOO_SMALL = 2,
+    NCLIST_ERROR_INVALID_FORMAT = 3,
+    NCLIST_ERROR_OUT_OF_MEMORY = 4,
+    NCLIST_ERROR_UNKNOWN = 5
+} nclist_status;
+
+/**
+ * Type of overlap, with the same values as `nclist::OverlapType`.
+ */
+typedef enum {
+    NCLIST_OVERLAP_ANY = 0,
+    NCLIST_OVERLAP_EQUAL = 1,
+    NCLIST_OVERLAP_WITHIN = 2,
+    NCLIST_OVERLAP_EXTEND = 3,
+    NCLIST_OVERLAP_START = 4,
+    NCLIST_OVERLAP_END = 5
+} nclist_overlap_type;
+
+/**
+ * @return Description of the last error in the calling thread.
+ * This is an empty string if no error has occurred.
+ * The pointer is valid until the next call to any function in this interface from the same thread.
+ */
+NCLIST_C_EXPORT const char* nclist_last_error(void);
+
+/**
+ * Opaque handle to an `nclist::Nclist` with 32-bit integer positions.
+ */
+typedef struct nclist_index_i32 nclist_index_i32;
+
+/**
+ * Opaque handle to an `nclist::Nclist` with 64-bit integer positions.
+ */
+typedef struct nclist_index_i64 nclist_index_i64;
+
+/**
+ * Opaque handle to an `nclist::Nclist` with double-precision positions.
+ */
+typedef struct nclist_index_f64 nclist_index_f64;
+
+/**
+ * Opaque handle to the results of a batch search.
+ * The matches for query `i` are stored in `matches[offsets[i]]` to `matches[offsets[i + 1] - 1]`, see `nclist_results_offsets()` and `nclist_results_matches()`.
+ */
+typedef struct nclist_results nclist_results;
+
+/**
+ * Parameters for `nclist_overlaps_batch_i32()`, equivalent to `nclist::OverlapsBatchParameters`.
+ * This should be initialized with `nclist_batch_params_init_i32()` before setting individual members.
+ * Pointers to per-query arrays may be `NULL`, in which case the corresponding single value is used for all queries.
+ */
+typedef struct {
+    nclist_overlap_type type;
+    const int8_t* types;
+    int has_max_gap;
+    int32_t max_gap;
+    const int32_t* max_gaps;
+    int32_t min_overlap;
+    const int32_t* min_overlaps;
+    int quit_on_first;
+    int deduplicate;
+    int reuse_nested;
+    int num_threads;
+} nclist_batch_params_i32;
+
+/**
+ * Parameters for `nclist_overlaps_batch_i64()`, see `nclist_batch_params_i32` for details.
+ */
+typedef struct {
+    nclist_overlap_type type;
+    const int8_t* types;
+    int has_max_gap;
+    int64_t max_gap;
+    const int64_t* max_gaps;
+    int64_t min_overlap;
+    const int64_t* min_overlaps;
+    int quit_on_first;
+    int deduplicate;
+    int reuse_nested;
+    int num_threads;
+} nclist_batch_params_i64;
+
+/**
+ * Parameters for `nclist_overlaps_batch_f64()`, see `nclist_batch_params_i32` for details.
+ */
+typedef struct {
+    nclist_overlap_type type;
+    const int8_t* types;
+    int has_max_gap;
+    double max_gap;
+    const double* max_gaps;
+    double min_overlap;
+    const double* min_overlaps;
+    int quit_on_first;
+    int deduplicate;
+    int reuse_nested;
+    int num_threads;
+} nclist_batch_params_f64;
+
+/**
+ * @param[out] params Parameters to be set to the defaults of `nclist::OverlapsBatchParameters`.
+ */
+NCLIST_C_EXPORT void nclist_batch_params_init_i32(nclist_batch_params_i32* params);
+
+/**
+ * @param[out] params Parameters to be set to the defaults of `nclist::OverlapsBatchParameters`.
+ */
+NCLIST_C_EXPORT void nclist_batch_params_init_i64(nclist_batch_params_i64* params);
+
+/**
+ * @param[out] params Parameters to be set to the defaults of `nclist::OverlapsBatchParameters`.
+ */
+NCLIST_C_EXPORT void nclist_batch_params_init_f64(nclist_batch_params_f64* params);
+
+/**
+ * Build an index with `nclist::build()`.
+ *
+ * @param num_intervals Number of subject intervals.
+ * @param[in] starts Pointer to an array of length `num_intervals`, containing the start position of each subject interval.
+ * @param[in] ends Pointer to an array of length `num_intervals`, containing the non-inclusive end position of each subject interval.
+ * @param[out] index On success, set to a new index that should be released with `nclist_free_i32()`.
+ * @return Status code.
+ */
+NCLIST_C_EXPORT nclist_status nclist_build_i32(int32_t num_intervals, const int32_t* starts, const int32_t* ends, nclist_index_i32** index);
+
+/**
+ * Overload of `nclist_build_i32()` for 64-bit integer positions.
+ */
+NCLIST_C_EXPORT nclist_status nclist_build_i64(int32_t num_intervals, const int64_t* starts, const int64_t* ends, nclist_index_i64** index);
+
+/**
+ * Overload of `nclist_build_i32()` for double-precision positions.
+ */
+NCLIST_C_EXPORT nclist_status nclist_build_f64(int32_t num_intervals, const double* starts, const double* ends, nclist_index_f64** index);
+
+/**
+ * @param index Index to be released, possibly `NULL`.
+ */
+NCLIST_C_EXPORT void nclist_free_i32(nclist_index_i32* index);
+
+/**
+ * @param index Index to be released, possibly `NULL`.
+ */
+NCLIST_C_EXPORT void nclist_free_i64(nclist_index_i64* index);
+
+/**
+ * @param index Index to be released, possibly `NULL`.
+ */
+NCLIST_C_EXPORT void nclist_free_f64(nclist_index_f64* index);
+
+/**
+ * @param index An index created by `nclist_build_i32()` or `nclist_load_i32()`.
+ * @param[out] size On success, set to the number of bytes required to save `index` with `nclist_save_i32()`.
+ * @return Status code.
+ */
+NCLIST_C_EXPORT nclist_status nclist_save_size_i32(const nclist_index_i32* index, size_t* size);
+
+/**
+ * Overload of `nclist_save_size_i32()` for 64-bit integer positions.
+ */
+NCLIST_C_EXPORT nclist_status nclist_save_size_i64(const nclist_index_i64* index, size_t* size);
+
+/**
+ * Overload of `nclist_save_size_i32()` for double-precision positions.
+ */
+NCLIST_C_EXPORT nclist_status nclist_save_size_f64(const nclist_index_f64* index, size_t* size);
+
+/**
+ * Save an index into a caller-provided buffer, e.g., for caching to disk or transfer between processes.
+ * The saved index uses the native byte order and can only be loaded on machines with the same endianness.
+ *
+ * @param index An index created by `nclist_build_i32()` or `nclist_load_i32()`.
+ * @param[out] buffer Pointer to a buffer of length `size`.
+ * @param size Size of the buffer in bytes, which should be no less than the value reported by `nclist_save_size_i32()`.
+ * @return Status code.
+ */
+NCLIST_C_EXPORT nclist_status nclist_save_i32(const nclist_index_i32* index, void* buffer, size_t size);
+
+/**
+ * Overload of `nclist_save_i32()` for 64-bit integer positions.
+ */
+NCLIST_C_EXPORT nclist_status nclist_save_i64(const nclist_index_i64* index, void* buffer, size_t size);
+
+/**
+ * Overload of `nclist_save_i32()` for double-precision positions.
+ */
+NCLIST_C_EXPORT nclist_status nclist_save_f64(const nclist_index_f64* index, void* buffer, size_t size);
+
+/**
+ * Load an index that was saved by `nclist_save_i32()`.
+ * The buffer is checked for consistency, so it is safe to search the loaded index even if the buffer was corrupted.
+ *
+ * @param[in] buffer Pointer to a buffer of length `size`, with no alignment requirements.
+ * @param size Size of the buffer in bytes, which should be equal to the value reported by `nclist_save_size_i32()` for the saved index.
+ * @param[out] index On success, set to a new index that should be released with `nclist_free_i32()`.
+ * @return Status code.
+ */
+NCLIST_C_EXPORT nclist_status nclist_load_i32(const void* buffer, size_t size, nclist_index_i32** index);
+
+/**
+ * Overload of `nclist_load_i32()` for 64-bit integer positions.
+ */
+NCLIST_C_EXPORT nclist_status nclist_load_i64(const void* buffer, size_t size, nclist_index_i64** index);
+
+/**
+ * Overload of `nclist_load_i32()` for double-precision positions.
+ */
+NCLIST_C_EXPORT nclist_status nclist_load_f64(const void* buffer, size_t size, nclist_index_f64** index);
+
+/**
+ * Search for overlaps with a batch of queries with `nclist::overlaps_batch()`.
+ *
+ * @param index An index created by `nclist_build_i32()` or `nclist_load_i32()`.
+ * @param num_queries Number of query intervals.
+ * @param[in] query_starts Pointer to an array of length `num_queries`, containing the start of each query interval.
+ * @param[in] query_ends Pointer to an array of length `num_queries`, containing the non-inclusive end of each query interval.
+ * @param[in] params Parameters for the search.
+ * If `NULL`, the defaults from `nclist_batch_params_init_i32()` are used.
+ * @param[out] results On success, set to the results of the search, which should be released with `nclist_results_free()`.
+ * @return Status code.
+ */
+NCLIST_C_EXPORT nclist_status nclist_overlaps_batch_i32(
+    const nclist_index_i32* index,
+    size_t num_queries,
+    const int32_t* query_starts,
+    const int32_t* query_ends,
+    const nclist_batch_params_i32* params,
+    nclist_results** results
+);
+
+/**
+ * Overload of `nclist_overlaps_batch_i32()` for 64-bit integer positions.
+ */
+NCLIST_C_EXPORT nclist_status nclist_overlaps_batch_i64(
+    const nclist_index_i64* index,
+    size_t num_queries,
+    const int64_t* query_starts,
+    const int64_t* query_ends,
+    const nclist_batch_params_i64* params,
+    nclist_results** results
+);
+
+/**
+ * Overload of `nclist_overlaps_batch_i32()` for double-precision positions.
+ */
+NCLIST_C_EXPORT nclist_status nclist_overlaps_batch_f64(
+    const nclist_index_f64* index,
+    size_t num_queries,
+    const double* query_starts,
+    const double* query_ends,
+    const nclist_batch_params_f64* params,
+    nclist_results** results
+);
+
+/**
+ * @param results Results of a batch search.
+ * @return Number of queries in the batch.
+ */
+NCLIST_C_EXPORT size_t nclist_results_num_queries(const nclist_results* results);
+
+/**
+ * @param results Results of a batch search.
+ * @return Pointer to an array of length equal to the number of queries plus 1, containing the offsets into the array returned by `nclist_results_matches()`.
+ * This remains valid until `results` is released.
+ */
+NCLIST_C_EXPORT const size_t* nclist_results_offsets(const nclist_results* results);
+
+/**
+ * @param results Results of a batch search.
+ * @return Pointer to an array of subject interval indices for all queries, see `nclist_results_offsets()`.
+ * This remains valid until `results` is released.
+ */
+NCLIST_C_EXPORT const int32_t* nclist_results_matches(const nclist_results* results);
+
+/**
+ * @param results Results to be released, possibly `NULL`.
+ */
+NCLIST_C_EXPORT void nclist_results_free(nclist_results* results);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
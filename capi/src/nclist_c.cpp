@@ -0,0 +1,457 @@
+#include "nclist_c.h"
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#include "nclist/build.hpp"
+#include "nclist/batch.hpp"
+
+struct nclist_index_i32 {
+    nclist::Nclist<int32_t, int32_t> index;
+};
+
+struct nclist_index_i64 {
+    nclist::Nclist<int32_t, int64_t> index;
+};
+
+struct nclist_index_f64 {
+    nclist::Nclist<int32_t, double> index;
+};
+
+struct nclist_results {
+    std::vector<std::size_t> offsets;
+    std::vector<int32_t> matches;
+};
+
+namespace {
+
+thread_local std::string last_error;
+
+class CapiError : public std::runtime_error {
+public:
+    CapiError(nclist_status status, const char* message) : std::runtime_error(message), status(status) {}
+    nclist_status status;
+};
+
+// All C++ exceptions are converted into status codes here, as they cannot be allowed to propagate into the caller's runtime.
+template<class Function_>
+nclist_status guard(Function_ fun) {
+    try {
+        fun();
+        return NCLIST_OK;
+    } catch (const CapiError& e) {
+        last_error = e.what();
+        return e.status;
+    } catch (const std::bad_alloc&) {
+        last_error = "failed to allocate memory";
+        return NCLIST_ERROR_OUT_OF_MEMORY;
+    } catch (const std::exception& e) {
+        last_error = e.what();
+        return NCLIST_ERROR_UNKNOWN;
+    } catch (...) {
+        last_error = "unknown error";
+        return NCLIST_ERROR_UNKNOWN;
+    }
+}
+
+void check_argument(bool okay, const char* message) {
+    if (!okay) {
+        throw CapiError(NCLIST_ERROR_INVALID_ARGUMENT, message);
+    }
+}
+
+void check_format(bool okay, const char* message) {
+    if (!okay) {
+        throw CapiError(NCLIST_ERROR_INVALID_FORMAT, message);
+    }
+}
+
+template<class Handle_, typename Position_>
+nclist_status build(int32_t num_intervals, const Position_* starts, const Position_* ends, Handle_** index) {
+    return guard([&]() -> void {
+        check_argument(index != NULL, "'index' should not be NULL");
+        check_argument(num_intervals >= 0, "'num_intervals' should be non-negative");
+        check_argument(num_intervals == 0 || (starts != NULL && ends != NULL), "'starts' and 'ends' should not be NULL");
+        auto output = new Handle_;
+        try {
+            output->index = nclist::build<int32_t, Position_>(num_intervals, starts, ends);
+        } catch (...) {
+            delete output;
+            throw;
+        }
+        *index = output;
+    });
+}
+
+/*
+ * The saved index has the following layout, with all values in native byte order:
+ *
+ * - 4 bytes containing the magic string "NCLS".
+ * - A 32-bit unsigned integer containing 0x01020304, to check that the byte order is the same on loading.
+ * - 1 byte each for the format version, the size of the index type, the position type code, and a reserved byte.
+ * - 64-bit unsigned integers for the number of root children, the number of nodes and the number of duplicates.
+ * - The nodes, as five 32-bit integers per node in the order of the members of `Nclist::Node`.
+ * - The start positions, end positions and duplicates.
+ *
+ * No padding is added, so all values are copied with memcpy() to avoid alignment requirements.
+ */
+constexpr char save_magic[4] = { 'N', 'C', 'L', 'S' };
+constexpr uint32_t save_byte_order = 0x01020304;
+constexpr unsigned char save_version = 1;
+constexpr std::size_t save_header_size = 4 + 4 + 4 + 8 * 3;
+constexpr std::size_t save_node_size = 5 * sizeof(int32_t);
+
+template<typename Position_>
+constexpr unsigned char position_code() {
+    if constexpr(std::is_same<Position_, int32_t>::value) {
+        return 1;
+    } else if constexpr(std::is_same<Position_, int64_t>::value) {
+        return 2;
+    } else {
+        static_assert(std::is_same<Position_, double>::value);
+        return 3;
+    }
+}
+
+template<typename Position_>
+std::size_t save_size(const nclist::Nclist<int32_t, Position_>& index) {
+    const std::size_t num_nodes = index.nodes.size();
+    return save_header_size + num_nodes * (save_node_size + 2 * sizeof(Position_)) + index.duplicates.size() * sizeof(int32_t);
+}
+
+template<typename Type_>
+unsigned char* save_values(unsigned char* ptr, const Type_* values, std::size_t n) {
+    if (n) {
+        std::memcpy(ptr, values, n * sizeof(Type_));
+    }
+    return ptr + n * sizeof(Type_);
+}
+
+template<typename Type_>
+const unsigned char* load_values(const unsigned char* ptr, Type_* values, std::size_t n) {
+    if (n) {
+        std::memcpy(values, ptr, n * sizeof(Type_));
+    }
+    return ptr + n * sizeof(Type_);
+}
+
+template<typename Position_>
+void save(const nclist::Nclist<int32_t, Position_>& index, void* buffer, std::size_t size) {
+    check_argument(buffer != NULL || size == 0, "'buffer' should not be NULL");
+    if (size < save_size(index)) {
+        throw CapiError(NCLIST_ERROR_BUFFER_TOO_SMALL, "buffer is too small to save the index");
+    }
+
+    auto ptr = static_cast<unsigned char*>(buffer);
+    ptr = save_values(ptr, save_magic, 4);
+    ptr = save_values(ptr, &save_byte_order, 1);
+    const unsigned char codes[4] = { save_version, sizeof(int32_t), position_code<Position_>(), 0 };
+    ptr = save_values(ptr, codes, 4);
+    const uint64_t counts[3] = { static_cast<uint64_t>(index.root_children), index.nodes.size(), index.duplicates.size() };
+    ptr = save_values(ptr, counts, 3);
+
+    for (const auto& node : index.nodes) {
+        const int32_t fields[5] = { node.id, node.children_start, node.children_end, node.duplicates_start, node.duplicates_end };
+        ptr = save_values(ptr, fields, 5);
+    }
+    ptr = save_values(ptr, index.starts.data(), index.starts.size());
+    ptr = save_values(ptr, index.ends.data(), index.ends.size());
+    save_values(ptr, index.duplicates.data(), index.duplicates.size());
+}
+
+// We check that the nodes form a tree, i.e., each non-root node is the child of exactly one node with a lower index.
+// This guarantees that all searches terminate and only access valid memory, even if the buffer was corrupted.
+// We don't check that the positions are sorted, as that only affects the correctness of the results and not the safety of the search.
+template<typename Position_>
+void load(const void* buffer, std::size_t size, nclist::Nclist<int32_t, Position_>& index) {
+    check_argument(buffer != NULL || size == 0, "'buffer' should not be NULL");
+    check_format(size >= save_header_size, "buffer is too small to contain a saved index");
+
+    auto ptr = static_cast<const unsigned char*>(buffer);
+    char magic[4];
+    ptr = load_values(ptr, magic, 4);
+    check_format(std::memcmp(magic, save_magic, 4) == 0, "buffer does not contain a saved index");
+    uint32_t byte_order;
+    ptr = load_values(ptr, &byte_order, 1);
+    check_format(byte_order == save_byte_order, "saved index has a different byte order");
+    unsigned char codes[4];
+    ptr = load_values(ptr, codes, 4);
+    check_format(codes[0] == save_version, "saved index has an unsupported format version");
+    check_format(codes[1] == sizeof(int32_t) && codes[2] == position_code<Position_>(), "saved index has different index or position types");
+    uint64_t counts[3];
+    ptr = load_values(ptr, counts, 3);
+
+    const uint64_t root_children = counts[0], num_nodes = counts[1], num_duplicates = counts[2];
+    constexpr uint64_t max_index = std::numeric_limits<int32_t>::max();
+    check_format(num_nodes <= max_index && num_duplicates <= max_index && root_children <= num_nodes, "saved index has invalid dimensions");
+    const uint64_t expected = save_header_size + num_nodes * (save_node_size + 2 * sizeof(Position_)) + num_duplicates * sizeof(int32_t); // can't overflow as both counts fit in an int32_t.
+    check_format(static_cast<uint64_t>(size) == expected, "buffer size is not consistent with the saved index");
+
+    index.root_children = root_children;
+    index.nodes.resize(num_nodes);
+    for (auto& node : index.nodes) {
+        int32_t fields[5];
+        ptr = load_values(ptr, fields, 5);
+        node.id = fields[0];
+        node.children_start = fields[1];
+        node.children_end = fields[2];
+        node.duplicates_start = fields[3];
+        node.duplicates_end = fields[4];
+    }
+    index.starts.resize(num_nodes);
+    ptr = load_values(ptr, index.starts.data(), num_nodes);
+    index.ends.resize(num_nodes);
+    ptr = load_values(ptr, index.ends.data(), num_nodes);
+    index.duplicates.resize(num_duplicates);
+    load_values(ptr, index.duplicates.data(), num_duplicates);
+
+    const int32_t nnodes = num_nodes, ndups = num_duplicates, nroots = root_children;
+    std::vector<unsigned char> has_parent(num_nodes);
+    for (int32_t n = 0; n < nnodes; ++n) {
+        const auto& node = index.nodes[n];
+        check_format(node.id >= 0, "saved index contains a negative interval index");
+        check_format(node.duplicates_start >= 0 && node.duplicates_start <= node.duplicates_end && node.duplicates_end <= ndups, "saved index contains invalid duplicates");
+        check_format(node.children_start >= 0 && node.children_start <= node.children_end && node.children_end <= nnodes, "saved index contains invalid children");
+        if (node.children_start == node.children_end) {
+            continue;
+        }
+        check_format(node.children_start > n, "saved index contains a child before its parent");
+        for (auto c = node.children_start; c < node.children_end; ++c) {
+            check_format(c >= nroots && !has_parent[c], "saved index contains a node with multiple parents");
+            has_parent[c] = 1;
+        }
+    }
+    for (int32_t n = nroots; n < nnodes; ++n) {
+        check_format(has_parent[n], "saved index contains a node without a parent");
+    }
+    for (auto d : index.duplicates) {
+        check_format(d >= 0, "saved index contains a negative interval index");
+    }
+}
+
+template<class CParams_>
+void init_params(CParams_* params) {
+    if (params == NULL) {
+        return;
+    }
+    params->type = NCLIST_OVERLAP_ANY;
+    params->types = NULL;
+    params->has_max_gap = 0;
+    params->max_gap = 0;
+    params->max_gaps = NULL;
+    params->min_overlap = 0;
+    params->min_overlaps = NULL;
+    params->quit_on_first = 0;
+    params->deduplicate = 0;
+    params->reuse_nested = 0;
+    params->num_threads = 1;
+}
+
+bool is_valid_type(int type) {
+    return type >= static_cast<int>(nclist::OverlapType::ANY) && type <= static_cast<int>(nclist::OverlapType::END);
+}
+
+template<typename Position_, class CParams_>
+nclist_status overlaps_batch(
+    const nclist::Nclist<int32_t, Position_>& index,
+    std::size_t num_queries,
+    const Position_* query_starts,
+    const Position_* query_ends,
+    const CParams_* cparams,
+    nclist_results** results)
+{
+    return guard([&]() -> void {
+        check_argument(results != NULL, "'results' should not be NULL");
+        check_argument(num_queries == 0 || (query_starts != NULL && query_ends != NULL), "'query_starts' and 'query_ends' should not be NULL");
+
+        CParams_ defaults;
+        if (cparams == NULL) {
+            init_params(&defaults);
+            cparams = &defaults;
+        }
+
+        nclist::OverlapsBatchParameters<Position_> params;
+        check_argument(is_valid_type(cparams->type), "unknown overlap type in 'type'");
+        params.type = static_cast<nclist::OverlapType>(cparams->type);
+
+        // The per-query types are validated and converted to the C++ enum, as we can't just reinterpret the caller's array.
+        std::vector<nclist::OverlapType> types;
+        if (cparams->types) {
+            types.reserve(num_queries);
+            for (std::size_t q = 0; q < num_queries; ++q) {
+                check_argument(is_valid_type(cparams->types[q]), "unknown overlap type in 'types'");
+                types.push_back(static_cast<nclist::OverlapType>(cparams->types[q]));
+            }
+            params.types = types.data();
+        }
+
+        if (cparams->has_max_gap) {
+            params.max_gap = cparams->max_gap;
+        }
+        params.max_gaps = cparams->max_gaps;
+        params.min_overlap = cparams->min_overlap;
+        params.min_overlaps = cparams->min_overlaps;
+        params.quit_on_first = cparams->quit_on_first;
+        params.deduplicate = cparams->deduplicate;
+        params.reuse_nested = cparams->reuse_nested;
+        params.num_threads = cparams->num_threads;
+
+        auto output = new nclist_results;
+        try {
+            nclist::overlaps_batch(index, num_queries, query_starts, query_ends, params, output->offsets, output->matches);
+        } catch (...) {
+            delete output;
+            throw;
+        }
+        *results = output;
+    });
+}
+
+}
+
+extern "C" {
+
+const char* nclist_last_error(void) {
+    return last_error.c_str();
+}
+
+void nclist_batch_params_init_i32(nclist_batch_params_i32* params) {
+    init_params(params);
+}
+
+void nclist_batch_params_init_i64(nclist_batch_params_i64* params) {
+    init_params(params);
+}
+
+void nclist_batch_params_init_f64(nclist_batch_params_f64* params) {
+    init_params(params);
+}
+
+nclist_status nclist_build_i32(int32_t num_intervals, const int32_t* starts, const int32_t* ends, nclist_index_i32** index) {
+    return build(num_intervals, starts, ends, index);
+}
+
+nclist_status nclist_build_i64(int32_t num_intervals, const int64_t* starts, const int64_t* ends, nclist_index_i64** index) {
+    return build(num_intervals, starts, ends, index);
+}
+
+nclist_status nclist_build_f64(int32_t num_intervals, const double* starts, const double* ends, nclist_index_f64** index) {
+    return build(num_intervals, starts, ends, index);
+}
+
+void nclist_free_i32(nclist_index_i32* index) {
+    delete index;
+}
+
+void nclist_free_i64(nclist_index_i64* index) {
+    delete index;
+}
+
+void nclist_free_f64(nclist_index_f64* index) {
+    delete index;
+}
+
+#define NCLIST_C_DEFINE_SAVE_LOAD(suffix) \
+nclist_status nclist_save_size_##suffix(const nclist_index_##suffix* index, size_t* size) { \
+    return guard([&]() -> void { \
+        check_argument(index != NULL && size != NULL, "'index' and 'size' should not be NULL"); \
+        *size = save_size(index->index); \
+    }); \
+} \
+\
+nclist_status nclist_save_##suffix(const nclist_index_##suffix* index, void* buffer, size_t size) { \
+    return guard([&]() -> void { \
+        check_argument(index != NULL, "'index' should not be NULL"); \
+        save(index->index, buffer, size); \
+    }); \
+} \
+\
+nclist_status nclist_load_##suffix(const void* buffer, size_t size, nclist_index_##suffix** index) { \
+    return guard([&]() -> void { \
+        check_argument(index != NULL, "'index' should not be NULL"); \
+        auto output = new nclist_index_##suffix; \
+        try { \
+            load(buffer, size, output->index); \
+        } catch (...) { \
+            delete output; \
+            throw; \
+        } \
+        *index = output; \
+    }); \
+}
+
+NCLIST_C_DEFINE_SAVE_LOAD(i32)
+NCLIST_C_DEFINE_SAVE_LOAD(i64)
+NCLIST_C_DEFINE_SAVE_LOAD(f64)
+
+#undef NCLIST_C_DEFINE_SAVE_LOAD
+
+nclist_status nclist_overlaps_batch_i32(
+    const nclist_index_i32* index,
+    size_t num_queries,
+    const int32_t* query_starts,
+    const int32_t* query_ends,
+    const nclist_batch_params_i32* params,
+    nclist_results** results)
+{
+    if (index == NULL) {
+        last_error = "'index' should not be NULL";
+        return NCLIST_ERROR_INVALID_ARGUMENT;
+    }
+    return overlaps_batch(index->index, num_queries, query_starts, query_ends, params, results);
+}
+
+nclist_status nclist_overlaps_batch_i64(
+    const nclist_index_i64* index,
+    size_t num_queries,
+    const int64_t* query_starts,
+    const int64_t* query_ends,
+    const nclist_batch_params_i64* params,
+    nclist_results** results)
+{
+    if (index == NULL) {
+        last_error = "'index' should not be NULL";
+        return NCLIST_ERROR_INVALID_ARGUMENT;
+    }
+    return overlaps_batch(index->index, num_queries, query_starts, query_ends, params, results);
+}
+
+nclist_status nclist_overlaps_batch_f64(
+    const nclist_index_f64* index,
+    size_t num_queries,
+    const double* query_starts,
+    const double* query_ends,
+    const nclist_batch_params_f64* params,
+    nclist_results** results)
+{
+    if (index == NULL) {
+        last_error = "'index' should not be NULL";
+        return NCLIST_ERROR_INVALID_ARGUMENT;
+    }
+    return overlaps_batch(index->index, num_queries, query_starts, query_ends, params, results);
+}
+
+size_t nclist_results_num_queries(const nclist_results* results) {
+    return results->offsets.size() - 1;
+}
+
+const size_t* nclist_results_offsets(const nclist_results* results) {
+    return results->offsets.data();
+}
+
+const int32_t* nclist_results_matches(const nclist_results* results) {
+    return results->matches.data();
+}
+
+void nclist_results_free(nclist_results* results) {
+    delete results;
+}
+
+}
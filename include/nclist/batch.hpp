@@ -0,0 +1,1167 @@
+#ifndef NCLIST_BATCH_HPP
+#define NCLIST_BATCH_HPP
+
+#include <vector>
+#include <optional>
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+#include "build.hpp"
+#include "view.hpp"
+#include "overlaps_any.hpp"
+#include "overlaps_equal.hpp"
+#include "overlaps_within.hpp"
+#include "overlaps_extend.hpp"
+#include "overlaps_start.hpp"
+#include "overlaps_end.hpp"
+#include "parallelize.hpp"
+#include "lockstep.hpp"
+#include "histogram.hpp"
+#include "results.hpp"
+#include "utils.hpp"
+
+/**
+ * @file batch.hpp
+ * @brief Search for overlaps with a batch of heterogeneous queries.
+ */
+
+namespace nclist {
+
+/**
+ * Type of overlap to search for in `overlaps_batch()`.
+ *
+ * - `ANY`: uses `overlaps_any()`.
+ * - `EQUAL`: uses `overlaps_equal()`.
+ * - `WITHIN`: uses `overlaps_within()`.
+ * - `EXTEND`: uses `overlaps_extend()`.
+ * - `START`: uses `overlaps_start()`.
+ * - `END`: uses `overlaps_end()`.
+ */
+enum class OverlapType : char { ANY, EQUAL, WITHIN, EXTEND, START, END };
+
+/**
+ * @brief Details of a slow query in `overlaps_batch()`.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * This contains enough information to reproduce the query outside of the batch, e.g., by calling the function corresponding to `type`.
+ */
+template<typename Position_>
+struct SlowQuery {
+    /**
+     * Index of the query in the batch.
+     */
+    std::size_t index = 0;
+
+    /**
+     * Start of the query interval.
+     */
+    Position_ query_start = 0;
+
+    /**
+     * Non-inclusive end of the query interval.
+     */
+    Position_ query_end = 0;
+
+    /**
+     * Type of overlap for this query.
+     */
+    OverlapType type = OverlapType::ANY;
+
+    /**
+     * Maximum gap for this query, if one was set.
+     */
+    std::optional<Position_> max_gap;
+
+    /**
+     * Minimum overlap for this query.
+     */
+    Position_ min_overlap = 0;
+
+    /**
+     * Time spent searching for this query, in nanoseconds.
+     */
+    std::uint64_t nanoseconds = 0;
+
+    /**
+     * Number of root intervals that were searched for this query, after narrowing the root range with the query coordinates.
+     */
+    std::size_t num_roots = 0;
+
+    /**
+     * Number of subject intervals reported for this query.
+     */
+    std::size_t num_matches = 0;
+
+    /**
+     * Number of nodes visited by the traversal for this query, see `OverlapsAnyWorkspace::num_visited`.
+     * This is only reported for `ANY` queries if the `NCLIST_COUNT_TRAVERSAL` macro is defined, otherwise it is always zero.
+     */
+    std::size_t num_visited = 0;
+
+    /**
+     * Number of binary searches performed by the traversal for this query, see `OverlapsAnyWorkspace::num_searches`.
+     * This is only reported for `ANY` queries if the `NCLIST_COUNT_TRAVERSAL` macro is defined, otherwise it is always zero.
+     */
+    std::size_t num_searches = 0;
+};
+
+/**
+ * @brief Latency profile for `overlaps_batch()`.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * This records the latency of each query in `overlaps_batch()` when it is supplied via `OverlapsBatchParameters::profile`.
+ * Results are accumulated across calls to `overlaps_batch()` with the same profile, until `clear()` is called.
+ */
+template<typename Position_>
+struct OverlapsBatchProfile {
+    /**
+     * Maximum number of slow queries to retain in `slowest`.
+     */
+    std::size_t num_slowest = 10;
+
+    /**
+     * Histograms of per-query latencies in nanoseconds.
+     * Each entry corresponds to an `OverlapType`, e.g., `latencies[static_cast<int>(OverlapType::WITHIN)]` contains the latencies for all `WITHIN` queries.
+     */
+    LatencyHistogram latencies[6];
+
+    /**
+     * Details of the slowest queries, sorted by decreasing latency.
+     * This contains no more than `num_slowest` entries.
+     */
+    std::vector<SlowQuery<Position_> > slowest;
+
+    /**
+     * Remove all recorded latencies and slow queries.
+     */
+    void clear() {
+        for (auto& l : latencies) {
+            l.clear();
+        }
+        slowest.clear();
+    }
+};
+
+/**
+ * @brief Parameters for `overlaps_batch()`.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * Each parameter can be set for all queries with a single value, or for each query with a pointer to an array of per-query values.
+ * If a pointer is non-`NULL`, it takes precedence over the corresponding single value.
+ */
+template<typename Position_>
+struct OverlapsBatchParameters {
+    /**
+     * Type of overlap to search for, for all queries.
+     */
+    OverlapType type = OverlapType::ANY;
+
+    /**
+     * Pointer to an array of length equal to the number of queries, containing the type of overlap to search for in each query.
+     * An error is raised if any entry (or `type`, if this is `NULL`) is not a valid `OverlapType`.
+     */
+    const OverlapType* types = NULL;
+
+    /**
+     * Maximum gap for all queries.
+     * This is interpreted as described for the `max_gap` parameter of the function corresponding to each query's `OverlapType`.
+     * If no value is set, the default `max_gap` of that function's parameters is used.
+     */
+    std::optional<Position_> max_gap;
+
+    /**
+     * Pointer to an array of length equal to the number of queries, containing the maximum gap for each query.
+     * This is interpreted as described for `max_gap`, except that every query is considered to have a value.
+     */
+    const Position_* max_gaps = NULL;
+
+    /**
+     * Minimum overlap for all queries, see the `min_overlap` parameter of the function corresponding to each query's `OverlapType`.
+     */
+    Position_ min_overlap = 0;
+
+    /**
+     * Pointer to an array of length equal to the number of queries, containing the minimum overlap for each query.
+     */
+    const Position_* min_overlaps = NULL;
+
+    /**
+     * Whether to quit immediately upon identifying an overlap with each query interval.
+     */
+    bool quit_on_first = false;
+
+    /**
+     * Number of threads to use.
+     * The parallelization scheme can be modified by defining `NCLIST_CUSTOM_PARALLEL`, see `parallelize()` for details.
+     */
+    int num_threads = 1;
+
+    /**
+     * Pointer to a profile in which to record the latency of each query.
+     * If `NULL`, no timing is performed.
+     * Otherwise, each query is timed and its latency is added to the profile, along with the details of the slowest queries.
+     * Each thread records its latencies separately, and all results are combined into the profile at the end of `overlaps_batch()`.
+     */
+    OverlapsBatchProfile<Position_>* profile = NULL;
+
+    /**
+     * Whether to detect identical queries in the batch, i.e., with the same start/end positions and the same per-query type and parameters.
+     * If `true`, each unique query is only searched once and its results are copied to all identical queries.
+     * This is useful for batches with many duplicate queries, e.g., identical read intervals from deep sequencing.
+     * Deduplication involves hashing all queries, so it may be slower for batches without many duplicates.
+     * If a `profile` is supplied, only the unique queries are recorded.
+     *
+     * This is always performed by `overlaps_batch_unique()`, regardless of the value of this parameter.
+     */
+    bool deduplicate = false;
+
+    /**
+     * Whether to re-use the results of `ANY` queries for later `ANY` queries that are nested within them.
+     * If `true`, `ANY` queries are sorted by increasing start and decreasing end, and the results of each query are cached while it might contain later queries.
+     * Any subject interval that overlaps a nested query must also overlap its containing query (with the same `max_gap` and `min_overlap`),
+     * so the results for the nested query can be obtained by filtering the cached results instead of traversing the NCList.
+     * Filtering is only performed when a simple cost model predicts that it is cheaper than a traversal, e.g., when the nested query covers a large fraction of the containing query.
+     * The weights of the cost model were measured with the benchmarks in the `perf/` directory.
+     * This is useful for batches of multi-scale windows where many queries are nested within other queries.
+     * For batches with few nested queries, the sorting and caching of the `ANY` queries may make the search slower than the default.
+     * Results are the same regardless of this parameter.
+     *
+     * This is ignored if `quit_on_first = true`, as the cached results would be incomplete.
+     */
+    bool reuse_nested = false;
+};
+
+/**
+ * @cond
+ */
+template<typename Index_>
+struct OverlapsBatchWorkspace {
+    OverlapsAnyWorkspace<Index_> any;
+    OverlapsEqualWorkspace<Index_> equal;
+    OverlapsWithinWorkspace<Index_> within;
+    OverlapsExtendWorkspace<Index_> extend;
+    OverlapsStartWorkspace<Index_> start;
+    OverlapsEndWorkspace<Index_> end;
+};
+
+// Per-worker version of the profile, to avoid contention between threads.
+template<typename Position_>
+struct OverlapsBatchProfiler {
+    OverlapsBatchProfiler(std::size_t num_slowest) : slowest(num_slowest) {}
+    LatencyHistogram latencies[6];
+    SlowestEntries<SlowQuery<Position_> > slowest;
+};
+
+template<typename Position_>
+void merge_batch_profiles(const std::vector<OverlapsBatchProfiler<Position_> >& profilers, OverlapsBatchProfile<Position_>& profile) {
+    for (const auto& current : profilers) {
+        for (int t = 0; t < 6; ++t) {
+            profile.latencies[t].merge(current.latencies[t]);
+        }
+        merge_slowest_entries(current.slowest, profile.num_slowest, profile.slowest);
+    }
+}
+
+template<class Parameters_, typename Position_>
+void fill_batch_parameters(const OverlapsBatchParameters<Position_>& params, const std::size_t q, Parameters_& current) {
+    if (params.max_gaps) {
+        current.max_gap = params.max_gaps[q];
+    } else if (params.max_gap.has_value()) {
+        current.max_gap = *(params.max_gap);
+    }
+    current.min_overlap = (params.min_overlaps ? params.min_overlaps[q] : params.min_overlap);
+    current.quit_on_first = params.quit_on_first;
+}
+
+template<typename Position_>
+std::optional<Position_> get_batch_gap(const std::optional<Position_>& max_gap) {
+    return max_gap;
+}
+
+template<typename Position_>
+std::optional<Position_> get_batch_gap(const Position_ max_gap) {
+    return max_gap;
+}
+
+// Converts the bounds on the real positions into bounds on the stored offsets for a lockstep search on `stored`, where `real[i] = base + stored[i]`.
+// Bounds outside the range of the real positions are mapped to the first or last stored offset, and the search result is fixed afterwards with `below`/`above`.
+// Otherwise, the bound lies between two real positions, so its offset lies between the corresponding stored offsets and can be computed with `bound - base`.
+// This holds even if the subtraction wraps around for unsigned types, e.g., for a transformed view where the base was reduced by a flank.
+template<typename Stored_, typename Position_, class Positions_>
+void convert_to_offsets(
+    const Positions_& positions,
+    const std::size_t num_positions,
+    const std::size_t num_bounds,
+    const Position_* bounds,
+    Stored_* offsets,
+    unsigned char* status)
+{
+    const auto stored = positions.data();
+    const Position_ base = positions.base();
+    const Position_ first = positions[0], last = positions[num_positions - 1];
+    for (std::size_t i = 0; i < num_bounds; ++i) {
+        const auto current = bounds[i];
+        if (current < first) {
+            offsets[i] = stored[0];
+            status[i] = 1;
+        } else if (current > last) {
+            offsets[i] = stored[num_positions - 1];
+            status[i] = 2;
+        } else {
+            offsets[i] = static_cast<Stored_>(current - base);
+            status[i] = 0;
+        }
+    }
+}
+
+template<class Positions_>
+struct OffsetStoredType {
+    typedef void type;
+};
+
+template<typename Position_, typename Stored_>
+struct OffsetStoredType<OffsetPositions<Position_, Stored_> > {
+    typedef Stored_ type;
+};
+
+// Identifies unique queries based on the query coordinates and any per-query type or parameters.
+// On output, `unique_queries` contains the first occurrence of each unique query in increasing order,
+// and `query_to_unique` contains the index of the unique query (i.e., in `unique_queries`) for each query.
+//
+// We use an open-addressing hash table with linear probing, which was 2.5-3 times faster than sorting the query indices for 10 million queries (see perf/README.md).
+// Each slot of the table contains the index of a unique query, so the table itself is only a few bytes per query.
+template<typename Position_>
+void find_unique_batch_queries(
+    const std::size_t num_queries,
+    const Position_* query_starts,
+    const Position_* query_ends,
+    const OverlapsBatchParameters<Position_>& params,
+    std::vector<std::size_t>& unique_queries,
+    std::vector<std::size_t>& query_to_unique)
+{
+    std::size_t capacity = 16;
+    while (capacity < num_queries * 2) {
+        capacity *= 2;
+    }
+    const std::size_t mask = capacity - 1;
+    constexpr std::size_t empty = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> table(capacity, empty);
+
+    std::hash<Position_> hasher;
+    const auto combine = [](std::size_t seed, const std::size_t value) -> std::size_t {
+        return seed ^ (value + static_cast<std::size_t>(0x9e3779b9) + (seed << 6) + (seed >> 2)); // same as boost::hash_combine.
+    };
+    const auto hash = [&](const std::size_t q) -> std::size_t {
+        std::size_t seed = combine(hasher(query_starts[q]), hasher(query_ends[q]));
+        if (params.types) {
+            seed = combine(seed, static_cast<std::size_t>(params.types[q]));
+        }
+        if (params.max_gaps) {
+            seed = combine(seed, hasher(params.max_gaps[q]));
+        }
+        if (params.min_overlaps) {
+            seed = combine(seed, hasher(params.min_overlaps[q]));
+        }
+        // Mixing the bits so that the lower bits used by the mask depend on all bits of the seed, as std::hash is often the identity for integers.
+        std::uint64_t mixed = seed;
+        mixed ^= mixed >> 33;
+        mixed *= static_cast<std::uint64_t>(0xff51afd7ed558ccdULL);
+        mixed ^= mixed >> 33;
+        return mixed;
+    };
+    const auto is_same = [&](const std::size_t left, const std::size_t right) -> bool {
+        return query_starts[left] == query_starts[right] &&
+            query_ends[left] == query_ends[right] &&
+            (!params.types || params.types[left] == params.types[right]) &&
+            (!params.max_gaps || params.max_gaps[left] == params.max_gaps[right]) &&
+            (!params.min_overlaps || params.min_overlaps[left] == params.min_overlaps[right]);
+    };
+
+    unique_queries.clear();
+    query_to_unique.resize(num_queries);
+    for (std::size_t q = 0; q < num_queries; ++q) {
+        std::size_t slot = hash(q) & mask;
+        while (1) {
+            const auto existing = table[slot];
+            if (existing == empty) {
+                table[slot] = unique_queries.size();
+                query_to_unique[q] = unique_queries.size();
+                unique_queries.push_back(q);
+                break;
+            }
+            if (is_same(unique_queries[existing], q)) {
+                query_to_unique[q] = existing;
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+    }
+}
+
+// Node lists for `ANY` queries that might contain later queries, for use in `overlaps_any_nested()`.
+// Entries are stored as a stack of nested queries, much like the construction of the NCList itself.
+// Popped entries are not freed but re-used by later pushes, so as to avoid repeated allocations for the node lists.
+template<typename Index_, typename Position_>
+struct NestedAnyCache {
+    struct Outer {
+        Position_ query_start, query_end;
+        std::optional<Position_> max_gap;
+        Position_ min_overlap;
+        std::vector<Index_> nodes;
+    };
+    std::vector<Outer> stack;
+    std::size_t depth = 0;
+};
+
+// Same results as `overlaps_any()`, but re-using the cached results of a containing query if it is cheaper to filter them than to traverse the NCList.
+// This assumes that queries are supplied in order of increasing start and decreasing end, so that containing queries are processed before the queries nested within them.
+// The node lists are stored in the pre-order of the traversal in `overlaps_any_nodes()`, so filtering preserves the order of the reported intervals.
+template<typename Index_, typename Position_, typename Stored_, class Matches_>
+void overlaps_any_nested(
+    const NclistView<Index_, Position_, Stored_>& subject,
+    const Position_ query_start,
+    const Position_ query_end,
+    const OverlapsAnyParameters<Position_>& params,
+    OverlapsAnyWorkspace<Index_>& workspace,
+    NestedAnyCache<Index_, Position_>& cache,
+    Matches_& matches)
+{
+    auto& stack = cache.stack;
+    auto& depth = cache.depth;
+    while (depth > 0 && stack[depth - 1].query_end < query_end) {
+        --depth;
+    }
+
+    if (depth == stack.size()) {
+        stack.emplace_back();
+    }
+    auto& current = stack[depth];
+    current.query_start = query_start;
+    current.query_end = query_end;
+    current.max_gap = params.max_gap;
+    current.min_overlap = params.min_overlap;
+    current.nodes.clear();
+    ++depth;
+
+    bool use_outer = false;
+    if (depth > 1) {
+        const auto& outer = stack[depth - 2];
+        if (outer.query_start <= query_start && outer.max_gap == params.max_gap && outer.min_overlap == params.min_overlap) {
+            // Costs are expressed in units of the time taken to filter one cached node.
+            // A traversal involves a binary search on the root intervals and then a visit to each overlapping node.
+            // In perf/src/batch.cpp, each visited node cost 9.7-11.4 filtered nodes and each level of the root search cost 0.4-0.5 filtered nodes (see perf/README.md).
+            // We estimate the number of overlapping nodes by assuming that the outer results are evenly distributed along the outer query.
+            constexpr double cost_per_node = 10, cost_per_level = 0.5;
+            const double inner_width = static_cast<double>(query_end - query_start) + 1;
+            const double outer_width = static_cast<double>(outer.query_end - outer.query_start) + 1;
+            const double num_outer = outer.nodes.size();
+            double traversal_cost = cost_per_node * num_outer * std::min(1.0, inner_width / outer_width);
+            for (Index_ num_roots = subject.root_end - subject.root_start; num_roots > 0; num_roots /= 2) {
+                traversal_cost += cost_per_level;
+            }
+            use_outer = (num_outer <= traversal_cost);
+        }
+    }
+
+    if (use_outer) {
+        const auto& outer = stack[depth - 2];
+        for (const auto node : outer.nodes) {
+            if (overlaps_any_matches<Position_>(subject.starts[node], subject.ends[node], query_start, query_end, params)) {
+                current.nodes.push_back(node);
+            }
+        }
+    } else {
+        overlaps_any_nodes(subject, query_start, query_end, params, workspace, [&](const Index_ node) -> bool { current.nodes.push_back(node); return true; });
+    }
+
+    start_matches(matches);
+    for (const auto node : current.nodes) {
+        const auto& current_node = subject.nodes[node];
+        add_match(matches, current_node.id);
+        if (current_node.duplicates_start != current_node.duplicates_end) {
+            add_matches(matches, subject.duplicates + current_node.duplicates_start, subject.duplicates + current_node.duplicates_end);
+        }
+    }
+    finish_matches(matches);
+}
+
+// Subject intervals that satisfy any type of overlap must have `subject_ends[i] >= query_start - gap` and `subject_starts[i] <= query_end + gap`,
+// where `gap` is the `max_gap` for types where it is defined as a distance between positions (and zero otherwise).
+// Each root interval contains all of its descendents, so the same bounds can be used to narrow the range of root intervals to be searched.
+// We compute this range for many queries at once with a lockstep binary search, which is faster than doing a separate scalar search for each query;
+// the per-query traversal then only needs to search the (typically short) narrowed range.
+template<class Parameters_, class Workspace_, typename Index_, typename Position_, class Output_, class Search_, typename Stored_>
+void run_batch_group(
+    const NclistView<Index_, Position_, Stored_>& subject,
+    const Position_* query_starts,
+    const Position_* query_ends,
+    const OverlapsBatchParameters<Position_>& params,
+    const OverlapType type,
+    const bool positional_gap,
+    const std::size_t* order,
+    const std::size_t length,
+    Workspace_& workspace,
+    Output_& output,
+    OverlapsBatchProfiler<Position_>* profiler,
+    Search_ search)
+{
+    constexpr std::size_t chunk_size = 256;
+    Parameters_ chunk_params[chunk_size];
+    Position_ lower[chunk_size], upper[chunk_size];
+    Index_ narrow_start[chunk_size], narrow_end[chunk_size];
+    const Index_ num_roots = subject.root_end - subject.root_start;
+
+    for (std::size_t chunk_start = 0; chunk_start < length; chunk_start += chunk_size) {
+        const std::size_t chunk_length = std::min(chunk_size, length - chunk_start);
+        const auto chunk_order = order + chunk_start;
+
+        for (std::size_t i = 0; i < chunk_length; ++i) {
+            const auto q = chunk_order[i];
+            auto& current = chunk_params[i];
+            current = Parameters_();
+            fill_batch_parameters(params, q, current);
+
+            const Position_ query_start = query_starts[q], query_end = query_ends[q];
+            const auto gap = get_batch_gap(current.max_gap);
+            if (positional_gap && gap.has_value()) {
+                lower[i] = safe_subtract_gap(query_start, *gap);
+                upper[i] = safe_add_gap(query_end, *gap);
+            } else {
+                lower[i] = query_start;
+                upper[i] = query_end;
+            }
+
+            if constexpr(std::is_same<Parameters_, OverlapsAnyParameters<Position_> >::value) {
+                // Using the same bound as overlaps_any() so that the narrowed roots start at its first candidate, see below.
+                if (current.min_overlap > 0 && std::numeric_limits<Position_>::max() - current.min_overlap >= query_start) {
+                    lower[i] = query_start + current.min_overlap;
+                }
+            }
+        }
+
+        bool exact_narrowing = true;
+
+        if constexpr(std::is_same<Position_, Stored_>::value) {
+            lockstep_lower_bound(subject.ends + subject.root_start, num_roots, chunk_length, lower, narrow_start);
+            lockstep_upper_bound(subject.starts + subject.root_start, num_roots, chunk_length, upper, narrow_end);
+        } else if constexpr(std::is_floating_point<Position_>::value && !std::is_void<typename OffsetStoredType<decltype(subject.starts)>::type>::value) {
+            // Offsets computed by floating-point subtraction might not round-trip exactly, so we do a scalar search on the real positions instead.
+            const auto ends = subject.ends + subject.root_start, starts = subject.starts + subject.root_start;
+            for (std::size_t i = 0; i < chunk_length; ++i) {
+                narrow_start[i] = std::lower_bound(ends, ends + num_roots, lower[i]) - ends;
+                narrow_end[i] = std::upper_bound(starts, starts + num_roots, upper[i]) - starts;
+            }
+        } else if constexpr(!std::is_void<typename OffsetStoredType<decltype(subject.starts)>::type>::value) {
+            // For narrowed or transformed positions, we search on the stored offsets, see convert_to_offsets() for details.
+            typedef typename OffsetStoredType<decltype(subject.starts)>::type Offset;
+            if (num_roots == 0) {
+                std::fill_n(narrow_start, chunk_length, 0);
+                std::fill_n(narrow_end, chunk_length, 0);
+            } else {
+                Offset stored_lower[chunk_size], stored_upper[chunk_size];
+                unsigned char lower_status[chunk_size], upper_status[chunk_size];
+                const auto ends = subject.ends + subject.root_start, starts = subject.starts + subject.root_start;
+                convert_to_offsets(ends, num_roots, chunk_length, lower, stored_lower, lower_status);
+                convert_to_offsets(starts, num_roots, chunk_length, upper, stored_upper, upper_status);
+                lockstep_lower_bound(ends.data(), num_roots, chunk_length, stored_lower, narrow_start);
+                lockstep_upper_bound(starts.data(), num_roots, chunk_length, stored_upper, narrow_end);
+                for (std::size_t i = 0; i < chunk_length; ++i) {
+                    if (lower_status[i] == 2) {
+                        narrow_start[i] = num_roots;
+                    }
+                    if (upper_status[i] == 1) {
+                        narrow_end[i] = 0;
+                    }
+                }
+            }
+        } else {
+            // Other storage types are searched without narrowing.
+            std::fill_n(narrow_start, chunk_length, 0);
+            std::fill_n(narrow_end, chunk_length, num_roots);
+            exact_narrowing = false;
+        }
+
+        // overlaps_any() skips its own binary search on the roots if the first root ends after the query start.
+        // This is already true for the narrowed roots, except in the basic mode where a root ending exactly at the query start is not an overlap.
+        // Root ends are strictly increasing, so we only need to skip one root in that case.
+        if (exact_narrowing) {
+            if constexpr(std::is_same<Parameters_, OverlapsAnyParameters<Position_> >::value) {
+                for (std::size_t i = 0; i < chunk_length; ++i) {
+                    const auto& current = chunk_params[i];
+                    if (current.min_overlap > 0 || current.max_gap.has_value() || narrow_start[i] == num_roots) {
+                        continue;
+                    }
+                    if (subject.ends[subject.root_start + narrow_start[i]] == query_starts[chunk_order[i]]) {
+                        ++narrow_start[i];
+                    }
+                }
+            }
+        }
+
+        for (std::size_t i = 0; i < chunk_length; ++i) {
+            const auto q = chunk_order[i];
+            auto& matches = output.target(q);
+            auto narrowed = subject;
+            narrowed.root_start = subject.root_start + narrow_start[i];
+            narrowed.root_end = subject.root_start + std::max(narrow_start[i], narrow_end[i]);
+
+            if (profiler == NULL) {
+                search(narrowed, query_starts[q], query_ends[q], chunk_params[i], workspace, matches);
+            } else {
+#ifdef NCLIST_COUNT_TRAVERSAL
+                std::size_t last_visited = 0, last_searches = 0;
+                if constexpr(std::is_same<Workspace_, OverlapsAnyWorkspace<Index_> >::value) {
+                    last_visited = workspace.num_visited;
+                    last_searches = workspace.num_searches;
+                }
+#endif
+                const auto begin = std::chrono::steady_clock::now();
+                search(narrowed, query_starts[q], query_ends[q], chunk_params[i], workspace, matches);
+                const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+                const std::uint64_t nanoseconds = std::max<decltype(elapsed)>(elapsed, 0);
+                profiler->latencies[static_cast<int>(type)].add(nanoseconds);
+
+                if (profiler->slowest.is_slow(nanoseconds)) {
+                    SlowQuery<Position_> details;
+                    details.index = q;
+                    details.query_start = query_starts[q];
+                    details.query_end = query_ends[q];
+                    details.type = type;
+                    details.max_gap = get_batch_gap(chunk_params[i].max_gap);
+                    details.min_overlap = chunk_params[i].min_overlap;
+                    details.nanoseconds = nanoseconds;
+                    details.num_roots = narrowed.root_end - narrowed.root_start;
+                    details.num_matches = matches.size();
+#ifdef NCLIST_COUNT_TRAVERSAL
+                    if constexpr(std::is_same<Workspace_, OverlapsAnyWorkspace<Index_> >::value) {
+                        details.num_visited = workspace.num_visited - last_visited;
+                        details.num_searches = workspace.num_searches - last_searches;
+                    }
+#endif
+                    profiler->slowest.add(std::move(details));
+                }
+            }
+
+            output.store(q);
+        }
+    }
+}
+
+// Each worker stores its matches in its own buffer, which are then copied into the output in the input order.
+template<typename Index_>
+struct BatchBufferOutput {
+    BatchBufferOutput(int worker, std::vector<Index_>& buffer, std::size_t* buffer_starts, std::size_t* counts, int* owners) :
+        worker(worker), buffer(buffer), buffer_starts(buffer_starts), counts(counts), owners(owners) {}
+    int worker;
+    std::vector<Index_> current;
+    std::vector<Index_>& buffer;
+    std::size_t* buffer_starts;
+    std::size_t* counts;
+    int* owners;
+
+    std::vector<Index_>& target(std::size_t) {
+        return current;
+    }
+
+    void store(const std::size_t q) {
+        owners[q] = worker;
+        buffer_starts[q] = buffer.size();
+        counts[q] = current.size();
+        buffer.insert(buffer.end(), current.begin(), current.end());
+    }
+};
+
+// Each query is searched directly into its own container, so no further copying is required.
+template<class Results_>
+struct BatchResultsOutput {
+    BatchResultsOutput(Results_* results) : results(results) {}
+    Results_* results;
+
+    Results_& target(const std::size_t q) {
+        return results[q];
+    }
+
+    void store(std::size_t) {}
+};
+/**
+ * @endcond
+ */
+
+/**
+ * @cond
+ */
+// `with_subject` is called once in each worker with the worker index and a function that should be called with the subject view for that worker.
+// This allows different workers to search different copies of the same subject intervals, e.g., for NUMA-aware replication.
+// `create_output` is called once in each worker with the worker index, and should return an object that holds the matches for each query, e.g., `BatchBufferOutput`.
+// If `searched` is not NULL, only the `num_searched` queries in `searched` are searched, otherwise all queries are searched.
+template<typename Index_, typename Position_, class WithSubject_, class CreateOutput_>
+void search_batch(
+    WithSubject_ with_subject,
+    const Position_* query_starts,
+    const Position_* query_ends,
+    const OverlapsBatchParameters<Position_>& params,
+    const std::size_t num_searched,
+    const std::size_t* searched,
+    const int num_workers,
+    CreateOutput_ create_output)
+{
+    const auto get_searched = [&](const std::size_t i) -> std::size_t {
+        return (searched ? searched[i] : i);
+    };
+
+    // Grouping queries by their overlap type, so that each worker runs the same search function for many consecutive queries.
+    // This is done with a counting sort to preserve the input order within each group.
+    constexpr int num_types = 6;
+    std::size_t group_starts[num_types + 1] = { 0 };
+    const auto get_type = [&](const std::size_t q) -> int {
+        return static_cast<int>(params.types ? params.types[q] : params.type);
+    };
+
+    // Types are validated here as they are used to index into `group_starts`, and an unknown type would otherwise write out of bounds.
+    for (std::size_t i = 0; i < num_searched; ++i) {
+        const int type = get_type(get_searched(i));
+        if (type < 0 || type >= num_types) {
+            throw std::runtime_error("unknown overlap type for query " + std::to_string(get_searched(i)));
+        }
+        ++group_starts[type + 1];
+    }
+    for (int t = 0; t < num_types; ++t) {
+        group_starts[t + 1] += group_starts[t];
+    }
+    std::vector<std::size_t> order(num_searched);
+    {
+        std::size_t group_positions[num_types];
+        std::copy(group_starts, group_starts + num_types, group_positions);
+        for (std::size_t i = 0; i < num_searched; ++i) {
+            const auto q = get_searched(i);
+            auto& pos = group_positions[get_type(q)];
+            order[pos] = q;
+            ++pos;
+        }
+    }
+
+    // Sorting the ANY queries so that containing queries are searched before the queries nested within them.
+    // This also improves the locality of the traversals, as each worker searches a contiguous range of query positions.
+    const bool reuse_nested = params.reuse_nested && !params.quit_on_first;
+    if (reuse_nested) {
+        const auto any = static_cast<int>(OverlapType::ANY);
+        std::sort(order.begin() + group_starts[any], order.begin() + group_starts[any + 1], [&](const std::size_t left, const std::size_t right) -> bool {
+            if (query_starts[left] != query_starts[right]) {
+                return query_starts[left] < query_starts[right];
+            } else if (query_ends[left] != query_ends[right]) {
+                return query_ends[left] > query_ends[right];
+            } else {
+                return left < right;
+            }
+        });
+    }
+
+    std::vector<OverlapsBatchProfiler<Position_> > profilers;
+    if (params.profile) {
+        profilers.resize(num_workers, OverlapsBatchProfiler<Position_>(params.profile->num_slowest));
+    }
+
+    parallelize(num_workers, num_searched, [&](int w, std::size_t start, std::size_t length) -> void {
+        with_subject(w, [&](const auto& subject) -> void {
+            OverlapsBatchWorkspace<Index_> workspace;
+            auto output = create_output(w);
+            auto profiler = (params.profile ? profilers.data() + w : NULL);
+            const std::size_t end = start + length;
+
+            for (int t = 0; t < num_types; ++t) {
+                const std::size_t gstart = std::max(start, group_starts[t]), gend = std::min(end, group_starts[t + 1]);
+                if (gstart >= gend) {
+                    continue;
+                }
+
+                const auto gorder = order.data() + gstart;
+                const auto glength = gend - gstart;
+
+                switch (static_cast<OverlapType>(t)) {
+                    case OverlapType::ANY:
+                        if (reuse_nested) {
+                            NestedAnyCache<Index_, Position_> cache;
+                            run_batch_group<OverlapsAnyParameters<Position_> >(subject, query_starts, query_ends, params, static_cast<OverlapType>(t), true, gorder, glength, workspace.any, output, profiler,
+                                [&](const auto& s, auto qs, auto qe, const auto& p, auto& work, auto& m) -> void { overlaps_any_nested(s, qs, qe, p, work, cache, m); });
+                            break;
+                        }
+                        run_batch_group<OverlapsAnyParameters<Position_> >(subject, query_starts, query_ends, params, static_cast<OverlapType>(t), true, gorder, glength, workspace.any, output, profiler,
+                            [](const auto& s, auto qs, auto qe, const auto& p, auto& work, auto& m) -> void { overlaps_any(s, qs, qe, p, work, m); });
+                        break;
+                    case OverlapType::EQUAL:
+                        run_batch_group<OverlapsEqualParameters<Position_> >(subject, query_starts, query_ends, params, static_cast<OverlapType>(t), true, gorder, glength, workspace.equal, output, profiler,
+                            [](const auto& s, auto qs, auto qe, const auto& p, auto& work, auto& m) -> void { overlaps_equal(s, qs, qe, p, work, m); });
+                        break;
+                    case OverlapType::WITHIN:
+                        run_batch_group<OverlapsWithinParameters<Position_> >(subject, query_starts, query_ends, params, static_cast<OverlapType>(t), false, gorder, glength, workspace.within, output, profiler,
+                            [](const auto& s, auto qs, auto qe, const auto& p, auto& work, auto& m) -> void { overlaps_within(s, qs, qe, p, work, m); });
+                        break;
+                    case OverlapType::EXTEND:
+                        run_batch_group<OverlapsExtendParameters<Position_> >(subject, query_starts, query_ends, params, static_cast<OverlapType>(t), false, gorder, glength, workspace.extend, output, profiler,
+                            [](const auto& s, auto qs, auto qe, const auto& p, auto& work, auto& m) -> void { overlaps_extend(s, qs, qe, p, work, m); });
+                        break;
+                    case OverlapType::START:
+                        run_batch_group<OverlapsStartParameters<Position_> >(subject, query_starts, query_ends, params, static_cast<OverlapType>(t), true, gorder, glength, workspace.start, output, profiler,
+                            [](const auto& s, auto qs, auto qe, const auto& p, auto& work, auto& m) -> void { overlaps_start(s, qs, qe, p, work, m); });
+                        break;
+                    case OverlapType::END:
+                        run_batch_group<OverlapsEndParameters<Position_> >(subject, query_starts, query_ends, params, static_cast<OverlapType>(t), true, gorder, glength, workspace.end, output, profiler,
+                            [](const auto& s, auto qs, auto qe, const auto& p, auto& work, auto& m) -> void { overlaps_end(s, qs, qe, p, work, m); });
+                        break;
+                }
+            }
+        });
+    });
+
+    if (params.profile) {
+        merge_batch_profiles(profilers, *(params.profile));
+    }
+}
+
+inline int get_batch_workers(const int num_threads) {
+    return std::max(num_threads, 1);
+}
+
+template<typename Index_, typename Position_, class WithSubject_>
+void overlaps_batch_internal(
+    WithSubject_ with_subject,
+    const std::size_t num_queries,
+    const Position_* query_starts,
+    const Position_* query_ends,
+    const OverlapsBatchParameters<Position_>& params,
+    std::vector<std::size_t>* unique_indices,
+    std::vector<std::size_t>& offsets,
+    std::vector<Index_>& matches
+)
+{
+    // If `unique_indices` is supplied, results are reported for each unique query and `unique_indices` is filled with the unique query for each query.
+    // Otherwise, results are reported for each query, possibly after searching only the unique queries if `params.deduplicate = true`.
+    const bool deduplicate = params.deduplicate || unique_indices != NULL;
+    std::vector<std::size_t> unique_queries, query_to_unique;
+    if (deduplicate) {
+        find_unique_batch_queries(num_queries, query_starts, query_ends, params, unique_queries, query_to_unique);
+    }
+    const std::size_t num_searched = (deduplicate ? unique_queries.size() : num_queries);
+
+    // Each worker stores its matches in its own buffer, which are then copied into the output in the input order.
+    const int num_workers = get_batch_workers(params.num_threads);
+    std::vector<std::vector<Index_> > buffers(num_workers);
+    std::vector<std::size_t> buffer_starts(num_queries), counts(num_queries);
+    std::vector<int> owners(num_queries);
+    search_batch<Index_, Position_>(with_subject, query_starts, query_ends, params, num_searched, (deduplicate ? unique_queries.data() : NULL), num_workers, [&](int w) -> BatchBufferOutput<Index_> {
+        return BatchBufferOutput<Index_>(w, buffers[w], buffer_starts.data(), counts.data(), owners.data());
+    });
+
+    // Identical queries share the results of their first occurrence, which was the only one to be searched.
+    const std::size_t num_reported = (unique_indices ? num_searched : num_queries);
+    const auto get_reported = [&](const std::size_t i) -> std::size_t {
+        if (unique_indices) {
+            return unique_queries[i];
+        } else if (deduplicate) {
+            return unique_queries[query_to_unique[i]];
+        } else {
+            return i;
+        }
+    };
+
+    offsets.clear();
+    offsets.reserve(num_reported + 1);
+    offsets.push_back(0);
+    for (std::size_t i = 0; i < num_reported; ++i) {
+        offsets.push_back(offsets.back() + counts[get_reported(i)]);
+    }
+
+    matches.resize(offsets.back());
+    parallelize(num_workers, num_reported, [&](int, std::size_t start, std::size_t length) -> void {
+        for (std::size_t i = start, end = start + length; i < end; ++i) {
+            const auto q = get_reported(i);
+            const auto src = buffers[owners[q]].begin() + buffer_starts[q];
+            std::copy(src, src + counts[q], matches.begin() + offsets[i]);
+        }
+    });
+
+    if (unique_indices) {
+        unique_indices->swap(query_to_unique);
+    }
+}
+
+template<typename Index_, typename Position_, class WithSubject_, class Results_>
+void overlaps_batch_results_internal(
+    WithSubject_ with_subject,
+    const std::size_t num_queries,
+    const Position_* query_starts,
+    const Position_* query_ends,
+    const OverlapsBatchParameters<Position_>& params,
+    std::vector<Results_>& results
+)
+{
+    std::vector<std::size_t> unique_queries, query_to_unique;
+    if (params.deduplicate) {
+        find_unique_batch_queries(num_queries, query_starts, query_ends, params, unique_queries, query_to_unique);
+    }
+    const std::size_t num_searched = (params.deduplicate ? unique_queries.size() : num_queries);
+
+    results.clear();
+    results.resize(num_queries);
+    const int num_workers = get_batch_workers(params.num_threads);
+    search_batch<Index_, Position_>(with_subject, query_starts, query_ends, params, num_searched, (params.deduplicate ? unique_queries.data() : NULL), num_workers, [&](int) -> BatchResultsOutput<Results_> {
+        return BatchResultsOutput<Results_>(results.data());
+    });
+
+    // Identical queries are given a copy of the results of their first occurrence.
+    if (params.deduplicate) {
+        parallelize(num_workers, num_queries, [&](int, std::size_t start, std::size_t length) -> void {
+            for (std::size_t i = start, end = start + length; i < end; ++i) {
+                const auto u = unique_queries[query_to_unique[i]];
+                if (u != i) {
+                    results[i] = results[u];
+                }
+            }
+        });
+    }
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Overload of `overlaps_batch()` that only searches the subject intervals in an `NclistView`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam Stored_ Numeric type for the stored start/end positions of each interval, see `NclistView` for details.
+ *
+ * @param subject View of an `Nclist`, typically created with `make_view()`.
+ * @param num_queries Number of query intervals.
+ * @param[in] query_starts Pointer to an array of length `num_queries`, containing the start of each query interval.
+ * @param[in] query_ends Pointer to an array of length `num_queries`, containing the non-inclusive end of each query interval.
+ * @param params Parameters for the search.
+ * @param[out] offsets On output, vector of length `num_queries + 1`.
+ * The matches for query `i` are stored in `matches[offsets[i]]` to `matches[offsets[i + 1] - 1]`.
+ * @param[out] matches On output, vector of subject interval indices for each query, see `offsets`.
+ */
+template<typename Index_, typename Position_, typename Stored_>
+void overlaps_batch(
+    const NclistView<Index_, Position_, Stored_>& subject,
+    const std::size_t num_queries,
+    const Position_* query_starts,
+    const Position_* query_ends,
+    const OverlapsBatchParameters<Position_>& params,
+    std::vector<std::size_t>& offsets,
+    std::vector<Index_>& matches)
+{
+    overlaps_batch_internal<Index_, Position_>(
+        [&](int, auto fun) -> void {
+            if (params.num_threads > 1) {
+                ViewWorkerState<Index_, Position_, Stored_> state;
+                fun(state.get(subject));
+            } else {
+                fun(subject);
+            }
+        },
+        num_queries,
+        query_starts,
+        query_ends,
+        params,
+        NULL,
+        offsets,
+        matches
+    );
+}
+
+/**
+ * Find subject intervals that overlap with each query interval in a batch.
+ * Each query may have its own type of overlap and parameters, as specified in `OverlapsBatchParameters`.
+ * Queries are internally grouped by their type of overlap and dispatched to the corresponding function, e.g., `overlaps_any()`, `overlaps_within()`.
+ * The results are then reported in the same order as the input queries.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param num_queries Number of query intervals.
+ * @param[in] query_starts Pointer to an array of length `num_queries`, containing the start of each query interval.
+ * @param[in] query_ends Pointer to an array of length `num_queries`, containing the non-inclusive end of each query interval.
+ * @param params Parameters for the search.
+ * @param[out] offsets On output, vector of length `num_queries + 1`.
+ * The matches for query `i` are stored in `matches[offsets[i]]` to `matches[offsets[i + 1] - 1]`.
+ * @param[out] matches On output, vector of subject interval indices for each query, see `offsets`.
+ * For each query, indices are reported in the same order as the corresponding function for its type of overlap.
+ */
+template<typename Index_, typename Position_>
+void overlaps_batch(
+    const Nclist<Index_, Position_>& subject,
+    const std::size_t num_queries,
+    const Position_* query_starts,
+    const Position_* query_ends,
+    const OverlapsBatchParameters<Position_>& params,
+    std::vector<std::size_t>& offsets,
+    std::vector<Index_>& matches)
+{
+    overlaps_batch(make_view(subject), num_queries, query_starts, query_ends, params, offsets, matches);
+}
+
+/**
+ * Overload of `overlaps_batch()` that stores the matches for each query in a compressed container.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam Stored_ Numeric type for the stored start/end positions of each interval, see `NclistView` for details.
+ * @tparam Results_ Container for the matches, either `BitmapResults<Index_>` or `DeltaResults<Index_>`.
+ *
+ * @param subject View of an `Nclist`, typically created with `make_view()`.
+ * @param num_queries Number of query intervals.
+ * @param[in] query_starts Pointer to an array of length `num_queries`, containing the start of each query interval.
+ * @param[in] query_ends Pointer to an array of length `num_queries`, containing the non-inclusive end of each query interval.
+ * @param params Parameters for the search.
+ * @param[out] matches On output, vector of length `num_queries` containing the subject interval indices for each query.
+ */
+template<typename Index_, typename Position_, typename Stored_, class Results_>
+void overlaps_batch(
+    const NclistView<Index_, Position_, Stored_>& subject,
+    const std::size_t num_queries,
+    const Position_* query_starts,
+    const Position_* query_ends,
+    const OverlapsBatchParameters<Position_>& params,
+    std::vector<Results_>& matches)
+{
+    overlaps_batch_results_internal<Index_, Position_>(
+        [&](int, auto fun) -> void {
+            if (params.num_threads > 1) {
+                ViewWorkerState<Index_, Position_, Stored_> state;
+                fun(state.get(subject));
+            } else {
+                fun(subject);
+            }
+        },
+        num_queries,
+        query_starts,
+        query_ends,
+        params,
+        matches
+    );
+}
+
+/**
+ * Overload of `overlaps_batch()` that stores the matches for each query in a compressed container.
+ * Each query is searched directly into its container, so the matches are never held in an uncompressed vector.
+ * This reduces memory usage for batches where some queries overlap many subject intervals, e.g., wide query intervals against a collection of sequencing reads.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam Results_ Container for the matches, either `BitmapResults<Index_>` or `DeltaResults<Index_>`.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param num_queries Number of query intervals.
+ * @param[in] query_starts Pointer to an array of length `num_queries`, containing the start of each query interval.
+ * @param[in] query_ends Pointer to an array of length `num_queries`, containing the non-inclusive end of each query interval.
+ * @param params Parameters for the search.
+ * If `OverlapsBatchParameters::deduplicate = true`, identical queries receive copies of the same container.
+ * @param[out] matches On output, vector of length `num_queries` containing the subject interval indices for each query.
+ */
+template<typename Index_, typename Position_, class Results_>
+void overlaps_batch(
+    const Nclist<Index_, Position_>& subject,
+    const std::size_t num_queries,
+    const Position_* query_starts,
+    const Position_* query_ends,
+    const OverlapsBatchParameters<Position_>& params,
+    std::vector<Results_>& matches)
+{
+    overlaps_batch(make_view(subject), num_queries, query_starts, query_ends, params, matches);
+}
+
+/**
+ * Overload of `overlaps_batch_unique()` that only searches the subject intervals in an `NclistView`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam Stored_ Numeric type for the stored start/end positions of each interval, see `NclistView` for details.
+ *
+ * @param subject View of an `Nclist`, typically created with `make_view()`.
+ * @param num_queries Number of query intervals.
+ * @param[in] query_starts Pointer to an array of length `num_queries`, containing the start of each query interval.
+ * @param[in] query_ends Pointer to an array of length `num_queries`, containing the non-inclusive end of each query interval.
+ * @param params Parameters for the search.
+ * @param[out] unique_indices On output, vector of length `num_queries` containing the index of the unique query for each query.
+ * @param[out] offsets On output, vector of length equal to the number of unique queries plus 1.
+ * The matches for unique query `u` are stored in `matches[offsets[u]]` to `matches[offsets[u + 1] - 1]`.
+ * @param[out] matches On output, vector of subject interval indices for each unique query, see `offsets`.
+ */
+template<typename Index_, typename Position_, typename Stored_>
+void overlaps_batch_unique(
+    const NclistView<Index_, Position_, Stored_>& subject,
+    const std::size_t num_queries,
+    const Position_* query_starts,
+    const Position_* query_ends,
+    const OverlapsBatchParameters<Position_>& params,
+    std::vector<std::size_t>& unique_indices,
+    std::vector<std::size_t>& offsets,
+    std::vector<Index_>& matches)
+{
+    overlaps_batch_internal<Index_, Position_>(
+        [&](int, auto fun) -> void {
+            if (params.num_threads > 1) {
+                ViewWorkerState<Index_, Position_, Stored_> state;
+                fun(state.get(subject));
+            } else {
+                fun(subject);
+            }
+        },
+        num_queries,
+        query_starts,
+        query_ends,
+        params,
+        &unique_indices,
+        offsets,
+        matches
+    );
+}
+
+/**
+ * Variant of `overlaps_batch()` that only reports results for each unique query in the batch.
+ * Identical queries (i.e., with the same start/end positions and the same per-query type and parameters) are only searched once,
+ * and they share the same slice of `matches` via an indirection table.
+ * This reduces both the search time and the memory usage of the output when the batch contains many duplicate queries,
+ * e.g., identical read intervals from deep sequencing.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param num_queries Number of query intervals.
+ * @param[in] query_starts Pointer to an array of length `num_queries`, containing the start of each query interval.
+ * @param[in] query_ends Pointer to an array of length `num_queries`, containing the non-inclusive end of each query interval.
+ * @param params Parameters for the search.
+ * `OverlapsBatchParameters::deduplicate` is ignored.
+ * @param[out] unique_indices On output, vector of length `num_queries` containing the index of the unique query for each query.
+ * Unique queries are indexed in the order of their first occurrence in the batch.
+ * @param[out] offsets On output, vector of length equal to the number of unique queries plus 1.
+ * The matches for query `i` are stored in `matches[offsets[unique_indices[i]]]` to `matches[offsets[unique_indices[i] + 1] - 1]`.
+ * @param[out] matches On output, vector of subject interval indices for each unique query, see `offsets`.
+ * For each query, indices are reported in the same order as the corresponding function for its type of overlap.
+ */
+template<typename Index_, typename Position_>
+void overlaps_batch_unique(
+    const Nclist<Index_, Position_>& subject,
+    const std::size_t num_queries,
+    const Position_* query_starts,
+    const Position_* query_ends,
+    const OverlapsBatchParameters<Position_>& params,
+    std::vector<std::size_t>& unique_indices,
+    std::vector<std::size_t>& offsets,
+    std::vector<Index_>& matches)
+{
+    overlaps_batch_unique(make_view(subject), num_queries, query_starts, query_ends, params, unique_indices, offsets, matches);
+}
+
+}
+
+#endif
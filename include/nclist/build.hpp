@@ -34,7 +34,7 @@ struct Nclist {
 
     struct Node {
         Node() = default;
-        Node(Index_ id) : id(id) {}
+        constexpr Node(Index_ id) : id(id) {}
 
         // Index of the subject interval in the user-supplied arrays. 
         Index_ id = 0;
@@ -101,12 +101,9 @@ void check_safe_ptrdiff(Size_ size) {
     }
 }
 
+// We want to sort by increasing start but DECREASING end, so that the children sort after their parents. 
 template<typename Index_, class StartArray_, class EndArray_>
-Nclist<Index_, ArrayElement<StartArray_> > build_internal(std::vector<Index_> of_interest, const StartArray_& starts, const EndArray_& ends) {
-    typedef ArrayElement<StartArray_> Position;
-    static_assert(std::is_same<Position, ArrayElement<EndArray_> >::value);
-
-    // We want to sort by increasing start but DECREASING end, so that the children sort after their parents. 
+void sort_intervals(std::vector<Index_>& of_interest, const StartArray_& starts, const EndArray_& ends) {
     const auto cmp = [&](const Index_ l, const Index_ r) -> bool {
         if (starts[l] == starts[r]) {
             return ends[l] > ends[r];
@@ -117,6 +114,13 @@ Nclist<Index_, ArrayElement<StartArray_> > build_internal(std::vector<Index_> of
     if (!std::is_sorted(of_interest.begin(), of_interest.end(), cmp)) {
         std::sort(of_interest.begin(), of_interest.end(), cmp);
     }
+}
+
+template<typename Index_, class StartArray_, class EndArray_>
+Nclist<Index_, ArrayElement<StartArray_> > build_internal(std::vector<Index_> of_interest, const StartArray_& starts, const EndArray_& ends) {
+    typedef ArrayElement<StartArray_> Position;
+    static_assert(std::is_same<Position, ArrayElement<EndArray_> >::value);
+    sort_intervals(of_interest, starts, ends);
 
     const auto num_intervals = of_interest.size();
     typedef typename Nclist<Index_, Position>::Node WorkingNode;
@@ -326,6 +330,231 @@ Nclist<Index_, ArrayElement<StartArray_> > build_internal(std::vector<Index_> of
 
     return output;
 }
+
+// Variant of build_internal() that re-uses the working buffers in place, so that the peak memory usage is close to the size of the final Nclist.
+// This is slower due to the random access in the in-place permutation of the nodes at the end.
+template<typename Index_, class StartArray_, class EndArray_>
+Nclist<Index_, ArrayElement<StartArray_> > build_internal_low_memory(std::vector<Index_> of_interest, const StartArray_& starts, const EndArray_& ends) {
+    typedef ArrayElement<StartArray_> Position;
+    static_assert(std::is_same<Position, ArrayElement<EndArray_> >::value);
+    sort_intervals(of_interest, starts, ends);
+
+    const Index_ num_intervals = of_interest.size();
+
+    // Counting the number of duplicate intervals so that we can allocate the exact number of nodes.
+    // After sorting, duplicate intervals are always adjacent to each other.
+    Index_ num_duplicates = 0;
+    for (Index_ i = 1; i < num_intervals; ++i) {
+        const auto previd = of_interest[i - 1], curid = of_interest[i];
+        num_duplicates += (starts[previd] == starts[curid] && ends[previd] == ends[curid]);
+    }
+    const Index_ num_nodes = num_intervals - num_duplicates;
+
+    typedef typename Nclist<Index_, Position>::Node WorkingNode;
+    std::vector<WorkingNode> working_list;
+    working_list.reserve(num_nodes);
+
+    // This section deserves some explanation.
+    // For each node in the list, we need to track its children.
+    // This is most easily done by allocating a vector per node, but that is very time-consuming when we have millions of nodes.
+    //
+    // Instead, we recognize that the number of child indices is no greater than the number of nodes (as each interval must only have one parent).
+    // We allocate a 'working_children' vector of length equal to the number of nodes.
+    // The left side of the vector contains the already-processed child indices, while the right side contains the currently-processed indices.
+    // The aim is to store all children in a single memory allocation that can be easily freed.
+    //
+    // At each level, we add child indices to the right side of the vector, moving in torwards the center.
+    // Once we move past a level (i.e., we discard it from 'history'), we shift its indices from the right to the left, as no more children will be added.
+    // We will always have space to perform the left shift as we know the upper bound on the number of child indices.
+    // This move also exposes the indices of that level's parent on the right of the vector, allowing for further addition of new children to that parent.
+    //
+    // The simplest approach is to left shift the children of each level separately.
+    // However, if we are discarding multiple levels at once, we can accumulate their associated contiguous slices of the 'working_children' vector.
+    // This allows us to perform a single left shift, eliminating overhead from repeated function calls.
+    //
+    // A quirk of this approach is that, because we add on the right towards the center, the children are stored in reverse order of addition.
+    // This requires some later work to undo this, to report the correct order for binary search.
+    std::vector<Index_> working_children;
+    safe_resize(working_children, num_nodes);
+    Index_ children_used = 0, children_tmp_boundary = num_nodes;
+
+    // Duplicates are handled differently as all duplicates of an interval are adjacent to it in 'of_interest'.
+    // This means that we can compact the duplicates in-place at the start of 'of_interest', as we never write past the current read position.
+    // The duplicates of each node form a contiguous slice that can be directly used as the final 'duplicates' vector.
+    Index_ duplicates_used = 0;
+
+    struct Level {
+        Level() = default;
+        Level(Index_ offset, Position end) : offset(offset), end(end) {}
+        Index_ offset; // offset into `working_list`
+        Position end; // storing the end coordinate for better cache locality.
+        Index_ num_children = 0;
+    };
+    std::vector<Level> levels(1);
+
+    Index_ num_children_to_copy = 0;
+    const auto process_level = [&](const Level& curlevel) -> void {
+        if (curlevel.num_children) {
+            auto& original_node = working_list[curlevel.offset];
+            original_node.children_start = children_used + num_children_to_copy;
+            num_children_to_copy += curlevel.num_children;
+            original_node.children_end = children_used + num_children_to_copy;
+        }
+    };
+
+    const auto left_shift_indices = [&]() -> void {
+        if (num_children_to_copy) {
+            if (children_used != children_tmp_boundary) { // protect the copy, though this should only be relevant at the end of the traversal.
+                std::copy_n(working_children.begin() + children_tmp_boundary, num_children_to_copy, working_children.begin() + children_used);
+            }
+            children_used += num_children_to_copy;
+            children_tmp_boundary += num_children_to_copy;
+        }
+    };
+
+    Index_ last_id = 0;
+    for (Index_ i = 0; i < num_intervals; ++i) {
+        const auto curid = of_interest[i];
+        const auto curend = ends[curid];
+
+        if (levels.size() > 1) { // i.e., We've processed our first interval.
+            const auto last_end = levels.back().end;
+            if (last_end < curend) { // If we're no longer nested within the previous interval, we need to back up to the root until we are nested.
+                num_children_to_copy = 0;
+                do {
+                    const auto& curlevel = levels.back();
+                    process_level(curlevel);
+                    levels.pop_back();
+                } while (levels.size() > 1 && levels.back().end < curend);
+                left_shift_indices();
+
+            } else if (last_end == curend) { // Special handling of duplicate intervals.
+                if (starts[curid] == starts[last_id]) { // Only accessing 'starts' if we're forced to.
+                    // The previous interval must be the last node, as duplicates are adjacent after sorting.
+                    auto& last_node = working_list.back();
+                    if (last_node.duplicates_start == last_node.duplicates_end) {
+                        last_node.duplicates_start = duplicates_used;
+                    }
+                    of_interest[duplicates_used] = curid;
+                    ++duplicates_used;
+                    last_node.duplicates_end = duplicates_used;
+                    continue;
+                }
+            }
+        }
+
+        const auto used = working_list.size();
+        working_list.emplace_back(curid);
+        ++(levels.back().num_children);
+        --children_tmp_boundary;
+        working_children[children_tmp_boundary] = used;
+        levels.emplace_back(used, curend);
+
+        last_id = curid;
+    }
+
+    num_children_to_copy = 0;
+    while (levels.size() > 1) { // processing all remaining levels except for the root node, which we'll handle separately.
+        const auto& curlevel = levels.back();
+        process_level(curlevel);
+        levels.pop_back();
+    }
+    left_shift_indices();
+
+    // The start of 'of_interest' now contains the duplicates, so we shrink it to free up the rest of the memory.
+    Nclist<Index_, Position> output;
+    of_interest.resize(duplicates_used);
+    of_interest.shrink_to_fit();
+    output.duplicates.swap(of_interest);
+
+    // We convert the `working_list` into the output format where the children's start/end coordinates are laid out contiguously.
+    // This should make for an easier binary search (allowing us to use std::lower_bound and friends) and improve cache locality.
+    // We do this by traversing the list in a depth-first manner and computing the destination of each node in the output vectors.
+    // Each node's children are also updated in place to refer to the offsets in the output vectors.
+    std::vector<Index_> destinations;
+    safe_resize(destinations, num_nodes);
+
+    // We compute iterator differences to obtain an index after std::lower_bound and friends.
+    // We want to ensure that the difference fits in the difference type without overflow.
+    // This can be guaranteed by checking that the difference type is large enough to hold the vector's full length.
+    // We only need to check output.starts as output.ends is the same type so will have the same difference type.
+    // We use Index_ as this gives us a chance to avoid the check at compile time,
+    // given that num_nodes <= num_intervals/num_subset.
+    check_safe_ptrdiff<decltype(output.starts.begin())>(num_nodes);
+
+    struct Level2 {
+        Level2() = default;
+        Level2(Index_ working_at, Index_ working_start, Index_ output_offset) : working_at(working_at), working_start(working_start), output_offset(output_offset) {}
+        Index_ working_at;
+        Index_ working_start;
+        Index_ output_offset;
+    };
+    std::vector<Level2> history;
+
+    output.root_children = levels.front().num_children;
+    Index_ output_children_used = output.root_children;
+    history.emplace_back(num_nodes, children_tmp_boundary, 0);
+
+    while (1) {
+        auto& current_state = history.back();
+        if (current_state.working_at == current_state.working_start) {
+            history.pop_back();
+            if (history.empty()) {
+                break;
+            } else {
+                continue;
+            }
+        }
+
+        // Remember that we inserted children in reverse order into their working vectors.
+        // So when we copy, we do so in reverse order to cancel out the reversal, hence the decrement here.
+        --(current_state.working_at);
+        auto current_working_at = current_state.working_at;
+        auto current_output_offset = current_state.output_offset;
+        ++(current_state.output_offset); // do all modifications to current_state before the emplace_back(), otherwise the history might get reallocated and the reference would be dangling.
+
+        auto child = working_children[current_working_at];
+        destinations[child] = current_output_offset;
+        auto& current = working_list[child];
+
+        auto children_old_start = current.children_start, children_old_end = current.children_end;
+        if (children_old_start != children_old_end) {
+            current.children_start = output_children_used;
+            output_children_used += children_old_end - children_old_start;
+            current.children_end = output_children_used;
+            history.emplace_back(children_old_end, children_old_start, current.children_start);
+        }
+    }
+
+    working_children.clear(); // freeing up some memory for more allocations in the next section.
+    working_children.shrink_to_fit();
+
+    // Permuting the nodes in place to their destinations, following each cycle of the permutation until every node is in the right place.
+    // This avoids the need to allocate a separate vector for the output nodes.
+    for (Index_ i = 0; i < num_nodes; ++i) {
+        while (destinations[i] != i) {
+            const auto target = destinations[i];
+            std::swap(working_list[i], working_list[target]);
+            std::swap(destinations[i], destinations[target]);
+        }
+    }
+    destinations.clear();
+    destinations.shrink_to_fit();
+    output.nodes.swap(working_list);
+
+    // Starts and ends are guaranteed to be sorted for all children of a given node.
+    // Obviously we already sorted in order of increasing starts, and interval indices were added to each node's children in that order.
+    // For the ends, this is less obvious but any end that is equal to or less than the previous end should be a child of that previous interval and should not show up here.
+    safe_resize(output.starts, num_nodes);
+    safe_resize(output.ends, num_nodes);
+    for (Index_ i = 0; i < num_nodes; ++i) {
+        const auto curid = output.nodes[i].id;
+        output.starts[i] = starts[curid];
+        output.ends[i] = ends[curid];
+    }
+
+    return output;
+}
 /**
  * @endcond
  */
@@ -411,6 +640,83 @@ Nclist<Index_, Position_> build(Index_ num_intervals, const Position_* starts, c
     return build_custom<Index_>(num_intervals, starts, ends);
 }
 
+/**
+ * Variant of `build_custom()` that re-uses its working buffers in place, so that the peak memory usage during the build is close to the size of the final `Nclist`.
+ * By comparison, `build_custom()` needs about twice the size of the final `Nclist`, but this variant is about 25% slower.
+ * Both functions produce the same tree of nodes, though the duplicates of each node may be stored in a different order.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam StartArray_ Class with a `[` method that accepts an `Index_` and returns the start position of the associated interval.
+ * @tparam EndArray_ Class with a `[` method that accepts an `Index_` and returns the end position of the associated interval.
+ *
+ * @param num_subset Number of subject intervals in the subset to include in the `Nclist`.
+ * @param[in] subset Pointer to an array of length equal to `num_subset`, containing the subset of subject intervals to include in the NCList.
+ * @param[in] starts Array-like object containing the start positions of all subject intervals, see `build_custom()` for details.
+ * @param[in] ends Array-like object containing the end positions of all subject intervals, see `build_custom()` for details.
+ *
+ * @return A `Nclist` containing the specified subset of subject intervals.
+ */
+template<typename Index_, class StartArray_, class EndArray_>
+Nclist<Index_, ArrayElement<StartArray_> > build_custom_low_memory(Index_ num_subset, const Index_* subset, const StartArray_& starts, const EndArray_& ends) {
+    std::vector<Index_> of_interest(subset, subset + num_subset);
+    return build_internal_low_memory(std::move(of_interest), starts, ends);
+}
+
+/**
+ * Variant of `build_custom()` that re-uses its working buffers in place, see the other `build_custom_low_memory()` overload for details.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam StartArray_ Class with a `[` method that accepts an `Index_` and returns the start position of the associated interval.
+ * @tparam EndArray_ Class with a `[` method that accepts an `Index_` and returns the end position of the associated interval.
+ *
+ * @param num_intervals Number of subject intervals to include in the NCList.
+ * @param[in] starts Array-like object containing the start positions of all subject intervals, see `build_custom()` for details.
+ * @param[in] ends Array-like object containing the end positions of all subject intervals, see `build_custom()` for details.
+ *
+ * @return A `Nclist` containing all subject intervals.
+ */
+template<typename Index_, class StartArray_, class EndArray_>
+Nclist<Index_, ArrayElement<StartArray_> > build_custom_low_memory(Index_ num_intervals, const StartArray_& starts, const EndArray_& ends) {
+    std::vector<Index_> of_interest(num_intervals);
+    std::iota(of_interest.begin(), of_interest.end(), static_cast<Index_>(0));
+    return build_internal_low_memory(std::move(of_interest), starts, ends);
+}
+
+/**
+ * Variant of `build()` that re-uses its working buffers in place, see `build_custom_low_memory()` for details.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param num_subset Number of subject intervals in the subset to include in the `Nclist`.
+ * @param[in] subset Pointer to an array of length equal to `num_subset`, containing the subset of subject intervals to include in the NCList.
+ * @param[in] starts Pointer to an array containing the start positions of all subject intervals, see `build()` for details.
+ * @param[in] ends Pointer to an array containing the end positions of all subject intervals, see `build()` for details.
+ *
+ * @return A `Nclist` containing the specified subset of subject intervals.
+ */
+template<typename Index_, typename Position_>
+Nclist<Index_, Position_> build_low_memory(Index_ num_subset, const Index_* subset, const Position_* starts, const Position_* ends) {
+    return build_custom_low_memory<Index_>(num_subset, subset, starts, ends);
+}
+
+/**
+ * Variant of `build()` that re-uses its working buffers in place, see `build_custom_low_memory()` for details.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end position of each interval.
+ *
+ * @param num_intervals Number of subject intervals to include in the NCList.
+ * @param[in] starts Pointer to an array of length `num_intervals`, containing the start positions of all subject intervals.
+ * @param[in] ends Pointer to an array of length `num_intervals`, containing the end positions of all subject intervals.
+ *
+ * @return A `Nclist` containing all subject intervals.
+ */
+template<typename Index_, typename Position_>
+Nclist<Index_, Position_> build_low_memory(Index_ num_intervals, const Position_* starts, const Position_* ends) {
+    return build_custom_low_memory<Index_>(num_intervals, starts, ends);
+}
+
 }
 
 #endif
@@ -0,0 +1,263 @@
+#ifndef NCLIST_CLASSIFY_HPP
+#define NCLIST_CLASSIFY_HPP
+
+#include <vector>
+#include <algorithm>
+
+#include "build.hpp"
+#include "view.hpp"
+
+/**
+ * @file classify.hpp
+ * @brief Classify overlaps by their type.
+ */
+
+namespace nclist {
+
+/**
+ * Flags for the type of overlap between a query and subject interval, to be combined in a bitmask by `classify_overlaps()`.
+ *
+ * - `OVERLAP_ANY`: the subject is reported by `overlaps_any()`.
+ * - `OVERLAP_EQUAL`: the subject is reported by `overlaps_equal()`.
+ * - `OVERLAP_WITHIN`: the subject is reported by `overlaps_within()`, i.e., the query lies within the subject.
+ * - `OVERLAP_EXTEND`: the subject is reported by `overlaps_extend()`, i.e., the query extends past the subject.
+ * - `OVERLAP_START`: the subject is reported by `overlaps_start()`.
+ * - `OVERLAP_END`: the subject is reported by `overlaps_end()`.
+ */
+enum OverlapFlag : unsigned char {
+    OVERLAP_ANY = 1,
+    OVERLAP_EQUAL = 2,
+    OVERLAP_WITHIN = 4,
+    OVERLAP_EXTEND = 8,
+    OVERLAP_START = 16,
+    OVERLAP_END = 32
+};
+
+/**
+ * @brief Workspace for `classify_overlaps()`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ *
+ * This holds intermediate data structures that can be re-used across multiple calls to `classify_overlaps()` to avoid reallocations.
+ */
+template<typename Index_>
+struct ClassifyOverlapsWorkspace {
+    /**
+     * @cond
+     */
+    struct State {
+        State() = default;
+        State(Index_ cat, Index_ cend, bool skip) : child_at(cat), child_end(cend), skip_search(skip) {}
+        Index_ child_at = 0, child_end = 0;
+        bool skip_search = false;
+    };
+    std::vector<State> history;
+    /**
+     * @endcond
+     */
+};
+
+/**
+ * @brief Parameters for `classify_overlaps()`.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ */
+template<typename Position_>
+struct ClassifyOverlapsParameters {
+    /**
+     * Minimum overlap between query and subject intervals.
+     * An overlap will not be reported if the length of the overlapping subinterval is less than `min_overlap`.
+     * This has the same effect as setting `min_overlap` in the parameters for each of the individual `overlaps_*()` functions.
+     */
+    Position_ min_overlap = 0;
+};
+
+/**
+ * Overload of `classify_overlaps()` that only searches the subject intervals in an `NclistView`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam Stored_ Numeric type for the stored start/end positions of each interval, see `NclistView` for details.
+ *
+ * @param subject View of an `Nclist`, typically created with `make_view()`.
+ * @param query_start Start of the query interval.
+ * @param query_end Non-inclusive end of the query interval.
+ * @param params Parameters for the search.
+ * @param workspace Workspace for intermediate data structures.
+ * This can be default-constructed and re-used across `classify_overlaps()` calls.
+ * @param[out] matches On output, vector of indices of subject intervals that have any type of overlap with the query interval.
+ * Indices are reported in arbitrary order.
+ * @param[out] types On output, vector of the same length as `matches`.
+ * Each entry is a bitmask of `OverlapFlag`s specifying the types of overlap between the query and the corresponding subject interval in `matches`.
+ */
+template<typename Index_, typename Position_, typename Stored_>
+void classify_overlaps(
+    const NclistView<Index_, Position_, Stored_>& subject,
+    const Position_ query_start,
+    const Position_ query_end,
+    const ClassifyOverlapsParameters<Position_>& params,
+    ClassifyOverlapsWorkspace<Index_>& workspace,
+    std::vector<Index_>& matches,
+    std::vector<unsigned char>& types)
+{
+    matches.clear();
+    types.clear();
+    if (subject.root_start == subject.root_end) {
+        return;
+    }
+
+    /****************************************
+     * Each type of overlap requires that `subject_starts[i] <= query_end` and `query_start <= subject_ends[i]`,
+     * i.e., the subject interval overlaps or is immediately adjacent to the query interval.
+     * This is the same problem as solved by `overlaps_any()` with `max_gap = 0`, so we use the same traversal strategy:
+     *
+     * - At each node of the NCList, we find the first child where `subject_ends` is greater than or equal to `query_start`.
+     * - We iterate until the first child `j` where `subject_starts[j] > query_end`, at which point we stop.
+     * - If `query_start <= subject_starts[i]` for node `i`, the binary search can be skipped for its entire lineage.
+     *
+     * For each subject interval encountered during iteration, we check each type of overlap and report the subject with its bitmask if any type is satisfied.
+     * Children are processed regardless of whether the subject interval itself is reported.
+     *
+     * If `min_overlap > 0`, we skip subject intervals (and their children) that do not have a sufficiently long overlapping subinterval.
+     * This is the same strategy as used in `overlaps_any()`, and also applies to each of the other overlap types.
+     *
+     ****************************************/
+
+    if (params.min_overlap > 0) {
+        if (query_end - query_start < params.min_overlap) {
+            return;
+        }
+    }
+
+    const auto find_first_child = [&](const Index_ children_start, const Index_ children_end) -> Index_ {
+        const auto ebegin = subject.ends;
+        const auto estart = ebegin + children_start;
+        const auto eend = ebegin + children_end;
+        return std::lower_bound(estart, eend, query_start) - ebegin;
+    };
+
+    const auto can_skip_search = [&](const Position_ subject_start) -> bool {
+        return subject_start >= query_start;
+    };
+
+    const auto is_finished = [&](const Position_ subject_start) -> bool {
+        return subject_start > query_end;
+    };
+
+    Index_ root_child_at = subject.root_start;
+    const bool root_skip_search = can_skip_search(subject.starts[subject.root_start]);
+    if (!root_skip_search) {
+        root_child_at = find_first_child(subject.root_start, subject.root_end);
+    }
+
+    workspace.history.clear();
+    while (1) {
+        Index_ current_subject;
+        bool skip_search;
+        if (workspace.history.empty()) {
+            if (root_child_at == subject.root_end || is_finished(subject.starts[root_child_at])) {
+                break;
+            }
+            current_subject = root_child_at;
+            skip_search = root_skip_search;
+            ++root_child_at;
+        } else {
+            auto& current_state = workspace.history.back();
+            if (current_state.child_at == current_state.child_end || is_finished(subject.starts[current_state.child_at])) {
+                workspace.history.pop_back();
+                continue;
+            }
+            current_subject = current_state.child_at;
+            skip_search = current_state.skip_search;
+            ++(current_state.child_at); // do this before the emplace_back(), otherwise the history might get reallocated and the reference would be dangling.
+        }
+
+        const auto& current_node = subject.nodes[current_subject];
+        const auto subject_start = subject.starts[current_subject];
+        const auto subject_end = subject.ends[current_subject];
+
+        if (params.min_overlap > 0) {
+            if (std::min(query_end, subject_end) - std::max(query_start, subject_start) < params.min_overlap) {
+                // No point continuing with the children, as all children will by definition have smaller overlaps and cannot satisfy `min_overlap`.
+                continue;
+            }
+        }
+
+        unsigned char mask = 0;
+        if (subject_start < query_end && query_start < subject_end) {
+            mask |= OVERLAP_ANY;
+        }
+        const bool same_start = (subject_start == query_start);
+        const bool same_end = (subject_end == query_end);
+        if (same_start) {
+            mask |= OVERLAP_START;
+        }
+        if (same_end) {
+            mask |= OVERLAP_END;
+        }
+        if (same_start && same_end) {
+            mask |= OVERLAP_EQUAL;
+        }
+        if (subject_start <= query_start && query_end <= subject_end) {
+            mask |= OVERLAP_WITHIN;
+        }
+        if (query_start <= subject_start && subject_end <= query_end) {
+            mask |= OVERLAP_EXTEND;
+        }
+
+        if (mask) {
+            matches.push_back(current_node.id);
+            types.push_back(mask);
+            if (current_node.duplicates_start != current_node.duplicates_end) {
+                matches.insert(matches.end(), subject.duplicates + current_node.duplicates_start, subject.duplicates + current_node.duplicates_end);
+                types.resize(matches.size(), mask);
+            }
+        }
+
+        if (current_node.children_start != current_node.children_end) {
+            if (skip_search) {
+                workspace.history.emplace_back(current_node.children_start, current_node.children_end, true);
+            } else {
+                const Index_ start_pos = find_first_child(current_node.children_start, current_node.children_end);
+                if (start_pos != current_node.children_end) {
+                    workspace.history.emplace_back(start_pos, current_node.children_end, can_skip_search(subject.starts[start_pos]));
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Find subject intervals with any type of overlap to the query interval, and classify each overlap by its type(s).
+ * This is equivalent to combining the results of `overlaps_any()`, `overlaps_equal()`, `overlaps_within()`, `overlaps_extend()`, `overlaps_start()` and `overlaps_end()` with default parameters,
+ * but only requires a single traversal of the `Nclist`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param query_start Start of the query interval.
+ * @param query_end Non-inclusive end of the query interval.
+ * @param params Parameters for the search.
+ * @param workspace Workspace for intermediate data structures.
+ * This can be default-constructed and re-used across `classify_overlaps()` calls.
+ * @param[out] matches On output, vector of indices of subject intervals that have any type of overlap with the query interval.
+ * Indices are reported in arbitrary order.
+ * @param[out] types On output, vector of the same length as `matches`.
+ * Each entry is a bitmask of `OverlapFlag`s specifying the types of overlap between the query and the corresponding subject interval in `matches`.
+ */
+template<typename Index_, typename Position_>
+void classify_overlaps(
+    const Nclist<Index_, Position_>& subject,
+    const Position_ query_start,
+    const Position_ query_end,
+    const ClassifyOverlapsParameters<Position_>& params,
+    ClassifyOverlapsWorkspace<Index_>& workspace,
+    std::vector<Index_>& matches,
+    std::vector<unsigned char>& types)
+{
+    classify_overlaps(make_view(subject), query_start, query_end, params, workspace, matches, types);
+}
+
+}
+
+#endif
@@ -0,0 +1,661 @@
+#ifndef NCLIST_COMPRESSED_HPP
+#define NCLIST_COMPRESSED_HPP
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+#include "build.hpp"
+#include "view.hpp"
+
+/**
+ * @file compressed.hpp
+ * @brief Compressed storage for nested containment lists.
+ */
+
+namespace nclist {
+
+/**
+ * Number of nodes in each block of a `CompressedNclist`.
+ */
+constexpr std::size_t compressed_block_size = 64;
+
+/**
+ * @brief Nested containment list with block-compressed storage.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Integer type for the start/end positions of each interval.
+ *
+ * This stores the same information as an `Nclist`, but the nodes and their start/end positions are delta- and varint-encoded in blocks of `compressed_block_size` nodes.
+ * This is intended for large collections of rarely-queried indexes where memory usage is more important than query speed.
+ * Instances of a `CompressedNclist` are usually created by `compress()`, and can be searched by creating a view with `make_view()`.
+ */
+template<typename Index_, typename Position_>
+struct CompressedNclist {
+/**
+ * @cond
+ */
+    // Unique identifier for the contents, so that a CompressedNclistWorkspace can check whether its decompressed blocks are still valid.
+    std::uint64_t id = 0;
+
+    Index_ root_children = 0;
+    Index_ num_nodes = 0;
+
+    // Per-block headers with the smallest start position and the largest end position in each block.
+    std::vector<Position_> block_min_starts, block_max_ends;
+
+    // Encoded bytes for block `b` are stored in `data[block_offsets[b]]` to `data[block_offsets[b + 1] - 1]`.
+    std::vector<std::size_t> block_offsets;
+    std::vector<unsigned char> data;
+
+    std::vector<Index_> duplicates;
+/**
+ * @endcond
+ */
+};
+
+/**
+ * @cond
+ */
+inline std::uint64_t next_compressed_id() {
+    static std::atomic<std::uint64_t> counter(0);
+    return ++counter;
+}
+
+// Delta encoding of arbitrary integers, using modular arithmetic in 64 bits and then zig-zag encoding to get small unsigned values for small negative deltas.
+template<typename Integer_>
+std::uint64_t zigzag_delta(Integer_ value, Integer_ previous) {
+    const std::uint64_t delta = static_cast<std::uint64_t>(value) - static_cast<std::uint64_t>(previous);
+    return (delta << 1) ^ (0 - (delta >> 63));
+}
+
+template<typename Integer_>
+Integer_ unzigzag_delta(std::uint64_t encoded, Integer_ previous) {
+    const std::uint64_t delta = (encoded >> 1) ^ (0 - (encoded & 1));
+    return static_cast<Integer_>(static_cast<std::uint64_t>(previous) + delta);
+}
+
+inline void encode_varint(std::uint64_t value, std::vector<unsigned char>& output) {
+    while (value >= 128) {
+        output.push_back(static_cast<unsigned char>(value | 128));
+        value >>= 7;
+    }
+    output.push_back(static_cast<unsigned char>(value));
+}
+
+inline std::uint64_t decode_varint(const unsigned char*& ptr) {
+    std::uint64_t value = 0;
+    int shift = 0;
+    while (1) {
+        const unsigned char byte = *ptr;
+        ++ptr;
+        value |= static_cast<std::uint64_t>(byte & 127) << shift;
+        if (byte < 128) {
+            return value;
+        }
+        shift += 7;
+    }
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Default maximum number of decompressed blocks in a `CompressedNclistWorkspace`.
+ */
+constexpr std::size_t compressed_workspace_max_blocks = 1024;
+
+/**
+ * @brief Workspace for querying a `CompressedNclist`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Integer type for the start/end positions of each interval.
+ *
+ * This holds the decompressed blocks of a `CompressedNclist`.
+ * Blocks are only decompressed when they are accessed during a search, and are retained for re-use in subsequent searches on the same `CompressedNclist`.
+ * Once the number of decompressed blocks reaches the limit specified in the constructor, the least recently used block is discarded to make room for each new block.
+ * This ensures that the memory usage of a long-lived workspace does not approach that of the uncompressed `Nclist`.
+ * If the workspace is used with a different `CompressedNclist`, all previously decompressed blocks are discarded.
+ *
+ * A workspace should not be shared between threads, as decompression modifies its contents.
+ * This means that views created from the same workspace should not be searched in parallel by the caller.
+ * (`overlaps_batch()` with `OverlapsBatchParameters::num_threads` greater than 1 is safe as it creates a separate workspace for each worker.)
+ */
+template<typename Index_, typename Position_>
+class CompressedNclistWorkspace {
+public:
+    /**
+     * @param max_blocks Maximum number of decompressed blocks to retain in the workspace.
+     * If zero, the number of blocks is unlimited, i.e., all blocks are retained until `clear()` is called.
+     */
+    CompressedNclistWorkspace(const std::size_t max_blocks = compressed_workspace_max_blocks) : my_max_blocks(max_blocks) {}
+
+    /**
+     * Discard all decompressed blocks to free memory.
+     */
+    void clear() {
+        my_slots.clear();
+        my_slots.shrink_to_fit();
+        my_block_slots.clear();
+        my_block_slots.shrink_to_fit();
+        my_source = NULL;
+        my_id = 0;
+        my_head = no_slot;
+        my_tail = no_slot;
+        my_last_block = no_slot;
+    }
+
+    /**
+     * @return Number of blocks that are currently decompressed.
+     */
+    std::size_t num_decompressed() const {
+        return my_slots.size();
+    }
+
+    /**
+     * @return Maximum number of decompressed blocks, or zero if there is no limit.
+     */
+    std::size_t get_max_blocks() const {
+        return my_max_blocks;
+    }
+
+    /**
+     * Change the maximum number of decompressed blocks.
+     * This discards all decompressed blocks.
+     *
+     * @param max_blocks Maximum number of decompressed blocks, or zero if there is no limit.
+     */
+    void set_max_blocks(const std::size_t max_blocks) {
+        const auto source = my_source;
+        clear();
+        my_max_blocks = max_blocks;
+        if (source) {
+            attach(*source);
+        }
+    }
+
+    /**
+     * @cond
+     */
+public:
+    typedef typename Nclist<Index_, Position_>::Node Node;
+
+    struct Block {
+        Node nodes[compressed_block_size];
+        Position_ starts[compressed_block_size];
+        Position_ ends[compressed_block_size];
+    };
+
+    void attach(const CompressedNclist<Index_, Position_>& source) {
+        if (my_id != source.id) {
+            my_slots.clear();
+            my_block_slots.clear();
+            my_block_slots.resize(source.block_min_starts.size(), no_slot);
+            my_head = no_slot;
+            my_tail = no_slot;
+            my_last_block = no_slot;
+            my_id = source.id;
+        }
+        my_source = &source; // updating in case the same contents were copied to a different address.
+    }
+
+    const CompressedNclist<Index_, Position_>* source() const {
+        return my_source;
+    }
+
+    const Block& get(const std::size_t i) {
+        const std::size_t b = i / compressed_block_size;
+        if (b == my_last_block) { // the most recently used block is already at the front of the list.
+            return *(my_slots[my_last_slot].block);
+        }
+
+        std::size_t s = my_block_slots[b];
+        if (s == no_slot) {
+            if (my_max_blocks == 0 || my_slots.size() < my_max_blocks) {
+                s = my_slots.size();
+                my_slots.emplace_back();
+                my_slots.back().block.reset(new Block);
+            } else {
+                s = my_tail;
+                unlink(s);
+                my_block_slots[my_slots[s].owner] = no_slot;
+            }
+            my_slots[s].owner = b;
+            my_block_slots[b] = s;
+            decode(b, *(my_slots[s].block));
+            push_front(s);
+        } else {
+            unlink(s);
+            push_front(s);
+        }
+
+        my_last_block = b;
+        my_last_slot = s;
+        return *(my_slots[s].block);
+    }
+
+private:
+    void decode(const std::size_t b, Block& output) const {
+        const auto& source = *my_source;
+        const std::size_t block_start = b * compressed_block_size;
+        const std::size_t block_length = std::min(compressed_block_size, static_cast<std::size_t>(source.num_nodes) - block_start);
+        const unsigned char* ptr = source.data.data() + source.block_offsets[b];
+
+        Position_ last_start = 0;
+        Index_ last_id = 0, last_children_end = 0, last_duplicates_end = 0;
+        for (std::size_t i = 0; i < block_length; ++i) {
+            last_start = unzigzag_delta(decode_varint(ptr), last_start);
+            output.starts[i] = last_start;
+            output.ends[i] = unzigzag_delta(decode_varint(ptr), last_start);
+
+            auto& node = output.nodes[i];
+            last_id = unzigzag_delta(decode_varint(ptr), last_id);
+            node.id = last_id;
+
+            node.children_start = unzigzag_delta(decode_varint(ptr), last_children_end);
+            node.children_end = node.children_start + static_cast<Index_>(decode_varint(ptr));
+            last_children_end = node.children_end;
+
+            node.duplicates_start = unzigzag_delta(decode_varint(ptr), last_duplicates_end);
+            node.duplicates_end = node.duplicates_start + static_cast<Index_>(decode_varint(ptr));
+            last_duplicates_end = node.duplicates_end;
+        }
+    }
+
+    // Decompressed blocks are held in slots, which are arranged in a doubly-linked list from the most to least recently used.
+    void unlink(const std::size_t s) {
+        auto& slot = my_slots[s];
+        if (slot.previous == no_slot) {
+            my_head = slot.next;
+        } else {
+            my_slots[slot.previous].next = slot.next;
+        }
+        if (slot.next == no_slot) {
+            my_tail = slot.previous;
+        } else {
+            my_slots[slot.next].previous = slot.previous;
+        }
+    }
+
+    void push_front(const std::size_t s) {
+        auto& slot = my_slots[s];
+        slot.previous = no_slot;
+        slot.next = my_head;
+        if (my_head == no_slot) {
+            my_tail = s;
+        } else {
+            my_slots[my_head].previous = s;
+        }
+        my_head = s;
+    }
+
+private:
+    static constexpr std::size_t no_slot = static_cast<std::size_t>(-1);
+
+    struct Slot {
+        std::unique_ptr<Block> block;
+        std::size_t owner = 0;
+        std::size_t previous = no_slot;
+        std::size_t next = no_slot;
+    };
+
+    const CompressedNclist<Index_, Position_>* my_source = NULL;
+    std::uint64_t my_id = 0;
+    std::size_t my_max_blocks;
+
+    std::vector<Slot> my_slots;
+    std::vector<std::size_t> my_block_slots;
+    std::size_t my_head = no_slot, my_tail = no_slot;
+    std::size_t my_last_block = no_slot, my_last_slot = 0;
+    /**
+     * @endcond
+     */
+};
+
+/**
+ * @cond
+ */
+// Tag for the storage type of a compressed view.
+struct CompressedStorage {};
+
+template<typename Index_, typename Position_>
+class CompressedNodes {
+public:
+    CompressedNodes() = default;
+    CompressedNodes(CompressedNclistWorkspace<Index_, Position_>* workspace) : my_workspace(workspace) {}
+
+    // Returning a copy, as the block containing the node might be evicted from the workspace by subsequent accesses.
+    template<typename Offset_>
+    typename Nclist<Index_, Position_>::Node operator[](Offset_ i) const {
+        const std::size_t j = i;
+        return my_workspace->get(j).nodes[j % compressed_block_size];
+    }
+
+    CompressedNclistWorkspace<Index_, Position_>* workspace() const {
+        return my_workspace;
+    }
+
+private:
+    CompressedNclistWorkspace<Index_, Position_>* my_workspace = NULL;
+};
+
+template<typename Index_, typename Position_, bool end_>
+class CompressedPositions {
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef Position_ value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const Position_* pointer;
+    typedef Position_ reference;
+
+    CompressedPositions() = default;
+    CompressedPositions(CompressedNclistWorkspace<Index_, Position_>* workspace, std::ptrdiff_t position) : my_workspace(workspace), my_position(position) {}
+
+public:
+    template<typename Offset_>
+    Position_ operator[](Offset_ i) const {
+        return fetch(my_position + static_cast<std::ptrdiff_t>(i));
+    }
+
+    Position_ operator*() const {
+        return fetch(my_position);
+    }
+
+    template<typename Offset_>
+    CompressedPositions operator+(Offset_ i) const {
+        return CompressedPositions(my_workspace, my_position + static_cast<std::ptrdiff_t>(i));
+    }
+
+    template<typename Offset_>
+    CompressedPositions operator-(Offset_ i) const {
+        return CompressedPositions(my_workspace, my_position - static_cast<std::ptrdiff_t>(i));
+    }
+
+    difference_type operator-(const CompressedPositions& other) const {
+        return my_position - other.my_position;
+    }
+
+    CompressedPositions& operator+=(difference_type i) {
+        my_position += i;
+        return *this;
+    }
+
+    CompressedPositions& operator-=(difference_type i) {
+        my_position -= i;
+        return *this;
+    }
+
+    CompressedPositions& operator++() {
+        ++my_position;
+        return *this;
+    }
+
+    CompressedPositions operator++(int) {
+        auto copy = *this;
+        ++my_position;
+        return copy;
+    }
+
+    CompressedPositions& operator--() {
+        --my_position;
+        return *this;
+    }
+
+    CompressedPositions operator--(int) {
+        auto copy = *this;
+        --my_position;
+        return copy;
+    }
+
+    bool operator==(const CompressedPositions& other) const {
+        return my_position == other.my_position;
+    }
+
+    bool operator!=(const CompressedPositions& other) const {
+        return my_position != other.my_position;
+    }
+
+    bool operator<(const CompressedPositions& other) const {
+        return my_position < other.my_position;
+    }
+
+    CompressedPositions rebind(CompressedNclistWorkspace<Index_, Position_>* workspace) const {
+        return CompressedPositions(workspace, my_position);
+    }
+
+private:
+    CompressedNclistWorkspace<Index_, Position_>* my_workspace = NULL;
+    std::ptrdiff_t my_position = 0;
+
+    Position_ fetch(const std::ptrdiff_t i) const {
+        const std::size_t j = i;
+        const auto& block = my_workspace->get(j);
+        if constexpr(end_) {
+            return block.ends[j % compressed_block_size];
+        } else {
+            return block.starts[j % compressed_block_size];
+        }
+    }
+};
+
+template<typename Index_, typename Position_>
+struct ViewStorage<Index_, Position_, CompressedStorage> {
+    typedef CompressedNodes<Index_, Position_> Nodes;
+    typedef CompressedPositions<Index_, Position_, false> Starts;
+    typedef CompressedPositions<Index_, Position_, true> Ends;
+};
+
+// Each worker decompresses blocks into its own workspace, with the same limit as the workspace of the original view.
+template<typename Index_, typename Position_>
+class ViewWorkerState<Index_, Position_, CompressedStorage> {
+public:
+    const NclistView<Index_, Position_, CompressedStorage>& get(const NclistView<Index_, Position_, CompressedStorage>& original) {
+        const auto original_workspace = original.nodes.workspace();
+        my_workspace.set_max_blocks(original_workspace->get_max_blocks());
+        my_workspace.attach(*(original_workspace->source()));
+        my_view = original;
+        my_view.nodes = CompressedNodes<Index_, Position_>(&my_workspace);
+        my_view.starts = original.starts.rebind(&my_workspace);
+        my_view.ends = original.ends.rebind(&my_workspace);
+        return my_view;
+    }
+
+private:
+    CompressedNclistWorkspace<Index_, Position_> my_workspace;
+    NclistView<Index_, Position_, CompressedStorage> my_view;
+};
+/**
+ * @endcond
+ */
+
+/**
+ * Compress a nested containment list.
+ * Nodes are partitioned into blocks of `compressed_block_size` consecutive nodes.
+ * Within each block, start positions are delta-encoded, end positions are encoded as differences from their start positions,
+ * and the interval indices and child/duplicate offsets of each node are delta-encoded from the previous node;
+ * all values are then stored as variable-length integers.
+ * Each block also has a header that contains its smallest start position and largest end position, which is used to narrow the search in `make_view()`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Integer type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @return A `CompressedNclist` containing the same subject intervals as `subject`.
+ */
+template<typename Index_, typename Position_>
+CompressedNclist<Index_, Position_> compress(const Nclist<Index_, Position_>& subject) {
+    static_assert(std::is_integral<Position_>::value);
+
+    CompressedNclist<Index_, Position_> output;
+    output.id = next_compressed_id();
+    output.root_children = subject.root_children;
+    output.num_nodes = subject.nodes.size();
+    output.duplicates = subject.duplicates;
+
+    const std::size_t num_nodes = subject.nodes.size();
+    const std::size_t num_blocks = (num_nodes + compressed_block_size - 1) / compressed_block_size;
+    output.block_min_starts.reserve(num_blocks);
+    output.block_max_ends.reserve(num_blocks);
+    output.block_offsets.reserve(num_blocks + 1);
+    output.block_offsets.push_back(0);
+
+    for (std::size_t block_start = 0; block_start < num_nodes; block_start += compressed_block_size) {
+        const std::size_t block_end = std::min(num_nodes, block_start + compressed_block_size);
+        Position_ min_start = subject.starts[block_start], max_end = subject.ends[block_start];
+        Position_ last_start = 0;
+        Index_ last_id = 0, last_children_end = 0, last_duplicates_end = 0;
+
+        for (std::size_t i = block_start; i < block_end; ++i) {
+            const auto curstart = subject.starts[i], curend = subject.ends[i];
+            min_start = std::min(min_start, curstart);
+            max_end = std::max(max_end, curend);
+            encode_varint(zigzag_delta(curstart, last_start), output.data);
+            encode_varint(zigzag_delta(curend, curstart), output.data);
+            last_start = curstart;
+
+            const auto& node = subject.nodes[i];
+            encode_varint(zigzag_delta(node.id, last_id), output.data);
+            last_id = node.id;
+            encode_varint(zigzag_delta(node.children_start, last_children_end), output.data);
+            encode_varint(static_cast<std::uint64_t>(node.children_end - node.children_start), output.data);
+            last_children_end = node.children_end;
+            encode_varint(zigzag_delta(node.duplicates_start, last_duplicates_end), output.data);
+            encode_varint(static_cast<std::uint64_t>(node.duplicates_end - node.duplicates_start), output.data);
+            last_duplicates_end = node.duplicates_end;
+        }
+
+        output.block_min_starts.push_back(min_start);
+        output.block_max_ends.push_back(max_end);
+        output.block_offsets.push_back(output.data.size());
+    }
+
+    output.data.shrink_to_fit();
+    return output;
+}
+
+/**
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Integer type for the start/end positions of each interval.
+ *
+ * @param subject A `CompressedNclist` of subject intervals, typically created by `compress()`.
+ * @return An `Nclist` containing the same subject intervals as `subject`.
+ */
+template<typename Index_, typename Position_>
+Nclist<Index_, Position_> decompress(const CompressedNclist<Index_, Position_>& subject) {
+    Nclist<Index_, Position_> output;
+    output.root_children = subject.root_children;
+    output.nodes.reserve(subject.num_nodes);
+    output.starts.reserve(subject.num_nodes);
+    output.ends.reserve(subject.num_nodes);
+    output.duplicates = subject.duplicates;
+
+    CompressedNclistWorkspace<Index_, Position_> workspace;
+    workspace.attach(subject);
+    for (std::size_t i = 0, num_nodes = subject.num_nodes; i < num_nodes; i += compressed_block_size) {
+        const auto& block = workspace.get(i);
+        const std::size_t block_length = std::min(compressed_block_size, num_nodes - i);
+        output.nodes.insert(output.nodes.end(), block.nodes, block.nodes + block_length);
+        output.starts.insert(output.starts.end(), block.starts, block.starts + block_length);
+        output.ends.insert(output.ends.end(), block.ends, block.ends + block_length);
+    }
+
+    return output;
+}
+
+/**
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Integer type for the start/end positions of each interval.
+ *
+ * @param subject A `CompressedNclist` of subject intervals, typically created by `compress()`.
+ * @return Number of bytes used to store the nodes and positions in `subject`, including the block headers.
+ * This can be compared to the memory usage of the original `Nclist` to compute the compression ratio.
+ */
+template<typename Index_, typename Position_>
+std::size_t compressed_size(const CompressedNclist<Index_, Position_>& subject) {
+    return subject.data.size() +
+        subject.block_offsets.size() * sizeof(std::size_t) +
+        (subject.block_min_starts.size() + subject.block_max_ends.size()) * sizeof(Position_);
+}
+
+/**
+ * Create a view of all subject intervals in a `CompressedNclist`.
+ * Blocks are decompressed into `workspace` on demand when the view is searched by any query function, e.g., `overlaps_any()`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Integer type for the start/end positions of each interval.
+ *
+ * @param subject A `CompressedNclist` of subject intervals, typically created by `compress()`.
+ * @param workspace Workspace for the decompressed blocks.
+ * This should have a longer lifetime than the view.
+ *
+ * @return View of all subject intervals in `subject`.
+ */
+template<typename Index_, typename Position_>
+NclistView<Index_, Position_, CompressedStorage> make_view(const CompressedNclist<Index_, Position_>& subject, CompressedNclistWorkspace<Index_, Position_>& workspace) {
+    workspace.attach(subject);
+    NclistView<Index_, Position_, CompressedStorage> output;
+    output.root_start = 0;
+    output.root_end = subject.root_children;
+    output.nodes = CompressedNodes<Index_, Position_>(&workspace);
+    output.starts = CompressedPositions<Index_, Position_, false>(&workspace, 0);
+    output.ends = CompressedPositions<Index_, Position_, true>(&workspace, 0);
+    output.duplicates = subject.duplicates.data();
+    return output;
+}
+
+/**
+ * Create a view of the root intervals in a `CompressedNclist` that might overlap a coordinate window.
+ * This is similar to the windowed `make_view()` for an `Nclist`, except that the root intervals are chosen using the block headers.
+ * As such, the view may contain some extra root intervals that do not overlap the window, but only a few blocks need to be decompressed to search its roots.
+ * Typically, the window is set to the query interval (extended by any `max_gap`) so that a search only decompresses the blocks that are needed for that query.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Integer type for the start/end positions of each interval.
+ *
+ * @param subject A `CompressedNclist` of subject intervals, typically created by `compress()`.
+ * @param workspace Workspace for the decompressed blocks.
+ * This should have a longer lifetime than the view.
+ * @param window_start Start of the window.
+ * @param window_end Non-inclusive end of the window.
+ *
+ * @return View of a subset of root intervals in `subject`, containing all root intervals where `subject_starts[i] < window_end` and `window_start < subject_ends[i]`.
+ */
+template<typename Index_, typename Position_>
+NclistView<Index_, Position_, CompressedStorage> make_view(
+    const CompressedNclist<Index_, Position_>& subject,
+    CompressedNclistWorkspace<Index_, Position_>& workspace,
+    const Position_ window_start,
+    const Position_ window_end)
+{
+    auto output = make_view(subject, workspace);
+
+    // Root intervals are sorted by both start and end positions, so the headers of blocks containing only root nodes are also sorted.
+    // The last block containing root nodes might also contain non-root nodes, but the largest end position is still the end of the last root interval,
+    // as all non-root nodes are contained within a root interval.
+    const std::size_t num_roots = subject.root_children;
+    const std::size_t num_root_blocks = (num_roots + compressed_block_size - 1) / compressed_block_size;
+    const auto ebegin = subject.block_max_ends.begin();
+    const std::size_t first_block = std::upper_bound(ebegin, ebegin + num_root_blocks, window_start) - ebegin;
+
+    // The smallest start position of the last root block might be from a non-root node, so we only search the blocks that contain only root nodes.
+    const std::size_t num_full_blocks = num_roots / compressed_block_size;
+    const auto sbegin = subject.block_min_starts.begin();
+    const std::size_t last_block = std::lower_bound(sbegin + std::min(first_block, num_full_blocks), sbegin + num_full_blocks, window_end) - sbegin;
+
+    const std::size_t root_start = std::min(num_roots, first_block * compressed_block_size);
+    output.root_start = root_start;
+    if (last_block < num_full_blocks) {
+        output.root_end = std::max(root_start, last_block * compressed_block_size);
+    }
+    return output;
+}
+
+}
+
+#endif
@@ -0,0 +1,500 @@
+#ifndef NCLIST_COUNT_READS_HPP
+#define NCLIST_COUNT_READS_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+
+#include "build.hpp"
+#include "overlaps_any.hpp"
+#include "parallelize.hpp"
+#include "histogram.hpp"
+
+/**
+ * @file count_reads.hpp
+ * @brief Assign reads to features and count the number of reads per feature.
+ */
+
+namespace nclist {
+
+/**
+ * Policy for reads that overlap multiple features in `count_reads()`.
+ *
+ * - `UNIQUE`: only reads that overlap exactly one feature are counted.
+ *   Reads that overlap multiple features are considered to be ambiguous and are not counted.
+ * - `ALL`: each read adds a count of 1 to every feature that it overlaps.
+ * - `FRACTIONAL`: each read adds a count of `1/n` to every feature that it overlaps, where `n` is the number of overlapped features.
+ */
+enum class MultiFeaturePolicy : char { UNIQUE, ALL, FRACTIONAL };
+
+/**
+ * @brief Details of a slow read in `count_reads()`.
+ */
+struct SlowRead {
+    /**
+     * Index of the read in the batch.
+     */
+    std::size_t index = 0;
+
+    /**
+     * Number of blocks in the read.
+     */
+    std::size_t num_blocks = 0;
+
+    /**
+     * Number of features to which the read was assigned.
+     */
+    std::size_t num_hits = 0;
+
+    /**
+     * Time spent assigning this read, in nanoseconds.
+     */
+    std::uint64_t nanoseconds = 0;
+
+    /**
+     * Number of nodes visited by the traversals for all blocks of this read, see `OverlapsAnyWorkspace::num_visited`.
+     * This is only reported if the `NCLIST_COUNT_TRAVERSAL` macro is defined, otherwise it is always zero.
+     */
+    std::size_t num_visited = 0;
+
+    /**
+     * Number of binary searches performed by the traversals for all blocks of this read, see `OverlapsAnyWorkspace::num_searches`.
+     * This is only reported if the `NCLIST_COUNT_TRAVERSAL` macro is defined, otherwise it is always zero.
+     */
+    std::size_t num_searches = 0;
+};
+
+/**
+ * @brief Latency profile for `count_reads()`.
+ *
+ * This records the time spent assigning each read in `count_reads()` when it is supplied via `CountReadsParameters::profile`.
+ * Results are accumulated across calls to `count_reads()` with the same profile, until `clear()` is called.
+ */
+struct CountReadsProfile {
+    /**
+     * Maximum number of slow reads to retain in `slowest`.
+     */
+    std::size_t num_slowest = 10;
+
+    /**
+     * Histogram of per-read latencies in nanoseconds.
+     */
+    LatencyHistogram latencies;
+
+    /**
+     * Details of the slowest reads, sorted by decreasing latency.
+     * This contains no more than `num_slowest` entries.
+     */
+    std::vector<SlowRead> slowest;
+
+    /**
+     * Remove all recorded latencies and slow reads.
+     */
+    void clear() {
+        latencies.clear();
+        slowest.clear();
+    }
+};
+
+/**
+ * @brief Parameters for `assign_read()` and `count_reads()`.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ */
+template<typename Position_>
+struct CountReadsParameters {
+    /**
+     * Minimum overlap between a read and a feature.
+     * This is defined as the number of positions in the read that are covered by any of the feature's subject intervals,
+     * i.e., the length of the union of the overlapping subintervals across all blocks of the read and all subject intervals of the feature.
+     * Positions covered by multiple subject intervals (e.g., duplicate or overlapping exons) or by multiple blocks (e.g., overlapping mates) are only counted once.
+     * A read is only assigned to a feature if this length is greater than or equal to `min_overlap`.
+     * If zero, a read is assigned to any feature that it overlaps.
+     */
+    Position_ min_overlap = 0;
+
+    /**
+     * Policy for reads that overlap multiple features.
+     * Only used in `count_reads()`.
+     */
+    MultiFeaturePolicy policy = MultiFeaturePolicy::UNIQUE;
+
+    /**
+     * Number of threads to use.
+     * Only used in `count_reads()`.
+     * The parallelization scheme can be modified by defining `NCLIST_CUSTOM_PARALLEL`, see `parallelize()` for details.
+     */
+    int num_threads = 1;
+
+    /**
+     * Pointer to a profile in which to record the time spent assigning each read.
+     * If `NULL`, no timing is performed.
+     * Otherwise, each read is timed and its latency is added to the profile, along with the details of the slowest reads.
+     * Each thread records its latencies separately, and all results are combined into the profile at the end of `count_reads()`.
+     * Only used in `count_reads()`.
+     */
+    CountReadsProfile* profile = NULL;
+};
+
+/**
+ * @brief Mapping of subject intervals to features.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ *
+ * Instances of a `FeatureMap` are usually created by `build_feature_map()`.
+ */
+template<typename Index_>
+struct FeatureMap {
+/**
+ * @cond
+ */
+    // Feature index for each subject interval, or empty if each subject interval is its own feature.
+    std::vector<Index_> features;
+    Index_ num_features = 0;
+
+    // Node in `Nclist::nodes` for each subject interval, for retrieving its coordinates from the `Nclist`.
+    std::vector<Index_> nodes;
+/**
+ * @endcond
+ */
+};
+
+/**
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param num_subjects Number of subject intervals used to build `subject`.
+ * @param[in] features Pointer to an array of length `num_subjects`, containing the feature index for each subject interval.
+ * All values should lie in `[0, num_features)`.
+ * Each feature may consist of multiple subject intervals, e.g., exons of the same gene.
+ * Alternatively, this may be `NULL`, in which case each subject interval is treated as a separate feature.
+ * @param num_features Number of features.
+ * Ignored if `features = NULL`.
+ *
+ * @return Mapping of subject intervals to features.
+ */
+template<typename Index_, typename Position_>
+FeatureMap<Index_> build_feature_map(const Nclist<Index_, Position_>& subject, const Index_ num_subjects, const Index_* features, const Index_ num_features) {
+    FeatureMap<Index_> output;
+    if (features == NULL) {
+        output.num_features = num_subjects;
+    } else {
+        output.features.insert(output.features.end(), features, features + num_subjects);
+        output.num_features = num_features;
+    }
+
+    safe_resize(output.nodes, num_subjects);
+    const Index_ num_nodes = subject.nodes.size();
+    for (Index_ n = 0; n < num_nodes; ++n) {
+        const auto& current_node = subject.nodes[n];
+        output.nodes[current_node.id] = n;
+        for (auto d = current_node.duplicates_start; d < current_node.duplicates_end; ++d) {
+            output.nodes[subject.duplicates[d]] = n;
+        }
+    }
+
+    return output;
+}
+
+/**
+ * @brief Workspace for `assign_read()`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * This holds intermediate data structures that can be re-used across multiple calls to `assign_read()` to avoid reallocations.
+ */
+template<typename Index_, typename Position_>
+struct AssignReadWorkspace {
+    /**
+     * @cond
+     */
+    OverlapsAnyWorkspace<Index_> any;
+    std::vector<Index_> matches;
+
+    // Same epoch-based marking as in OverlapsGroupedWorkspace.
+    std::vector<std::uint32_t> stamps;
+    std::uint32_t epoch = 0;
+
+    // Overlapping subintervals for each feature, used to compute the covered length when min_overlap > 0.
+    struct Piece {
+        Piece() = default;
+        Piece(Index_ feature, Position_ start, Position_ end) : feature(feature), start(start), end(end) {}
+        Index_ feature;
+        Position_ start, end;
+    };
+    std::vector<Piece> pieces;
+
+    void next_epoch(std::size_t num_features) {
+        if (stamps.size() != num_features) {
+            stamps.clear();
+            stamps.resize(num_features);
+            epoch = 0;
+        }
+        ++epoch;
+        if (epoch == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            epoch = 1;
+        }
+    }
+    /**
+     * @endcond
+     */
+};
+
+/**
+ * Assign a single read to features.
+ * Each read may consist of multiple blocks, e.g., exonic segments of a spliced alignment or both mates of a paired-end fragment.
+ * A read is assigned to a feature if any of its blocks overlaps any of the feature's subject intervals, as defined by `overlaps_any()` with default parameters.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param features Mapping of subject intervals to features, typically built with `build_feature_map()`.
+ * @param num_blocks Number of blocks in the read.
+ * @param[in] block_starts Pointer to an array of length `num_blocks`, containing the start of each block.
+ * @param[in] block_ends Pointer to an array of length `num_blocks`, containing the non-inclusive end of each block.
+ * @param params Parameters for assignment.
+ * @param workspace Workspace for intermediate data structures.
+ * This can be default-constructed and re-used across `assign_read()` calls.
+ * @param[out] hits On output, vector of unique indices of the features to which the read is assigned.
+ * Indices are reported in arbitrary order.
+ */
+template<typename Index_, typename Position_>
+void assign_read(
+    const Nclist<Index_, Position_>& subject,
+    const FeatureMap<Index_>& features,
+    const std::size_t num_blocks,
+    const Position_* block_starts,
+    const Position_* block_ends,
+    const CountReadsParameters<Position_>& params,
+    AssignReadWorkspace<Index_, Position_>& workspace,
+    std::vector<Index_>& hits)
+{
+    hits.clear();
+    OverlapsAnyParameters<Position_> any_params;
+
+    if (params.min_overlap == 0) {
+        workspace.next_epoch(features.num_features);
+        for (std::size_t b = 0; b < num_blocks; ++b) {
+            overlaps_any(subject, block_starts[b], block_ends[b], any_params, workspace.any, workspace.matches);
+            for (auto m : workspace.matches) {
+                const Index_ f = (features.features.empty() ? m : features.features[m]);
+                auto& stamp = workspace.stamps[f];
+                if (stamp != workspace.epoch) {
+                    stamp = workspace.epoch;
+                    hits.push_back(f);
+                }
+            }
+        }
+        return;
+    }
+
+    // Otherwise, we collect the overlapping subintervals for each feature and merge them,
+    // so that positions covered by multiple subject intervals or blocks are only counted once.
+    auto& pieces = workspace.pieces;
+    pieces.clear();
+    for (std::size_t b = 0; b < num_blocks; ++b) {
+        const auto bstart = block_starts[b];
+        const auto bend = block_ends[b];
+        overlaps_any(subject, bstart, bend, any_params, workspace.any, workspace.matches);
+        for (auto m : workspace.matches) {
+            const Index_ f = (features.features.empty() ? m : features.features[m]);
+            const auto node = features.nodes[m];
+            pieces.emplace_back(f, std::max(bstart, subject.starts[node]), std::min(bend, subject.ends[node]));
+        }
+    }
+
+    std::sort(pieces.begin(), pieces.end(), [](const auto& left, const auto& right) -> bool {
+        if (left.feature == right.feature) {
+            return left.start < right.start;
+        } else {
+            return left.feature < right.feature;
+        }
+    });
+
+    const auto num_pieces = pieces.size();
+    std::size_t p = 0;
+    while (p < num_pieces) {
+        const auto f = pieces[p].feature;
+        Position_ covered = 0;
+        auto run_start = pieces[p].start, run_end = pieces[p].end;
+        for (++p; p < num_pieces && pieces[p].feature == f; ++p) {
+            const auto& current = pieces[p];
+            if (current.start > run_end) {
+                covered += run_end - run_start;
+                run_start = current.start;
+                run_end = current.end;
+            } else if (current.end > run_end) {
+                run_end = current.end;
+            }
+        }
+        covered += run_end - run_start;
+        if (covered >= params.min_overlap) {
+            hits.push_back(f);
+        }
+    }
+}
+
+/**
+ * @brief Results of `count_reads()`.
+ */
+struct CountReadsResults {
+    /**
+     * Number of reads assigned to each feature.
+     * This may be fractional if `MultiFeaturePolicy::FRACTIONAL` is used.
+     */
+    std::vector<double> counts;
+
+    /**
+     * Number of reads that contributed to `counts`.
+     */
+    std::size_t assigned = 0;
+
+    /**
+     * Number of reads that were assigned to multiple features.
+     * These reads are not counted in `counts` or `assigned` if `MultiFeaturePolicy::UNIQUE` is used.
+     */
+    std::size_t ambiguous = 0;
+
+    /**
+     * Number of reads that were not assigned to any feature.
+     */
+    std::size_t no_features = 0;
+};
+
+/**
+ * Assign a batch of reads to features with `assign_read()`, and count the number of reads assigned to each feature.
+ * Each thread accumulates counts in its own array, and these are summed across threads at the end.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param features Mapping of subject intervals to features, typically built with `build_feature_map()`.
+ * @param num_reads Number of reads.
+ * @param[in] block_offsets Pointer to an array of length `num_reads + 1`.
+ * The blocks for read `r` are stored in `block_starts[block_offsets[r]]` to `block_starts[block_offsets[r + 1] - 1]`, and similarly for `block_ends`.
+ * @param[in] block_starts Pointer to an array containing the start of each block.
+ * @param[in] block_ends Pointer to an array containing the non-inclusive end of each block.
+ * @param params Parameters for assignment and counting.
+ *
+ * @return Per-feature counts and assignment statistics.
+ */
+template<typename Index_, typename Position_>
+CountReadsResults count_reads(
+    const Nclist<Index_, Position_>& subject,
+    const FeatureMap<Index_>& features,
+    const std::size_t num_reads,
+    const std::size_t* block_offsets,
+    const Position_* block_starts,
+    const Position_* block_ends,
+    const CountReadsParameters<Position_>& params)
+{
+    const int num_threads = std::max(params.num_threads, 1);
+    std::vector<CountReadsResults> thread_results(num_threads);
+
+    std::vector<LatencyHistogram> thread_latencies;
+    std::vector<SlowestEntries<SlowRead> > thread_slowest;
+    if (params.profile) {
+        thread_latencies.resize(num_threads);
+        thread_slowest.resize(num_threads, SlowestEntries<SlowRead>(params.profile->num_slowest));
+    }
+
+    parallelize(num_threads, num_reads, [&](int t, std::size_t start, std::size_t length) -> void {
+        auto& current = thread_results[t];
+        safe_resize(current.counts, features.num_features);
+        AssignReadWorkspace<Index_, Position_> workspace;
+        std::vector<Index_> hits;
+
+        for (std::size_t r = start, end = start + length; r < end; ++r) {
+            const auto offset = block_offsets[r];
+            const auto num_blocks = block_offsets[r + 1] - offset;
+            if (params.profile == NULL) {
+                assign_read(subject, features, num_blocks, block_starts + offset, block_ends + offset, params, workspace, hits);
+            } else {
+                const std::size_t last_visited = workspace.any.num_visited, last_searches = workspace.any.num_searches;
+                const auto begin = std::chrono::steady_clock::now();
+                assign_read(subject, features, num_blocks, block_starts + offset, block_ends + offset, params, workspace, hits);
+                const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+                const std::uint64_t nanoseconds = std::max<decltype(elapsed)>(elapsed, 0);
+                thread_latencies[t].add(nanoseconds);
+
+                auto& slowest = thread_slowest[t];
+                if (slowest.is_slow(nanoseconds)) {
+                    SlowRead details;
+                    details.index = r;
+                    details.num_blocks = num_blocks;
+                    details.num_hits = hits.size();
+                    details.nanoseconds = nanoseconds;
+                    details.num_visited = workspace.any.num_visited - last_visited;
+                    details.num_searches = workspace.any.num_searches - last_searches;
+                    slowest.add(std::move(details));
+                }
+            }
+
+            const auto num_hits = hits.size();
+            if (num_hits == 0) {
+                ++current.no_features;
+                continue;
+            }
+            if (num_hits > 1) {
+                ++current.ambiguous;
+            }
+
+            switch (params.policy) {
+                case MultiFeaturePolicy::UNIQUE:
+                    if (num_hits == 1) {
+                        current.counts[hits.front()] += 1;
+                        ++current.assigned;
+                    }
+                    break;
+                case MultiFeaturePolicy::ALL:
+                    for (auto h : hits) {
+                        current.counts[h] += 1;
+                    }
+                    ++current.assigned;
+                    break;
+                case MultiFeaturePolicy::FRACTIONAL:
+                    {
+                        const double frac = 1.0 / num_hits;
+                        for (auto h : hits) {
+                            current.counts[h] += frac;
+                        }
+                        ++current.assigned;
+                    }
+                    break;
+            }
+        }
+    });
+
+    // Reducing in a fixed order so that the results are deterministic for a given number of threads.
+    CountReadsResults output;
+    safe_resize(output.counts, features.num_features);
+    for (const auto& current : thread_results) {
+        if (!current.counts.empty()) {
+            for (Index_ f = 0; f < features.num_features; ++f) {
+                output.counts[f] += current.counts[f];
+            }
+        }
+        output.assigned += current.assigned;
+        output.ambiguous += current.ambiguous;
+        output.no_features += current.no_features;
+    }
+
+    if (params.profile) {
+        for (int t = 0; t < num_threads; ++t) {
+            params.profile->latencies.merge(thread_latencies[t]);
+            merge_slowest_entries(thread_slowest[t], params.profile->num_slowest, params.profile->slowest);
+        }
+    }
+
+    return output;
+}
+
+}
+
+#endif
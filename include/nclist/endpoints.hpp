@@ -0,0 +1,269 @@
+#ifndef NCLIST_ENDPOINTS_HPP
+#define NCLIST_ENDPOINTS_HPP
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cstddef>
+
+#include "build.hpp"
+#include "utils.hpp"
+#include "overlaps_start.hpp"
+#include "overlaps_end.hpp"
+
+/**
+ * @file endpoints.hpp
+ * @brief Globally sorted indexes of the start/end positions of subject intervals.
+ */
+
+namespace nclist {
+
+/**
+ * @brief Globally sorted start and end positions of subject intervals.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * The start positions in `Nclist::starts` are only sorted within each run of sibling nodes.
+ * In contrast, this index sorts the start (and separately, end) positions across all nodes,
+ * so that all subject intervals with an endpoint in a given range can be found with a single binary search.
+ * Instances of an `EndpointIndex` are usually created by `build_endpoint_index()`.
+ */
+template<typename Index_, typename Position_>
+struct EndpointIndex {
+/**
+ * @cond
+ */
+    // `start_nodes` contains indices of nodes in `Nclist::nodes`, sorted by their start positions.
+    // `starts` contains the sorted start positions for a more cache-friendly binary search.
+    // Duplicate intervals are not stored here as they have the same start position as their node.
+    std::vector<Position_> starts;
+    std::vector<Index_> start_nodes;
+
+    // Same for the end positions.
+    std::vector<Position_> ends;
+    std::vector<Index_> end_nodes;
+/**
+ * @endcond
+ */
+};
+
+/**
+ * @cond
+ */
+template<typename Index_, typename Position_>
+void fill_endpoint_index(const std::vector<Position_>& positions, std::vector<Position_>& sorted_positions, std::vector<Index_>& sorted_nodes) {
+    const Index_ num_nodes = positions.size();
+    sorted_nodes.resize(num_nodes);
+    std::iota(sorted_nodes.begin(), sorted_nodes.end(), static_cast<Index_>(0));
+    std::stable_sort(sorted_nodes.begin(), sorted_nodes.end(), [&](Index_ left, Index_ right) -> bool { return positions[left] < positions[right]; });
+    sorted_positions.reserve(num_nodes);
+    for (auto n : sorted_nodes) {
+        sorted_positions.push_back(positions[n]);
+    }
+}
+
+template<typename Index_, typename Position_>
+void report_endpoint_node(const Nclist<Index_, Position_>& subject, const Index_ node, std::vector<Index_>& matches) {
+    const auto& current_node = subject.nodes[node];
+    matches.push_back(current_node.id);
+    if (current_node.duplicates_start != current_node.duplicates_end) {
+        matches.insert(matches.end(), subject.duplicates.begin() + current_node.duplicates_start, subject.duplicates.begin() + current_node.duplicates_end);
+    }
+}
+/**
+ * @endcond
+ */
+
+/**
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @return Globally sorted endpoint index for all subject intervals in `subject`.
+ */
+template<typename Index_, typename Position_>
+EndpointIndex<Index_, Position_> build_endpoint_index(const Nclist<Index_, Position_>& subject) {
+    EndpointIndex<Index_, Position_> output;
+    fill_endpoint_index(subject.starts, output.starts, output.start_nodes);
+    fill_endpoint_index(subject.ends, output.ends, output.end_nodes);
+    return output;
+}
+
+/**
+ * Find subject intervals with start positions in a specified range.
+ * This requires a binary search and is proportional to the number of reported intervals.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param index Endpoint index for `subject`, typically built with `build_endpoint_index()`.
+ * @param range_start Start of the range.
+ * @param range_end Non-inclusive end of the range.
+ * @param[out] matches On output, vector of indices of subject intervals with start positions in `[range_start, range_end)`.
+ * Indices are reported in order of increasing start position, with ties in arbitrary order.
+ */
+template<typename Index_, typename Position_>
+void starts_in_range(
+    const Nclist<Index_, Position_>& subject,
+    const EndpointIndex<Index_, Position_>& index,
+    const Position_ range_start,
+    const Position_ range_end,
+    std::vector<Index_>& matches)
+{
+    matches.clear();
+    const auto sbegin = index.starts.begin();
+    const auto send = index.starts.end();
+    const Index_ first = std::lower_bound(sbegin, send, range_start) - sbegin;
+    const Index_ last = std::lower_bound(sbegin + first, send, range_end) - sbegin;
+    for (Index_ i = first; i < last; ++i) {
+        report_endpoint_node(subject, index.start_nodes[i], matches);
+    }
+}
+
+/**
+ * Find subject intervals with end positions in a specified range.
+ * This requires a binary search and is proportional to the number of reported intervals.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param index Endpoint index for `subject`, typically built with `build_endpoint_index()`.
+ * @param range_start Start of the range.
+ * @param range_end Non-inclusive end of the range.
+ * @param[out] matches On output, vector of indices of subject intervals with (non-inclusive) end positions in `[range_start, range_end)`.
+ * Indices are reported in order of increasing end position, with ties in arbitrary order.
+ */
+template<typename Index_, typename Position_>
+void ends_in_range(
+    const Nclist<Index_, Position_>& subject,
+    const EndpointIndex<Index_, Position_>& index,
+    const Position_ range_start,
+    const Position_ range_end,
+    std::vector<Index_>& matches)
+{
+    matches.clear();
+    const auto ebegin = index.ends.begin();
+    const auto eend = index.ends.end();
+    const Index_ first = std::lower_bound(ebegin, eend, range_start) - ebegin;
+    const Index_ last = std::lower_bound(ebegin + first, eend, range_end) - ebegin;
+    for (Index_ i = first; i < last; ++i) {
+        report_endpoint_node(subject, index.end_nodes[i], matches);
+    }
+}
+
+/**
+ * @cond
+ */
+template<typename Index_, typename Position_>
+void overlaps_endpoint_indexed(
+    const Nclist<Index_, Position_>& subject,
+    const std::vector<Position_>& positions,
+    const std::vector<Index_>& nodes,
+    const Position_ query_position,
+    const Position_ query_start,
+    const Position_ query_end,
+    const Position_ max_gap,
+    const Position_ min_overlap,
+    const bool quit_on_first,
+    std::vector<Index_>& matches)
+{
+    matches.clear();
+    if (min_overlap > 0) {
+        if (query_end - query_start < min_overlap) {
+            return;
+        }
+    }
+
+    // We don't compute 'query_position + max_gap' to avoid overflow, but rather check each position as we go.
+    const auto pbegin = positions.begin();
+    const Index_ num_nodes = positions.size();
+    Index_ i = std::lower_bound(pbegin, positions.end(), safe_subtract_gap(query_position, max_gap)) - pbegin;
+
+    for (; i < num_nodes; ++i) {
+        const auto current = positions[i];
+        if (current > query_position && current - query_position > max_gap) {
+            break;
+        }
+
+        const auto node = nodes[i];
+        if (min_overlap > 0) {
+            const auto common_end = std::min(subject.ends[node], query_end);
+            const auto common_start = std::max(subject.starts[node], query_start);
+            if (common_end <= common_start || common_end - common_start < min_overlap) {
+                continue;
+            }
+        }
+
+        if (quit_on_first) {
+            matches.push_back(subject.nodes[node].id);
+            return;
+        }
+        report_endpoint_node(subject, node, matches);
+    }
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Find subject intervals with the same start position as the query interval, using an endpoint index.
+ * This gives the same results as `overlaps_start()` without an endpoint index,
+ * but only requires a single binary search followed by a scan across the subject intervals with start positions within `OverlapsStartParameters::max_gap` of the query start.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param index Endpoint index for `subject`, typically built with `build_endpoint_index()`.
+ * @param query_start Start of the query interval.
+ * @param query_end Non-inclusive end of the query interval.
+ * @param params Parameters for the search.
+ * @param[out] matches On output, vector of subject interval indices that overlap with the query interval.
+ * Indices are reported in arbitrary order.
+ */
+template<typename Index_, typename Position_>
+void overlaps_start(
+    const Nclist<Index_, Position_>& subject,
+    const EndpointIndex<Index_, Position_>& index,
+    const Position_ query_start,
+    const Position_ query_end,
+    const OverlapsStartParameters<Position_>& params,
+    std::vector<Index_>& matches)
+{
+    overlaps_endpoint_indexed(subject, index.starts, index.start_nodes, query_start, query_start, query_end, params.max_gap, params.min_overlap, params.quit_on_first, matches);
+}
+
+/**
+ * Find subject intervals with the same end position as the query interval, using an endpoint index.
+ * This gives the same results as `overlaps_end()` without an endpoint index,
+ * but only requires a single binary search followed by a scan across the subject intervals with end positions within `OverlapsEndParameters::max_gap` of the query end.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param index Endpoint index for `subject`, typically built with `build_endpoint_index()`.
+ * @param query_start Start of the query interval.
+ * @param query_end Non-inclusive end of the query interval.
+ * @param params Parameters for the search.
+ * @param[out] matches On output, vector of subject interval indices that overlap with the query interval.
+ * Indices are reported in arbitrary order.
+ */
+template<typename Index_, typename Position_>
+void overlaps_end(
+    const Nclist<Index_, Position_>& subject,
+    const EndpointIndex<Index_, Position_>& index,
+    const Position_ query_start,
+    const Position_ query_end,
+    const OverlapsEndParameters<Position_>& params,
+    std::vector<Index_>& matches)
+{
+    overlaps_endpoint_indexed(subject, index.ends, index.end_nodes, query_end, query_start, query_end, params.max_gap, params.min_overlap, params.quit_on_first, matches);
+}
+
+}
+
+#endif
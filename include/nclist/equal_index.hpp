@@ -0,0 +1,137 @@
+#ifndef NCLIST_EQUAL_INDEX_HPP
+#define NCLIST_EQUAL_INDEX_HPP
+
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <functional>
+#include <cstddef>
+
+#include "build.hpp"
+#include "overlaps_equal.hpp"
+
+/**
+ * @file equal_index.hpp
+ * @brief Hash index for finding intervals with the same start and end positions.
+ */
+
+namespace nclist {
+
+/**
+ * @cond
+ */
+template<typename Position_>
+struct EqualIndexHasher {
+    std::size_t operator()(const std::pair<Position_, Position_>& key) const {
+        std::hash<Position_> hasher;
+        std::size_t seed = hasher(key.first);
+        seed ^= hasher(key.second) + static_cast<std::size_t>(0x9e3779b9) + (seed << 6) + (seed >> 2); // same as boost::hash_combine.
+        return seed;
+    }
+};
+/**
+ * @endcond
+ */
+
+/**
+ * @brief Hash index of the start/end positions of subject intervals.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * This maps each unique pair of start/end positions to its node in the `Nclist`,
+ * allowing `overlaps_equal()` to find exact matches in constant expected time.
+ * Instances of an `EqualIndex` are usually created by `build_equal_index()`.
+ */
+template<typename Index_, typename Position_>
+struct EqualIndex {
+/**
+ * @cond
+ */
+    // Maps each (start, end) pair to the index of the node in `Nclist::nodes`.
+    // Identical intervals are always stored in the same node (i.e., as duplicates), so each pair occurs at most once.
+    std::unordered_map<std::pair<Position_, Position_>, Index_, EqualIndexHasher<Position_> > nodes;
+/**
+ * @endcond
+ */
+};
+
+/**
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @return Hash index for all subject intervals in `subject`.
+ */
+template<typename Index_, typename Position_>
+EqualIndex<Index_, Position_> build_equal_index(const Nclist<Index_, Position_>& subject) {
+    EqualIndex<Index_, Position_> output;
+    const Index_ num_nodes = subject.nodes.size();
+    output.nodes.reserve(num_nodes);
+    for (Index_ n = 0; n < num_nodes; ++n) {
+        output.nodes.emplace(std::make_pair(subject.starts[n], subject.ends[n]), n);
+    }
+    return output;
+}
+
+/**
+ * Find subject intervals with the same start and end positions as the query interval, using a hash index.
+ * This gives the same results as `overlaps_equal()` without a hash index, but only requires a single hash lookup when `OverlapsEqualParameters::max_gap = 0`.
+ * Otherwise, if `OverlapsEqualParameters::max_gap > 0`, it falls back to the usual traversal of the `Nclist`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param index Hash index for `subject`, typically built with `build_equal_index()`.
+ * @param query_start Start of the query interval.
+ * @param query_end Non-inclusive end of the query interval.
+ * @param params Parameters for the search.
+ * @param workspace Workspace for intermediate data structures.
+ * This can be default-constructed and re-used across `overlaps_equal()` calls.
+ * @param[out] matches On output, vector of subject interval indices that overlap with the query interval.
+ * Indices are reported in arbitrary order.
+ */
+template<typename Index_, typename Position_>
+void overlaps_equal(
+    const Nclist<Index_, Position_>& subject,
+    const EqualIndex<Index_, Position_>& index,
+    const Position_ query_start,
+    const Position_ query_end,
+    const OverlapsEqualParameters<Position_>& params,
+    OverlapsEqualWorkspace<Index_>& workspace,
+    std::vector<Index_>& matches)
+{
+    if (params.max_gap > 0) {
+        overlaps_equal(subject, query_start, query_end, params, workspace, matches);
+        return;
+    }
+
+    matches.clear();
+
+    // For an exact match, the overlapping subinterval is the query itself.
+    // We also need to reject zero-length overlaps when min_overlap > 0, for consistency with the traversal.
+    if (params.min_overlap > 0) {
+        if (query_end <= query_start || query_end - query_start < params.min_overlap) {
+            return;
+        }
+    }
+
+    auto it = index.nodes.find(std::make_pair(query_start, query_end));
+    if (it == index.nodes.end()) {
+        return;
+    }
+
+    const auto& current_node = subject.nodes[it->second];
+    matches.push_back(current_node.id);
+    if (params.quit_on_first) {
+        return;
+    }
+    if (current_node.duplicates_start != current_node.duplicates_end) {
+        matches.insert(matches.end(), subject.duplicates.begin() + current_node.duplicates_start, subject.duplicates.begin() + current_node.duplicates_end);
+    }
+}
+
+}
+
+#endif
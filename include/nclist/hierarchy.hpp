@@ -0,0 +1,266 @@
+#ifndef NCLIST_HIERARCHY_HPP
+#define NCLIST_HIERARCHY_HPP
+
+#include <vector>
+#include <optional>
+#include <algorithm>
+
+#include "build.hpp"
+
+/**
+ * @file hierarchy.hpp
+ * @brief Navigate the containment hierarchy of subject intervals.
+ */
+
+namespace nclist {
+
+/**
+ * @brief Inverse map and parent links for an `Nclist`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ *
+ * This maps each subject interval to its node in the `Nclist`, and each node to its parent node.
+ * It allows the containment hierarchy to be navigated from any subject interval, e.g., to find the gene containing an exon or to collapse nested peaks.
+ * Instances of a `Hierarchy` are usually created by `build_hierarchy()`.
+ *
+ * The parent of each subject interval is another subject interval that contains it, i.e., the parent's start is no greater than the child's start and the parent's end is no less than the child's end.
+ * Note that the hierarchy is not unique when a subject interval is contained by multiple subject intervals that partially overlap each other.
+ * In such cases, only one of the containing intervals is reported as the parent, and the others are neither ancestors nor descendants.
+ * Users should call `overlaps_within()` to find all containing intervals.
+ *
+ * Identical subject intervals are stored in the same node, so they have the same parent, children, ancestors and descendants.
+ * They are not considered to be parents or children of each other.
+ */
+template<typename Index_>
+struct Hierarchy {
+/**
+ * @cond
+ */
+    // Index of the node in `Nclist::nodes` for each subject interval.
+    // This is set to `parents.size()` for subject intervals that are not in the `Nclist`, e.g., when building from a subset.
+    std::vector<Index_> nodes;
+
+    // Index of the parent node in `Nclist::nodes` for each node.
+    // This is set to `parents.size()` for children of the root node.
+    std::vector<Index_> parents;
+/**
+ * @endcond
+ */
+};
+
+/**
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param num_intervals Number of subject intervals that were used to build `subject`.
+ * If `subject` was built from a subset, this should be the total number of intervals in the `starts` and `ends` arrays.
+ *
+ * @return Hierarchy for all subject intervals in `subject`.
+ * This requires memory proportional to `num_intervals`.
+ */
+template<typename Index_, typename Position_>
+Hierarchy<Index_> build_hierarchy(const Nclist<Index_, Position_>& subject, const Index_ num_intervals) {
+    Hierarchy<Index_> output;
+    const Index_ num_nodes = subject.nodes.size();
+    safe_resize(output.nodes, num_intervals);
+    std::fill(output.nodes.begin(), output.nodes.end(), num_nodes);
+    output.parents.resize(num_nodes, num_nodes);
+
+    for (Index_ n = 0; n < num_nodes; ++n) {
+        const auto& current_node = subject.nodes[n];
+        output.nodes[current_node.id] = n;
+        for (auto d = current_node.duplicates_start; d < current_node.duplicates_end; ++d) {
+            output.nodes[subject.duplicates[d]] = n;
+        }
+        for (auto c = current_node.children_start; c < current_node.children_end; ++c) {
+            output.parents[c] = n;
+        }
+    }
+
+    return output;
+}
+
+/**
+ * @cond
+ */
+template<typename Index_, typename Position_>
+void add_node_ids(const Nclist<Index_, Position_>& subject, const Index_ node, std::vector<Index_>& output) {
+    const auto& current_node = subject.nodes[node];
+    output.push_back(current_node.id);
+    output.insert(output.end(), subject.duplicates.begin() + current_node.duplicates_start, subject.duplicates.begin() + current_node.duplicates_end);
+}
+/**
+ * @endcond
+ */
+
+/**
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param hierarchy Hierarchy for `subject`, typically built with `build_hierarchy()`.
+ * @param id Index of a subject interval, less than the `num_intervals` used in `build_hierarchy()`.
+ *
+ * @return Index of the parent of subject interval `id`.
+ * If the parent has duplicates, the index of any one of the duplicates may be returned.
+ * No value is returned if `id` has no parent or is not present in `subject`.
+ */
+template<typename Index_, typename Position_>
+std::optional<Index_> find_parent(const Nclist<Index_, Position_>& subject, const Hierarchy<Index_>& hierarchy, const Index_ id) {
+    const Index_ num_nodes = hierarchy.parents.size();
+    const auto node = hierarchy.nodes[id];
+    if (node == num_nodes) {
+        return std::nullopt;
+    }
+    const auto parent = hierarchy.parents[node];
+    if (parent == num_nodes) {
+        return std::nullopt;
+    }
+    return subject.nodes[parent].id;
+}
+
+/**
+ * Find the children of a subject interval in constant time per child.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param hierarchy Hierarchy for `subject`, typically built with `build_hierarchy()`.
+ * @param id Index of a subject interval, less than the `num_intervals` used in `build_hierarchy()`.
+ * @param[out] children On output, vector of subject interval indices for the children of `id`.
+ * Children are sorted by increasing start position, and duplicates of each child are reported immediately after that child.
+ * This is empty if `id` has no children or is not present in `subject`.
+ */
+template<typename Index_, typename Position_>
+void find_children(const Nclist<Index_, Position_>& subject, const Hierarchy<Index_>& hierarchy, const Index_ id, std::vector<Index_>& children) {
+    children.clear();
+    const Index_ num_nodes = hierarchy.parents.size();
+    const auto node = hierarchy.nodes[id];
+    if (node == num_nodes) {
+        return;
+    }
+    const auto& current_node = subject.nodes[node];
+    for (auto c = current_node.children_start; c < current_node.children_end; ++c) {
+        add_node_ids(subject, c, children);
+    }
+}
+
+/**
+ * Find the ancestors of a subject interval in time proportional to its depth in the hierarchy.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param hierarchy Hierarchy for `subject`, typically built with `build_hierarchy()`.
+ * @param id Index of a subject interval, less than the `num_intervals` used in `build_hierarchy()`.
+ * @param[out] ancestors On output, vector of subject interval indices for the ancestors of `id`.
+ * Ancestors are ordered from the parent of `id` to a child of the root node, i.e., from the innermost to the outermost containing interval.
+ * Duplicates of each ancestor are reported immediately after that ancestor.
+ * This is empty if `id` has no parent or is not present in `subject`.
+ */
+template<typename Index_, typename Position_>
+void find_ancestors(const Nclist<Index_, Position_>& subject, const Hierarchy<Index_>& hierarchy, const Index_ id, std::vector<Index_>& ancestors) {
+    ancestors.clear();
+    const Index_ num_nodes = hierarchy.parents.size();
+    auto node = hierarchy.nodes[id];
+    if (node == num_nodes) {
+        return;
+    }
+    while (1) {
+        node = hierarchy.parents[node];
+        if (node == num_nodes) {
+            break;
+        }
+        add_node_ids(subject, node, ancestors);
+    }
+}
+
+/**
+ * @brief Workspace for `find_descendants()`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ *
+ * This holds intermediate data structures that can be re-used across multiple calls to `find_descendants()`.
+ */
+template<typename Index_>
+struct FindDescendantsWorkspace {
+/**
+ * @cond
+ */
+    std::vector<Index_> stack;
+/**
+ * @endcond
+ */
+};
+
+/**
+ * Find the descendants of a subject interval in time proportional to the number of descendants.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param hierarchy Hierarchy for `subject`, typically built with `build_hierarchy()`.
+ * @param id Index of a subject interval, less than the `num_intervals` used in `build_hierarchy()`.
+ * @param workspace Workspace for intermediate data structures.
+ * This can be default-constructed and re-used across `find_descendants()` calls.
+ * @param[out] descendants On output, vector of subject interval indices for the descendants of `id`.
+ * Descendants are reported in depth-first order, i.e., each child is followed by its own descendants before the next child is reported.
+ * Duplicates of each descendant are reported immediately after that descendant.
+ * This is empty if `id` has no children or is not present in `subject`.
+ */
+template<typename Index_, typename Position_>
+void find_descendants(
+    const Nclist<Index_, Position_>& subject,
+    const Hierarchy<Index_>& hierarchy,
+    const Index_ id,
+    FindDescendantsWorkspace<Index_>& workspace,
+    std::vector<Index_>& descendants)
+{
+    descendants.clear();
+    const Index_ num_nodes = hierarchy.parents.size();
+    const auto node = hierarchy.nodes[id];
+    if (node == num_nodes) {
+        return;
+    }
+
+    // Children are pushed in reverse order so that they are popped in increasing order of their start positions.
+    auto& stack = workspace.stack;
+    stack.clear();
+    const auto push_children = [&](const Index_ n) -> void {
+        const auto& current_node = subject.nodes[n];
+        for (auto c = current_node.children_end; c > current_node.children_start; --c) {
+            stack.push_back(c - 1);
+        }
+    };
+
+    push_children(node);
+    while (!stack.empty()) {
+        const auto current = stack.back();
+        stack.pop_back();
+        add_node_ids(subject, current, descendants);
+        push_children(current);
+    }
+}
+
+/**
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param hierarchy Hierarchy for `subject`, typically built with `build_hierarchy()`.
+ * @param id Index of a subject interval, less than the `num_intervals` used in `build_hierarchy()`.
+ * @param[out] descendants On output, vector of subject interval indices for the descendants of `id`, see `find_descendants()` for details.
+ */
+template<typename Index_, typename Position_>
+void find_descendants(const Nclist<Index_, Position_>& subject, const Hierarchy<Index_>& hierarchy, const Index_ id, std::vector<Index_>& descendants) {
+    FindDescendantsWorkspace<Index_> workspace;
+    find_descendants(subject, hierarchy, id, workspace, descendants);
+}
+
+}
+
+#endif
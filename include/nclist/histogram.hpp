@@ -0,0 +1,233 @@
+#ifndef NCLIST_HISTOGRAM_HPP
+#define NCLIST_HISTOGRAM_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+
+/**
+ * @file histogram.hpp
+ * @brief Low-overhead histograms for latencies.
+ */
+
+namespace nclist {
+
+/**
+ * @brief Log-linear histogram of non-negative integer values.
+ *
+ * This is a simplified version of an HDR histogram, intended for recording the latencies of individual queries.
+ * Values below `2^sub_bucket_bits` are recorded exactly.
+ * Larger values are assigned to buckets where each power of two is split into `2^sub_bucket_bits` linear sub-buckets,
+ * so the relative error of any reported value is no greater than `2^-sub_bucket_bits` (about 3%).
+ * Recording a value only involves a few bit operations and an increment, so it is cheap enough to use for every query.
+ */
+class LatencyHistogram {
+public:
+    /**
+     * Number of bits used to define the sub-buckets within each power of two.
+     */
+    static constexpr int sub_bucket_bits = 5;
+
+    /**
+     * @param value Value to be recorded, typically a latency in nanoseconds.
+     */
+    void add(const std::uint64_t value) {
+        if (my_counts.empty()) {
+            my_counts.resize(num_buckets);
+        }
+        ++(my_counts[bucket(value)]);
+        if (my_total_count == 0) {
+            my_min = value;
+            my_max = value;
+        } else {
+            my_min = std::min(my_min, value);
+            my_max = std::max(my_max, value);
+        }
+        ++my_total_count;
+        my_sum += value;
+    }
+
+    /**
+     * Add all values from another histogram, e.g., to combine histograms from multiple threads.
+     * @param other Another histogram.
+     */
+    void merge(const LatencyHistogram& other) {
+        if (other.my_total_count == 0) {
+            return;
+        }
+        if (my_counts.empty()) {
+            my_counts.resize(num_buckets);
+        }
+        for (std::size_t b = 0; b < num_buckets; ++b) {
+            my_counts[b] += other.my_counts[b];
+        }
+        if (my_total_count == 0) {
+            my_min = other.my_min;
+            my_max = other.my_max;
+        } else {
+            my_min = std::min(my_min, other.my_min);
+            my_max = std::max(my_max, other.my_max);
+        }
+        my_total_count += other.my_total_count;
+        my_sum += other.my_sum;
+    }
+
+    /**
+     * Remove all recorded values.
+     */
+    void clear() {
+        std::fill(my_counts.begin(), my_counts.end(), 0);
+        my_total_count = 0;
+        my_sum = 0;
+        my_min = 0;
+        my_max = 0;
+    }
+
+public:
+    /**
+     * @return Number of recorded values.
+     */
+    std::uint64_t count() const {
+        return my_total_count;
+    }
+
+    /**
+     * @return Smallest recorded value, or zero if no values were recorded.
+     */
+    std::uint64_t min() const {
+        return my_min;
+    }
+
+    /**
+     * @return Largest recorded value, or zero if no values were recorded.
+     */
+    std::uint64_t max() const {
+        return my_max;
+    }
+
+    /**
+     * @return Mean of the recorded values, or zero if no values were recorded.
+     */
+    double mean() const {
+        if (my_total_count == 0) {
+            return 0;
+        }
+        return static_cast<double>(my_sum) / static_cast<double>(my_total_count);
+    }
+
+    /**
+     * @param quantile Quantile of interest, in `[0, 1]`.
+     * For example, a value of 0.99 will return the 99th percentile.
+     * @return Upper bound of the bucket containing the requested quantile, capped at the largest recorded value.
+     * This is zero if no values were recorded.
+     */
+    std::uint64_t quantile(const double quantile) const {
+        if (my_total_count == 0) {
+            return 0;
+        }
+
+        std::uint64_t rank = static_cast<std::uint64_t>(quantile * static_cast<double>(my_total_count) + 0.5);
+        rank = std::max<std::uint64_t>(1, std::min(rank, my_total_count));
+
+        std::uint64_t cumulative = 0;
+        for (std::size_t b = 0; b < num_buckets; ++b) {
+            cumulative += my_counts[b];
+            if (cumulative >= rank) {
+                return std::min(upper_bound(b), my_max);
+            }
+        }
+        return my_max; // should never be reached.
+    }
+
+    /**
+     * @cond
+     */
+private:
+    static constexpr std::uint64_t sub_bucket_count = static_cast<std::uint64_t>(1) << sub_bucket_bits;
+    static constexpr std::size_t num_buckets = (65 - sub_bucket_bits) * sub_bucket_count;
+
+    static std::size_t bucket(const std::uint64_t value) {
+        if (value < sub_bucket_count) {
+            return value;
+        }
+        // Shifting the value until only the 'sub_bucket_bits + 1' leading bits remain.
+        std::uint64_t mantissa = value;
+        std::size_t shift = 0;
+        while (mantissa >= 2 * sub_bucket_count) {
+            mantissa >>= 1;
+            ++shift;
+        }
+        return (shift + 1) * sub_bucket_count + (mantissa - sub_bucket_count);
+    }
+
+    static std::uint64_t upper_bound(const std::size_t b) {
+        if (b < sub_bucket_count) {
+            return b;
+        }
+        const std::size_t shift = b / sub_bucket_count - 1;
+        const std::uint64_t mantissa = b % sub_bucket_count + sub_bucket_count + 1;
+        if (mantissa > (std::numeric_limits<std::uint64_t>::max() >> shift)) {
+            return std::numeric_limits<std::uint64_t>::max();
+        }
+        return (mantissa << shift) - 1;
+    }
+
+    std::vector<std::uint64_t> my_counts;
+    std::uint64_t my_total_count = 0;
+    std::uint64_t my_sum = 0;
+    std::uint64_t my_min = 0;
+    std::uint64_t my_max = 0;
+    /**
+     * @endcond
+     */
+};
+
+/**
+ * @cond
+ */
+// Per-thread record of the slowest entries, to avoid contention between threads when profiling.
+// `Entry_` should have a `nanoseconds` member.
+template<class Entry_>
+struct SlowestEntries {
+    SlowestEntries(std::size_t num_slowest) : num_slowest(num_slowest) {}
+
+    std::size_t num_slowest;
+    std::vector<Entry_> entries; // min-heap on the latency, so that the fastest of the slow entries can be easily replaced.
+
+    static bool compare(const Entry_& left, const Entry_& right) {
+        return left.nanoseconds > right.nanoseconds;
+    }
+
+    bool is_slow(const std::uint64_t nanoseconds) const {
+        return entries.size() < num_slowest || (num_slowest && nanoseconds > entries.front().nanoseconds);
+    }
+
+    void add(Entry_ details) {
+        if (entries.size() == num_slowest) {
+            std::pop_heap(entries.begin(), entries.end(), compare);
+            entries.back() = std::move(details);
+        } else {
+            entries.push_back(std::move(details));
+        }
+        std::push_heap(entries.begin(), entries.end(), compare);
+    }
+};
+
+// Add the slowest entries from one thread to the combined entries, which are sorted by decreasing latency and truncated to `num_slowest`.
+template<class Entry_>
+void merge_slowest_entries(const SlowestEntries<Entry_>& current, const std::size_t num_slowest, std::vector<Entry_>& combined) {
+    combined.insert(combined.end(), current.entries.begin(), current.entries.end());
+    std::sort(combined.begin(), combined.end(), SlowestEntries<Entry_>::compare);
+    if (combined.size() > num_slowest) {
+        combined.resize(num_slowest);
+    }
+}
+/**
+ * @endcond
+ */
+
+}
+
+#endif
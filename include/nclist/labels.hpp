@@ -0,0 +1,187 @@
+#ifndef NCLIST_LABELS_HPP
+#define NCLIST_LABELS_HPP
+
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include "build.hpp"
+#include "view.hpp"
+#include "overlaps_any.hpp"
+
+/**
+ * @file labels.hpp
+ * @brief Find overlaps to subject intervals with specific labels.
+ */
+
+namespace nclist {
+
+/**
+ * Maximum number of distinct labels that can be stored in a `LabelSummaries` object.
+ */
+constexpr int max_labels = 64;
+
+/**
+ * @brief Per-node summaries of subject interval labels.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ *
+ * Each subject interval is assigned a categorical label in `[0, max_labels)`.
+ * For each node of the `Nclist`, we store a bitmask summarizing the labels of all subject intervals in that node's subtree,
+ * allowing `overlaps_any_labelled()` to skip entire subtrees that do not contain any of the requested labels.
+ *
+ * Instances of a `LabelSummaries` are usually created by `build_label_summaries()`.
+ */
+template<typename Index_>
+struct LabelSummaries {
+/**
+ * @cond
+ */
+    // Union of the label bits of each node, its duplicates and all of its descendents, i.e., `subtree[i]` corresponds to `Nclist::nodes[i]`.
+    std::vector<std::uint64_t> subtree;
+
+    // Label of each node's own subject interval, i.e., `nodes[i]` corresponds to `Nclist::nodes[i]`.
+    std::vector<unsigned char> nodes;
+
+    // Label of each duplicate subject interval, i.e., `duplicates[i]` corresponds to `Nclist::duplicates[i]`.
+    std::vector<unsigned char> duplicates;
+/**
+ * @endcond
+ */
+};
+
+/**
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam Label_ Integer type of the label.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param[in] labels Pointer to an array containing the label for each subject interval.
+ * This should be long enough to be addressable by any subject interval index in `subject`.
+ * All labels should lie in `[0, max_labels)`.
+ *
+ * @return Label summaries for all nodes of `subject`.
+ */
+template<typename Index_, typename Position_, typename Label_>
+LabelSummaries<Index_> build_label_summaries(const Nclist<Index_, Position_>& subject, const Label_* labels) {
+    const auto get_label = [&](const Index_ id) -> unsigned char {
+        const auto lab = labels[id];
+        if constexpr(std::is_signed<Label_>::value) {
+            if (lab < 0) {
+                throw std::runtime_error("labels should be non-negative");
+            }
+        }
+        if (lab >= static_cast<Label_>(max_labels)) {
+            throw std::runtime_error("labels should be less than 'nclist::max_labels'");
+        }
+        return lab;
+    };
+
+    LabelSummaries<Index_> output;
+    const auto num_nodes = subject.nodes.size();
+    output.nodes.resize(num_nodes);
+    output.subtree.resize(num_nodes);
+    output.duplicates.reserve(subject.duplicates.size());
+    for (const auto& d : subject.duplicates) {
+        output.duplicates.push_back(get_label(d));
+    }
+
+    // Children are always stored after their parents in `Nclist::nodes`,
+    // so a reverse iteration guarantees that all children have been processed before their parent.
+    for (decltype(subject.nodes.size()) i = num_nodes; i > 0; --i) {
+        const auto n = i - 1;
+        const auto& current_node = subject.nodes[n];
+        const auto self = get_label(current_node.id);
+        output.nodes[n] = self;
+
+        std::uint64_t mask = static_cast<std::uint64_t>(1) << self;
+        for (auto d = current_node.duplicates_start; d < current_node.duplicates_end; ++d) {
+            mask |= static_cast<std::uint64_t>(1) << output.duplicates[d];
+        }
+        for (auto c = current_node.children_start; c < current_node.children_end; ++c) {
+            mask |= output.subtree[c];
+        }
+        output.subtree[n] = mask;
+    }
+
+    return output;
+}
+
+/**
+ * Find subject intervals that exhibit any overlap with the query interval and have a label in the requested set.
+ * This is equivalent to calling `overlaps_any()` and filtering the `matches` on their labels,
+ * but is more efficient as subtrees without any of the requested labels are not traversed.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param summaries Label summaries for `subject`, typically built with `build_label_summaries()`.
+ * @param label_set Bitmask specifying the requested labels, i.e., label `l` is requested if the `l`-th bit is set.
+ * @param query_start Start of the query interval.
+ * @param query_end Non-inclusive end of the query interval.
+ * @param params Parameters for the search, see `overlaps_any()` for details.
+ * @param workspace Workspace for intermediate data structures.
+ * This can be default-constructed and re-used across `overlaps_any_labelled()` and `overlaps_any()` calls.
+ * @param[out] matches On output, vector of subject interval indices that overlap with the query interval and have a requested label.
+ * Indices are reported in arbitrary order.
+ */
+template<typename Index_, typename Position_>
+void overlaps_any_labelled(
+    const Nclist<Index_, Position_>& subject,
+    const LabelSummaries<Index_>& summaries,
+    const std::uint64_t label_set,
+    const Position_ query_start,
+    const Position_ query_end,
+    const OverlapsAnyParameters<Position_>& params,
+    OverlapsAnyWorkspace<Index_>& workspace,
+    std::vector<Index_>& matches)
+{
+    matches.clear();
+    if (label_set == 0) {
+        return;
+    }
+
+    const auto is_requested = [&](const unsigned char label) -> bool {
+        return (label_set >> label) & 1;
+    };
+
+    // Subtrees without any of the requested labels are pruned, as none of their subject intervals can be reported.
+    // Otherwise, we still traverse the children of a node even if its own subject interval (and its duplicates) do not have a requested label.
+    overlaps_any_nodes(
+        make_view(subject),
+        query_start,
+        query_end,
+        params,
+        workspace,
+        [&](const Index_ node) -> bool {
+            const auto& current_node = subject.nodes[node];
+            bool found = false;
+            if (is_requested(summaries.nodes[node])) {
+                matches.push_back(current_node.id);
+                if (params.quit_on_first) {
+                    return true;
+                }
+                found = true;
+            }
+            for (auto d = current_node.duplicates_start; d < current_node.duplicates_end; ++d) {
+                if (is_requested(summaries.duplicates[d])) {
+                    matches.push_back(subject.duplicates[d]);
+                    if (params.quit_on_first) {
+                        return true;
+                    }
+                    found = true;
+                }
+            }
+            return found;
+        },
+        [&](const Index_ node) -> bool {
+            return (summaries.subtree[node] & label_set) == 0;
+        }
+    );
+}
+
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef NCLIST_LOCKSTEP_HPP
+#define NCLIST_LOCKSTEP_HPP
+
+#include <cstddef>
+#include <algorithm>
+
+/**
+ * @file lockstep.hpp
+ * @brief Binary searches for many targets in lockstep.
+ */
+
+namespace nclist {
+
+/**
+ * @cond
+ */
+// Branchless binary search for a block of targets. Each step halves the remaining length for all targets at once,
+// so the loads for different targets are independent and can be issued in parallel.
+template<bool upper_, typename Index_, typename Position_>
+void lockstep_search_block(const Position_* values, const Index_ num_values, const std::size_t num_targets, const Position_* targets, Index_* output) {
+    constexpr std::size_t max_lanes = 16;
+    Index_ base[max_lanes];
+    std::fill_n(base, num_targets, 0);
+
+    const auto go_right = [&](const Position_ value, const Position_ target) -> bool {
+        if constexpr(upper_) {
+            return value <= target;
+        } else {
+            return value < target;
+        }
+    };
+
+    Index_ len = num_values;
+    while (len > 1) {
+        const Index_ half = len / 2;
+        for (std::size_t l = 0; l < num_targets; ++l) {
+            base[l] += go_right(values[base[l] + half], targets[l]) * half;
+        }
+        len -= half;
+    }
+
+    for (std::size_t l = 0; l < num_targets; ++l) {
+        output[l] = base[l] + go_right(values[base[l]], targets[l]);
+    }
+}
+
+template<bool upper_, typename Index_, typename Position_>
+void lockstep_search(const Position_* values, const Index_ num_values, const std::size_t num_targets, const Position_* targets, Index_* output) {
+    if (num_values == 0) {
+        std::fill_n(output, num_targets, 0);
+        return;
+    }
+
+    constexpr std::size_t lanes = 16;
+    for (std::size_t t = 0; t < num_targets; t += lanes) {
+        lockstep_search_block<upper_>(values, num_values, std::min(lanes, num_targets - t), targets + t, output + t);
+    }
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Equivalent to calling `std::lower_bound()` for each target on the same sorted array.
+ * Targets are processed in blocks that are searched in lockstep with a branchless binary search,
+ * which avoids branch mispredictions and allows the memory accesses for different targets to overlap.
+ *
+ * @tparam Index_ Integer type of the array index.
+ * @tparam Position_ Numeric type of the values in the array.
+ *
+ * @param[in] values Pointer to a sorted array of length `num_values`.
+ * @param num_values Number of values in the array.
+ * @param num_targets Number of targets.
+ * @param[in] targets Pointer to an array of length `num_targets`, containing the values to search for.
+ * @param[out] output Pointer to an array of length `num_targets`.
+ * On output, this contains the index of the first element of `values` that is not less than each target, or `num_values` if no such element exists.
+ */
+template<typename Index_, typename Position_>
+void lockstep_lower_bound(const Position_* values, const Index_ num_values, const std::size_t num_targets, const Position_* targets, Index_* output) {
+    lockstep_search<false>(values, num_values, num_targets, targets, output);
+}
+
+/**
+ * Equivalent to calling `std::upper_bound()` for each target on the same sorted array, see `lockstep_lower_bound()` for details.
+ *
+ * @tparam Index_ Integer type of the array index.
+ * @tparam Position_ Numeric type of the values in the array.
+ *
+ * @param[in] values Pointer to a sorted array of length `num_values`.
+ * @param num_values Number of values in the array.
+ * @param num_targets Number of targets.
+ * @param[in] targets Pointer to an array of length `num_targets`, containing the values to search for.
+ * @param[out] output Pointer to an array of length `num_targets`.
+ * On output, this contains the index of the first element of `values` that is greater than each target, or `num_values` if no such element exists.
+ */
+template<typename Index_, typename Position_>
+void lockstep_upper_bound(const Position_* values, const Index_ num_values, const std::size_t num_targets, const Position_* targets, Index_* output) {
+    lockstep_search<true>(values, num_values, num_targets, targets, output);
+}
+
+}
+
+#endif
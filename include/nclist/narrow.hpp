@@ -0,0 +1,207 @@
+#ifndef NCLIST_NARROW_HPP
+#define NCLIST_NARROW_HPP
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+
+#include "build.hpp"
+#include "view.hpp"
+
+/**
+ * @file narrow.hpp
+ * @brief Nested containment lists with narrowed position storage.
+ */
+
+namespace nclist {
+
+/**
+ * @brief Nested containment list with positions stored as offsets from a base position.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Integer type for the start/end positions of each interval.
+ * @tparam Stored_ Unsigned integer type for the stored offsets, typically smaller than `Position_`.
+ *
+ * Instances of a `NarrowNclist` are usually created by `build_narrow()`.
+ * They can be searched by creating a view with `make_view()` and passing it to any of the query functions, e.g., `overlaps_any()`.
+ */
+template<typename Index_, typename Position_, typename Stored_ = std::uint32_t>
+struct NarrowNclist {
+/**
+ * @cond
+ */
+    // All positions in `offsets` are relative to `base`, which is the smallest start position.
+    Position_ base = 0;
+    Nclist<Index_, Stored_> offsets;
+/**
+ * @endcond
+ */
+};
+
+/**
+ * @cond
+ */
+template<typename Stored_, typename Position_, class Array_>
+class NarrowedArray {
+public:
+    NarrowedArray(const Array_& array, Position_ base) : my_array(array), my_base(base) {}
+
+    template<typename Index_>
+    Stored_ operator[](Index_ i) const {
+        return static_cast<Stored_>(my_array[i] - my_base);
+    }
+
+private:
+    const Array_& my_array;
+    Position_ my_base;
+};
+
+template<typename Index_, typename Stored_, class StartArray_, class EndArray_>
+NarrowNclist<Index_, ArrayElement<StartArray_>, Stored_> build_narrow_internal(std::vector<Index_> of_interest, const StartArray_& starts, const EndArray_& ends) {
+    typedef ArrayElement<StartArray_> Position;
+    static_assert(std::is_same<Position, ArrayElement<EndArray_> >::value);
+    static_assert(std::is_integral<Position>::value);
+    static_assert(std::is_integral<Stored_>::value && std::is_unsigned<Stored_>::value);
+
+    NarrowNclist<Index_, Position, Stored_> output;
+    if (of_interest.empty()) {
+        return output;
+    }
+
+    Position lowest = starts[of_interest.front()], highest = ends[of_interest.front()];
+    for (auto i : of_interest) {
+        lowest = std::min(lowest, static_cast<Position>(starts[i]));
+        highest = std::max(highest, static_cast<Position>(ends[i]));
+    }
+
+    // Check that the span fits in the stored type. We also check for overflow in the subtraction itself, as it might exceed the positive range of a signed 'Position'.
+    typedef typename std::make_unsigned<Position>::type UnsignedPosition;
+    if constexpr(std::is_signed<Position>::value) {
+        if (lowest < 0 && highest > std::numeric_limits<Position>::max() + lowest) {
+            throw std::runtime_error("span of subject intervals is too large for the stored offset type");
+        }
+    }
+    if (static_cast<UnsignedPosition>(highest - lowest) > static_cast<UnsignedPosition>(std::numeric_limits<Stored_>::max())) {
+        throw std::runtime_error("span of subject intervals is too large for the stored offset type");
+    }
+
+    output.base = lowest;
+    output.offsets = build_internal(std::move(of_interest), NarrowedArray<Stored_, Position, StartArray_>(starts, lowest), NarrowedArray<Stored_, Position, EndArray_>(ends, lowest));
+    return output;
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Build a nested containment list where the start/end positions are stored as offsets from the smallest start position.
+ * This is useful when `Position_` is a large type (e.g., 64-bit integers for coordinates on a concatenated genome) but the span of the subject intervals is small enough for a narrower `Stored_` type.
+ * The narrower type reduces the memory usage of the position arrays and allows more positions to fit in each cache line during the binary searches.
+ * Query positions are not narrowed, and the search results are exactly the same as those for the `Nclist` from `build()`.
+ *
+ * @tparam Stored_ Unsigned integer type for the stored offsets.
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam StartArray_ Class with a `[` method that accepts an `Index_` and returns the start position of the associated interval, see `build_custom()` for details.
+ * @tparam EndArray_ Class with a `[` method that accepts an `Index_` and returns the end position of the associated interval, see `build_custom()` for details.
+ *
+ * @param num_subset Number of subject intervals in the subset to include in the `NarrowNclist`.
+ * @param[in] subset Pointer to an array of length equal to `num_subset`, containing the subset of subject intervals to include in the NCList.
+ * @param[in] starts Array-like object containing the start positions of all subject intervals.
+ * This should be addressable by any element in `[subset, subset + num_subset)`.
+ * @param[in] ends Array-like object containing the end positions of all subject intervals.
+ * This should be addressable by any element in `[subset, subset + num_subset)`.
+ *
+ * @return A `NarrowNclist` containing the specified subset of subject intervals.
+ * An error is thrown if the difference between the largest end position and the smallest start position cannot be represented by `Stored_`.
+ */
+template<typename Stored_ = std::uint32_t, typename Index_, class StartArray_, class EndArray_>
+NarrowNclist<Index_, ArrayElement<StartArray_>, Stored_> build_narrow_custom(Index_ num_subset, const Index_* subset, const StartArray_& starts, const EndArray_& ends) {
+    std::vector<Index_> of_interest(subset, subset + num_subset);
+    return build_narrow_internal<Index_, Stored_>(std::move(of_interest), starts, ends);
+}
+
+/**
+ * @tparam Stored_ Unsigned integer type for the stored offsets.
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam StartArray_ Class with a `[` method that accepts an `Index_` and returns the start position of the associated interval, see `build_custom()` for details.
+ * @tparam EndArray_ Class with a `[` method that accepts an `Index_` and returns the end position of the associated interval, see `build_custom()` for details.
+ *
+ * @param num_intervals Number of subject intervals to include in the NCList.
+ * @param[in] starts Array-like object containing the start positions of all subject intervals.
+ * This should be addressable by any element in `[0, num_intervals)`.
+ * @param[in] ends Array-like object containing the end positions of all subject intervals.
+ * This should be addressable by any element in `[0, num_intervals)`.
+ *
+ * @return A `NarrowNclist` containing all subject intervals, see `build_narrow_custom()` for details.
+ */
+template<typename Stored_ = std::uint32_t, typename Index_, class StartArray_, class EndArray_>
+NarrowNclist<Index_, ArrayElement<StartArray_>, Stored_> build_narrow_custom(Index_ num_intervals, const StartArray_& starts, const EndArray_& ends) {
+    std::vector<Index_> of_interest(num_intervals);
+    std::iota(of_interest.begin(), of_interest.end(), static_cast<Index_>(0));
+    return build_narrow_internal<Index_, Stored_>(std::move(of_interest), starts, ends);
+}
+
+/**
+ * @tparam Stored_ Unsigned integer type for the stored offsets.
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Integer type for the start/end positions of each interval.
+ *
+ * @param num_subset Number of subject intervals in the subset to include in the `NarrowNclist`.
+ * @param[in] subset Pointer to an array of length equal to `num_subset`, containing the subset of subject intervals to include in the NCList.
+ * @param[in] starts Pointer to an array containing the start positions of all subject intervals.
+ * This should be long enough to be addressable by any element in `[subset, subset + num_subset)`.
+ * @param[in] ends Pointer to an array containing the end positions of all subject intervals.
+ * This should be long enough to be addressable by any element in `[subset, subset + num_subset)`.
+ *
+ * @return A `NarrowNclist` containing the specified subset of subject intervals, see `build_narrow_custom()` for details.
+ */
+template<typename Stored_ = std::uint32_t, typename Index_, typename Position_>
+NarrowNclist<Index_, Position_, Stored_> build_narrow(Index_ num_subset, const Index_* subset, const Position_* starts, const Position_* ends) {
+    return build_narrow_custom<Stored_, Index_>(num_subset, subset, starts, ends);
+}
+
+/**
+ * @tparam Stored_ Unsigned integer type for the stored offsets.
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Integer type for the start/end positions of each interval.
+ *
+ * @param num_intervals Number of subject intervals to include in the NCList.
+ * @param[in] starts Pointer to an array of length `num_intervals`, containing the start positions of all subject intervals.
+ * @param[in] ends Pointer to an array of length `num_intervals`, containing the end positions of all subject intervals.
+ *
+ * @return A `NarrowNclist` containing all subject intervals, see `build_narrow_custom()` for details.
+ */
+template<typename Stored_ = std::uint32_t, typename Index_, typename Position_>
+NarrowNclist<Index_, Position_, Stored_> build_narrow(Index_ num_intervals, const Position_* starts, const Position_* ends) {
+    return build_narrow_custom<Stored_, Index_>(num_intervals, starts, ends);
+}
+
+/**
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Integer type for the start/end positions of each interval.
+ * @tparam Stored_ Unsigned integer type for the stored offsets.
+ *
+ * @param subject A `NarrowNclist` of subject intervals, typically built with `build_narrow()`.
+ * @return View of all subject intervals in `subject`.
+ * Positions are converted back to `Position_` on access, so the view can be used in any query function that accepts an `NclistView`.
+ */
+template<typename Index_, typename Position_, typename Stored_>
+NclistView<Index_, Position_, Stored_> make_view(const NarrowNclist<Index_, Position_, Stored_>& subject) {
+    NclistView<Index_, Position_, Stored_> output;
+    output.root_start = 0;
+    output.root_end = subject.offsets.root_children;
+    output.nodes = subject.offsets.nodes.data();
+    output.starts = OffsetPositions<Position_, Stored_>(subject.offsets.starts.data(), subject.base);
+    output.ends = OffsetPositions<Position_, Stored_>(subject.offsets.ends.data(), subject.base);
+    output.duplicates = subject.offsets.duplicates.data();
+    return output;
+}
+
+}
+
+#endif
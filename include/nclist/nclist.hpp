@@ -2,6 +2,11 @@
 #define NCLIST_HPP
 
 #include "build.hpp"
+#include "view.hpp"
+#include "narrow.hpp"
+#include "compressed.hpp"
+#include "transform.hpp"
+#include "static.hpp"
 #include "overlaps_any.hpp"
 #include "overlaps_end.hpp"
 #include "overlaps_equal.hpp"
@@ -9,6 +14,23 @@
 #include "overlaps_start.hpp"
 #include "overlaps_within.hpp"
 #include "nearest.hpp"
+#include "labels.hpp"
+#include "results.hpp"
+#include "sample_overlaps.hpp"
+#include "overlaps_grouped.hpp"
+#include "equal_index.hpp"
+#include "endpoints.hpp"
+#include "hierarchy.hpp"
+#include "nearest_self.hpp"
+#include "parallelize.hpp"
+#include "count_reads.hpp"
+#include "similarity.hpp"
+#include "permute.hpp"
+#include "classify.hpp"
+#include "lockstep.hpp"
+#include "histogram.hpp"
+#include "batch.hpp"
+#include "numa.hpp"
 
 /**
  * @file nclist.hpp
@@ -7,6 +7,7 @@
 #include <limits>
 
 #include "build.hpp"
+#include "view.hpp"
 #include "utils.hpp"
 
 /**
@@ -63,9 +64,9 @@ struct NearestParameters {
 /**
  * @cond
  */
-template<typename Index_, typename Position_>
+template<typename Index_, typename Position_, typename Stored_>
 void nearest_before(
-    const Nclist<Index_, Position_>& subject,
+    const NclistView<Index_, Position_, Stored_>& subject,
     const Index_ root_index,
     const Position_ end_position,
     const bool quit_on_first,
@@ -79,7 +80,7 @@ void nearest_before(
             return;
         }
         if (current_node.duplicates_start != current_node.duplicates_end) {
-            matches.insert(matches.end(), subject.duplicates.begin() + current_node.duplicates_start, subject.duplicates.begin() + current_node.duplicates_end);
+            matches.insert(matches.end(), subject.duplicates + current_node.duplicates_start, subject.duplicates + current_node.duplicates_end);
         }
         if (current_node.children_start == current_node.children_end) {
             return;
@@ -91,9 +92,9 @@ void nearest_before(
     }
 }
 
-template<typename Index_, typename Position_>
+template<typename Index_, typename Position_, typename Stored_>
 void nearest_after(
-    const Nclist<Index_, Position_>& subject,
+    const NclistView<Index_, Position_, Stored_>& subject,
     const Index_ root_index,
     const Position_ start_position,
     const bool quit_on_first,
@@ -107,7 +108,7 @@ void nearest_after(
             return;
         }
         if (current_node.duplicates_start != current_node.duplicates_end) {
-            matches.insert(matches.end(), subject.duplicates.begin() + current_node.duplicates_start, subject.duplicates.begin() + current_node.duplicates_end);
+            matches.insert(matches.end(), subject.duplicates + current_node.duplicates_start, subject.duplicates + current_node.duplicates_end);
         }
         if (current_node.children_start == current_node.children_end) {
             return;
@@ -119,9 +120,9 @@ void nearest_after(
     }
 }
 
-template<typename Index_, typename Position_>
+template<typename Index_, typename Position_, typename Stored_>
 Index_ nearest_overlaps(
-    const Nclist<Index_, Position_>& subject,
+    const NclistView<Index_, Position_, Stored_>& subject,
     const Position_ query_start,
     const Position_ query_end,
     const bool quit_on_first,
@@ -164,7 +165,7 @@ Index_ nearest_overlaps(
      */
 
     const auto find_first_child = [&](const Index_ children_start, const Index_ children_end) -> Index_ {
-        const auto ebegin = subject.ends.begin();
+        const auto ebegin = subject.ends;
         const auto estart = ebegin + children_start; 
         const auto eend = ebegin + children_end;
         return std::upper_bound(estart, eend, query_start) - ebegin;
@@ -178,11 +179,11 @@ Index_ nearest_overlaps(
         return subject_start >= query_end;
     };
 
-    Index_ root_child_at = 0;
-    const bool root_skip_search = can_skip_search(subject.starts[0]);
+    Index_ root_child_at = subject.root_start;
+    const bool root_skip_search = can_skip_search(subject.starts[subject.root_start]);
     if (!root_skip_search) {
-        root_child_at = find_first_child(0, subject.root_children);
-        if (adjacent_equals_overlap && root_child_at) {
+        root_child_at = find_first_child(subject.root_start, subject.root_end);
+        if (adjacent_equals_overlap && root_child_at > subject.root_start) {
             const Index_ previous_child = root_child_at - 1;
             if (query_start == subject.ends[previous_child]) { 
                 nearest_before(subject, previous_child, query_start, quit_on_first, matches);
@@ -199,7 +200,7 @@ Index_ nearest_overlaps(
         bool skip_search;
 
         if (workspace.history.empty()) {
-            if (root_child_at == subject.root_children) {
+            if (root_child_at == subject.root_end) {
                 break;
             } else {
                 const Position_ next_start = subject.starts[root_child_at];
@@ -244,7 +245,7 @@ Index_ nearest_overlaps(
             break;
         }
         if (current_node.duplicates_start != current_node.duplicates_end) {
-            matches.insert(matches.end(), subject.duplicates.begin() + current_node.duplicates_start, subject.duplicates.begin() + current_node.duplicates_end);
+            matches.insert(matches.end(), subject.duplicates + current_node.duplicates_start, subject.duplicates + current_node.duplicates_end);
         }
 
         if (current_node.children_start != current_node.children_end) {
@@ -274,19 +275,13 @@ Index_ nearest_overlaps(
  */
 
 /**
- * Find subject intervals that are nearest to the query interval. 
- * If any overlaps are present, all overlapping intervals are reported.
- * If no overlaps are present, the subject interval with the smallest gap to the query is reported.
- * A gap is defined as the distance between the query start and subject end (for queries after the subject) or the subject start and the query end (otherwise). 
- * If multiple subjects have the same gap, all ties are reported.
- *
- * This function is based on its counterpart of the same name in the [**IRanges** R/Bioconductor package](https://bioconductor.org/packages/IRanges).
- * Users should set `NearestParameters::adjacent_equals_overlap = true` to obtain the same results as the R package, 
+ * Overload of `nearest()` that only searches the subject intervals in an `NclistView`.
  *
  * @tparam Index_ Integer type of the subject interval index.
  * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam Stored_ Numeric type for the stored start/end positions of each interval, see `NclistView` for details.
  *
- * @param subject An `Nclist` of subject intervals, typically built with `build()`. 
+ * @param subject View of an `Nclist`, typically created with `make_view()`.
  * @param query_start Start of the query interval.
  * @param query_end Non-inclusive end of the query interval.
  * @param params Parameters for the search.
@@ -295,9 +290,9 @@ Index_ nearest_overlaps(
  * @param[out] matches On output, vector of indices of the nearest subject intervals to the query interval.
  * Indices are reported in arbitrary order.
  */
-template<typename Index_, typename Position_>
+template<typename Index_, typename Position_, typename Stored_>
 void nearest(
-    const Nclist<Index_, Position_>& subject,
+    const NclistView<Index_, Position_, Stored_>& subject,
     const Position_ query_start,
     const Position_ query_end,
     const NearestParameters<Position_>& params,
@@ -305,7 +300,7 @@ void nearest(
     std::vector<Index_>& matches)
 {
     matches.clear();
-    if (subject.root_children == 0) {
+    if (subject.root_start == subject.root_end) {
         return;
     }
 
@@ -352,10 +347,10 @@ void nearest(
      ****************************************/
 
     std::optional<Position_> to_previous, to_next; 
-    if (root_index) {
+    if (root_index > subject.root_start) {
         to_previous = query_start - subject.ends[root_index - 1];
     }
-    if (root_index < subject.root_children) {
+    if (root_index < subject.root_end) {
         to_next = subject.starts[root_index] - query_end; 
     }
 
@@ -374,6 +369,40 @@ void nearest(
     }
 }
 
+/**
+ * Find subject intervals that are nearest to the query interval. 
+ * If any overlaps are present, all overlapping intervals are reported.
+ * If no overlaps are present, the subject interval with the smallest gap to the query is reported.
+ * A gap is defined as the distance between the query start and subject end (for queries after the subject) or the subject start and the query end (otherwise). 
+ * If multiple subjects have the same gap, all ties are reported.
+ *
+ * This function is based on its counterpart of the same name in the [**IRanges** R/Bioconductor package](https://bioconductor.org/packages/IRanges).
+ * Users should set `NearestParameters::adjacent_equals_overlap = true` to obtain the same results as the R package, 
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`. 
+ * @param query_start Start of the query interval.
+ * @param query_end Non-inclusive end of the query interval.
+ * @param params Parameters for the search.
+ * @param workspace Workspace for intermediate data structures.
+ * This can be default-constructed and re-used across `nearest()` calls.
+ * @param[out] matches On output, vector of indices of the nearest subject intervals to the query interval.
+ * Indices are reported in arbitrary order.
+ */
+template<typename Index_, typename Position_>
+void nearest(
+    const Nclist<Index_, Position_>& subject,
+    const Position_ query_start,
+    const Position_ query_end,
+    const NearestParameters<Position_>& params,
+    NearestWorkspace<Index_>& workspace,
+    std::vector<Index_>& matches)
+{
+    nearest(make_view(subject), query_start, query_end, params, workspace, matches);
+}
+
 }
 
 #endif
@@ -0,0 +1,322 @@
+#ifndef NCLIST_NEAREST_SELF_HPP
+#define NCLIST_NEAREST_SELF_HPP
+
+#include <vector>
+#include <algorithm>
+#include <optional>
+#include <cstddef>
+
+#include "build.hpp"
+#include "view.hpp"
+#include "nearest.hpp"
+#include "endpoints.hpp"
+#include "hierarchy.hpp"
+#include "parallelize.hpp"
+
+/**
+ * @file nearest_self.hpp
+ * @brief Find the nearest neighbors of each subject interval within the same set.
+ */
+
+namespace nclist {
+
+/**
+ * @brief Parameters for `nearest_self()`.
+ * @tparam Position_ Numeric type of the start/end positions of each interval.
+ */
+template<typename Position_>
+struct NearestSelfParameters {
+    /**
+     * Whether to only report one arbitrarily chosen neighbor for each subject interval.
+     * If `false`, all tied neighbors are reported.
+     */
+    bool quit_on_first = false;
+
+    /**
+     * Whether to consider immediately-adjacent subject intervals to be equally "nearest" as an overlapping subject interval,
+     * see `NearestParameters::adjacent_equals_overlap` for details.
+     */
+    bool adjacent_equals_overlap = false;
+
+    /**
+     * Number of threads to use.
+     * The parallelization scheme can be modified by defining `NCLIST_CUSTOM_PARALLEL`, see `parallelize()` for details.
+     */
+    int num_threads = 1;
+};
+
+/**
+ * @cond
+ */
+template<typename Position_>
+bool nearest_self_is_near(const Position_ other_start, const Position_ other_end, const Position_ start, const Position_ end, const bool adjacent_equals_overlap) {
+    return (other_start < end && start < other_end) || (adjacent_equals_overlap && (other_end == start || other_start == end));
+}
+
+// Finds the neighbors of node 'n', storing them in 'current' and returning the distance.
+// 'current' may contain the indices of the subject intervals in 'n' itself, which should be removed by the caller for each interval.
+template<typename Index_, typename Position_>
+Position_ nearest_self_node(
+    const Nclist<Index_, Position_>& subject,
+    const EndpointIndex<Index_, Position_>& endpoints,
+    const std::vector<Index_>& parents,
+    const Index_ n,
+    const NearestSelfParameters<Position_>& params,
+    NearestWorkspace<Index_>& workspace,
+    std::vector<Index_>& current)
+{
+    current.clear();
+    const Index_ num_nodes = subject.nodes.size();
+    const auto& node = subject.nodes[n];
+    const Position_ start = subject.starts[n], end = subject.ends[n];
+    const bool has_duplicates = node.duplicates_start != node.duplicates_end;
+    const bool self_near = nearest_self_is_near(start, end, start, end, params.adjacent_equals_overlap);
+
+    const auto is_near = [&](const Index_ other) -> bool {
+        return nearest_self_is_near(subject.starts[other], subject.ends[other], start, end, params.adjacent_equals_overlap);
+    };
+
+    const Index_ parent = parents[n];
+    Index_ sibling_start = 0, sibling_end = subject.root_children;
+    if (parent != num_nodes) {
+        sibling_start = subject.nodes[parent].children_start;
+        sibling_end = subject.nodes[parent].children_end;
+    }
+    const bool has_children = node.children_start != node.children_end;
+
+    /****************************************
+     * If only one neighbor is required, we check the intervals that are adjacent to 'n' in the NCList before falling back to a full search.
+     * These are very likely to overlap 'n' if any overlaps exist, e.g., the parent always contains 'n' and the first child is always contained by 'n'.
+     * All candidates are explicitly checked so the choice of neighbor is always valid.
+     ****************************************/
+    if (params.quit_on_first) {
+        if (has_duplicates && self_near) {
+            current.push_back(node.id);
+            current.push_back(subject.duplicates[node.duplicates_start]);
+            return 0;
+        }
+
+        const auto check = [&](const Index_ other) -> bool {
+            if (is_near(other)) {
+                current.push_back(subject.nodes[other].id);
+                return true;
+            }
+            return false;
+        };
+
+        if (parent != num_nodes && check(parent)) {
+            return 0;
+        }
+        if (has_children) {
+            if (check(node.children_start) || check(node.children_end - 1)) {
+                return 0;
+            }
+        }
+        if ((n > sibling_start && check(n - 1)) || (n + 1 < sibling_end && check(n + 1))) {
+            return 0;
+        }
+    }
+
+    /****************************************
+     * For a root node without children, any other overlapping interval must be another root or a descendant of another root.
+     * A descendant can only overlap 'n' if its root does, and the start and end positions of the roots are strictly increasing,
+     * so the only candidates are the immediately preceding and following roots.
+     * If neither of these is near 'n' and 'n' has no duplicates that are near each other, there are no overlaps and we can skip the full search.
+     * This is often the case for sparse sets of intervals, e.g., peaks or genes, where most intervals are childless roots.
+     ****************************************/
+    const bool no_overlaps = parent == num_nodes &&
+        !has_children &&
+        !(has_duplicates && self_near) &&
+        !(n > 0 && is_near(n - 1)) &&
+        !(n + 1 < subject.root_children && is_near(n + 1));
+
+    if (!no_overlaps) {
+        // Otherwise, we search for all overlapping intervals, which includes 'n' itself if it can overlap with itself.
+        nearest_overlaps(make_view(subject), start, end, false, params.adjacent_equals_overlap, workspace, current);
+        if (current.size() > static_cast<std::size_t>(self_near)) {
+            if (params.quit_on_first && current.size() > 2) {
+                current.resize(2); // two distinct intervals are enough to guarantee a neighbor for each interval in 'n'.
+            }
+            return 0;
+        }
+        current.clear();
+    }
+
+    /****************************************
+     * If there are no overlaps, the nearest preceding interval has the largest end position that is no greater than 'start',
+     * and the nearest following interval has the smallest start position that is no less than 'end'.
+     * We find these with a binary search on the globally sorted endpoints, reporting all nodes with the same position as ties.
+     *
+     * The only complication is when 'n' is a zero-length interval that is immediately adjacent to itself.
+     * If 'n' has no duplicates and is the only node with that position, we skip to the next position as 'n' cannot be its own neighbor.
+     ****************************************/
+    const auto ebegin = endpoints.ends.begin();
+    std::size_t prev_hi = std::upper_bound(ebegin, endpoints.ends.end(), start) - ebegin, prev_lo = prev_hi;
+    std::optional<Position_> to_previous;
+    while (prev_hi > 0) {
+        prev_lo = std::lower_bound(ebegin, ebegin + prev_hi, endpoints.ends[prev_hi - 1]) - ebegin;
+        if (prev_hi - prev_lo == 1 && endpoints.end_nodes[prev_lo] == n && !has_duplicates) {
+            prev_hi = prev_lo;
+            continue;
+        }
+        to_previous = start - endpoints.ends[prev_lo];
+        break;
+    }
+
+    const auto sbegin = endpoints.starts.begin();
+    const auto send = endpoints.starts.end();
+    std::size_t next_lo = std::lower_bound(sbegin, send, end) - sbegin, next_hi = next_lo;
+    std::optional<Position_> to_next;
+    while (next_lo < endpoints.starts.size()) {
+        next_hi = std::upper_bound(sbegin + next_lo, send, endpoints.starts[next_lo]) - sbegin;
+        if (next_hi - next_lo == 1 && endpoints.start_nodes[next_lo] == n && !has_duplicates) {
+            next_lo = next_hi;
+            continue;
+        }
+        to_next = endpoints.starts[next_lo] - end;
+        break;
+    }
+
+    Position_ distance = 0;
+    const bool use_previous = to_previous.has_value() && (!to_next.has_value() || *to_previous <= *to_next);
+    if (use_previous) {
+        distance = *to_previous;
+        for (auto i = prev_lo; i < prev_hi; ++i) {
+            report_endpoint_node(subject, endpoints.end_nodes[i], current);
+        }
+    }
+    if (to_next.has_value() && (!to_previous.has_value() || *to_next <= *to_previous)) {
+        distance = *to_next;
+        for (auto i = next_lo; i < next_hi; ++i) {
+            const auto other = endpoints.start_nodes[i];
+            if (use_previous && other == n) {
+                continue; // 'n' can only be in both sets if it is zero-length, in which case it was already reported as a preceding interval.
+            }
+            report_endpoint_node(subject, other, current);
+        }
+    }
+
+    if (params.quit_on_first && current.size() > 2) {
+        current.resize(2);
+    }
+    return distance;
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Find the nearest neighbors of each subject interval among all other subject intervals in the same `Nclist`.
+ * For each subject interval `i`, this gives the same results as calling `nearest()` with `i` as the query on an `Nclist` that contains all subject intervals except for `i`.
+ * However, it is more efficient as identical subject intervals are only processed once,
+ * and the nearest non-overlapping intervals are found with a binary search on the globally sorted endpoints (see `build_endpoint_index()`).
+ * The search for overlapping intervals is also skipped for top-level intervals without children if the adjacent top-level intervals are not near.
+ * Otherwise, each subject interval still requires a search for overlaps, so the speed for heavily nested intervals is similar to a loop of `nearest()` calls.
+ *
+ * Identical subject intervals (i.e., duplicates) are always reported as neighbors of each other.
+ * Subject intervals that are nested within `i`, or that contain `i`, are also reported as neighbors as they overlap `i`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param num_intervals Number of subject intervals that were used to build `subject`.
+ * If `subject` was built from a subset, this should be the total number of intervals in the `starts` and `ends` arrays.
+ * @param params Parameters for the search.
+ * @param[out] offsets On output, vector of length `num_intervals + 1`.
+ * The neighbors of subject interval `i` are stored in `neighbors[offsets[i]]` to `neighbors[offsets[i + 1] - 1]`.
+ * No neighbors are reported for subject intervals that are not present in `subject`.
+ * @param[out] neighbors On output, vector of subject interval indices for the neighbors of each subject interval, see `offsets`.
+ * Indices for each subject interval are reported in arbitrary order.
+ * @param[out] distances On output, vector of length `num_intervals` containing the distance from each subject interval to its neighbors.
+ * This is zero for overlapping (or, if `NearestSelfParameters::adjacent_equals_overlap = true`, adjacent) neighbors, or if there are no neighbors.
+ * Otherwise, it is the gap between the subject interval and its neighbors, as defined in `nearest()`.
+ */
+template<typename Index_, typename Position_>
+void nearest_self(
+    const Nclist<Index_, Position_>& subject,
+    const Index_ num_intervals,
+    const NearestSelfParameters<Position_>& params,
+    std::vector<std::size_t>& offsets,
+    std::vector<Index_>& neighbors,
+    std::vector<Position_>& distances)
+{
+    const Index_ num_nodes = subject.nodes.size();
+    const auto hierarchy = build_hierarchy(subject, num_intervals);
+    const auto& node_of = hierarchy.nodes;
+
+    const auto endpoints = build_endpoint_index(subject);
+
+    // Each worker stores the neighbors for its nodes in its own buffer, which are then copied into the output for each subject interval.
+    const int num_workers = std::max(params.num_threads, 1);
+    std::vector<std::vector<Index_> > buffers(num_workers);
+    std::vector<int> owners(num_nodes);
+    std::vector<std::size_t> node_starts(num_nodes), node_counts(num_nodes);
+    std::vector<Position_> node_distances(num_nodes);
+
+    parallelize(num_workers, num_nodes, [&](int w, Index_ start, Index_ length) -> void {
+        NearestWorkspace<Index_> workspace;
+        std::vector<Index_> current;
+        auto& buffer = buffers[w];
+        for (Index_ n = start, end = start + length; n < end; ++n) {
+            node_distances[n] = nearest_self_node(subject, endpoints, hierarchy.parents, n, params, workspace, current);
+            owners[n] = w;
+            node_starts[n] = buffer.size();
+            node_counts[n] = current.size();
+            buffer.insert(buffer.end(), current.begin(), current.end());
+        }
+    });
+
+    // Each subject interval gets the neighbors of its node, minus itself.
+    const auto get_node_neighbors = [&](const Index_ node) -> const Index_* {
+        return buffers[owners[node]].data() + node_starts[node];
+    };
+
+    offsets.clear();
+    offsets.resize(static_cast<std::size_t>(num_intervals) + 1);
+    distances.clear();
+    distances.resize(num_intervals);
+    parallelize(num_workers, num_intervals, [&](int, Index_ start, Index_ length) -> void {
+        for (Index_ i = start, end = start + length; i < end; ++i) {
+            const auto node = node_of[i];
+            if (node == num_nodes) {
+                continue;
+            }
+            const auto candidates = get_node_neighbors(node);
+            const auto num_candidates = node_counts[node];
+            std::size_t count = num_candidates - (std::find(candidates, candidates + num_candidates, i) != candidates + num_candidates);
+            if (params.quit_on_first) {
+                count = std::min(count, static_cast<std::size_t>(1));
+            }
+            offsets[static_cast<std::size_t>(i) + 1] = count;
+            distances[i] = node_distances[node];
+        }
+    });
+
+    for (Index_ i = 0; i < num_intervals; ++i) {
+        offsets[static_cast<std::size_t>(i) + 1] += offsets[i];
+    }
+
+    neighbors.resize(offsets.back());
+    parallelize(num_workers, num_intervals, [&](int, Index_ start, Index_ length) -> void {
+        for (Index_ i = start, end = start + length; i < end; ++i) {
+            const auto node = node_of[i];
+            if (node == num_nodes) {
+                continue;
+            }
+            const auto candidates = get_node_neighbors(node);
+            auto output = neighbors.begin() + offsets[i];
+            const auto output_end = neighbors.begin() + offsets[static_cast<std::size_t>(i) + 1];
+            for (std::size_t c = 0, num_candidates = node_counts[node]; c < num_candidates && output != output_end; ++c) {
+                if (candidates[c] != i) {
+                    *output = candidates[c];
+                    ++output;
+                }
+            }
+        }
+    });
+}
+
+}
+
+#endif
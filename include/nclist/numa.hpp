@@ -0,0 +1,319 @@
+#ifndef NCLIST_NUMA_HPP
+#define NCLIST_NUMA_HPP
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <thread>
+#include <exception>
+#include <cstddef>
+#include <utility>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "build.hpp"
+#include "view.hpp"
+#include "batch.hpp"
+
+/**
+ * @file numa.hpp
+ * @brief Replicate an `Nclist` across NUMA nodes.
+ */
+
+namespace nclist {
+
+/**
+ * @brief CPUs on each NUMA node.
+ *
+ * Each entry of `node_cpus` corresponds to a NUMA node and contains the identities of the CPUs on that node.
+ * This is usually created by `detect_numa_topology()`, but can also be manually constructed, e.g., to only use a subset of nodes.
+ */
+struct NumaTopology {
+    /**
+     * CPUs for each NUMA node.
+     */
+    std::vector<std::vector<int> > node_cpus;
+};
+
+/**
+ * @cond
+ */
+// Parses a Linux CPU list, e.g., "0-15,32-47".
+// Malformed entries are ignored as we only use the topology as a performance hint.
+inline std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> output;
+    std::size_t pos = 0;
+    const std::size_t len = list.size();
+
+    const auto parse_number = [&](int& value) -> bool {
+        const std::size_t init = pos;
+        value = 0;
+        while (pos < len && list[pos] >= '0' && list[pos] <= '9') {
+            value = value * 10 + (list[pos] - '0');
+            ++pos;
+        }
+        return pos > init;
+    };
+
+    while (pos < len) {
+        int first, last;
+        if (parse_number(first)) {
+            last = first;
+            if (pos < len && list[pos] == '-') {
+                ++pos;
+                if (!parse_number(last)) {
+                    last = first - 1;
+                }
+            }
+            for (int c = first; c <= last; ++c) {
+                output.push_back(c);
+            }
+        }
+
+        // Skipping to the next entry.
+        while (pos < len && list[pos] != ',') {
+            ++pos;
+        }
+        ++pos;
+    }
+
+    return output;
+}
+
+inline bool read_first_line(const std::string& path, std::string& line) {
+    std::ifstream handle(path);
+    if (!handle) {
+        return false;
+    }
+    return static_cast<bool>(std::getline(handle, line));
+}
+
+// Binds the current thread to a set of CPUs, restoring the previous affinity on destruction.
+// This is necessary as the thread may belong to a user-supplied thread pool, see NCLIST_CUSTOM_PARALLEL.
+// Failures are silently ignored as binding is only a performance optimization.
+class NumaThreadBinding {
+public:
+    NumaThreadBinding(const std::vector<int>& cpus) {
+#ifdef __linux__
+        if (cpus.empty() || sched_getaffinity(0, sizeof(cpu_set_t), &my_previous) != 0) {
+            return;
+        }
+
+        cpu_set_t requested;
+        CPU_ZERO(&requested);
+        bool any = false;
+        for (auto c : cpus) {
+            if (c >= 0 && c < CPU_SETSIZE) {
+                CPU_SET(c, &requested);
+                any = true;
+            }
+        }
+
+        my_bound = any && sched_setaffinity(0, sizeof(cpu_set_t), &requested) == 0;
+#else
+        (void)cpus;
+#endif
+    }
+
+    ~NumaThreadBinding() {
+#ifdef __linux__
+        if (my_bound) {
+            sched_setaffinity(0, sizeof(cpu_set_t), &my_previous);
+        }
+#endif
+    }
+
+    NumaThreadBinding(const NumaThreadBinding&) = delete;
+    NumaThreadBinding& operator=(const NumaThreadBinding&) = delete;
+
+    bool bound() const {
+        return my_bound;
+    }
+
+private:
+    bool my_bound = false;
+#ifdef __linux__
+    cpu_set_t my_previous;
+#endif
+};
+/**
+ * @endcond
+ */
+
+/**
+ * Detect the NUMA topology of the current machine.
+ * On Linux, this is obtained from `/sys/devices/system/node`, ignoring any nodes without CPUs (e.g., memory-only nodes).
+ * On other platforms, or if the topology cannot be determined, a single node is reported with no CPUs.
+ *
+ * @return The NUMA topology, containing at least one node.
+ */
+inline NumaTopology detect_numa_topology() {
+    NumaTopology output;
+
+#ifdef __linux__
+    const std::string root = "/sys/devices/system/node/";
+    std::string online;
+    if (read_first_line(root + "online", online)) {
+        for (auto node : parse_cpu_list(online)) {
+            std::string cpulist;
+            if (!read_first_line(root + "node" + std::to_string(node) + "/cpulist", cpulist)) {
+                continue;
+            }
+            auto cpus = parse_cpu_list(cpulist);
+            if (!cpus.empty()) {
+                output.node_cpus.push_back(std::move(cpus));
+            }
+        }
+    }
+#endif
+
+    if (output.node_cpus.empty()) {
+        output.node_cpus.resize(1);
+    }
+    return output;
+}
+
+/**
+ * @brief `Nclist` replicated across NUMA nodes.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * On machines with multiple NUMA nodes, threads that search an `Nclist` allocated on a remote node pay extra latency for each memory access.
+ * This class creates a separate copy of the `Nclist` on each node, which can then be searched by `overlaps_batch()` with each worker thread using the copy on its local node.
+ * This is most useful for long-running query servers that perform many searches against the same subject intervals.
+ *
+ * Each replica is allocated by a thread that is bound to the CPUs of its node, so that the replica's memory is placed on that node by the operating system's first-touch policy.
+ * On machines with a single NUMA node, only the original `Nclist` is stored and no threads are bound, so there is no overhead compared to using the `Nclist` directly.
+ */
+template<typename Index_, typename Position_>
+class NumaReplicatedNclist {
+public:
+    /**
+     * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+     * This is copied to each node and then released, or moved into the replica if there is only one node.
+     * @param topology NUMA topology of the machine.
+     */
+    NumaReplicatedNclist(Nclist<Index_, Position_> subject, NumaTopology topology = detect_numa_topology()) : my_topology(std::move(topology)) {
+        const auto num_nodes = my_topology.node_cpus.size();
+        if (num_nodes <= 1) {
+            my_topology.node_cpus.resize(1);
+            my_replicas.push_back(std::move(subject));
+            return;
+        }
+
+        // Each replica is copied in a separate thread so that it is allocated on its own node.
+        // We don't use parallelize() as we need a dedicated thread for each node, regardless of NCLIST_CUSTOM_PARALLEL.
+        my_replicas.resize(num_nodes);
+        std::vector<std::thread> workers;
+        workers.reserve(num_nodes);
+        std::vector<std::exception_ptr> errors(num_nodes);
+
+        for (decltype(my_replicas.size()) n = 0; n < num_nodes; ++n) {
+            workers.emplace_back([&](decltype(my_replicas.size()) node) -> void {
+                try {
+                    NumaThreadBinding binding(my_topology.node_cpus[node]);
+                    my_replicas[node] = subject;
+                } catch (...) {
+                    errors[node] = std::current_exception();
+                }
+            }, n);
+        }
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (const auto& err : errors) {
+            if (err) {
+                std::rethrow_exception(err);
+            }
+        }
+    }
+
+public:
+    /**
+     * @return Number of NUMA nodes, i.e., the number of replicas.
+     */
+    std::size_t num_nodes() const {
+        return my_replicas.size();
+    }
+
+    /**
+     * @param node Index of the NUMA node, in `[0, num_nodes())`.
+     * @return The replica of the `Nclist` on node `node`.
+     */
+    const Nclist<Index_, Position_>& replica(const std::size_t node) const {
+        return my_replicas[node];
+    }
+
+    /**
+     * @param node Index of the NUMA node, in `[0, num_nodes())`.
+     * @return CPUs on node `node`.
+     * This may be empty if the topology could not be determined.
+     */
+    const std::vector<int>& cpus(const std::size_t node) const {
+        return my_topology.node_cpus[node];
+    }
+
+private:
+    NumaTopology my_topology;
+    std::vector<Nclist<Index_, Position_> > my_replicas;
+};
+
+/**
+ * Overload of `overlaps_batch()` that searches a `NumaReplicatedNclist`.
+ * Worker `w` is assigned to node `w % num_nodes()`, and is bound to the CPUs of that node while it searches the local replica.
+ * The previous CPU affinity of each worker thread is restored after the search, so this can be safely used with a custom thread pool (see `parallelize()`).
+ * If there is only one node, this is equivalent to calling `overlaps_batch()` on the original `Nclist`.
+ *
+ * For best performance, `OverlapsBatchParameters::num_threads` should be a multiple of the number of nodes.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject Subject intervals replicated across NUMA nodes.
+ * @param num_queries Number of query intervals.
+ * @param[in] query_starts Pointer to an array of length `num_queries`, containing the start of each query interval.
+ * @param[in] query_ends Pointer to an array of length `num_queries`, containing the non-inclusive end of each query interval.
+ * @param params Parameters for the search.
+ * @param[out] offsets On output, vector of length `num_queries + 1`.
+ * The matches for query `i` are stored in `matches[offsets[i]]` to `matches[offsets[i + 1] - 1]`.
+ * @param[out] matches On output, vector of subject interval indices for each query, see `offsets`.
+ */
+template<typename Index_, typename Position_>
+void overlaps_batch(
+    const NumaReplicatedNclist<Index_, Position_>& subject,
+    const std::size_t num_queries,
+    const Position_* query_starts,
+    const Position_* query_ends,
+    const OverlapsBatchParameters<Position_>& params,
+    std::vector<std::size_t>& offsets,
+    std::vector<Index_>& matches)
+{
+    const auto num_nodes = subject.num_nodes();
+    if (num_nodes == 1) {
+        overlaps_batch(subject.replica(0), num_queries, query_starts, query_ends, params, offsets, matches);
+        return;
+    }
+
+    overlaps_batch_internal<Index_, Position_>(
+        [&](int w, auto fun) -> void {
+            const auto node = static_cast<std::size_t>(w) % num_nodes;
+            NumaThreadBinding binding(subject.cpus(node));
+            fun(make_view(subject.replica(node)));
+        },
+        num_queries,
+        query_starts,
+        query_ends,
+        params,
+        NULL,
+        offsets,
+        matches
+    );
+}
+
+}
+
+#endif
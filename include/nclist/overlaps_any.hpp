@@ -5,8 +5,11 @@
 #include <algorithm>
 #include <optional>
 #include <limits>
+#include <cstddef>
 
 #include "build.hpp"
+#include "view.hpp"
+#include "results.hpp"
 #include "utils.hpp"
 
 /**
@@ -22,9 +25,25 @@ namespace nclist {
  * @tparam Index_ Integer type of the subject interval index.
  *
  * This holds intermediate data structures that can be re-used across multiple calls to `overlaps_any()` to avoid reallocations.
+ *
+ * If the `NCLIST_COUNT_TRAVERSAL` macro is defined before including any **nclist** header, the workspace also counts the work done by each traversal.
+ * This is useful for diagnosing slow queries, see also `SlowQuery`.
+ * Counting is disabled by default as it adds some overhead to every visited node.
  */
 template<typename Index_>
 struct OverlapsAnyWorkspace {
+    /**
+     * Number of nodes visited by all searches with this workspace.
+     * This is only updated if `NCLIST_COUNT_TRAVERSAL` is defined, otherwise it is always zero.
+     */
+    std::size_t num_visited = 0;
+
+    /**
+     * Number of binary searches on the children of a node (or on the root intervals) by all searches with this workspace.
+     * This is only updated if `NCLIST_COUNT_TRAVERSAL` is defined, otherwise it is always zero.
+     */
+    std::size_t num_searches = 0;
+
     /**
      * @cond
      */
@@ -69,31 +88,22 @@ struct OverlapsAnyParameters {
 };
 
 /**
- * Find subject intervals that exhibit any overlap with the query interval. 
- *
- * @tparam Index_ Integer type of the subject interval index.
- * @tparam Position_ Numeric type for the start/end positions of each interval.
- *
- * @param subject An `Nclist` of subject intervals, typically built with `build()`. 
- * @param query_start Start of the query interval.
- * @param query_end Non-inclusive end of the query interval.
- * @param params Parameters for the search.
- * @param workspace Workspace for intermediate data structures.
- * This can be default-constructed and re-used across `overlaps_any()` calls.
- * @param[out] matches On output, vector of subject interval indices that overlap with the query interval.
- * Indices are reported in arbitrary order.
+ * @cond
  */
-template<typename Index_, typename Position_>
-void overlaps_any(
-    const Nclist<Index_, Position_>& subject,
+// Calls `report()` on the index of each node in `subject.nodes` that overlaps the query, in the order of a pre-order traversal of the NCList.
+// `report()` should return whether any subject interval was reported for this node, in which case the traversal stops if `quit_on_first = true`.
+// `prune()` is called on each overlapping node before `report()`, and if it returns true, the node and all of its descendents are skipped.
+template<typename Index_, typename Position_, typename Stored_, class Report_, class Prune_>
+void overlaps_any_nodes(
+    const NclistView<Index_, Position_, Stored_>& subject,
     const Position_ query_start,
     const Position_ query_end,
     const OverlapsAnyParameters<Position_>& params,
     OverlapsAnyWorkspace<Index_>& workspace,
-    std::vector<Index_>& matches)
+    Report_ report,
+    Prune_ prune)
 {
-    matches.clear();
-    if (subject.root_children == 0) {
+    if (subject.root_start == subject.root_end) {
         return;
     }
 
@@ -175,7 +185,10 @@ void overlaps_any(
     }
 
     const auto find_first_child = [&](const Index_ children_start, const Index_ children_end) -> Index_ {
-        const auto ebegin = subject.ends.begin();
+#ifdef NCLIST_COUNT_TRAVERSAL
+        ++workspace.num_searches;
+#endif
+        const auto ebegin = subject.ends;
         const auto estart = ebegin + children_start; 
         const auto eend = ebegin + children_end;
         if (mode == OverlapsAnyMode::BASIC) {
@@ -209,10 +222,20 @@ void overlaps_any(
         }
     };
 
-    Index_ root_child_at = 0;
-    const bool root_skip_search = can_skip_search(subject.starts[0]);
-    if (!root_skip_search) {
-        root_child_at = find_first_child(0, subject.root_children);
+    const auto ends_after_start = [&](const Position_ subject_end) -> bool {
+        if (mode == OverlapsAnyMode::BASIC) {
+            return subject_end > query_start;
+        } else {
+            return subject_end >= effective_query_start;
+        }
+    };
+
+    // If the first root already satisfies the binary search criterion, it must be the result of the search.
+    // This is often the case when the roots have been narrowed beforehand, e.g., by overlaps_batch().
+    Index_ root_child_at = subject.root_start;
+    const bool root_skip_search = can_skip_search(subject.starts[subject.root_start]);
+    if (!root_skip_search && !ends_after_start(subject.ends[subject.root_start])) {
+        root_child_at = find_first_child(subject.root_start, subject.root_end);
     }
 
     workspace.history.clear();
@@ -220,7 +243,7 @@ void overlaps_any(
         Index_ current_subject;
         bool skip_search;
         if (workspace.history.empty()) {
-            if (root_child_at == subject.root_children || is_finished(subject.starts[root_child_at])) {
+            if (root_child_at == subject.root_end || is_finished(subject.starts[root_child_at])) {
                 break;
             }
             current_subject = root_child_at;
@@ -237,6 +260,13 @@ void overlaps_any(
             ++(current_state.child_at); // do this before the emplace_back(), otherwise the history might get reallocated and the reference would be dangling.
         }
 
+#ifdef NCLIST_COUNT_TRAVERSAL
+        ++workspace.num_visited;
+#endif
+        if (prune(current_subject)) {
+            continue;
+        }
+
         const auto& current_node = subject.nodes[current_subject];
         if (mode == OverlapsAnyMode::MIN_OVERLAP) {
             if (std::min(query_end, subject.ends[current_subject]) - std::max(query_start, subject.starts[current_subject]) < params.min_overlap) {
@@ -245,13 +275,9 @@ void overlaps_any(
             }
         }
 
-        matches.push_back(current_node.id);
-        if (params.quit_on_first) {
+        if (report(current_subject) && params.quit_on_first) {
             return;
         }
-        if (current_node.duplicates_start != current_node.duplicates_end) {
-            matches.insert(matches.end(), subject.duplicates.begin() + current_node.duplicates_start, subject.duplicates.begin() + current_node.duplicates_end);
-        }
 
         if (current_node.children_start != current_node.children_end) {
             if (skip_search) {
@@ -266,6 +292,206 @@ void overlaps_any(
     }
 }
 
+template<typename Index_, typename Position_, typename Stored_, class Report_>
+void overlaps_any_nodes(
+    const NclistView<Index_, Position_, Stored_>& subject,
+    const Position_ query_start,
+    const Position_ query_end,
+    const OverlapsAnyParameters<Position_>& params,
+    OverlapsAnyWorkspace<Index_>& workspace,
+    Report_ report)
+{
+    overlaps_any_nodes(subject, query_start, query_end, params, workspace, report, [](const Index_) -> bool { return false; });
+}
+
+// Check whether a single subject interval would be reported by `overlaps_any_nodes()`.
+// This is used to filter the results of a containing query, so it must be kept consistent with the traversal above.
+template<typename Position_>
+bool overlaps_any_matches(
+    const Position_ subject_start,
+    const Position_ subject_end,
+    const Position_ query_start,
+    const Position_ query_end,
+    const OverlapsAnyParameters<Position_>& params)
+{
+    if (params.min_overlap > 0) {
+        if (subject_start >= query_end || subject_end <= query_start) {
+            return false;
+        }
+        return std::min(query_end, subject_end) - std::max(query_start, subject_start) >= params.min_overlap;
+    } else if (params.max_gap.has_value()) {
+        if (subject_end < safe_subtract_gap(query_start, *(params.max_gap))) {
+            return false;
+        }
+        return subject_start < query_end || subject_start - query_end <= *(params.max_gap);
+    } else {
+        return subject_start < query_end && query_start < subject_end;
+    }
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Overload of `overlaps_any()` that only searches the subject intervals in an `NclistView`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam Stored_ Numeric type for the stored start/end positions of each interval, see `NclistView` for details.
+ * @tparam Matches_ Container for the matches, either a `std::vector<Index_>`, `BitmapResults<Index_>` or `DeltaResults<Index_>`.
+ *
+ * @param subject View of an `Nclist`, typically created with `make_view()`.
+ * @param query_start Start of the query interval.
+ * @param query_end Non-inclusive end of the query interval.
+ * @param params Parameters for the search.
+ * @param workspace Workspace for intermediate data structures.
+ * This can be default-constructed and re-used across `overlaps_any()` calls.
+ * @param[out] matches On output, container of subject interval indices that overlap with the query interval.
+ * For a `std::vector`, indices are reported in arbitrary order.
+ */
+template<typename Index_, typename Position_, typename Stored_, class Matches_>
+void overlaps_any(
+    const NclistView<Index_, Position_, Stored_>& subject,
+    const Position_ query_start,
+    const Position_ query_end,
+    const OverlapsAnyParameters<Position_>& params,
+    OverlapsAnyWorkspace<Index_>& workspace,
+    Matches_& matches)
+{
+    start_matches(matches);
+    overlaps_any_nodes(subject, query_start, query_end, params, workspace, [&](const Index_ node) -> bool {
+        const auto& current_node = subject.nodes[node];
+        add_match(matches, current_node.id);
+        if (!params.quit_on_first && current_node.duplicates_start != current_node.duplicates_end) {
+            add_matches(matches, subject.duplicates + current_node.duplicates_start, subject.duplicates + current_node.duplicates_end);
+        }
+        return true;
+    });
+    finish_matches(matches);
+}
+
+/**
+ * Find subject intervals that exhibit any overlap with the query interval. 
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam Matches_ Container for the matches, either a `std::vector<Index_>`, `BitmapResults<Index_>` or `DeltaResults<Index_>`.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`. 
+ * @param query_start Start of the query interval.
+ * @param query_end Non-inclusive end of the query interval.
+ * @param params Parameters for the search.
+ * @param workspace Workspace for intermediate data structures.
+ * This can be default-constructed and re-used across `overlaps_any()` calls.
+ * @param[out] matches On output, container of subject interval indices that overlap with the query interval.
+ * For a `std::vector`, indices are reported in arbitrary order.
+ */
+template<typename Index_, typename Position_, class Matches_>
+void overlaps_any(
+    const Nclist<Index_, Position_>& subject,
+    const Position_ query_start,
+    const Position_ query_end,
+    const OverlapsAnyParameters<Position_>& params,
+    OverlapsAnyWorkspace<Index_>& workspace,
+    Matches_& matches)
+{
+    overlaps_any(make_view(subject), query_start, query_end, params, workspace, matches);
+}
+
+/**
+ * Overload of `has_overlaps_any()` that only searches the subject intervals in an `NclistView`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam Stored_ Numeric type for the stored start/end positions of each interval, see `NclistView` for details.
+ *
+ * @param subject View of an `Nclist`, typically created with `make_view()`.
+ * @param query_start Start of the query interval.
+ * @param query_end Non-inclusive end of the query interval.
+ * @param params Parameters for the search.
+ * `OverlapsAnyParameters::quit_on_first` is ignored.
+ *
+ * @return Whether any subject interval overlaps with the query interval.
+ */
+template<typename Index_, typename Position_, typename Stored_>
+bool has_overlaps_any(
+    const NclistView<Index_, Position_, Stored_>& subject,
+    const Position_ query_start,
+    const Position_ query_end,
+    const OverlapsAnyParameters<Position_>& params)
+{
+    /****************************************
+     * Each non-root interval is nested within its root interval, so if the former overlaps with the query, so does the latter.
+     * Specifically, the overlap with the root interval is at least as long and the gap to the root interval is no larger.
+     * This means that we only need to search the root intervals, which avoids any traversal of the NCList.
+     * We use the same binary search and stopping criteria as described in `overlaps_any()`.
+     ****************************************/
+
+    const auto ebegin = subject.ends;
+    const auto rbegin = ebegin + subject.root_start;
+    const auto rend = ebegin + subject.root_end;
+
+    if (params.min_overlap > 0) {
+        if (query_end - query_start < params.min_overlap) {
+            return false;
+        }
+        constexpr Position_ maxed = std::numeric_limits<Position_>::max();
+        if (maxed - params.min_overlap < query_start) {
+            return false;
+        }
+
+        Index_ i = std::lower_bound(rbegin, rend, query_start + params.min_overlap) - ebegin;
+        for (; i < subject.root_end; ++i) {
+            const auto subject_start = subject.starts[i];
+            if (subject_start >= query_end || query_end - subject_start < params.min_overlap) {
+                break;
+            }
+            if (std::min(query_end, subject.ends[i]) - std::max(query_start, subject_start) >= params.min_overlap) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    if (params.max_gap.has_value()) {
+        const Index_ i = std::lower_bound(rbegin, rend, safe_subtract_gap(query_start, *(params.max_gap))) - ebegin;
+        if (i == subject.root_end) {
+            return false;
+        }
+        const auto subject_start = subject.starts[i];
+        return subject_start < query_end || subject_start - query_end <= *(params.max_gap);
+    }
+
+    const Index_ i = std::upper_bound(rbegin, rend, query_start) - ebegin;
+    return i < subject.root_end && subject.starts[i] < query_end;
+}
+
+/**
+ * Determine whether any subject interval overlaps with the query interval.
+ * This is equivalent to checking whether `matches` is non-empty after calling `overlaps_any()` with the same `params`,
+ * but does not require a workspace or an output vector, making it more suitable for high-throughput counting.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`. 
+ * @param query_start Start of the query interval.
+ * @param query_end Non-inclusive end of the query interval.
+ * @param params Parameters for the search.
+ * `OverlapsAnyParameters::quit_on_first` is ignored.
+ *
+ * @return Whether any subject interval overlaps with the query interval.
+ */
+template<typename Index_, typename Position_>
+bool has_overlaps_any(
+    const Nclist<Index_, Position_>& subject,
+    const Position_ query_start,
+    const Position_ query_end,
+    const OverlapsAnyParameters<Position_>& params)
+{
+    return has_overlaps_any(make_view(subject), query_start, query_end, params);
+}
+
 }
 
 #endif
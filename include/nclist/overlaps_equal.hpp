@@ -5,6 +5,8 @@
 #include <algorithm>
 
 #include "build.hpp"
+#include "view.hpp"
+#include "results.hpp"
 #include "utils.hpp"
 
 /**
@@ -64,33 +66,18 @@ struct OverlapsEqualParameters {
 
 
 /**
- * Find subject intervals with the same start and end positions as the query interval.
- * By default, given a subject interval `[subject_start, subject_end)`, an overlap is considered if `subject_start == query_end` and `query_start == subject_end`.
- * This behavior can be tuned with parameters in `params`.
- *
- * @tparam Index_ Integer type of the subject interval index.
- * @tparam Position_ Numeric type for the start/end positions of each interval.
- *
- * @param subject An `Nclist` of subject intervals, typically built with `build()`. 
- * @param query_start Start of the query interval.
- * @param query_end Non-inclusive end of the query interval.
- * @param params Parameters for the search.
- * @param workspace Workspace for intermediate data structures.
- * This can be default-constructed and re-used across `overlaps_equal()` calls.
- * @param[out] matches On output, vector of subject interval indices that overlap with the query interval.
- * Indices are reported in arbitrary order.
+ * @cond
  */
-template<typename Index_, typename Position_>
-void overlaps_equal(
-    const Nclist<Index_, Position_>& subject,
+template<typename Index_, typename Position_, typename Stored_, class Matches_>
+void overlaps_equal_internal(
+    const NclistView<Index_, Position_, Stored_>& subject,
     const Position_ query_start,
     const Position_ query_end,
     const OverlapsEqualParameters<Position_>& params,
     OverlapsEqualWorkspace<Index_>& workspace,
-    std::vector<Index_>& matches)
+    Matches_& matches)
 {
-    matches.clear();
-    if (subject.root_children == 0) {
+    if (subject.root_start == subject.root_end) {
         return;
     }
 
@@ -156,7 +143,7 @@ void overlaps_equal(
     }
 
     const auto find_first_child = [&](const Index_ children_start, const Index_ children_end) -> Index_ {
-        const auto ebegin = subject.ends.begin();
+        const auto ebegin = subject.ends;
         const auto estart = ebegin + children_start; 
         const auto eend = ebegin + children_end;
         return std::lower_bound(estart, eend, effective_query_end) - ebegin;
@@ -190,13 +177,13 @@ void overlaps_equal(
         return false;
     };
 
-    Index_ root_child_at = find_first_child(0, subject.root_children);
+    Index_ root_child_at = find_first_child(subject.root_start, subject.root_end);
 
     workspace.history.clear();
     while (1) {
         Index_ current_subject;
         if (workspace.history.empty()) {
-            if (root_child_at == subject.root_children || is_finished(subject.starts[root_child_at])) {
+            if (root_child_at == subject.root_end || is_finished(subject.starts[root_child_at])) {
                 break;
             }
             current_subject = root_child_at;
@@ -233,12 +220,12 @@ void overlaps_equal(
         }
 
         if (okay) {
-            matches.push_back(current_node.id);
+            add_match(matches, current_node.id);
             if (params.quit_on_first) {
                 return;
             }
             if (current_node.duplicates_start != current_node.duplicates_end) {
-                matches.insert(matches.end(), subject.duplicates.begin() + current_node.duplicates_start, subject.duplicates.begin() + current_node.duplicates_end);
+                add_matches(matches, subject.duplicates + current_node.duplicates_start, subject.duplicates + current_node.duplicates_end);
             }
             if (params.max_gap == 0) { // no need to continue traversal, there should only be one node that is exactly equal.
                 return;
@@ -253,6 +240,70 @@ void overlaps_equal(
         }
     }
 }
+/**
+ * @endcond
+ */
+
+/**
+ * Overload of `overlaps_equal()` that only searches the subject intervals in an `NclistView`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam Stored_ Numeric type for the stored start/end positions of each interval, see `NclistView` for details.
+ * @tparam Matches_ Container for the matches, either a `std::vector<Index_>`, `BitmapResults<Index_>` or `DeltaResults<Index_>`.
+ *
+ * @param subject View of an `Nclist`, typically created with `make_view()`.
+ * @param query_start Start of the query interval.
+ * @param query_end Non-inclusive end of the query interval.
+ * @param params Parameters for the search.
+ * @param workspace Workspace for intermediate data structures.
+ * This can be default-constructed and re-used across `overlaps_equal()` calls.
+ * @param[out] matches On output, container of subject interval indices that overlap with the query interval.
+ * For a `std::vector`, indices are reported in arbitrary order.
+ */
+template<typename Index_, typename Position_, typename Stored_, class Matches_>
+void overlaps_equal(
+    const NclistView<Index_, Position_, Stored_>& subject,
+    const Position_ query_start,
+    const Position_ query_end,
+    const OverlapsEqualParameters<Position_>& params,
+    OverlapsEqualWorkspace<Index_>& workspace,
+    Matches_& matches)
+{
+    start_matches(matches);
+    overlaps_equal_internal(subject, query_start, query_end, params, workspace, matches);
+    finish_matches(matches);
+}
+
+/**
+ * Find subject intervals with the same start and end positions as the query interval.
+ * By default, given a subject interval `[subject_start, subject_end)`, an overlap is considered if `subject_start == query_end` and `query_start == subject_end`.
+ * This behavior can be tuned with parameters in `params`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam Matches_ Container for the matches, either a `std::vector<Index_>`, `BitmapResults<Index_>` or `DeltaResults<Index_>`.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`. 
+ * @param query_start Start of the query interval.
+ * @param query_end Non-inclusive end of the query interval.
+ * @param params Parameters for the search.
+ * @param workspace Workspace for intermediate data structures.
+ * This can be default-constructed and re-used across `overlaps_equal()` calls.
+ * @param[out] matches On output, container of subject interval indices that overlap with the query interval.
+ * For a `std::vector`, indices are reported in arbitrary order.
+ */
+template<typename Index_, typename Position_, class Matches_>
+void overlaps_equal(
+    const Nclist<Index_, Position_>& subject,
+    const Position_ query_start,
+    const Position_ query_end,
+    const OverlapsEqualParameters<Position_>& params,
+    OverlapsEqualWorkspace<Index_>& workspace,
+    Matches_& matches)
+{
+    overlaps_equal(make_view(subject), query_start, query_end, params, workspace, matches);
+}
 
 }
 
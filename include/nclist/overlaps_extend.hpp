@@ -7,6 +7,8 @@
 #include <limits>
 
 #include "build.hpp"
+#include "view.hpp"
+#include "results.hpp"
 
 /**
  * @file overlaps_extend.hpp
@@ -67,31 +69,18 @@ struct OverlapsExtendParameters {
 
 
 /**
- * Find subject ranges that are extended by the query range, i.e., each subject range is a subrange of the query.
- *
- * @tparam Index_ Integer type of the subject range index.
- * @tparam Position_ Numeric type for the start/end positions of each range.
- *
- * @param subject An `Nclist` of subject ranges, typically built with `build()`. 
- * @param query_start Start of the query range.
- * @param query_end Non-inclusive end of the query range.
- * @param params Parameters for the search.
- * @param workspace Workspace for intermediate data structures.
- * This can be default-constructed and re-used across `overlaps_extend()` calls.
- * @param[out] matches On output, vector of subject range indices that overlap with the query range.
- * Indices are reported in arbitrary order.
+ * @cond
  */
-template<typename Index_, typename Position_>
-void overlaps_extend(
-    const Nclist<Index_, Position_>& subject,
+template<typename Index_, typename Position_, typename Stored_, class Matches_>
+void overlaps_extend_internal(
+    const NclistView<Index_, Position_, Stored_>& subject,
     Position_ query_start,
     Position_ query_end,
     const OverlapsExtendParameters<Position_>& params,
     OverlapsExtendWorkspace<Index_>& workspace,
-    std::vector<Index_>& matches)
+    Matches_& matches)
 {
-    matches.clear();
-    if (subject.root_children == 0) {
+    if (subject.root_start == subject.root_end) {
         return;
     }
 
@@ -158,7 +147,7 @@ void overlaps_extend(
     }
 
     const auto find_first_child = [&](const Index_ children_start, const Index_ children_end) -> Index_ {
-        const auto ebegin = subject.ends.begin();
+        const auto ebegin = subject.ends;
         const auto estart = ebegin + children_start; 
         const auto eend = ebegin + children_end;
         return std::lower_bound(estart, eend, effective_query_start) - ebegin;
@@ -179,10 +168,10 @@ void overlaps_extend(
         }
     };
 
-    Index_ root_child_at = 0;
-    const bool root_skip_search = can_skip_search(subject.starts[0]);
+    Index_ root_child_at = subject.root_start;
+    const bool root_skip_search = can_skip_search(subject.starts[subject.root_start]);
     if (!root_skip_search) {
-        root_child_at = find_first_child(0, subject.root_children);
+        root_child_at = find_first_child(subject.root_start, subject.root_end);
     }
 
     workspace.history.clear();
@@ -190,7 +179,7 @@ void overlaps_extend(
         Index_ current_subject;
         bool current_skip_search;
         if (workspace.history.empty()) {
-            if (root_child_at == subject.root_children || is_finished(subject.starts[root_child_at])) {
+            if (root_child_at == subject.root_end || is_finished(subject.starts[root_child_at])) {
                 break;
             }
             current_subject = root_child_at;
@@ -224,12 +213,12 @@ void overlaps_extend(
         }
 
         if (query_start <= subject_start && query_end >= subject_end) {
-            matches.push_back(current_node.id);
+            add_match(matches, current_node.id);
             if (params.quit_on_first) {
                 return;
             }
             if (current_node.duplicates_start != current_node.duplicates_end) {
-                matches.insert(matches.end(), subject.duplicates.begin() + current_node.duplicates_start, subject.duplicates.begin() + current_node.duplicates_end);
+                add_matches(matches, subject.duplicates + current_node.duplicates_start, subject.duplicates + current_node.duplicates_end);
             }
         }
 
@@ -245,6 +234,68 @@ void overlaps_extend(
         }
     }
 }
+/**
+ * @endcond
+ */
+
+/**
+ * Overload of `overlaps_extend()` that only searches the subject intervals in an `NclistView`.
+ *
+ * @tparam Index_ Integer type of the subject range index.
+ * @tparam Position_ Numeric type for the start/end positions of each range.
+ * @tparam Stored_ Numeric type for the stored start/end positions of each interval, see `NclistView` for details.
+ * @tparam Matches_ Container for the matches, either a `std::vector<Index_>`, `BitmapResults<Index_>` or `DeltaResults<Index_>`.
+ *
+ * @param subject View of an `Nclist`, typically created with `make_view()`.
+ * @param query_start Start of the query range.
+ * @param query_end Non-inclusive end of the query range.
+ * @param params Parameters for the search.
+ * @param workspace Workspace for intermediate data structures.
+ * This can be default-constructed and re-used across `overlaps_extend()` calls.
+ * @param[out] matches On output, container of subject range indices that overlap with the query range.
+ * For a `std::vector`, indices are reported in arbitrary order.
+ */
+template<typename Index_, typename Position_, typename Stored_, class Matches_>
+void overlaps_extend(
+    const NclistView<Index_, Position_, Stored_>& subject,
+    Position_ query_start,
+    Position_ query_end,
+    const OverlapsExtendParameters<Position_>& params,
+    OverlapsExtendWorkspace<Index_>& workspace,
+    Matches_& matches)
+{
+    start_matches(matches);
+    overlaps_extend_internal(subject, query_start, query_end, params, workspace, matches);
+    finish_matches(matches);
+}
+
+/**
+ * Find subject ranges that are extended by the query range, i.e., each subject range is a subrange of the query.
+ *
+ * @tparam Index_ Integer type of the subject range index.
+ * @tparam Position_ Numeric type for the start/end positions of each range.
+ * @tparam Matches_ Container for the matches, either a `std::vector<Index_>`, `BitmapResults<Index_>` or `DeltaResults<Index_>`.
+ *
+ * @param subject An `Nclist` of subject ranges, typically built with `build()`. 
+ * @param query_start Start of the query range.
+ * @param query_end Non-inclusive end of the query range.
+ * @param params Parameters for the search.
+ * @param workspace Workspace for intermediate data structures.
+ * This can be default-constructed and re-used across `overlaps_extend()` calls.
+ * @param[out] matches On output, container of subject range indices that overlap with the query range.
+ * For a `std::vector`, indices are reported in arbitrary order.
+ */
+template<typename Index_, typename Position_, class Matches_>
+void overlaps_extend(
+    const Nclist<Index_, Position_>& subject,
+    Position_ query_start,
+    Position_ query_end,
+    const OverlapsExtendParameters<Position_>& params,
+    OverlapsExtendWorkspace<Index_>& workspace,
+    Matches_& matches)
+{
+    overlaps_extend(make_view(subject), query_start, query_end, params, workspace, matches);
+}
 
 }
 
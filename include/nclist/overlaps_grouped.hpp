@@ -0,0 +1,284 @@
+#ifndef NCLIST_OVERLAPS_GROUPED_HPP
+#define NCLIST_OVERLAPS_GROUPED_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+#include "build.hpp"
+#include "overlaps_any.hpp"
+#include "parallelize.hpp"
+
+/**
+ * @file overlaps_grouped.hpp
+ * @brief Find groups of overlapping intervals.
+ */
+
+namespace nclist {
+
+/**
+ * @brief Workspace for `overlaps_any_grouped()` and friends.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ *
+ * This holds intermediate data structures that can be re-used across multiple calls to `overlaps_any_grouped()` to avoid reallocations.
+ */
+template<typename Index_>
+struct OverlapsGroupedWorkspace {
+    /**
+     * @cond
+     */
+    OverlapsAnyWorkspace<Index_> any;
+
+    // Each group is marked as visited by setting its stamp to the current epoch.
+    // Incrementing the epoch for each query effectively clears all marks without touching the 'stamps' vector.
+    std::vector<std::uint32_t> stamps;
+    std::uint32_t epoch = 0;
+
+    void next_epoch(std::size_t num_groups) {
+        if (stamps.size() != num_groups) {
+            stamps.clear();
+            stamps.resize(num_groups);
+            epoch = 0;
+        }
+        ++epoch;
+        if (epoch == 0) { // handling wrap-around after 2^32 queries.
+            std::fill(stamps.begin(), stamps.end(), 0);
+            epoch = 1;
+        }
+    }
+    /**
+     * @endcond
+     */
+};
+
+/**
+ * @cond
+ */
+// Calls `add()` on each group that has not yet been seen for this query, as soon as it is encountered during the traversal.
+// This avoids building the full list of overlapping subject intervals only to collapse them into groups afterwards.
+template<typename Index_, typename Position_, typename Group_, class Add_>
+void overlaps_any_grouped_internal(
+    const Nclist<Index_, Position_>& subject,
+    const Group_* groups,
+    const Group_ num_groups,
+    const Position_ query_start,
+    const Position_ query_end,
+    const OverlapsAnyParameters<Position_>& params,
+    OverlapsGroupedWorkspace<Index_>& workspace,
+    Add_ add)
+{
+    workspace.next_epoch(num_groups);
+    const auto epoch = workspace.epoch;
+    auto& stamps = workspace.stamps;
+    const auto check = [&](const Index_ s) -> void {
+        const auto g = groups[s];
+        auto& stamp = stamps[g];
+        if (stamp != epoch) {
+            stamp = epoch;
+            add(g);
+        }
+    };
+
+    const auto view = make_view(subject);
+    overlaps_any_nodes(view, query_start, query_end, params, workspace.any, [&](const Index_ node) -> bool {
+        const auto& current_node = view.nodes[node];
+        check(current_node.id);
+        if (!params.quit_on_first) {
+            for (auto d = current_node.duplicates_start; d < current_node.duplicates_end; ++d) {
+                check(view.duplicates[d]);
+            }
+        }
+        return true;
+    });
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Find groups of subject intervals that exhibit any overlap with the query interval.
+ * This is equivalent to mapping the `matches` of `overlaps_any()` to their groups and removing duplicate groups,
+ * e.g., to obtain gene-level overlaps from an `Nclist` of transcripts or exons.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam Group_ Integer type of the group index.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param[in] groups Pointer to an array containing the group index for each subject interval.
+ * This should be long enough to be addressable by any subject interval index in `subject`.
+ * @param num_groups Number of groups, i.e., all values in `groups` should lie in `[0, num_groups)`.
+ * @param query_start Start of the query interval.
+ * @param query_end Non-inclusive end of the query interval.
+ * @param params Parameters for the search, see `overlaps_any()` for details.
+ * If `OverlapsAnyParameters::quit_on_first = true`, only one arbitrarily chosen group will be reported.
+ * @param workspace Workspace for intermediate data structures.
+ * This can be default-constructed and re-used across `overlaps_any_grouped()` calls.
+ * @param[out] matches On output, vector of unique indices of groups containing subject intervals that overlap with the query interval.
+ * Indices are reported in arbitrary order.
+ */
+template<typename Index_, typename Position_, typename Group_>
+void overlaps_any_grouped(
+    const Nclist<Index_, Position_>& subject,
+    const Group_* groups,
+    const Group_ num_groups,
+    const Position_ query_start,
+    const Position_ query_end,
+    const OverlapsAnyParameters<Position_>& params,
+    OverlapsGroupedWorkspace<Index_>& workspace,
+    std::vector<Group_>& matches)
+{
+    matches.clear();
+    overlaps_any_grouped_internal(subject, groups, num_groups, query_start, query_end, params, workspace, [&](const Group_ g) -> void {
+        matches.push_back(g);
+    });
+}
+
+/**
+ * Count the number of groups of subject intervals that exhibit any overlap with the query interval.
+ * This is equivalent to the length of `matches` in `overlaps_any_grouped()`, without the need to store the group indices.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam Group_ Integer type of the group index.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param[in] groups Pointer to an array containing the group index for each subject interval, see `overlaps_any_grouped()` for details.
+ * @param num_groups Number of groups.
+ * @param query_start Start of the query interval.
+ * @param query_end Non-inclusive end of the query interval.
+ * @param params Parameters for the search, see `overlaps_any()` for details.
+ * @param workspace Workspace for intermediate data structures.
+ * This can be default-constructed and re-used across `count_overlaps_any_grouped()` calls.
+ *
+ * @return Number of groups containing subject intervals that overlap with the query interval.
+ */
+template<typename Index_, typename Position_, typename Group_>
+Group_ count_overlaps_any_grouped(
+    const Nclist<Index_, Position_>& subject,
+    const Group_* groups,
+    const Group_ num_groups,
+    const Position_ query_start,
+    const Position_ query_end,
+    const OverlapsAnyParameters<Position_>& params,
+    OverlapsGroupedWorkspace<Index_>& workspace)
+{
+    Group_ count = 0;
+    overlaps_any_grouped_internal(subject, groups, num_groups, query_start, query_end, params, workspace, [&](const Group_) -> void {
+        ++count;
+    });
+    return count;
+}
+
+/**
+ * Apply `overlaps_any_grouped()` to a batch of query intervals.
+ * Queries are distributed across threads with `parallelize()`, where each thread uses its own workspace.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam Group_ Integer type of the group index.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param[in] groups Pointer to an array containing the group index for each subject interval, see `overlaps_any_grouped()` for details.
+ * @param num_groups Number of groups.
+ * @param num_queries Number of query intervals.
+ * @param[in] query_starts Pointer to an array of length `num_queries`, containing the start of each query interval.
+ * @param[in] query_ends Pointer to an array of length `num_queries`, containing the non-inclusive end of each query interval.
+ * @param params Parameters for the search, see `overlaps_any()` for details.
+ * @param num_threads Number of threads to use.
+ * @param[out] offsets On output, vector of length `num_queries + 1`.
+ * The groups for query `i` are stored in `matches[offsets[i]]` to `matches[offsets[i + 1] - 1]`.
+ * @param[out] matches On output, vector of unique group indices for each query, see `offsets`.
+ */
+template<typename Index_, typename Position_, typename Group_>
+void overlaps_any_grouped_batch(
+    const Nclist<Index_, Position_>& subject,
+    const Group_* groups,
+    const Group_ num_groups,
+    const std::size_t num_queries,
+    const Position_* query_starts,
+    const Position_* query_ends,
+    const OverlapsAnyParameters<Position_>& params,
+    const int num_threads,
+    std::vector<std::size_t>& offsets,
+    std::vector<Group_>& matches)
+{
+    // Each worker stores the groups for its contiguous range of queries in its own buffer, which are then concatenated in the input order.
+    const int num_workers = std::max(num_threads, 1);
+    std::vector<std::vector<Group_> > buffers(num_workers);
+    std::vector<std::size_t> counts(num_queries);
+    std::vector<std::size_t> worker_starts(num_workers, num_queries);
+
+    parallelize(num_workers, num_queries, [&](int w, std::size_t start, std::size_t length) -> void {
+        OverlapsGroupedWorkspace<Index_> workspace;
+        auto& buffer = buffers[w];
+        worker_starts[w] = start;
+        for (std::size_t q = start, end = start + length; q < end; ++q) {
+            const auto before = buffer.size();
+            overlaps_any_grouped_internal(subject, groups, num_groups, query_starts[q], query_ends[q], params, workspace, [&](const Group_ g) -> void {
+                buffer.push_back(g);
+            });
+            counts[q] = buffer.size() - before;
+        }
+    });
+
+    offsets.clear();
+    offsets.reserve(num_queries + 1);
+    offsets.push_back(0);
+    for (std::size_t q = 0; q < num_queries; ++q) {
+        offsets.push_back(offsets.back() + counts[q]);
+    }
+
+    matches.resize(offsets.back());
+    for (int w = 0; w < num_workers; ++w) {
+        const auto& buffer = buffers[w];
+        if (!buffer.empty()) {
+            std::copy(buffer.begin(), buffer.end(), matches.begin() + offsets[worker_starts[w]]);
+        }
+    }
+}
+
+/**
+ * Apply `count_overlaps_any_grouped()` to a batch of query intervals.
+ * Queries are distributed across threads with `parallelize()`, where each thread uses its own workspace.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam Group_ Integer type of the group index.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param[in] groups Pointer to an array containing the group index for each subject interval, see `overlaps_any_grouped()` for details.
+ * @param num_groups Number of groups.
+ * @param num_queries Number of query intervals.
+ * @param[in] query_starts Pointer to an array of length `num_queries`, containing the start of each query interval.
+ * @param[in] query_ends Pointer to an array of length `num_queries`, containing the non-inclusive end of each query interval.
+ * @param params Parameters for the search, see `overlaps_any()` for details.
+ * @param num_threads Number of threads to use.
+ * @param[out] counts Pointer to an array of length `num_queries`.
+ * On output, this contains the number of overlapping groups for each query.
+ */
+template<typename Index_, typename Position_, typename Group_>
+void count_overlaps_any_grouped_batch(
+    const Nclist<Index_, Position_>& subject,
+    const Group_* groups,
+    const Group_ num_groups,
+    const std::size_t num_queries,
+    const Position_* query_starts,
+    const Position_* query_ends,
+    const OverlapsAnyParameters<Position_>& params,
+    const int num_threads,
+    Group_* counts)
+{
+    parallelize(num_threads, num_queries, [&](int, std::size_t start, std::size_t length) -> void {
+        OverlapsGroupedWorkspace<Index_> workspace;
+        for (std::size_t q = start, end = start + length; q < end; ++q) {
+            counts[q] = count_overlaps_any_grouped(subject, groups, num_groups, query_starts[q], query_ends[q], params, workspace);
+        }
+    });
+}
+
+}
+
+#endif
@@ -6,6 +6,8 @@
 #include <optional>
 
 #include "build.hpp"
+#include "view.hpp"
+#include "results.hpp"
 
 /**
  * @file overlaps_within.hpp
@@ -64,31 +66,18 @@ struct OverlapsWithinParameters {
 };
 
 /**
- * Find subject ranges where the query range lies within them, i.e., the query is a subrange of each subject range. 
- *
- * @tparam Index_ Integer type of the subject range index.
- * @tparam Position_ Numeric type for the start/end positions of each range.
- *
- * @param subject An `Nclist` of subject ranges, typically built with `build()`. 
- * @param query_start Start of the query range.
- * @param query_end Non-inclusive end of the query range.
- * @param params Parameters for the search.
- * @param workspace Workspace for intermediate data structures.
- * This can be default-constructed and re-used across `overlaps_within()` calls.
- * @param[out] matches On output, vector of subject range indices that overlap with the query range.
- * Indices are reported in arbitrary order.
+ * @cond
  */
-template<typename Index_, typename Position_>
-void overlaps_within(
-    const Nclist<Index_, Position_>& subject,
+template<typename Index_, typename Position_, typename Stored_, class Matches_>
+void overlaps_within_internal(
+    const NclistView<Index_, Position_, Stored_>& subject,
     const Position_ query_start,
     const Position_ query_end,
     const OverlapsWithinParameters<Position_>& params,
     OverlapsWithinWorkspace<Index_>& workspace,
-    std::vector<Index_>& matches)
+    Matches_& matches)
 {
-    matches.clear();
-    if (subject.root_children == 0) {
+    if (subject.root_start == subject.root_end) {
         return;
     }
 
@@ -131,7 +120,7 @@ void overlaps_within(
     }
 
     const auto find_first_child = [&](const Index_ children_start, const Index_ children_end) -> Index_ {
-        const auto ebegin = subject.ends.begin();
+        const auto ebegin = subject.ends;
         const auto estart = ebegin + children_start; 
         const auto eend = ebegin + children_end;
         return std::lower_bound(estart, eend, query_end) - ebegin;
@@ -141,13 +130,13 @@ void overlaps_within(
         return subject_start > query_start;
     };
 
-    Index_ root_child_at = find_first_child(0, subject.root_children);
+    Index_ root_child_at = find_first_child(subject.root_start, subject.root_end);
 
     workspace.history.clear();
     while (1) {
         Index_ current_subject;
         if (workspace.history.empty()) {
-            if (root_child_at == subject.root_children || is_finished(subject.starts[root_child_at])) {
+            if (root_child_at == subject.root_end || is_finished(subject.starts[root_child_at])) {
                 break;
             }
             current_subject = root_child_at;
@@ -177,12 +166,12 @@ void overlaps_within(
         }
 
         if (add_self) {
-            matches.push_back(current_node.id);
+            add_match(matches, current_node.id);
             if (params.quit_on_first) {
                 return;
             }
             if (current_node.duplicates_start != current_node.duplicates_end) {
-                matches.insert(matches.end(), subject.duplicates.begin() + current_node.duplicates_start, subject.duplicates.begin() + current_node.duplicates_end);
+                add_matches(matches, subject.duplicates + current_node.duplicates_start, subject.duplicates + current_node.duplicates_end);
             }
         }
 
@@ -194,6 +183,68 @@ void overlaps_within(
         }
     }
 }
+/**
+ * @endcond
+ */
+
+/**
+ * Overload of `overlaps_within()` that only searches the subject intervals in an `NclistView`.
+ *
+ * @tparam Index_ Integer type of the subject range index.
+ * @tparam Position_ Numeric type for the start/end positions of each range.
+ * @tparam Stored_ Numeric type for the stored start/end positions of each interval, see `NclistView` for details.
+ * @tparam Matches_ Container for the matches, either a `std::vector<Index_>`, `BitmapResults<Index_>` or `DeltaResults<Index_>`.
+ *
+ * @param subject View of an `Nclist`, typically created with `make_view()`.
+ * @param query_start Start of the query range.
+ * @param query_end Non-inclusive end of the query range.
+ * @param params Parameters for the search.
+ * @param workspace Workspace for intermediate data structures.
+ * This can be default-constructed and re-used across `overlaps_within()` calls.
+ * @param[out] matches On output, container of subject range indices that overlap with the query range.
+ * For a `std::vector`, indices are reported in arbitrary order.
+ */
+template<typename Index_, typename Position_, typename Stored_, class Matches_>
+void overlaps_within(
+    const NclistView<Index_, Position_, Stored_>& subject,
+    const Position_ query_start,
+    const Position_ query_end,
+    const OverlapsWithinParameters<Position_>& params,
+    OverlapsWithinWorkspace<Index_>& workspace,
+    Matches_& matches)
+{
+    start_matches(matches);
+    overlaps_within_internal(subject, query_start, query_end, params, workspace, matches);
+    finish_matches(matches);
+}
+
+/**
+ * Find subject ranges where the query range lies within them, i.e., the query is a subrange of each subject range. 
+ *
+ * @tparam Index_ Integer type of the subject range index.
+ * @tparam Position_ Numeric type for the start/end positions of each range.
+ * @tparam Matches_ Container for the matches, either a `std::vector<Index_>`, `BitmapResults<Index_>` or `DeltaResults<Index_>`.
+ *
+ * @param subject An `Nclist` of subject ranges, typically built with `build()`. 
+ * @param query_start Start of the query range.
+ * @param query_end Non-inclusive end of the query range.
+ * @param params Parameters for the search.
+ * @param workspace Workspace for intermediate data structures.
+ * This can be default-constructed and re-used across `overlaps_within()` calls.
+ * @param[out] matches On output, container of subject range indices that overlap with the query range.
+ * For a `std::vector`, indices are reported in arbitrary order.
+ */
+template<typename Index_, typename Position_, class Matches_>
+void overlaps_within(
+    const Nclist<Index_, Position_>& subject,
+    const Position_ query_start,
+    const Position_ query_end,
+    const OverlapsWithinParameters<Position_>& params,
+    OverlapsWithinWorkspace<Index_>& workspace,
+    Matches_& matches)
+{
+    overlaps_within(make_view(subject), query_start, query_end, params, workspace, matches);
+}
 
 }
 
@@ -0,0 +1,85 @@
+#ifndef NCLIST_PARALLELIZE_HPP
+#define NCLIST_PARALLELIZE_HPP
+
+#include <vector>
+#include <thread>
+#include <exception>
+
+/**
+ * @file parallelize.hpp
+ * @brief Parallelize tasks across workers.
+ */
+
+namespace nclist {
+
+/**
+ * Split `num_tasks` into contiguous ranges and run them on separate workers.
+ * By default, this uses `std::thread` with one thread per worker.
+ * Any exceptions thrown in a worker are re-thrown in the calling thread after all workers have finished.
+ *
+ * Users can override this by defining the `NCLIST_CUSTOM_PARALLEL` function-like macro before including any **nclist** headers.
+ * This should accept the same arguments as `parallelize()`, e.g., to use an existing thread pool or OpenMP.
+ *
+ * @tparam Task_ Integer type of the number of tasks.
+ * @tparam Run_ Function that accepts three arguments:
+ * - `w`, the identity of the worker, in `[0, num_workers)`.
+ * - `start`, the index of the first task in the range to be processed by this worker.
+ * - `length`, the number of tasks in the range.
+ *
+ * @param num_workers Number of workers.
+ * @param num_tasks Number of tasks.
+ * @param run_task_range Function to process a range of tasks.
+ * This is called no more than once for each worker.
+ */
+template<typename Task_, class Run_>
+void parallelize(int num_workers, Task_ num_tasks, Run_ run_task_range) {
+#ifdef NCLIST_CUSTOM_PARALLEL
+    NCLIST_CUSTOM_PARALLEL(num_workers, num_tasks, run_task_range);
+#else
+    if (num_tasks == 0) {
+        return;
+    }
+    if (num_workers <= 1 || num_tasks == 1) {
+        run_task_range(0, static_cast<Task_>(0), num_tasks);
+        return;
+    }
+
+    Task_ per_worker = num_tasks / num_workers;
+    Task_ remainder = num_tasks % num_workers;
+    if (per_worker == 0) {
+        num_workers = num_tasks;
+        per_worker = 1;
+        remainder = 0;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(num_workers);
+    std::vector<std::exception_ptr> errors(num_workers);
+
+    Task_ start = 0;
+    for (int w = 0; w < num_workers; ++w) {
+        Task_ length = per_worker + (static_cast<Task_>(w) < remainder);
+        workers.emplace_back([&run_task_range,&errors](int w, Task_ start, Task_ length) -> void {
+            try {
+                run_task_range(w, start, length);
+            } catch (...) {
+                errors[w] = std::current_exception();
+            }
+        }, w, start, length);
+        start += length;
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (const auto& err : errors) {
+        if (err) {
+            std::rethrow_exception(err);
+        }
+    }
+#endif
+}
+
+}
+
+#endif
@@ -0,0 +1,203 @@
+#ifndef NCLIST_PERMUTE_HPP
+#define NCLIST_PERMUTE_HPP
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+#include "build.hpp"
+#include "overlaps_any.hpp"
+#include "parallelize.hpp"
+
+/**
+ * @file permute.hpp
+ * @brief Permutation tests for overlap enrichment.
+ */
+
+namespace nclist {
+
+/**
+ * @brief Parameters for `permute_overlaps()`.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ */
+template<typename Position_>
+struct PermuteOverlapsParameters {
+    /**
+     * Parameters to define an overlap between query and subject intervals, see `overlaps_any()` for details.
+     */
+    OverlapsAnyParameters<Position_> overlaps;
+
+    /**
+     * Number of permutation iterations.
+     */
+    std::size_t num_iterations = 1000;
+
+    /**
+     * Seed for the random number generator.
+     */
+    std::uint64_t seed = 1234567890;
+
+    /**
+     * Maximum number of attempts to place each query interval within the allowed regions.
+     * An error is thrown if this is exceeded, typically because the query interval is wider than most regions.
+     */
+    std::size_t max_attempts = 1000;
+
+    /**
+     * Number of threads to use.
+     * The parallelization scheme can be modified by defining `NCLIST_CUSTOM_PARALLEL`, see `parallelize()` for details.
+     */
+    int num_threads = 1;
+};
+
+/**
+ * Count the number of query intervals that overlap with at least one subject interval, using `has_overlaps_any()`.
+ * This is typically used to compute the observed statistic for `permute_overlaps()`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param num_queries Number of query intervals.
+ * @param[in] query_starts Pointer to an array of length `num_queries`, containing the start of each query interval.
+ * @param[in] query_ends Pointer to an array of length `num_queries`, containing the non-inclusive end of each query interval.
+ * @param params Parameters to define an overlap, see `overlaps_any()` for details.
+ *
+ * @return Number of overlapping query intervals.
+ */
+template<typename Index_, typename Position_>
+std::size_t count_overlapping_queries(
+    const Nclist<Index_, Position_>& subject,
+    const std::size_t num_queries,
+    const Position_* query_starts,
+    const Position_* query_ends,
+    const OverlapsAnyParameters<Position_>& params)
+{
+    std::size_t count = 0;
+    for (std::size_t q = 0; q < num_queries; ++q) {
+        count += has_overlaps_any(subject, query_starts[q], query_ends[q], params);
+    }
+    return count;
+}
+
+/**
+ * Generate a null distribution for the number of overlapping query intervals by randomly shuffling the query intervals.
+ * In each iteration, each query interval is moved to a random location within the allowed regions while preserving its width.
+ * The number of shuffled query intervals that overlap with at least one subject interval is then computed as in `count_overlapping_queries()`.
+ * This is similar to the permutation tests in the **regioneR** R package or the **GAT** Python package.
+ *
+ * Each query interval is placed by choosing a start position uniformly at random from the allowed regions.
+ * If the shuffled interval extends past the end of its region, it is rejected and a new start position is chosen.
+ * This ensures that each query interval is uniformly distributed across all positions where it fits entirely within a region.
+ *
+ * Each iteration uses a separate random number stream that is seeded from `PermuteOverlapsParameters::seed` and the iteration number.
+ * This means that the results are reproducible regardless of `PermuteOverlapsParameters::num_threads`.
+ *
+ * @tparam Engine_ Random number engine that can be constructed from a `std::seed_seq`.
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param num_queries Number of query intervals.
+ * @param[in] query_starts Pointer to an array of length `num_queries`, containing the start of each query interval.
+ * @param[in] query_ends Pointer to an array of length `num_queries`, containing the non-inclusive end of each query interval.
+ * @param num_regions Number of allowed regions.
+ * @param[in] region_starts Pointer to an array of length `num_regions`, containing the start of each allowed region.
+ * @param[in] region_ends Pointer to an array of length `num_regions`, containing the non-inclusive end of each allowed region.
+ * Regions should not overlap with each other.
+ * @param params Parameters for the permutations.
+ *
+ * @return Vector of length `PermuteOverlapsParameters::num_iterations`, containing the number of overlapping query intervals in each iteration.
+ */
+template<class Engine_ = std::mt19937_64, typename Index_, typename Position_>
+std::vector<std::size_t> permute_overlaps(
+    const Nclist<Index_, Position_>& subject,
+    const std::size_t num_queries,
+    const Position_* query_starts,
+    const Position_* query_ends,
+    const std::size_t num_regions,
+    const Position_* region_starts,
+    const Position_* region_ends,
+    const PermuteOverlapsParameters<Position_>& params)
+{
+    constexpr bool is_integral = std::is_integral<Position_>::value;
+    typedef typename std::conditional<is_integral, unsigned long long, double>::type Total;
+
+    // Cumulative region lengths, for choosing a position uniformly across all regions.
+    std::vector<Total> cumulative;
+    cumulative.reserve(num_regions);
+    Total total = 0;
+    for (std::size_t r = 0; r < num_regions; ++r) {
+        if (region_ends[r] < region_starts[r]) {
+            throw std::runtime_error("region ends should not be less than the region starts");
+        }
+        total += static_cast<Total>(region_ends[r] - region_starts[r]);
+        cumulative.push_back(total);
+    }
+
+    std::vector<Position_> widths(num_queries);
+    for (std::size_t q = 0; q < num_queries; ++q) {
+        widths[q] = query_ends[q] - query_starts[q];
+    }
+
+    std::vector<std::size_t> output(params.num_iterations);
+    if (num_queries == 0) {
+        return output;
+    }
+    if (total == 0) {
+        throw std::runtime_error("allowed regions should have non-zero total length");
+    }
+
+    parallelize(params.num_threads, params.num_iterations, [&](int, std::size_t start, std::size_t length) -> void {
+        typedef typename std::conditional<is_integral, std::uniform_int_distribution<Total>, std::uniform_real_distribution<Total> >::type Distribution;
+        Distribution dist(0, is_integral ? total - 1 : total);
+
+        for (std::size_t it = start, end = start + length; it < end; ++it) {
+            std::seed_seq seq{
+                static_cast<std::uint32_t>(params.seed),
+                static_cast<std::uint32_t>(params.seed >> 32),
+                static_cast<std::uint32_t>(it),
+                static_cast<std::uint32_t>(static_cast<std::uint64_t>(it) >> 32)
+            };
+            Engine_ rng(seq);
+
+            std::size_t count = 0;
+            for (std::size_t q = 0; q < num_queries; ++q) {
+                const auto width = widths[q];
+                std::size_t attempt = 0;
+                while (1) {
+                    if (attempt == params.max_attempts) {
+                        throw std::runtime_error("failed to place a query interval within the allowed regions");
+                    }
+                    ++attempt;
+
+                    const Total draw = dist(rng);
+                    const std::size_t r = std::upper_bound(cumulative.begin(), cumulative.end(), draw) - cumulative.begin();
+                    if (r == num_regions) { // only possible for floating-point draws at the upper limit.
+                        continue;
+                    }
+
+                    const Total offset = draw - (r ? cumulative[r - 1] : 0);
+                    const Position_ shuffled_start = region_starts[r] + static_cast<Position_>(offset);
+                    if (region_ends[r] - shuffled_start < width) {
+                        continue;
+                    }
+
+                    count += has_overlaps_any(subject, shuffled_start, static_cast<Position_>(shuffled_start + width), params.overlaps);
+                    break;
+                }
+            }
+            output[it] = count;
+        }
+    });
+
+    return output;
+}
+
+}
+
+#endif
@@ -0,0 +1,753 @@
+#ifndef NCLIST_RESULTS_HPP
+#define NCLIST_RESULTS_HPP
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include <iterator>
+
+/**
+ * @file results.hpp
+ * @brief Compressed containers for overlap results.
+ */
+
+namespace nclist {
+
+/**
+ * @cond
+ */
+inline int count_bits(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    int count = 0;
+    while (x) {
+        x &= x - 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+inline int lowest_bit(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int pos = 0;
+    while ((x & 1) == 0) {
+        x >>= 1;
+        ++pos;
+    }
+    return pos;
+#endif
+}
+/**
+ * @endcond
+ */
+
+/**
+ * @brief Roaring-style bitmap of subject interval indices.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ *
+ * Indices are partitioned into chunks of 65536 consecutive values.
+ * Each chunk is stored as a sorted array of 16-bit offsets if it is sparse, or as a 65536-bit bitmap if it contains more than 4096 indices.
+ * This provides a compact representation for large sets of overlapping subject intervals that form near-contiguous ranges of indices,
+ * e.g., when a wide query interval overlaps many intervals in a sorted set of reads.
+ *
+ * A `BitmapResults` can be passed directly to `overlaps_any()` and friends in place of a `std::vector` of matches,
+ * in which case each overlapping subject interval is added to the bitmap as soon as it is found by the search.
+ * Similarly, `overlaps_batch()` can fill a separate `BitmapResults` for each query.
+ */
+template<typename Index_>
+class BitmapResults {
+public:
+    /**
+     * Remove all indices from the bitmap.
+     */
+    void clear() {
+        my_chunks.clear();
+        my_size = 0;
+    }
+
+    /**
+     * @return Number of unique indices in the bitmap.
+     */
+    std::size_t size() const {
+        return my_size;
+    }
+
+    /**
+     * @return Whether the bitmap is empty.
+     */
+    bool empty() const {
+        return my_size == 0;
+    }
+
+    /**
+     * @param id Subject interval index to add to the bitmap.
+     * This is ignored if it is already present.
+     */
+    void insert(const Index_ id) {
+        auto& chunk = find_or_create_chunk(id >> chunk_shift);
+        if (add_to_chunk(chunk, id & chunk_mask)) {
+            ++my_size;
+        }
+    }
+
+    /**
+     * @tparam Iterator_ Iterator over subject interval indices.
+     * @param first Start of the range of subject interval indices to add to the bitmap.
+     * @param last End of the range of subject interval indices to add to the bitmap.
+     * Indices may be supplied in any order, e.g., as reported in the `matches` of `overlaps_any()`.
+     * Indices that are already present are ignored.
+     */
+    template<class Iterator_>
+    void insert(Iterator_ first, Iterator_ last) {
+        my_buffer.clear();
+        my_buffer.insert(my_buffer.end(), first, last);
+        std::sort(my_buffer.begin(), my_buffer.end());
+
+        auto bIt = my_buffer.begin(), bEnd = my_buffer.end();
+        while (bIt != bEnd) {
+            const Index_ key = *bIt >> chunk_shift;
+            auto& chunk = find_or_create_chunk(key);
+            do {
+                if (add_to_chunk(chunk, *bIt & chunk_mask)) {
+                    ++my_size;
+                }
+                ++bIt;
+            } while (bIt != bEnd && (*bIt >> chunk_shift) == key);
+        }
+    }
+
+    /**
+     * @param id Subject interval index.
+     * @return Whether `id` is present in the bitmap.
+     */
+    bool contains(const Index_ id) const {
+        const Index_ key = id >> chunk_shift;
+        auto it = std::lower_bound(my_chunks.begin(), my_chunks.end(), key, [](const Chunk& c, Index_ k) -> bool { return c.key < k; });
+        if (it == my_chunks.end() || it->key != key) {
+            return false;
+        }
+        const std::uint16_t low = id & chunk_mask;
+        if (it->bits.empty()) {
+            return std::binary_search(it->array.begin(), it->array.end(), low);
+        } else {
+            return (it->bits[low >> 6] >> (low & 63)) & 1;
+        }
+    }
+
+    /**
+     * @tparam Function_ Function that accepts an `Index_` and returns nothing.
+     * @param fun Function to be called on each index in the bitmap, in increasing order.
+     */
+    template<class Function_>
+    void for_each(Function_ fun) const {
+        for (const auto& chunk : my_chunks) {
+            const Index_ base = chunk.key << chunk_shift;
+            if (chunk.bits.empty()) {
+                for (auto low : chunk.array) {
+                    fun(base | static_cast<Index_>(low));
+                }
+            } else {
+                for (int w = 0; w < words_per_chunk; ++w) {
+                    auto word = chunk.bits[w];
+                    while (word) {
+                        const int b = lowest_bit(word);
+                        fun(base | static_cast<Index_>(w * 64 + b));
+                        word &= word - 1;
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @return Vector of all indices in the bitmap, in increasing order.
+     */
+    std::vector<Index_> to_vector() const {
+        std::vector<Index_> output;
+        output.reserve(my_size);
+        for_each([&](Index_ i) -> void { output.push_back(i); });
+        return output;
+    }
+
+    /**
+     * @return Approximate memory usage of the bitmap's contents, in bytes.
+     */
+    std::size_t bytes() const {
+        std::size_t total = my_chunks.size() * sizeof(Chunk);
+        for (const auto& chunk : my_chunks) {
+            total += chunk.array.size() * sizeof(std::uint16_t) + chunk.bits.size() * sizeof(std::uint64_t);
+        }
+        return total;
+    }
+
+/**
+ * @cond
+ */
+public:
+    static constexpr int chunk_shift = 16;
+    static constexpr Index_ chunk_mask = 65535;
+    static constexpr int words_per_chunk = 1024;
+    static constexpr std::size_t max_array_size = 4096;
+
+    struct Chunk {
+        Chunk() = default;
+        Chunk(Index_ key) : key(key) {}
+        Index_ key = 0;
+        std::size_t count = 0;
+        std::vector<std::uint16_t> array; // used if 'bits' is empty.
+        std::vector<std::uint64_t> bits;
+    };
+
+    std::vector<Chunk> my_chunks;
+    std::size_t my_size = 0;
+    std::vector<Index_> my_buffer;
+
+    Chunk& find_or_create_chunk(const Index_ key) {
+        if (!my_chunks.empty() && my_chunks.back().key < key) { // fast path for sorted insertions.
+            my_chunks.emplace_back(key);
+            return my_chunks.back();
+        }
+        auto it = std::lower_bound(my_chunks.begin(), my_chunks.end(), key, [](const Chunk& c, Index_ k) -> bool { return c.key < k; });
+        if (it == my_chunks.end() || it->key != key) {
+            it = my_chunks.emplace(it, key);
+        }
+        return *it;
+    }
+
+    static void array_to_bitmap(Chunk& chunk) {
+        chunk.bits.resize(words_per_chunk);
+        for (auto low : chunk.array) {
+            chunk.bits[low >> 6] |= static_cast<std::uint64_t>(1) << (low & 63);
+        }
+        chunk.array.clear();
+        chunk.array.shrink_to_fit();
+    }
+
+    static void bitmap_to_array(Chunk& chunk) {
+        chunk.array.clear();
+        chunk.array.reserve(chunk.count);
+        for (int w = 0; w < words_per_chunk; ++w) {
+            auto word = chunk.bits[w];
+            while (word) {
+                chunk.array.push_back(w * 64 + lowest_bit(word));
+                word &= word - 1;
+            }
+        }
+        chunk.bits.clear();
+        chunk.bits.shrink_to_fit();
+    }
+
+    static bool add_to_chunk(Chunk& chunk, const std::uint16_t low) {
+        if (chunk.bits.empty()) {
+            if (chunk.array.empty() || chunk.array.back() < low) { // fast path for sorted insertions.
+                chunk.array.push_back(low);
+            } else {
+                auto it = std::lower_bound(chunk.array.begin(), chunk.array.end(), low);
+                if (*it == low) {
+                    return false;
+                }
+                chunk.array.insert(it, low);
+            }
+            ++chunk.count;
+            if (chunk.count > max_array_size) {
+                array_to_bitmap(chunk);
+            }
+            return true;
+        }
+
+        auto& word = chunk.bits[low >> 6];
+        const auto bit = static_cast<std::uint64_t>(1) << (low & 63);
+        if (word & bit) {
+            return false;
+        }
+        word |= bit;
+        ++chunk.count;
+        return true;
+    }
+/**
+ * @endcond
+ */
+};
+
+/**
+ * @brief Delta-encoded sorted list of subject interval indices.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ *
+ * Indices are stored in increasing order, where each index is represented by its difference from the previous index in a variable-length (LEB128) encoding.
+ * For near-contiguous sets of indices, most differences are small and can be stored in a single byte.
+ * This is more compact than `BitmapResults` for sparse sets but does not support random access or out-of-order insertion.
+ *
+ * A `DeltaResults` can be passed directly to `overlaps_any()` and friends in place of a `std::vector` of matches.
+ * In such cases, overlapping subject intervals that are found out of order are staged in a small buffer that is periodically merged into the encoded list,
+ * so the full set of matches is never held in uncompressed form.
+ * Similarly, `overlaps_batch()` can fill a separate `DeltaResults` for each query.
+ */
+template<typename Index_>
+class DeltaResults {
+public:
+    /**
+     * Remove all indices from the list.
+     */
+    void clear() {
+        my_bytes.clear();
+        my_size = 0;
+        my_last = 0;
+        my_pending.clear();
+    }
+
+    /**
+     * @return Number of unique indices in the list.
+     */
+    std::size_t size() const {
+        return my_size;
+    }
+
+    /**
+     * @return Whether the list is empty.
+     */
+    bool empty() const {
+        return my_size == 0;
+    }
+
+    /**
+     * @param id Subject interval index to append to the list.
+     * This should be greater than all indices already in the list, otherwise it is ignored.
+     */
+    void push_back(const Index_ id) {
+        if (my_size) {
+            if (id <= my_last) {
+                return;
+            }
+            encode(id - my_last);
+        } else {
+            encode(id);
+        }
+        my_last = id;
+        ++my_size;
+    }
+
+    /**
+     * @tparam Iterator_ Iterator over subject interval indices.
+     * @param first Start of the range of subject interval indices to store in the list.
+     * @param last End of the range of subject interval indices to store in the list.
+     * Indices may be supplied in any order, e.g., as reported in the `matches` of `overlaps_any()`.
+     * Any existing contents of the list are discarded.
+     */
+    template<class Iterator_>
+    void assign(Iterator_ first, Iterator_ last) {
+        clear();
+        my_buffer.clear();
+        my_buffer.insert(my_buffer.end(), first, last);
+        std::sort(my_buffer.begin(), my_buffer.end());
+        for (auto x : my_buffer) {
+            push_back(x);
+        }
+    }
+
+    /**
+     * @tparam Function_ Function that accepts an `Index_` and returns nothing.
+     * @param fun Function to be called on each index in the list, in increasing order.
+     */
+    template<class Function_>
+    void for_each(Function_ fun) const {
+        Decoder dec(*this);
+        while (dec.remaining) {
+            fun(dec.next());
+        }
+    }
+
+    /**
+     * @return Vector of all indices in the list, in increasing order.
+     */
+    std::vector<Index_> to_vector() const {
+        std::vector<Index_> output;
+        output.reserve(my_size);
+        for_each([&](Index_ i) -> void { output.push_back(i); });
+        return output;
+    }
+
+    /**
+     * @return Memory usage of the encoded indices, in bytes.
+     */
+    std::size_t bytes() const {
+        return my_bytes.size();
+    }
+
+/**
+ * @cond
+ */
+public:
+    typedef typename std::make_unsigned<Index_>::type Unsigned;
+    std::vector<unsigned char> my_bytes;
+    std::size_t my_size = 0;
+    Index_ my_last = 0;
+    std::vector<Index_> my_buffer;
+    std::vector<Index_> my_pending;
+
+    // Out-of-order insertion for the query functions, see add_match().
+    // The staging buffer is merged into the encoded list once it reaches an eighth of the list's size, so the amortized cost of each merge is small.
+    static constexpr std::size_t min_pending = 1024;
+
+    void stage(const Index_ id) {
+        if (my_pending.empty() && (my_size == 0 || id > my_last)) { // fast path for sorted insertions.
+            push_back(id);
+            return;
+        }
+        my_pending.push_back(id);
+        if (my_pending.size() >= std::max(min_pending, my_size / 8)) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (my_pending.empty()) {
+            return;
+        }
+        std::sort(my_pending.begin(), my_pending.end());
+
+        // push_back() ignores indices that are not greater than the last index, which also removes duplicates.
+        if (my_size == 0 || my_pending.front() > my_last) {
+            for (auto x : my_pending) {
+                push_back(x);
+            }
+        } else {
+            DeltaResults merged;
+            merged.my_bytes.reserve(my_bytes.size() + my_pending.size());
+            Decoder dec(*this);
+            auto pIt = my_pending.begin(), pEnd = my_pending.end();
+            while (dec.remaining) {
+                const auto current = dec.next();
+                while (pIt != pEnd && *pIt < current) {
+                    merged.push_back(*pIt);
+                    ++pIt;
+                }
+                merged.push_back(current);
+            }
+            for (; pIt != pEnd; ++pIt) {
+                merged.push_back(*pIt);
+            }
+            my_bytes.swap(merged.my_bytes);
+            my_size = merged.my_size;
+            my_last = merged.my_last;
+        }
+
+        my_pending.clear();
+    }
+
+    void encode(Index_ delta) {
+        Unsigned x = delta;
+        while (x >= 128) {
+            my_bytes.push_back(static_cast<unsigned char>((x & 127) | 128));
+            x >>= 7;
+        }
+        my_bytes.push_back(static_cast<unsigned char>(x));
+    }
+
+    struct Decoder {
+        Decoder(const DeltaResults& parent) : ptr(parent.my_bytes.data()), remaining(parent.my_size) {}
+        const unsigned char* ptr;
+        std::size_t remaining;
+        Index_ current = 0;
+        bool started = false;
+
+        Index_ next() {
+            Unsigned x = 0;
+            int shift = 0;
+            while (1) {
+                const auto b = *ptr;
+                ++ptr;
+                x |= static_cast<Unsigned>(b & 127) << shift;
+                if ((b & 128) == 0) {
+                    break;
+                }
+                shift += 7;
+            }
+            if (started) {
+                current += x;
+            } else {
+                current = x;
+                started = true;
+            }
+            --remaining;
+            return current;
+        }
+    };
+/**
+ * @endcond
+ */
+};
+
+/**
+ * @cond
+ */
+// Helpers for the query functions to report matches into each type of container.
+// Each search calls start_matches() once, then add_match() or add_matches() for each overlapping subject interval, and finally finish_matches().
+template<typename Index_>
+void start_matches(std::vector<Index_>& matches) {
+    matches.clear();
+}
+
+template<typename Index_>
+void add_match(std::vector<Index_>& matches, const Index_ id) {
+    matches.push_back(id);
+}
+
+template<typename Index_>
+void add_matches(std::vector<Index_>& matches, const Index_* first, const Index_* last) {
+    matches.insert(matches.end(), first, last);
+}
+
+template<typename Index_>
+void finish_matches(std::vector<Index_>&) {}
+
+template<typename Index_>
+void start_matches(BitmapResults<Index_>& matches) {
+    matches.clear();
+}
+
+template<typename Index_>
+void add_match(BitmapResults<Index_>& matches, const Index_ id) {
+    matches.insert(id);
+}
+
+template<typename Index_>
+void add_matches(BitmapResults<Index_>& matches, const Index_* first, const Index_* last) {
+    for (; first != last; ++first) {
+        matches.insert(*first);
+    }
+}
+
+template<typename Index_>
+void finish_matches(BitmapResults<Index_>&) {}
+
+template<typename Index_>
+void start_matches(DeltaResults<Index_>& matches) {
+    matches.clear();
+}
+
+template<typename Index_>
+void add_match(DeltaResults<Index_>& matches, const Index_ id) {
+    matches.stage(id);
+}
+
+template<typename Index_>
+void add_matches(DeltaResults<Index_>& matches, const Index_* first, const Index_* last) {
+    for (; first != last; ++first) {
+        matches.stage(*first);
+    }
+}
+
+template<typename Index_>
+void finish_matches(DeltaResults<Index_>& matches) {
+    matches.flush();
+}
+/**
+ * @endcond
+ */
+
+/**
+ * @tparam Index_ Integer type of the subject interval index.
+ * @param left A set of subject interval indices.
+ * @param right Another set of subject interval indices.
+ * @return The union of `left` and `right`.
+ */
+template<typename Index_>
+BitmapResults<Index_> union_results(const BitmapResults<Index_>& left, const BitmapResults<Index_>& right) {
+    typedef typename BitmapResults<Index_>::Chunk Chunk;
+    BitmapResults<Index_> output;
+    output.my_chunks.reserve(left.my_chunks.size() + right.my_chunks.size());
+
+    auto lIt = left.my_chunks.begin(), lEnd = left.my_chunks.end();
+    auto rIt = right.my_chunks.begin(), rEnd = right.my_chunks.end();
+    while (lIt != lEnd || rIt != rEnd) {
+        if (rIt == rEnd || (lIt != lEnd && lIt->key < rIt->key)) {
+            output.my_chunks.push_back(*lIt);
+            ++lIt;
+        } else if (lIt == lEnd || rIt->key < lIt->key) {
+            output.my_chunks.push_back(*rIt);
+            ++rIt;
+        } else {
+            Chunk current(lIt->key);
+            if (lIt->bits.empty() && rIt->bits.empty()) {
+                current.array.reserve(lIt->array.size() + rIt->array.size());
+                std::set_union(lIt->array.begin(), lIt->array.end(), rIt->array.begin(), rIt->array.end(), std::back_inserter(current.array));
+                current.count = current.array.size();
+                if (current.count > BitmapResults<Index_>::max_array_size) {
+                    BitmapResults<Index_>::array_to_bitmap(current);
+                }
+            } else {
+                current.bits.resize(BitmapResults<Index_>::words_per_chunk);
+                for (const auto* chunk : { &(*lIt), &(*rIt) }) {
+                    if (chunk->bits.empty()) {
+                        for (auto low : chunk->array) {
+                            current.bits[low >> 6] |= static_cast<std::uint64_t>(1) << (low & 63);
+                        }
+                    } else {
+                        for (int w = 0; w < BitmapResults<Index_>::words_per_chunk; ++w) {
+                            current.bits[w] |= chunk->bits[w];
+                        }
+                    }
+                }
+                for (auto word : current.bits) {
+                    current.count += count_bits(word);
+                }
+            }
+            output.my_chunks.push_back(std::move(current));
+            ++lIt;
+            ++rIt;
+        }
+        output.my_size += output.my_chunks.back().count;
+    }
+
+    return output;
+}
+
+/**
+ * @tparam Index_ Integer type of the subject interval index.
+ * @param left A set of subject interval indices.
+ * @param right Another set of subject interval indices.
+ * @return The intersection of `left` and `right`.
+ */
+template<typename Index_>
+BitmapResults<Index_> intersect_results(const BitmapResults<Index_>& left, const BitmapResults<Index_>& right) {
+    typedef typename BitmapResults<Index_>::Chunk Chunk;
+    BitmapResults<Index_> output;
+
+    auto lIt = left.my_chunks.begin(), lEnd = left.my_chunks.end();
+    auto rIt = right.my_chunks.begin(), rEnd = right.my_chunks.end();
+    while (lIt != lEnd && rIt != rEnd) {
+        if (lIt->key < rIt->key) {
+            ++lIt;
+            continue;
+        } else if (rIt->key < lIt->key) {
+            ++rIt;
+            continue;
+        }
+
+        Chunk current(lIt->key);
+        if (lIt->bits.empty() && rIt->bits.empty()) {
+            std::set_intersection(lIt->array.begin(), lIt->array.end(), rIt->array.begin(), rIt->array.end(), std::back_inserter(current.array));
+            current.count = current.array.size();
+        } else if (!lIt->bits.empty() && !rIt->bits.empty()) {
+            current.bits.resize(BitmapResults<Index_>::words_per_chunk);
+            for (int w = 0; w < BitmapResults<Index_>::words_per_chunk; ++w) {
+                current.bits[w] = lIt->bits[w] & rIt->bits[w];
+                current.count += count_bits(current.bits[w]);
+            }
+            if (current.count <= BitmapResults<Index_>::max_array_size) {
+                BitmapResults<Index_>::bitmap_to_array(current);
+            }
+        } else {
+            const auto& sparse = (lIt->bits.empty() ? *lIt : *rIt);
+            const auto& dense = (lIt->bits.empty() ? *rIt : *lIt);
+            for (auto low : sparse.array) {
+                if ((dense.bits[low >> 6] >> (low & 63)) & 1) {
+                    current.array.push_back(low);
+                }
+            }
+            current.count = current.array.size();
+        }
+
+        if (current.count) {
+            output.my_size += current.count;
+            output.my_chunks.push_back(std::move(current));
+        }
+        ++lIt;
+        ++rIt;
+    }
+
+    return output;
+}
+
+/**
+ * @tparam Index_ Integer type of the subject interval index.
+ * @param left A set of subject interval indices.
+ * @param right Another set of subject interval indices.
+ * @return The union of `left` and `right`.
+ */
+template<typename Index_>
+DeltaResults<Index_> union_results(const DeltaResults<Index_>& left, const DeltaResults<Index_>& right) {
+    DeltaResults<Index_> output;
+    typename DeltaResults<Index_>::Decoder ldec(left), rdec(right);
+    bool lvalid = ldec.remaining > 0, rvalid = rdec.remaining > 0;
+    Index_ lval = (lvalid ? ldec.next() : 0), rval = (rvalid ? rdec.next() : 0);
+
+    while (lvalid || rvalid) {
+        if (!rvalid || (lvalid && lval < rval)) {
+            output.push_back(lval);
+            lvalid = ldec.remaining > 0;
+            if (lvalid) {
+                lval = ldec.next();
+            }
+        } else if (!lvalid || rval < lval) {
+            output.push_back(rval);
+            rvalid = rdec.remaining > 0;
+            if (rvalid) {
+                rval = rdec.next();
+            }
+        } else {
+            output.push_back(lval);
+            lvalid = ldec.remaining > 0;
+            if (lvalid) {
+                lval = ldec.next();
+            }
+            rvalid = rdec.remaining > 0;
+            if (rvalid) {
+                rval = rdec.next();
+            }
+        }
+    }
+
+    return output;
+}
+
+/**
+ * @tparam Index_ Integer type of the subject interval index.
+ * @param left A set of subject interval indices.
+ * @param right Another set of subject interval indices.
+ * @return The intersection of `left` and `right`.
+ */
+template<typename Index_>
+DeltaResults<Index_> intersect_results(const DeltaResults<Index_>& left, const DeltaResults<Index_>& right) {
+    DeltaResults<Index_> output;
+    typename DeltaResults<Index_>::Decoder ldec(left), rdec(right);
+    if (ldec.remaining == 0 || rdec.remaining == 0) {
+        return output;
+    }
+
+    Index_ lval = ldec.next(), rval = rdec.next();
+    while (1) {
+        if (lval < rval) {
+            if (ldec.remaining == 0) {
+                break;
+            }
+            lval = ldec.next();
+        } else if (rval < lval) {
+            if (rdec.remaining == 0) {
+                break;
+            }
+            rval = rdec.next();
+        } else {
+            output.push_back(lval);
+            if (ldec.remaining == 0 || rdec.remaining == 0) {
+                break;
+            }
+            lval = ldec.next();
+            rval = rdec.next();
+        }
+    }
+
+    return output;
+}
+
+}
+
+#endif
@@ -0,0 +1,295 @@
+#ifndef NCLIST_SAMPLE_OVERLAPS_HPP
+#define NCLIST_SAMPLE_OVERLAPS_HPP
+
+#include <vector>
+#include <algorithm>
+#include <unordered_set>
+#include <random>
+#include <cstddef>
+#include <numeric>
+
+#include "build.hpp"
+
+/**
+ * @file sample_overlaps.hpp
+ * @brief Randomly sample overlapping intervals.
+ */
+
+namespace nclist {
+
+/**
+ * @brief Number of subject intervals in each subtree of an `Nclist`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ *
+ * Instances of a `SubtreeCounts` are usually created by `build_subtree_counts()`.
+ */
+template<typename Index_>
+struct SubtreeCounts {
+/**
+ * @cond
+ */
+    // `cumulative[i]` is the total number of subject intervals (including duplicates) in the subtrees of `Nclist::nodes[0, i)`.
+    // As sibling nodes are stored contiguously, the number of intervals in the subtrees of siblings `[a, b)` is `cumulative[b] - cumulative[a]`.
+    std::vector<std::size_t> cumulative;
+/**
+ * @endcond
+ */
+};
+
+/**
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @return Number of subject intervals in the subtree of each node in `subject`.
+ */
+template<typename Index_, typename Position_>
+SubtreeCounts<Index_> build_subtree_counts(const Nclist<Index_, Position_>& subject) {
+    const auto num_nodes = subject.nodes.size();
+    std::vector<std::size_t> sizes(num_nodes);
+
+    // Children are always stored after their parents in `Nclist::nodes`,
+    // so a reverse iteration guarantees that all children have been processed before their parent.
+    for (decltype(subject.nodes.size()) i = num_nodes; i > 0; --i) {
+        const auto n = i - 1;
+        const auto& current_node = subject.nodes[n];
+        std::size_t total = 1 + static_cast<std::size_t>(current_node.duplicates_end - current_node.duplicates_start);
+        for (auto c = current_node.children_start; c < current_node.children_end; ++c) {
+            total += sizes[c];
+        }
+        sizes[n] = total;
+    }
+
+    SubtreeCounts<Index_> output;
+    output.cumulative.resize(num_nodes + 1);
+    std::partial_sum(sizes.begin(), sizes.end(), output.cumulative.begin() + 1);
+    return output;
+}
+
+/**
+ * @brief Workspace for `sample_overlaps()`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ *
+ * This holds intermediate data structures that can be re-used across multiple calls to `sample_overlaps()` to avoid reallocations.
+ */
+template<typename Index_>
+struct SampleOverlapsWorkspace {
+    /**
+     * @cond
+     */
+    struct Range {
+        Range() = default;
+        Range(Index_ first, Index_ last) : first(first), last(last) {}
+        Index_ first = 0, last = 0;
+    };
+    std::vector<Range> pending;
+
+    // Each segment is either a single node (if `whole = false`) or the entire subtrees of a contiguous run of sibling nodes.
+    struct Segment {
+        Segment() = default;
+        Segment(Index_ first, Index_ last, bool whole) : first(first), last(last), whole(whole) {}
+        Index_ first = 0, last = 0;
+        bool whole = false;
+    };
+    std::vector<Segment> segments;
+    std::vector<std::size_t> segment_ends;
+
+    std::unordered_set<std::size_t> chosen;
+    /**
+     * @endcond
+     */
+};
+
+/**
+ * @brief Parameters for `sample_overlaps()`.
+ */
+struct SampleOverlapsParameters {
+    /**
+     * Number of overlapping subject intervals to sample.
+     * If this is greater than the total number of overlapping subject intervals and `with_replacement = false`, all overlapping intervals are reported.
+     */
+    std::size_t num_samples = 1;
+
+    /**
+     * Whether to sample with replacement.
+     */
+    bool with_replacement = false;
+};
+
+/**
+ * Randomly sample subject intervals that exhibit any overlap with the query interval.
+ * Each overlapping subject interval (as defined by `overlaps_any()` with default parameters) has equal probability of being sampled.
+ *
+ * This uses per-subtree counts to avoid enumerating all overlapping subject intervals.
+ * Specifically, subtrees that are entirely enclosed by the query interval are counted in constant time and only visited to retrieve a sampled interval.
+ * The cost of this function is proportional to the number of samples multiplied by the depth of the `Nclist`,
+ * plus the number of subject intervals that contain the query start or end positions (as these must be inspected individually).
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam Engine_ A random number engine that can be used with `std::uniform_int_distribution`.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param counts Subtree counts for `subject`, typically built with `build_subtree_counts()`.
+ * @param query_start Start of the query interval.
+ * @param query_end Non-inclusive end of the query interval.
+ * @param params Parameters for sampling.
+ * @param rng Instance of a random number engine.
+ * @param workspace Workspace for intermediate data structures.
+ * This can be default-constructed and re-used across `sample_overlaps()` calls.
+ * @param[out] matches On output, vector of indices of the sampled subject intervals that overlap with the query interval.
+ * Indices are reported in arbitrary order.
+ *
+ * @return Total number of subject intervals that overlap with the query interval.
+ */
+template<typename Index_, typename Position_, class Engine_>
+std::size_t sample_overlaps(
+    const Nclist<Index_, Position_>& subject,
+    const SubtreeCounts<Index_>& counts,
+    const Position_ query_start,
+    const Position_ query_end,
+    const SampleOverlapsParameters& params,
+    Engine_& rng,
+    SampleOverlapsWorkspace<Index_>& workspace,
+    std::vector<Index_>& matches)
+{
+    matches.clear();
+    if (subject.root_children == 0) {
+        return 0;
+    }
+
+    /****************************************
+     * Our aim is to find overlaps to a subject interval `i` where `subject_starts[i] < query_end` and `query_start < subject_ends[i]`.
+     *
+     * For each run of sibling nodes, the overlapping nodes form a contiguous sequence `[first, stop)`.
+     * We find `first` with a binary search (std::upper_bound) on `subject_ends` for `query_start`, as in `overlaps_any()`.
+     * We find `stop` with a binary search (std::lower_bound) on `subject_starts` for `query_end`, which is possible as starts are also sorted for siblings.
+     *
+     * Within `[first, stop)`, we consider the nodes where `query_start < subject_starts[i]` and `subject_ends[i] < query_end`.
+     * All descendents of such nodes must also overlap with the query as they are nested within `[subject_starts[i], subject_ends[i])`.
+     * These nodes form a contiguous subsequence `[enclosed_start, enclosed_end)` as both the starts and ends are sorted among siblings.
+     * The total number of intervals in all of their subtrees can be obtained in constant time from the `SubtreeCounts`.
+     *
+     * The remaining nodes in `[first, enclosed_start)` and `[enclosed_end, stop)` contain the query start or end, respectively.
+     * Each of these nodes is recorded individually and its children are searched in the same manner.
+     *
+     * Once all segments are identified, we sample ranks in `[0, total)` and map each rank to a subject interval.
+     * For segments of entire subtrees, this involves a descent through the NCList where we binary search on the cumulative subtree counts at each level.
+     *
+     ****************************************/
+
+    const auto& cumulative = counts.cumulative;
+    workspace.segments.clear();
+    workspace.segment_ends.clear();
+    workspace.pending.clear();
+    workspace.pending.emplace_back(0, subject.root_children);
+    std::size_t total = 0;
+
+    const auto add_node = [&](const Index_ node) -> void {
+        const auto& current_node = subject.nodes[node];
+        workspace.segments.emplace_back(node, node + 1, false);
+        total += 1 + static_cast<std::size_t>(current_node.duplicates_end - current_node.duplicates_start);
+        workspace.segment_ends.push_back(total);
+        if (current_node.children_start != current_node.children_end) {
+            workspace.pending.emplace_back(current_node.children_start, current_node.children_end);
+        }
+    };
+
+    while (!workspace.pending.empty()) {
+        const auto current = workspace.pending.back();
+        workspace.pending.pop_back();
+
+        const auto sbegin = subject.starts.begin();
+        const auto ebegin = subject.ends.begin();
+        const Index_ first = std::upper_bound(ebegin + current.first, ebegin + current.last, query_start) - ebegin;
+        const Index_ stop = std::lower_bound(sbegin + first, sbegin + current.last, query_end) - sbegin;
+        if (first >= stop) {
+            continue;
+        }
+
+        const Index_ enclosed_start = std::upper_bound(sbegin + first, sbegin + stop, query_start) - sbegin;
+        const Index_ enclosed_end = std::lower_bound(ebegin + enclosed_start, ebegin + stop, query_end) - ebegin;
+
+        for (Index_ i = first; i < enclosed_start; ++i) {
+            add_node(i);
+        }
+        if (enclosed_start < enclosed_end) {
+            workspace.segments.emplace_back(enclosed_start, enclosed_end, true);
+            total += cumulative[enclosed_end] - cumulative[enclosed_start];
+            workspace.segment_ends.push_back(total);
+        }
+        for (Index_ i = enclosed_end; i < stop; ++i) {
+            add_node(i);
+        }
+    }
+
+    if (total == 0 || params.num_samples == 0) {
+        return total;
+    }
+
+    const auto retrieve = [&](std::size_t rank) -> Index_ {
+        const Index_ seg_index = std::upper_bound(workspace.segment_ends.begin(), workspace.segment_ends.end(), rank) - workspace.segment_ends.begin();
+        const auto& seg = workspace.segments[seg_index];
+        std::size_t offset = rank - (seg_index ? workspace.segment_ends[seg_index - 1] : 0);
+        Index_ first = seg.first, last = seg.last;
+
+        while (1) {
+            // Finding the node in [first, last) whose subtree contains 'offset'.
+            const auto base = cumulative[first];
+            const auto cbegin = cumulative.begin();
+            const Index_ node = (std::upper_bound(cbegin + first + 1, cbegin + last + 1, base + offset) - cbegin) - 1;
+            offset -= cumulative[node] - base;
+
+            const auto& current_node = subject.nodes[node];
+            if (offset == 0) {
+                return current_node.id;
+            }
+            const std::size_t num_dups = current_node.duplicates_end - current_node.duplicates_start;
+            if (offset <= num_dups) {
+                return subject.duplicates[current_node.duplicates_start + offset - 1];
+            }
+
+            // This should only happen for a segment containing whole subtrees, as a single node's children are tracked as separate segments.
+            offset -= 1 + num_dups;
+            first = current_node.children_start;
+            last = current_node.children_end;
+        }
+    };
+
+    if (params.with_replacement) {
+        std::uniform_int_distribution<std::size_t> dist(0, total - 1);
+        matches.reserve(params.num_samples);
+        for (std::size_t s = 0; s < params.num_samples; ++s) {
+            matches.push_back(retrieve(dist(rng)));
+        }
+
+    } else if (params.num_samples >= total) {
+        matches.reserve(total);
+        for (std::size_t r = 0; r < total; ++r) {
+            matches.push_back(retrieve(r));
+        }
+
+    } else {
+        // Using Floyd's algorithm to sample distinct ranks without allocating anything proportional to 'total'.
+        auto& chosen = workspace.chosen;
+        chosen.clear();
+        matches.reserve(params.num_samples);
+        for (std::size_t j = total - params.num_samples; j < total; ++j) {
+            std::uniform_int_distribution<std::size_t> dist(0, j);
+            auto candidate = dist(rng);
+            if (!chosen.insert(candidate).second) {
+                chosen.insert(j);
+                candidate = j;
+            }
+            matches.push_back(retrieve(candidate));
+        }
+    }
+
+    return total;
+}
+
+}
+
+#endif
@@ -0,0 +1,184 @@
+#ifndef NCLIST_SIMILARITY_HPP
+#define NCLIST_SIMILARITY_HPP
+
+#include <cstddef>
+#include <algorithm>
+
+#include "build.hpp"
+#include "parallelize.hpp"
+
+/**
+ * @file similarity.hpp
+ * @brief Similarity statistics between two sets of intervals.
+ */
+
+namespace nclist {
+
+/**
+ * @brief Similarity statistics between two sets of intervals.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * These statistics are computed from the union of each set of intervals, i.e., overlapping or contiguous intervals are merged.
+ * This is consistent with the output of `bedtools jaccard`.
+ */
+template<typename Position_>
+struct SimilarityStatistics {
+    /**
+     * Total length of the intersection of the two unions.
+     */
+    Position_ intersection_length = 0;
+
+    /**
+     * Total length of the union of both sets of intervals.
+     */
+    Position_ union_length = 0;
+
+    /**
+     * Jaccard index, i.e., `intersection_length / union_length`.
+     * This is set to zero if `union_length = 0`.
+     */
+    double jaccard = 0;
+
+    /**
+     * Number of disjoint subintervals in the intersection of the two unions.
+     */
+    std::size_t num_intersections = 0;
+};
+
+/**
+ * @cond
+ */
+// Iterates over the merged root intervals of an Nclist. As the root intervals are sorted by both start and end,
+// the union of all subject intervals can be obtained by just merging consecutive root intervals.
+template<typename Index_, typename Position_>
+class RootUnionIterator {
+public:
+    RootUnionIterator(const Nclist<Index_, Position_>& subject) : my_subject(subject) {
+        advance();
+    }
+
+    bool valid() const {
+        return my_valid;
+    }
+
+    Position_ start() const {
+        return my_start;
+    }
+
+    Position_ end() const {
+        return my_end;
+    }
+
+    void advance() {
+        if (my_position == my_subject.root_children) {
+            my_valid = false;
+            return;
+        }
+
+        my_start = my_subject.starts[my_position];
+        my_end = my_subject.ends[my_position];
+        ++my_position;
+        while (my_position < my_subject.root_children && my_subject.starts[my_position] <= my_end) {
+            my_end = my_subject.ends[my_position];
+            ++my_position;
+        }
+        my_valid = true;
+    }
+
+private:
+    const Nclist<Index_, Position_>& my_subject;
+    Index_ my_position = 0;
+    Position_ my_start = 0, my_end = 0;
+    bool my_valid = false;
+};
+
+template<typename Index_, typename Position_>
+Position_ compute_union_length(const Nclist<Index_, Position_>& subject) {
+    Position_ total = 0;
+    RootUnionIterator<Index_, Position_> it(subject);
+    for (; it.valid(); it.advance()) {
+        total += it.end() - it.start();
+    }
+    return total;
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Compute similarity statistics between two sets of intervals.
+ * This performs a single linear merge over the root intervals of each `Nclist`, without considering any of the nested intervals.
+ * No memory is allocated.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param x An `Nclist` of intervals, typically built with `build()`.
+ * @param y Another `Nclist` of intervals.
+ *
+ * @return Similarity statistics between `x` and `y`.
+ */
+template<typename Index_, typename Position_>
+SimilarityStatistics<Position_> compute_similarity(const Nclist<Index_, Position_>& x, const Nclist<Index_, Position_>& y) {
+    SimilarityStatistics<Position_> output;
+
+    RootUnionIterator<Index_, Position_> xit(x), yit(y);
+    while (xit.valid() && yit.valid()) {
+        const auto common_start = std::max(xit.start(), yit.start());
+        const auto common_end = std::min(xit.end(), yit.end());
+        if (common_start < common_end) {
+            output.intersection_length += common_end - common_start;
+            ++output.num_intersections;
+        }
+
+        // Advancing whichever union interval ends first, as it cannot overlap with any later intervals in the other set.
+        const auto xend = xit.end(), yend = yit.end();
+        if (xend <= yend) {
+            xit.advance();
+        }
+        if (yend <= xend) {
+            yit.advance();
+        }
+    }
+
+    output.union_length = compute_union_length(x) + compute_union_length(y) - output.intersection_length;
+    if (output.union_length > 0) {
+        output.jaccard = static_cast<double>(output.intersection_length) / static_cast<double>(output.union_length);
+    }
+    return output;
+}
+
+/**
+ * Compute similarity statistics for many pairs of interval sets, see `compute_similarity()` for details.
+ * Pairs are distributed across threads with `parallelize()`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param[in] sets Pointer to an array of `Nclist`s, each containing a set of intervals.
+ * @param num_pairs Number of pairs of sets.
+ * @param[in] first Pointer to an array of length `num_pairs`, containing the index of the first set of each pair in `sets`.
+ * @param[in] second Pointer to an array of length `num_pairs`, containing the index of the second set of each pair in `sets`.
+ * @param num_threads Number of threads to use.
+ * @param[out] output Pointer to an array of length `num_pairs`.
+ * On output, this contains the similarity statistics for each pair.
+ */
+template<typename Index_, typename Position_>
+void compute_similarity(
+    const Nclist<Index_, Position_>* sets,
+    const std::size_t num_pairs,
+    const std::size_t* first,
+    const std::size_t* second,
+    const int num_threads,
+    SimilarityStatistics<Position_>* output)
+{
+    parallelize(num_threads, num_pairs, [&](int, std::size_t start, std::size_t length) -> void {
+        for (std::size_t p = start, end = start + length; p < end; ++p) {
+            output[p] = compute_similarity(sets[first[p]], sets[second[p]]);
+        }
+    });
+}
+
+}
+
+#endif
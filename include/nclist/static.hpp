@@ -0,0 +1,211 @@
+#ifndef NCLIST_STATIC_HPP
+#define NCLIST_STATIC_HPP
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+#include "build.hpp"
+#include "view.hpp"
+
+/**
+ * @file static.hpp
+ * @brief Build a nested containment list at compile time.
+ */
+
+namespace nclist {
+
+/**
+ * @brief Nested containment list with fixed-size storage.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam num_intervals_ Number of subject intervals.
+ *
+ * This contains the same information as an `Nclist`, but all data is stored in fixed-size arrays so that it can be constructed in a `constexpr` context.
+ * Instances of a `StaticNclist` are usually created by `build_static()`.
+ * They can be searched by creating a view with `make_view()` and passing it to any of the query functions, e.g., `overlaps_any()`.
+ */
+template<typename Index_, typename Position_, std::size_t num_intervals_>
+struct StaticNclist {
+/**
+ * @cond
+ */
+    // Members are the same as those in `Nclist`, except that only the first `num_nodes` entries of `nodes`, `starts` and `ends` are used,
+    // and only the first `num_duplicates` entries of `duplicates` are used.
+    Index_ root_children = 0;
+    Index_ num_nodes = 0;
+    Index_ num_duplicates = 0;
+    std::array<typename Nclist<Index_, Position_>::Node, num_intervals_> nodes{};
+    std::array<Position_, num_intervals_> starts{};
+    std::array<Position_, num_intervals_> ends{};
+    std::array<Index_, num_intervals_> duplicates{};
+/**
+ * @endcond
+ */
+};
+
+/**
+ * Build a nested containment list from fixed-size arrays of start/end positions.
+ * This is a `constexpr` function so it can be used to construct a `StaticNclist` at compile time, e.g., for small annotation tables that are embedded in the binary.
+ * No work is then required at run time to build the nested containment list.
+ *
+ * This uses simple algorithms with quadratic complexity in the worst case, to avoid any dependencies on non-`constexpr` functions like `std::sort()`.
+ * It is only intended for small tables (e.g., hundreds to thousands of intervals), for which compile-time evaluation is still fast.
+ * Larger tables should use `build()` instead.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * This should be explicitly specified.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam num_intervals_ Number of subject intervals.
+ *
+ * @param starts Array containing the start positions of all subject intervals.
+ * @param ends Array containing the end positions of all subject intervals.
+ * The `i`-th subject interval is defined as `[starts[i], ends[i])`.
+ *
+ * @return A `StaticNclist` containing all subject intervals.
+ * Query results for this object are the same as those for the `Nclist` returned by `build()`, though the order of the reported indices may differ.
+ */
+template<typename Index_, typename Position_, std::size_t num_intervals_>
+constexpr StaticNclist<Index_, Position_, num_intervals_> build_static(const std::array<Position_, num_intervals_>& starts, const std::array<Position_, num_intervals_>& ends) {
+    static_assert(num_intervals_ <= static_cast<typename std::make_unsigned<Index_>::type>(std::numeric_limits<Index_>::max()));
+    constexpr Index_ num_intervals = num_intervals_;
+    StaticNclist<Index_, Position_, num_intervals_> output;
+
+    // Insertion sort by increasing start and then DECREASING end, so that the children sort after their parents.
+    std::array<Index_, num_intervals_> order{};
+    for (Index_ i = 0; i < num_intervals; ++i) {
+        const Position_ curstart = starts[i], curend = ends[i];
+        Index_ j = i;
+        while (j > 0) {
+            const Index_ prev = order[j - 1];
+            if (starts[prev] < curstart || (starts[prev] == curstart && ends[prev] >= curend)) {
+                break;
+            }
+            order[j] = prev;
+            --j;
+        }
+        order[j] = i;
+    }
+
+    // Identifying the parent of each node by walking through the sorted intervals with a stack of the currently open nodes, as in `build()`.
+    // Duplicates are adjacent after sorting, so we just count them for each node and store them in order.
+    // 'num_children' and 'children_offset' are used to store the children of each node in a single array with a counting sort.
+    constexpr Index_ no_parent = num_intervals;
+    std::array<Index_, num_intervals_> working_ids{}, parents{}, num_children{}, children_offset{}, dup_start{}, dup_end{};
+    std::array<Index_, num_intervals_> stack{};
+    Index_ stack_size = 0, num_nodes = 0, num_duplicates = 0, num_roots = 0;
+
+    for (Index_ i = 0; i < num_intervals; ++i) {
+        const Index_ curid = order[i];
+        const Position_ curstart = starts[curid], curend = ends[curid];
+
+        if (num_nodes) {
+            const Index_ lastid = working_ids[num_nodes - 1];
+            if (starts[lastid] == curstart && ends[lastid] == curend) {
+                output.duplicates[num_duplicates] = curid;
+                ++num_duplicates;
+                dup_end[num_nodes - 1] = num_duplicates;
+                continue;
+            }
+        }
+
+        while (stack_size && ends[working_ids[stack[stack_size - 1]]] < curend) {
+            --stack_size;
+        }
+
+        working_ids[num_nodes] = curid;
+        dup_start[num_nodes] = num_duplicates;
+        dup_end[num_nodes] = num_duplicates;
+        if (stack_size) {
+            const Index_ parent = stack[stack_size - 1];
+            parents[num_nodes] = parent;
+            ++num_children[parent];
+        } else {
+            parents[num_nodes] = no_parent;
+            ++num_roots;
+        }
+
+        stack[stack_size] = num_nodes;
+        ++stack_size;
+        ++num_nodes;
+    }
+
+    // Collecting the children of each node in sorted order.
+    std::array<Index_, num_intervals_> children{};
+    {
+        Index_ accumulated = 0;
+        for (Index_ k = 0; k < num_nodes; ++k) {
+            children_offset[k] = accumulated;
+            accumulated += num_children[k];
+        }
+        std::array<Index_, num_intervals_> filled{};
+        for (Index_ k = 0; k < num_nodes; ++k) {
+            const Index_ parent = parents[k];
+            if (parent != no_parent) {
+                children[children_offset[parent] + filled[parent]] = k;
+                ++filled[parent];
+            }
+        }
+    }
+
+    // Laying out the nodes in breadth-first order, so that the children of each node are contiguous and follow their parent.
+    // We start with the root nodes and then append the children of each node as it is encountered.
+    std::array<Index_, num_intervals_> layout{};
+    Index_ used = 0;
+    for (Index_ k = 0; k < num_nodes; ++k) {
+        if (parents[k] == no_parent) {
+            layout[used] = k;
+            ++used;
+        }
+    }
+
+    for (Index_ o = 0; o < num_nodes; ++o) {
+        const Index_ k = layout[o];
+        auto& node = output.nodes[o];
+        node.id = working_ids[k];
+        node.duplicates_start = dup_start[k];
+        node.duplicates_end = dup_end[k];
+        output.starts[o] = starts[node.id];
+        output.ends[o] = ends[node.id];
+
+        if (num_children[k]) {
+            node.children_start = used;
+            for (Index_ c = 0; c < num_children[k]; ++c) {
+                layout[used] = children[children_offset[k] + c];
+                ++used;
+            }
+            node.children_end = used;
+        }
+    }
+
+    output.root_children = num_roots;
+    output.num_nodes = num_nodes;
+    output.num_duplicates = num_duplicates;
+    return output;
+}
+
+/**
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam num_intervals_ Number of subject intervals.
+ *
+ * @param subject A `StaticNclist` of subject intervals, typically built with `build_static()`.
+ * @return View of all subject intervals in `subject`.
+ */
+template<typename Index_, typename Position_, std::size_t num_intervals_>
+NclistView<Index_, Position_> make_view(const StaticNclist<Index_, Position_, num_intervals_>& subject) {
+    NclistView<Index_, Position_> output;
+    output.root_start = 0;
+    output.root_end = subject.root_children;
+    output.nodes = subject.nodes.data();
+    output.starts = subject.starts.data();
+    output.ends = subject.ends.data();
+    output.duplicates = subject.duplicates.data();
+    return output;
+}
+
+}
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef NCLIST_TRANSFORM_HPP
+#define NCLIST_TRANSFORM_HPP
+
+#include <type_traits>
+
+#include "build.hpp"
+#include "view.hpp"
+
+/**
+ * @file transform.hpp
+ * @brief Query shifted or flanked subject intervals without rebuilding.
+ */
+
+namespace nclist {
+
+/**
+ * @brief Uniform transformation of all subject intervals.
+ *
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * Each subject interval `[s, e)` is transformed into `[s + shift - flank_start, e + shift + flank_end)`.
+ * The same transformation is applied to all subject intervals, so the nesting of intervals in the `Nclist` is not affected.
+ * For example, promoter regions can be obtained by setting `flank_start = flank_end = 2000` for an `Nclist` of gene bodies.
+ */
+template<typename Position_>
+struct SubjectTransform {
+    /**
+     * Shift to add to the start and end positions of each subject interval.
+     */
+    Position_ shift = 0;
+
+    /**
+     * Flank to subtract from the start position of each subject interval.
+     * This may be negative to shrink the subject intervals from their starts.
+     */
+    Position_ flank_start = 0;
+
+    /**
+     * Flank to add to the end position of each subject interval.
+     * This may be negative to shrink the subject intervals from their ends.
+     */
+    Position_ flank_end = 0;
+};
+
+/**
+ * @cond
+ */
+// Tag for the storage type of a transformed view, where 'Stored_' is the type of the positions in the original view.
+template<typename Stored_>
+struct TransformedStorage {};
+
+template<typename Index_, typename Position_, typename Stored_>
+struct ViewStorage<Index_, Position_, TransformedStorage<Stored_> > {
+    typedef const typename Nclist<Index_, Stored_>::Node* Nodes;
+    typedef OffsetPositions<Position_, Stored_> Starts;
+    typedef OffsetPositions<Position_, Stored_> Ends;
+};
+
+template<typename Position_, typename Stored_>
+OffsetPositions<Position_, Stored_> transform_positions(const OffsetPositions<Position_, Stored_>& positions, const Position_ delta) {
+    return OffsetPositions<Position_, Stored_>(positions.data(), positions.base() + delta);
+}
+
+template<typename Position_>
+OffsetPositions<Position_, Position_> transform_positions(const Position_* positions, const Position_ delta) {
+    return OffsetPositions<Position_, Position_>(positions, delta);
+}
+
+template<typename Index_, typename Position_, typename Stored_, typename Original_>
+NclistView<Index_, Position_, TransformedStorage<Stored_> > transform_view(const NclistView<Index_, Position_, Original_>& subject, const SubjectTransform<Position_>& transform) {
+    NclistView<Index_, Position_, TransformedStorage<Stored_> > output;
+    output.root_start = subject.root_start;
+    output.root_end = subject.root_end;
+    output.nodes = subject.nodes;
+    output.starts = transform_positions(subject.starts, static_cast<Position_>(transform.shift - transform.flank_start));
+    output.ends = transform_positions(subject.ends, static_cast<Position_>(transform.shift + transform.flank_end));
+    output.duplicates = subject.duplicates;
+    return output;
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Create a view where all subject intervals are uniformly shifted and/or flanked.
+ * The view can be passed to any of the query functions, e.g., `overlaps_any()`, `nearest()`,
+ * which will then report the subject intervals that satisfy the search criteria after transformation.
+ * This allows a single `Nclist` to be used for queries against many transformed variants of the subject intervals.
+ *
+ * The transformation is applied on access to each position, so it has no effect on the memory usage of the view.
+ * Users are responsible for ensuring that the transformed positions do not overflow `Position_`.
+ * Transformations that shrink the subject intervals (i.e., negative flanks) may yield negative widths;
+ * these intervals are still searched but are unlikely to give sensible results.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param transform Transformation to apply to each subject interval.
+ *
+ * @return View of all subject intervals in `subject` after transformation.
+ */
+template<typename Index_, typename Position_>
+NclistView<Index_, Position_, TransformedStorage<Position_> > make_view(const Nclist<Index_, Position_>& subject, const SubjectTransform<Position_>& transform) {
+    return transform_view<Index_, Position_, Position_>(make_view(subject), transform);
+}
+
+/**
+ * Overload of `make_view()` to transform the subject intervals in an existing view.
+ * This can be used to transform a view of a subset of root intervals, or a view of a `NarrowNclist` from `build_narrow()`.
+ * Transforming a view that was itself transformed will combine both transformations.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam Stored_ Numeric type for the stored start/end positions of each interval, see `NclistView` for details.
+ *
+ * @param subject View of an `Nclist`, typically created with `make_view()`.
+ * @param transform Transformation to apply to each subject interval.
+ *
+ * @return View of the subject intervals in `subject` after transformation.
+ */
+template<typename Index_, typename Position_, typename Stored_>
+NclistView<Index_, Position_, TransformedStorage<Stored_> > make_view(const NclistView<Index_, Position_, Stored_>& subject, const SubjectTransform<Position_>& transform) {
+    static_assert(std::is_arithmetic<Stored_>::value, "only views of an Nclist or NarrowNclist can be transformed");
+    return transform_view<Index_, Position_, Stored_>(subject, transform);
+}
+
+/**
+ * @cond
+ */
+template<typename Index_, typename Position_, typename Stored_>
+NclistView<Index_, Position_, TransformedStorage<Stored_> > make_view(const NclistView<Index_, Position_, TransformedStorage<Stored_> >& subject, const SubjectTransform<Position_>& transform) {
+    return transform_view<Index_, Position_, Stored_>(subject, transform);
+}
+/**
+ * @endcond
+ */
+
+}
+
+#endif
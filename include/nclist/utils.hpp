@@ -2,6 +2,7 @@
 #define NCLIST_UTILS_HPP
 
 #include <type_traits>
+#include <limits>
 
 namespace nclist {
 
@@ -14,6 +15,15 @@ Position_ safe_subtract_gap(Position_ query_start, Position_ max_gap) {
     }
 }
 
+template<typename Position_>
+Position_ safe_add_gap(Position_ query_end, Position_ max_gap) {
+    if (std::is_integral<Position_>::value && query_end > std::numeric_limits<Position_>::max() - max_gap) {
+        return std::numeric_limits<Position_>::max();
+    } else {
+        return query_end + max_gap;
+    }
+}
+
 template<typename Position_>
 bool diff_above_gap(Position_ pos1, Position_ pos2, Position_ max_gap) {
     if (pos1 > pos2) {
@@ -0,0 +1,239 @@
+#ifndef NCLIST_VIEW_HPP
+#define NCLIST_VIEW_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+#include "build.hpp"
+
+/**
+ * @file view.hpp
+ * @brief Views into a subset of a nested containment list.
+ */
+
+namespace nclist {
+
+/**
+ * @cond
+ */
+// Random-access iterator over positions that are stored as offsets from a base position.
+// This is used in place of a pointer to the positions in an `NclistView`, so that the query functions can be used without modification.
+template<typename Position_, typename Stored_>
+class OffsetPositions {
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef Position_ value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const Position_* pointer;
+    typedef Position_ reference;
+
+    OffsetPositions() = default;
+    OffsetPositions(const Stored_* ptr, Position_ base) : my_ptr(ptr), my_base(base) {}
+
+    const Stored_* data() const {
+        return my_ptr;
+    }
+
+    Position_ base() const {
+        return my_base;
+    }
+
+public:
+    template<typename Offset_>
+    Position_ operator[](Offset_ i) const {
+        return my_base + static_cast<Position_>(my_ptr[i]);
+    }
+
+    Position_ operator*() const {
+        return my_base + static_cast<Position_>(*my_ptr);
+    }
+
+    template<typename Offset_>
+    OffsetPositions operator+(Offset_ i) const {
+        return OffsetPositions(my_ptr + i, my_base);
+    }
+
+    template<typename Offset_>
+    OffsetPositions operator-(Offset_ i) const {
+        return OffsetPositions(my_ptr - i, my_base);
+    }
+
+    difference_type operator-(const OffsetPositions& other) const {
+        return my_ptr - other.my_ptr;
+    }
+
+    OffsetPositions& operator+=(difference_type i) {
+        my_ptr += i;
+        return *this;
+    }
+
+    OffsetPositions& operator-=(difference_type i) {
+        my_ptr -= i;
+        return *this;
+    }
+
+    OffsetPositions& operator++() {
+        ++my_ptr;
+        return *this;
+    }
+
+    OffsetPositions operator++(int) {
+        auto copy = *this;
+        ++my_ptr;
+        return copy;
+    }
+
+    OffsetPositions& operator--() {
+        --my_ptr;
+        return *this;
+    }
+
+    OffsetPositions operator--(int) {
+        auto copy = *this;
+        --my_ptr;
+        return copy;
+    }
+
+    bool operator==(const OffsetPositions& other) const {
+        return my_ptr == other.my_ptr;
+    }
+
+    bool operator!=(const OffsetPositions& other) const {
+        return my_ptr != other.my_ptr;
+    }
+
+    bool operator<(const OffsetPositions& other) const {
+        return my_ptr < other.my_ptr;
+    }
+
+private:
+    const Stored_* my_ptr = NULL;
+    Position_ my_base = 0;
+};
+
+// Types of the members of an `NclistView`, depending on how the positions are stored.
+// This can be specialized for other representations, e.g., compressed storage.
+template<typename Index_, typename Position_, typename Stored_>
+struct ViewStorage {
+    typedef const typename Nclist<Index_, Stored_>::Node* Nodes;
+    typedef typename std::conditional<std::is_same<Position_, Stored_>::value, const Position_*, OffsetPositions<Position_, Stored_> >::type Positions;
+    typedef Positions Starts;
+    typedef Positions Ends;
+};
+/**
+ * @endcond
+ */
+
+/**
+ * @brief View of a contiguous range of root intervals in an `Nclist`.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ * @tparam Stored_ Numeric type for the stored start/end positions of each interval.
+ * This is only different from `Position_` for views of a `NarrowNclist` (see `build_narrow()`) or a `CompressedNclist` (see `compress()`).
+ *
+ * Each root interval and its descendents are self-contained in an `Nclist`,
+ * so any contiguous range of root intervals is itself a valid nested containment list.
+ * An `NclistView` refers to such a range without copying any data, e.g., to split a single `Nclist` across multiple workers or shards.
+ * The view is only valid for the lifetime of the `Nclist` from which it was created.
+ *
+ * The following functions accept an `NclistView` in place of an `Nclist`, in which case only the subject intervals in the view are searched:
+ * `overlaps_any()`, `has_overlaps_any()`, `overlaps_within()`, `overlaps_extend()`, `overlaps_equal()`, `overlaps_start()`, `overlaps_end()`,
+ * `nearest()`, `classify_overlaps()`, `overlaps_batch()` and `overlaps_batch_unique()`.
+ * Other functions (e.g., `overlaps_any_labelled()`, `overlaps_any_grouped()`, `count_reads()`, `compute_similarity()`, `sample_overlaps()` and `permute_overlaps()`)
+ * only accept an `Nclist`, as do `build_equal_index()` and `build_endpoint_index()`.
+ * Instances of an `NclistView` are usually created by `make_view()`.
+ */
+template<typename Index_, typename Position_, typename Stored_ = Position_>
+struct NclistView {
+/**
+ * @cond
+ */
+    // Root intervals of the view are `nodes[i]` for `i` in `[root_start, root_end)`.
+    Index_ root_start = 0;
+    Index_ root_end = 0;
+
+    // These point to the start of the corresponding vectors in the `Nclist`.
+    // Nodes are not re-indexed, so the children and duplicates of each node are defined as described in `Nclist`.
+    // For narrowed positions, `starts` and `ends` add the base position to each stored offset on access.
+    // For compressed storage, `nodes`, `starts` and `ends` decompress the relevant block on access.
+    typename ViewStorage<Index_, Position_, Stored_>::Nodes nodes{};
+    typename ViewStorage<Index_, Position_, Stored_>::Starts starts{};
+    typename ViewStorage<Index_, Position_, Stored_>::Ends ends{};
+    const Index_* duplicates = NULL;
+/**
+ * @endcond
+ */
+};
+
+/**
+ * @cond
+ */
+// Per-worker copy of a view for parallel searches, e.g., in `overlaps_batch()`.
+// Most views can be shared between workers, but this can be specialized for storage types that modify their own state on access.
+template<typename Index_, typename Position_, typename Stored_>
+class ViewWorkerState {
+public:
+    const NclistView<Index_, Position_, Stored_>& get(const NclistView<Index_, Position_, Stored_>& original) {
+        return original;
+    }
+};
+/**
+ * @endcond
+ */
+
+/**
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @return View of all subject intervals in `subject`.
+ */
+template<typename Index_, typename Position_>
+NclistView<Index_, Position_> make_view(const Nclist<Index_, Position_>& subject) {
+    NclistView<Index_, Position_> output;
+    output.root_start = 0;
+    output.root_end = subject.root_children;
+    output.nodes = subject.nodes.data();
+    output.starts = subject.starts.data();
+    output.ends = subject.ends.data();
+    output.duplicates = subject.duplicates.data();
+    return output;
+}
+
+/**
+ * Create a view of the root intervals (and their descendents) that overlap a coordinate window.
+ * Any query interval that lies within the window will give the same results for the view as for the full `subject`,
+ * as long as overlaps are defined without a maximum gap (or with a window that is sufficiently extended).
+ * This makes it easy to partition a single `Nclist` across workers that are responsible for different coordinate ranges.
+ *
+ * Note that a single root interval may be present in views for adjacent windows if it overlaps both windows.
+ * Users should take care to avoid double-counting when combining results across views.
+ *
+ * @tparam Index_ Integer type of the subject interval index.
+ * @tparam Position_ Numeric type for the start/end positions of each interval.
+ *
+ * @param subject An `Nclist` of subject intervals, typically built with `build()`.
+ * @param window_start Start of the window.
+ * @param window_end Non-inclusive end of the window.
+ *
+ * @return View of all root intervals in `subject` where `subject_starts[i] < window_end` and `window_start < subject_ends[i]`.
+ */
+template<typename Index_, typename Position_>
+NclistView<Index_, Position_> make_view(const Nclist<Index_, Position_>& subject, const Position_ window_start, const Position_ window_end) {
+    auto output = make_view(subject);
+
+    // Root intervals are sorted by both start and end positions, so the overlapping intervals form a contiguous range.
+    const auto sbegin = subject.starts.begin();
+    const auto ebegin = subject.ends.begin();
+    output.root_start = std::upper_bound(ebegin, ebegin + subject.root_children, window_start) - ebegin;
+    output.root_end = std::lower_bound(sbegin + output.root_start, sbegin + subject.root_children, window_end) - sbegin;
+
+    return output;
+}
+
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef NCLIST_PERF_ANNOTATION_HPP
+#define NCLIST_PERF_ANNOTATION_HPP
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+
+// Simulating a gene annotation for a single chromosome, with genes, transcripts and exons as separate intervals.
+// Sizes are loosely modelled on GENCODE: log-normal gene lengths (median ~20 kb), 1-8 transcripts per gene,
+// and log-normal exon lengths (median ~150 bp), where exons are drawn from a per-gene pool so that they are often shared between transcripts.
+struct Annotation {
+    std::vector<std::int32_t> starts, ends;
+    std::vector<int> genes; // gene index for each interval.
+    std::vector<unsigned char> exons; // whether each interval is an exon, as opposed to a gene or transcript.
+};
+
+inline Annotation simulate_annotation(int num_genes, std::int32_t chromosome_length, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::lognormal_distribution<double> gene_length(std::log(20000.0), 1.2);
+    std::lognormal_distribution<double> exon_length(std::log(150.0), 0.8);
+    std::uniform_int_distribution<std::int32_t> gene_start(0, chromosome_length);
+
+    Annotation output;
+    std::vector<std::pair<std::int32_t, std::int32_t> > pool;
+    for (int g = 0; g < num_genes; ++g) {
+        const auto gstart = gene_start(rng);
+        const auto glen = std::max<std::int32_t>(200, std::min<double>(gene_length(rng), 2e6));
+        const auto gend = gstart + glen;
+        output.starts.push_back(gstart);
+        output.ends.push_back(gend);
+        output.genes.push_back(g);
+        output.exons.push_back(false);
+
+        pool.clear();
+        const int num_exons = 2 + rng() % 20;
+        for (int e = 0; e < num_exons; ++e) {
+            const auto elen = std::max<std::int32_t>(20, std::min<double>(exon_length(rng), glen));
+            const auto estart = gstart + static_cast<std::int32_t>(rng() % (glen - elen + 1));
+            pool.emplace_back(estart, estart + elen);
+        }
+        std::sort(pool.begin(), pool.end());
+
+        const int num_transcripts = 1 + rng() % 8;
+        for (int t = 0; t < num_transcripts; ++t) {
+            std::int32_t tstart = gend, tend = gstart;
+            for (const auto& ex : pool) {
+                if (rng() % 3 != 0) {
+                    output.starts.push_back(ex.first);
+                    output.ends.push_back(ex.second);
+                    output.genes.push_back(g);
+                    output.exons.push_back(true);
+                    tstart = std::min(tstart, ex.first);
+                    tend = std::max(tend, ex.second);
+                }
+            }
+            if (tstart < tend) {
+                output.starts.push_back(tstart);
+                output.ends.push_back(tend);
+                output.genes.push_back(g);
+                output.exons.push_back(false);
+            }
+        }
+    }
+
+    return output;
+}
+
+#endif
@@ -0,0 +1,233 @@
+#include "nclist/nclist.hpp"
+#include "annotation.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+
+// Usage: batch [NUM_GENES] [NUM_QUERIES]
+int main(int argc, char** argv) {
+    const int num_genes = (argc > 1 ? std::stoi(argv[1]) : 20000);
+    const std::size_t num_queries = (argc > 2 ? std::stoull(argv[2]) : 10000000);
+    const std::int32_t chromosome_length = 250000000;
+
+    const auto annotation = simulate_annotation(num_genes, chromosome_length, 42);
+    const int num_subjects = annotation.starts.size();
+    const auto index = nclist::build(num_subjects, annotation.starts.data(), annotation.ends.data());
+    const int num_roots = index.root_children;
+    std::cout << "Intervals: " << num_subjects << " (" << num_roots << " roots)" << std::endl;
+
+    // Unsorted 100-bp queries, e.g., reads from an unsorted BAM file.
+    std::mt19937_64 rng(100);
+    std::vector<std::int32_t> qstarts, qends;
+    for (std::size_t q = 0; q < num_queries; ++q) {
+        const std::int32_t start = rng() % chromosome_length;
+        qstarts.push_back(start);
+        qends.push_back(start + 100);
+    }
+
+    const auto time = [&](const std::string& name, auto fun) -> double {
+        const auto start = std::chrono::steady_clock::now();
+        const auto total = fun();
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << name << ": " << elapsed << " s (" << total << ")" << std::endl;
+        return elapsed;
+    };
+
+    // Narrowing of the root range on its own, i.e., the part of overlaps_batch() that uses the lockstep search.
+    std::vector<int> narrowed(num_queries);
+    time("Root search, std::lower_bound()", [&]() -> std::size_t {
+        const auto ends = index.ends.data();
+        for (std::size_t q = 0; q < num_queries; ++q) {
+            narrowed[q] = std::lower_bound(ends, ends + num_roots, qstarts[q]) - ends;
+        }
+        return std::accumulate(narrowed.begin(), narrowed.end(), static_cast<std::size_t>(0));
+    });
+    time("Root search, lockstep_lower_bound()", [&]() -> std::size_t {
+        nclist::lockstep_lower_bound(index.ends.data(), num_roots, num_queries, qstarts.data(), narrowed.data());
+        return std::accumulate(narrowed.begin(), narrowed.end(), static_cast<std::size_t>(0));
+    });
+
+    // Full searches.
+    time("overlaps_any() loop", [&]() -> std::size_t {
+        // Storing the results in the same format as overlaps_batch() for a fair comparison.
+        nclist::OverlapsAnyWorkspace<int> workspace;
+        nclist::OverlapsAnyParameters<std::int32_t> params;
+        std::vector<int> matches, all_matches;
+        std::vector<std::size_t> offsets { 0 };
+        for (std::size_t q = 0; q < num_queries; ++q) {
+            nclist::overlaps_any(index, qstarts[q], qends[q], params, workspace, matches);
+            all_matches.insert(all_matches.end(), matches.begin(), matches.end());
+            offsets.push_back(all_matches.size());
+        }
+        return all_matches.size();
+    });
+    time("overlaps_batch()", [&]() -> std::size_t {
+        nclist::OverlapsBatchParameters<std::int32_t> params;
+        std::vector<std::size_t> offsets;
+        std::vector<int> matches;
+        nclist::overlaps_batch(index, num_queries, qstarts.data(), qends.data(), params, offsets, matches);
+        return matches.size();
+    });
+
+    // Deduplication, for the random queries above (where only ~2% are duplicated by chance) and for a batch where each query occurs 5 times on average,
+    // e.g., duplicate reads from deep sequencing. The latter is sampled at random so that identical queries are not adjacent.
+    std::vector<std::int32_t> dstarts, dends;
+    {
+        const std::size_t num_unique = num_queries / 5;
+        for (std::size_t q = 0; q < num_queries; ++q) {
+            const auto chosen = rng() % num_unique;
+            dstarts.push_back(qstarts[chosen]);
+            dends.push_back(qends[chosen]);
+        }
+    }
+
+    const auto time_dedup = [&](const std::string& name, const std::vector<std::int32_t>& starts, const std::vector<std::int32_t>& ends) -> void {
+        nclist::OverlapsBatchParameters<std::int32_t> params;
+        std::vector<std::size_t> unique_queries, query_to_unique;
+        time("Unique queries, " + name + ", hash table", [&]() -> std::size_t {
+            nclist::find_unique_batch_queries(num_queries, starts.data(), ends.data(), params, unique_queries, query_to_unique);
+            return unique_queries.size();
+        });
+
+        // Alternative that sorts the query indices by position and assigns the same unique index to each run of identical queries.
+        time("Unique queries, " + name + ", sorting", [&]() -> std::size_t {
+            std::vector<std::size_t> order(num_queries);
+            std::iota(order.begin(), order.end(), static_cast<std::size_t>(0));
+            std::sort(order.begin(), order.end(), [&](const std::size_t left, const std::size_t right) -> bool {
+                if (starts[left] != starts[right]) {
+                    return starts[left] < starts[right];
+                } else if (ends[left] != ends[right]) {
+                    return ends[left] < ends[right];
+                } else {
+                    return left < right;
+                }
+            });
+            unique_queries.clear();
+            query_to_unique.resize(num_queries);
+            for (std::size_t i = 0; i < num_queries; ++i) {
+                const auto q = order[i];
+                if (i == 0 || starts[order[i - 1]] != starts[q] || ends[order[i - 1]] != ends[q]) {
+                    unique_queries.push_back(q);
+                }
+                query_to_unique[q] = unique_queries.size() - 1;
+            }
+            return unique_queries.size();
+        });
+
+        for (bool dedup : { false, true }) {
+            time("overlaps_batch(), " + name + ", deduplicate = " + (dedup ? "true" : "false"), [&]() -> std::size_t {
+                params.deduplicate = dedup;
+                std::vector<std::size_t> offsets;
+                std::vector<int> matches;
+                nclist::overlaps_batch(index, num_queries, starts.data(), ends.data(), params, offsets, matches);
+                return matches.size();
+            });
+        }
+    };
+    time_dedup("few duplicates", qstarts, qends);
+    time_dedup("5x duplicates", dstarts, dends);
+
+    // Multi-scale windows from 1 kb to 100 kb, each tiling the chromosome with a step of half the window width.
+    // Each window is nested within a window of the next scale (as each scale is at least twice the previous one), so these are ideal for reuse_nested = true.
+    const std::vector<std::int32_t> scales { 1000, 2000, 5000, 10000, 20000, 50000, 100000 };
+    std::vector<std::int32_t> wstarts, wends;
+    std::vector<std::size_t> scale_starts { 0 };
+    for (auto width : scales) {
+        for (std::int32_t start = 0; start < chromosome_length; start += width / 2) {
+            wstarts.push_back(start);
+            wends.push_back(start + width);
+        }
+        scale_starts.push_back(wstarts.size());
+    }
+    const std::size_t num_windows = wstarts.size();
+    std::cout << "Multi-scale windows: " << num_windows << std::endl;
+
+    // Calibrating the cost model in overlaps_any_nested() by timing each of its operations separately:
+    // the root binary search per level, the traversal per reported node, and the filtering of the containing window's nodes per cached node.
+    {
+        const auto view = nclist::make_view(index);
+        nclist::OverlapsAnyParameters<std::int32_t> params;
+        nclist::OverlapsAnyWorkspace<int> workspace;
+        std::vector<std::vector<int> > nodes(num_windows);
+        std::size_t num_reported = 0, num_cached = 0;
+
+        const auto root_time = time("Windows, root search", [&]() -> std::size_t {
+            const auto ends = index.ends.data();
+            std::size_t total = 0;
+            for (std::size_t w = 0; w < num_windows; ++w) {
+                total += std::upper_bound(ends, ends + num_roots, wstarts[w]) - ends;
+            }
+            return total;
+        });
+        const auto traversal_time = time("Windows, traversal", [&]() -> std::size_t {
+            for (std::size_t w = 0; w < num_windows; ++w) {
+                auto& current = nodes[w];
+                nclist::overlaps_any_nodes(view, wstarts[w], wends[w], params, workspace, [&](int node) -> bool { current.push_back(node); return true; });
+                num_reported += current.size();
+            }
+            return num_reported;
+        });
+
+        std::vector<int> filtered;
+        const auto filter_time = time("Windows, filtering", [&]() -> std::size_t {
+            std::size_t total = 0;
+            for (std::size_t s = 0; s + 1 < scales.size(); ++s) {
+                const std::int32_t outer_step = scales[s + 1] / 2;
+                for (std::size_t w = scale_starts[s]; w < scale_starts[s + 1]; ++w) {
+                    const auto& outer = nodes[scale_starts[s + 1] + wstarts[w] / outer_step];
+                    filtered.clear();
+                    for (auto node : outer) {
+                        if (nclist::overlaps_any_matches<std::int32_t>(index.starts[node], index.ends[node], wstarts[w], wends[w], params)) {
+                            filtered.push_back(node);
+                        }
+                    }
+                    num_cached += outer.size();
+                    total += filtered.size();
+                }
+            }
+            return total;
+        });
+
+        int num_levels = 0;
+        for (int r = num_roots; r > 0; r /= 2) {
+            ++num_levels;
+        }
+        const double per_filter = filter_time / num_cached;
+        std::cout << "Cost per traversed node: " << (traversal_time - root_time) / num_reported / per_filter << " filtered nodes" << std::endl;
+        std::cout << "Cost per root search level: " << root_time / (num_windows * num_levels) / per_filter << " filtered nodes" << std::endl;
+    }
+
+    // Full searches with and without re-use of nested results, for the multi-scale windows and for sliding 10 kb windows with a 1 kb step.
+    // The latter are of equal width and are never nested, so reuse_nested = true only adds the cost of sorting and caching.
+    std::vector<std::int32_t> sstarts, sends;
+    for (std::int32_t start = 0; start < chromosome_length; start += 1000) {
+        sstarts.push_back(start);
+        sends.push_back(start + 10000);
+    }
+
+    // Each search is repeated 10 times as a single search only takes a fraction of a second.
+    const auto time_nested = [&](const std::string& name, const std::vector<std::int32_t>& starts, const std::vector<std::int32_t>& ends) -> void {
+        for (bool reuse : { false, true }) {
+            time("overlaps_batch() x 10, " + name + ", reuse_nested = " + (reuse ? "true" : "false"), [&]() -> std::size_t {
+                nclist::OverlapsBatchParameters<std::int32_t> params;
+                params.reuse_nested = reuse;
+                std::vector<std::size_t> offsets;
+                std::vector<int> matches;
+                for (int r = 0; r < 10; ++r) {
+                    nclist::overlaps_batch(index, starts.size(), starts.data(), ends.data(), params, offsets, matches);
+                }
+                return matches.size();
+            });
+        }
+    };
+    time_nested("multi-scale windows", wstarts, wends);
+    time_nested("sliding windows", sstarts, sends);
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include "nclist/nclist.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Tracking the current and peak heap usage by replacing the global allocation functions.
+// Each allocation is prefixed with its size so that it can be subtracted on deallocation.
+static std::size_t current_bytes = 0, peak_bytes = 0;
+
+void* operator new(std::size_t size) {
+    constexpr std::size_t header = alignof(std::max_align_t);
+    auto ptr = static_cast<unsigned char*>(std::malloc(size + header));
+    if (ptr == NULL) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<std::size_t*>(ptr) = size;
+    current_bytes += size;
+    peak_bytes = std::max(peak_bytes, current_bytes);
+    return ptr + header;
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr == NULL) {
+        return;
+    }
+    constexpr std::size_t header = alignof(std::max_align_t);
+    auto base = static_cast<unsigned char*>(ptr) - header;
+    current_bytes -= *reinterpret_cast<std::size_t*>(base);
+    std::free(base);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+// Usage: build [NUM_INTERVALS]
+int main(int argc, char** argv) {
+    const int num_intervals = (argc > 1 ? std::stoi(argv[1]) : 5000000);
+
+    // Mostly short intervals with some long ones for nesting, and 2% duplicates.
+    std::mt19937_64 rng(42);
+    std::vector<int> starts, ends;
+    starts.reserve(num_intervals);
+    ends.reserve(num_intervals);
+    for (int i = 0; i < num_intervals; ++i) {
+        if (i > 0 && rng() % 50 == 0) {
+            starts.push_back(starts.back());
+            ends.push_back(ends.back());
+        } else {
+            const int start = rng() % 1000000000;
+            starts.push_back(start);
+            ends.push_back(start + 1 + rng() % (rng() % 20 == 0 ? 100000 : 1000));
+        }
+    }
+
+    const auto run = [&](const std::string& name, auto fun) -> void {
+        const auto baseline = current_bytes;
+        peak_bytes = current_bytes;
+        const auto start = std::chrono::steady_clock::now();
+        const auto index = fun();
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const auto final_bytes = current_bytes - baseline;
+        std::cout << name << ": " << elapsed << " s, peak " << (peak_bytes - baseline) / 1e6 << " MB, final " << final_bytes / 1e6 << " MB (" << index.nodes.size() << " nodes)" << std::endl;
+    };
+
+    for (int r = 0; r < 3; ++r) {
+        run("build()", [&]() { return nclist::build(num_intervals, starts.data(), ends.data()); });
+        run("build_low_memory()", [&]() { return nclist::build_low_memory(num_intervals, starts.data(), ends.data()); });
+    }
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include "nclist/nclist.hpp"
+#include "annotation.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+// Usage: compressed [NUM_GENES] [NUM_QUERIES]
+int main(int argc, char** argv) {
+    const int num_genes = (argc > 1 ? std::stoi(argv[1]) : 5000);
+    const int num_queries = (argc > 2 ? std::stoi(argv[2]) : 1000000);
+    const std::int32_t chromosome_length = 250000000;
+
+    const auto annotation = simulate_annotation(num_genes, chromosome_length, 42);
+    const int num_subjects = annotation.starts.size();
+    const auto full = nclist::build(num_subjects, annotation.starts.data(), annotation.ends.data());
+    const auto comp = nclist::compress(full);
+
+    const std::size_t full_size = full.nodes.size() * sizeof(full.nodes[0]) + (full.starts.size() + full.ends.size()) * sizeof(std::int32_t);
+    const std::size_t comp_size = nclist::compressed_size(comp);
+    std::cout << "Intervals: " << num_subjects << " (" << full.nodes.size() << " unique)" << std::endl;
+    std::cout << "Uncompressed nodes and positions: " << full_size << " bytes" << std::endl;
+    std::cout << "Compressed nodes and positions: " << comp_size << " bytes" << std::endl;
+    std::cout << "Ratio: " << static_cast<double>(full_size) / comp_size << std::endl;
+
+    // Read-like queries, where each query is processed separately with a windowed view.
+    std::mt19937_64 rng(100);
+    std::vector<std::int32_t> qstarts, qends;
+    for (int q = 0; q < num_queries; ++q) {
+        const std::int32_t start = rng() % chromosome_length;
+        qstarts.push_back(start);
+        qends.push_back(start + 100);
+    }
+
+    nclist::OverlapsAnyWorkspace<int> workspace;
+    nclist::OverlapsAnyParameters<std::int32_t> params;
+    std::vector<int> matches;
+
+    const auto run = [&](const std::string& name, auto fun) -> void {
+        std::size_t total = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int q = 0; q < num_queries; ++q) {
+            fun(qstarts[q], qends[q]);
+            total += matches.size();
+        }
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << name << ": " << elapsed << " s (" << total << " matches)" << std::endl;
+    };
+
+    // Random queries are the worst case for a bounded workspace, while sorted queries (e.g., from a coordinate-sorted BAM file) only need a few blocks at a time.
+    for (int sorted = 0; sorted < 2; ++sorted) {
+        if (sorted) {
+            std::sort(qstarts.begin(), qstarts.end());
+            for (int q = 0; q < num_queries; ++q) {
+                qends[q] = qstarts[q] + 100;
+            }
+        }
+        std::cout << (sorted ? "Sorted" : "Random") << " queries:" << std::endl;
+
+        run("  Uncompressed", [&](std::int32_t s, std::int32_t e) -> void {
+            nclist::overlaps_any(full, s, e, params, workspace, matches);
+        });
+
+        for (std::size_t limit : { static_cast<std::size_t>(0), nclist::compressed_workspace_max_blocks, static_cast<std::size_t>(64) }) {
+            nclist::CompressedNclistWorkspace<int, std::int32_t> cwork(limit);
+            run("  Compressed (limit " + std::to_string(limit) + ")", [&](std::int32_t s, std::int32_t e) -> void {
+                nclist::overlaps_any(nclist::make_view(comp, cwork, s, e), s, e, params, workspace, matches);
+            });
+            std::cout << "    decompressed blocks retained: " << cwork.num_decompressed() << " of " << comp.block_min_starts.size() << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include "nclist/nclist.hpp"
+#include "annotation.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+// Usage: count_reads [NUM_GENES] [NUM_READS] [CHUNK_SIZE] [NUM_THREADS]
+int main(int argc, char** argv) {
+    const int num_genes = (argc > 1 ? std::stoi(argv[1]) : 20000);
+    const std::size_t num_reads = (argc > 2 ? std::stoull(argv[2]) : 100000000);
+    const std::size_t chunk_size = (argc > 3 ? std::stoull(argv[3]) : 1000000);
+    const int num_threads = (argc > 4 ? std::stoi(argv[4]) : 1);
+    const std::int32_t chromosome_length = 250000000;
+
+    // Only using the exons as subject intervals, with each gene as a feature.
+    const auto annotation = simulate_annotation(num_genes, chromosome_length, 42);
+    std::vector<std::int32_t> exon_starts, exon_ends;
+    std::vector<int> exon_genes;
+    for (std::size_t i = 0, end = annotation.starts.size(); i < end; ++i) {
+        if (annotation.exons[i]) {
+            exon_starts.push_back(annotation.starts[i]);
+            exon_ends.push_back(annotation.ends[i]);
+            exon_genes.push_back(annotation.genes[i]);
+        }
+    }
+    const int num_exons = exon_starts.size();
+    const auto index = nclist::build(num_exons, exon_starts.data(), exon_ends.data());
+    const auto features = nclist::build_feature_map(index, num_exons, exon_genes.data(), num_genes);
+    std::cout << "Exons: " << num_exons << ", genes: " << num_genes << std::endl;
+
+    // RNA-seq-like reads of 100 bp, where 90% are placed near an exon and the rest are scattered across the chromosome.
+    // 20% of the reads are spliced into two blocks, separated by an intron of up to 5 kb.
+    std::mt19937_64 rng(100);
+    std::vector<std::size_t> offsets;
+    std::vector<std::int32_t> block_starts, block_ends;
+    const auto simulate_chunk = [&](std::size_t count) -> void {
+        offsets.clear();
+        block_starts.clear();
+        block_ends.clear();
+        offsets.push_back(0);
+        for (std::size_t r = 0; r < count; ++r) {
+            std::int32_t start;
+            if (rng() % 10 != 0) {
+                const auto e = rng() % num_exons;
+                start = exon_starts[e] - 50 + static_cast<std::int32_t>(rng() % (exon_ends[e] - exon_starts[e] + 1));
+            } else {
+                start = rng() % chromosome_length;
+            }
+            if (rng() % 5 == 0) {
+                block_starts.push_back(start);
+                block_ends.push_back(start + 60);
+                const std::int32_t next = start + 60 + 100 + static_cast<std::int32_t>(rng() % 4900);
+                block_starts.push_back(next);
+                block_ends.push_back(next + 40);
+            } else {
+                block_starts.push_back(start);
+                block_ends.push_back(start + 100);
+            }
+            offsets.push_back(block_starts.size());
+        }
+    };
+
+    nclist::CountReadsParameters<std::int32_t> params;
+    params.num_threads = num_threads;
+    nclist::CountReadsResults total;
+    total.counts.resize(num_genes);
+    double engine_time = 0;
+
+    // Hand-written loop over overlaps_any() for comparison, i.e., what users had to do before count_reads().
+    nclist::OverlapsAnyWorkspace<int> workspace;
+    nclist::OverlapsAnyParameters<std::int32_t> any_params;
+    std::vector<int> matches, hits;
+    std::vector<double> manual_counts(num_genes);
+    double manual_time = 0;
+
+    for (std::size_t processed = 0; processed < num_reads; processed += chunk_size) {
+        const auto count = std::min(chunk_size, num_reads - processed);
+        simulate_chunk(count);
+
+        auto start = std::chrono::steady_clock::now();
+        const auto res = nclist::count_reads(index, features, count, offsets.data(), block_starts.data(), block_ends.data(), params);
+        engine_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        for (int g = 0; g < num_genes; ++g) {
+            total.counts[g] += res.counts[g];
+        }
+        total.assigned += res.assigned;
+        total.ambiguous += res.ambiguous;
+        total.no_features += res.no_features;
+
+        start = std::chrono::steady_clock::now();
+        for (std::size_t r = 0; r < count; ++r) {
+            hits.clear();
+            for (auto b = offsets[r], bend = offsets[r + 1]; b < bend; ++b) {
+                nclist::overlaps_any(index, block_starts[b], block_ends[b], any_params, workspace, matches);
+                for (auto m : matches) {
+                    hits.push_back(exon_genes[m]);
+                }
+            }
+            std::sort(hits.begin(), hits.end());
+            hits.erase(std::unique(hits.begin(), hits.end()), hits.end());
+            if (hits.size() == 1) {
+                manual_counts[hits.front()] += 1;
+            }
+        }
+        manual_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::cout << "Reads: " << num_reads << " (assigned " << total.assigned << ", ambiguous " << total.ambiguous << ", no features " << total.no_features << ")" << std::endl;
+    std::cout << "count_reads(): " << engine_time << " s (" << num_reads / engine_time / 1e6 << " M reads/s)" << std::endl;
+    std::cout << "Manual loop: " << manual_time << " s (" << num_reads / manual_time / 1e6 << " M reads/s)" << std::endl;
+    std::cout << "Identical counts: " << (total.counts == manual_counts ? "yes" : "no") << std::endl;
+    return 0;
+}
@@ -0,0 +1,410 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <string>
+#include <random>
+#include <cstddef>
+#include <set>
+#include <tuple>
+
+#include "nclist/batch.hpp"
+#include "utils.hpp"
+
+TEST(OverlapsBatch, Simple) {
+    std::vector<int> test_starts { 10, 30, 20,   0, 50 };
+    std::vector<int> test_ends   { 50, 45, 50, 100, 60 };
+    auto index = nclist::build<int, int>(test_starts.size(), test_starts.data(), test_ends.data());
+
+    std::vector<int> query_starts { 30, 30, 30, 55, 0 };
+    std::vector<int> query_ends   { 45, 45, 45, 60, 100 };
+    std::vector<nclist::OverlapType> types {
+        nclist::OverlapType::EQUAL,
+        nclist::OverlapType::WITHIN,
+        nclist::OverlapType::START,
+        nclist::OverlapType::END,
+        nclist::OverlapType::EQUAL
+    };
+
+    nclist::OverlapsBatchParameters<int> params;
+    params.types = types.data();
+    std::vector<std::size_t> offsets;
+    std::vector<int> matches;
+    nclist::overlaps_batch(index, query_starts.size(), query_starts.data(), query_ends.data(), params, offsets, matches);
+
+    EXPECT_EQ(offsets, std::vector<std::size_t>({ 0, 1, 5, 6, 7, 8 }));
+    EXPECT_EQ(matches[0], 1);
+    std::vector<int> within(matches.begin() + 1, matches.begin() + 5);
+    std::sort(within.begin(), within.end());
+    EXPECT_EQ(within, std::vector<int>({ 0, 1, 2, 3 }));
+    EXPECT_EQ(matches[5], 1);
+    EXPECT_EQ(matches[6], 4);
+    EXPECT_EQ(matches[7], 3);
+
+    // Per-query parameters are respected.
+    std::vector<int> max_gaps { 0, 0, 0, 0, 10 };
+    params.max_gaps = max_gaps.data();
+    std::vector<int> min_overlaps { 0, 100, 0, 0, 0 };
+    params.min_overlaps = min_overlaps.data();
+    nclist::overlaps_batch(index, query_starts.size(), query_starts.data(), query_ends.data(), params, offsets, matches);
+    EXPECT_EQ(offsets, std::vector<std::size_t>({ 0, 1, 1, 2, 3, 4 }));
+
+    // Empty batches are handled correctly.
+    nclist::overlaps_batch(index, 0, query_starts.data(), query_ends.data(), params, offsets, matches);
+    EXPECT_EQ(offsets, std::vector<std::size_t>({ 0 }));
+    EXPECT_TRUE(matches.empty());
+}
+
+TEST(OverlapsBatch, InvalidType) {
+    std::vector<int> test_starts { 16, 84, 32 };
+    std::vector<int> test_ends   { 24, 96, 45 };
+    auto index = nclist::build<int, int>(test_starts.size(), test_starts.data(), test_ends.data());
+
+    std::vector<nclist::OverlapType> types { nclist::OverlapType::ANY, static_cast<nclist::OverlapType>(6), nclist::OverlapType::END };
+    nclist::OverlapsBatchParameters<int> params;
+    params.types = types.data();
+    std::vector<std::size_t> offsets;
+    std::vector<int> matches;
+
+    std::string msg;
+    try {
+        nclist::overlaps_batch(index, 3, test_starts.data(), test_ends.data(), params, offsets, matches);
+    } catch (std::exception& e) {
+        msg = e.what();
+    }
+    EXPECT_TRUE(msg.find("unknown overlap type for query 1") != std::string::npos);
+
+    msg.clear();
+    params.types = NULL;
+    params.type = static_cast<nclist::OverlapType>(-1);
+    try {
+        nclist::overlaps_batch(index, 3, test_starts.data(), test_ends.data(), params, offsets, matches);
+    } catch (std::exception& e) {
+        msg = e.what();
+    }
+    EXPECT_TRUE(msg.find("unknown overlap type") != std::string::npos);
+}
+
+class OverlapsBatchTest : public OverlapsTestCore, public ::testing::TestWithParam<std::tuple<int, int, int> > {
+protected:
+    int nthreads;
+    void SetUp() {
+        auto params = GetParam();
+        assemble(params);
+        nthreads = std::get<2>(params);
+    }
+
+    template<class Parameters_, class Workspace_, class Search_>
+    static void reference(
+        const nclist::Nclist<int, int>& index,
+        int qs,
+        int qe,
+        std::optional<int> max_gap,
+        int min_overlap,
+        Workspace_& workspace,
+        std::vector<int>& output,
+        Search_ search)
+    {
+        Parameters_ params;
+        if (max_gap.has_value()) {
+            params.max_gap = *max_gap;
+        }
+        params.min_overlap = min_overlap;
+        search(index, qs, qe, params, workspace, output);
+    }
+};
+
+TEST_P(OverlapsBatchTest, Reference) {
+    auto index = nclist::build(nsubject, subject_start.data(), subject_end.data());
+
+    std::mt19937_64 rng(nquery * 7 + nsubject + nthreads);
+    std::vector<nclist::OverlapType> types(nquery);
+    std::vector<int> max_gaps(nquery), min_overlaps(nquery);
+    for (int q = 0; q < nquery; ++q) {
+        types[q] = static_cast<nclist::OverlapType>(rng() % 6);
+        max_gaps[q] = rng() % 10;
+        min_overlaps[q] = (rng() % 3 == 0 ? rng() % 10 : 0);
+    }
+
+    nclist::OverlapsBatchParameters<int> params;
+    params.num_threads = nthreads;
+    params.types = types.data();
+    std::vector<std::size_t> offsets;
+    std::vector<int> matches;
+
+    nclist::OverlapsAnyWorkspace<int> a_work;
+    nclist::OverlapsEqualWorkspace<int> eq_work;
+    nclist::OverlapsWithinWorkspace<int> w_work;
+    nclist::OverlapsExtendWorkspace<int> x_work;
+    nclist::OverlapsStartWorkspace<int> s_work;
+    nclist::OverlapsEndWorkspace<int> en_work;
+    std::vector<int> ref;
+
+    auto compare = [&](bool use_max_gap, bool use_min_overlap) -> void {
+        ASSERT_EQ(offsets.size(), nquery + 1);
+        for (int q = 0; q < nquery; ++q) {
+            std::optional<int> max_gap;
+            if (use_max_gap) {
+                max_gap = max_gaps[q];
+            }
+            const int min_overlap = (use_min_overlap ? min_overlaps[q] : 0);
+
+            switch (types[q]) {
+                case nclist::OverlapType::ANY:
+                    reference<nclist::OverlapsAnyParameters<int> >(index, query_start[q], query_end[q], max_gap, min_overlap, a_work, ref,
+                        [](const auto& s, int qs, int qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_any(s, qs, qe, p, w, m); });
+                    break;
+                case nclist::OverlapType::EQUAL:
+                    reference<nclist::OverlapsEqualParameters<int> >(index, query_start[q], query_end[q], max_gap, min_overlap, eq_work, ref,
+                        [](const auto& s, int qs, int qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_equal(s, qs, qe, p, w, m); });
+                    break;
+                case nclist::OverlapType::WITHIN:
+                    reference<nclist::OverlapsWithinParameters<int> >(index, query_start[q], query_end[q], max_gap, min_overlap, w_work, ref,
+                        [](const auto& s, int qs, int qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_within(s, qs, qe, p, w, m); });
+                    break;
+                case nclist::OverlapType::EXTEND:
+                    reference<nclist::OverlapsExtendParameters<int> >(index, query_start[q], query_end[q], max_gap, min_overlap, x_work, ref,
+                        [](const auto& s, int qs, int qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_extend(s, qs, qe, p, w, m); });
+                    break;
+                case nclist::OverlapType::START:
+                    reference<nclist::OverlapsStartParameters<int> >(index, query_start[q], query_end[q], max_gap, min_overlap, s_work, ref,
+                        [](const auto& s, int qs, int qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_start(s, qs, qe, p, w, m); });
+                    break;
+                case nclist::OverlapType::END:
+                    reference<nclist::OverlapsEndParameters<int> >(index, query_start[q], query_end[q], max_gap, min_overlap, en_work, ref,
+                        [](const auto& s, int qs, int qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_end(s, qs, qe, p, w, m); });
+                    break;
+            }
+
+            std::vector<int> observed(matches.begin() + offsets[q], matches.begin() + offsets[q + 1]);
+            EXPECT_EQ(observed, ref);
+        }
+    };
+
+    nclist::overlaps_batch(index, nquery, query_start.data(), query_end.data(), params, offsets, matches);
+    compare(false, false);
+
+    params.max_gaps = max_gaps.data();
+    nclist::overlaps_batch(index, nquery, query_start.data(), query_end.data(), params, offsets, matches);
+    compare(true, false);
+
+    params.min_overlaps = min_overlaps.data();
+    nclist::overlaps_batch(index, nquery, query_start.data(), query_end.data(), params, offsets, matches);
+    compare(true, true);
+}
+
+TEST_P(OverlapsBatchTest, Uniform) {
+    auto index = nclist::build(nsubject, subject_start.data(), subject_end.data());
+    nclist::OverlapsBatchParameters<int> params;
+    params.num_threads = nthreads;
+    params.type = nclist::OverlapType::WITHIN;
+    params.max_gap = 5;
+    std::vector<std::size_t> offsets;
+    std::vector<int> matches;
+    nclist::overlaps_batch(index, nquery, query_start.data(), query_end.data(), params, offsets, matches);
+
+    nclist::OverlapsWithinParameters<int> wparams;
+    wparams.max_gap = 5;
+    nclist::OverlapsWithinWorkspace<int> work;
+    std::vector<int> ref;
+    for (int q = 0; q < nquery; ++q) {
+        nclist::overlaps_within(index, query_start[q], query_end[q], wparams, work, ref);
+        std::vector<int> observed(matches.begin() + offsets[q], matches.begin() + offsets[q + 1]);
+        EXPECT_EQ(observed, ref);
+    }
+}
+
+TEST_P(OverlapsBatchTest, Profile) {
+    auto index = nclist::build(nsubject, subject_start.data(), subject_end.data());
+    nclist::OverlapsBatchParameters<int> params;
+    params.num_threads = nthreads;
+    std::vector<nclist::OverlapType> types;
+    std::vector<int> max_gaps;
+    for (int q = 0; q < nquery; ++q) {
+        types.push_back(static_cast<nclist::OverlapType>(q % 6));
+        max_gaps.push_back(q % 4);
+    }
+    params.types = types.data();
+    params.max_gaps = max_gaps.data();
+
+    std::vector<std::size_t> ref_offsets;
+    std::vector<int> ref_matches;
+    nclist::overlaps_batch(index, nquery, query_start.data(), query_end.data(), params, ref_offsets, ref_matches);
+
+    nclist::OverlapsBatchProfile<int> profile;
+    profile.num_slowest = 5;
+    params.profile = &profile;
+    std::vector<std::size_t> offsets;
+    std::vector<int> matches;
+    nclist::overlaps_batch(index, nquery, query_start.data(), query_end.data(), params, offsets, matches);
+    EXPECT_EQ(offsets, ref_offsets);
+    EXPECT_EQ(matches, ref_matches);
+
+    std::uint64_t total = 0, largest = 0;
+    for (int t = 0; t < 6; ++t) {
+        const auto& hist = profile.latencies[t];
+        EXPECT_EQ(hist.count(), nquery / 6 + (t < nquery % 6));
+        total += hist.count();
+        largest = std::max(largest, hist.max());
+    }
+    EXPECT_EQ(total, nquery);
+
+    ASSERT_EQ(profile.slowest.size(), 5);
+    EXPECT_EQ(profile.slowest.front().nanoseconds, largest);
+    for (std::size_t i = 0; i < profile.slowest.size(); ++i) {
+        const auto& slow = profile.slowest[i];
+        if (i) {
+            EXPECT_GE(profile.slowest[i - 1].nanoseconds, slow.nanoseconds);
+        }
+        const auto q = slow.index;
+        EXPECT_EQ(slow.query_start, query_start[q]);
+        EXPECT_EQ(slow.query_end, query_end[q]);
+        EXPECT_EQ(slow.type, types[q]);
+        ASSERT_TRUE(slow.max_gap.has_value());
+        EXPECT_EQ(*(slow.max_gap), max_gaps[q]);
+        EXPECT_EQ(slow.num_matches, offsets[q + 1] - offsets[q]);
+        EXPECT_LE(slow.num_roots, index.root_children);
+    }
+
+    // Results are accumulated across calls.
+    nclist::overlaps_batch(index, nquery, query_start.data(), query_end.data(), params, offsets, matches);
+    EXPECT_EQ(profile.latencies[0].count(), 2 * (nquery / 6 + 1));
+    EXPECT_EQ(profile.slowest.size(), 5);
+
+    profile.clear();
+    EXPECT_EQ(profile.latencies[0].count(), 0);
+    EXPECT_TRUE(profile.slowest.empty());
+}
+
+TEST_P(OverlapsBatchTest, Deduplicate) {
+    auto index = nclist::build(nsubject, subject_start.data(), subject_end.data());
+
+    // Adding many copies of existing queries, with some differing only in their type or parameters.
+    std::mt19937_64 rng(nquery * 3 + nsubject + nthreads);
+    std::vector<int> starts(query_start), ends(query_end);
+    std::vector<nclist::OverlapType> types(nquery);
+    std::vector<int> max_gaps(nquery);
+    for (int q = 0; q < nquery; ++q) {
+        types[q] = static_cast<nclist::OverlapType>(rng() % 6);
+        max_gaps[q] = rng() % 5;
+    }
+    for (int i = 0; i < nquery * 2; ++i) {
+        const auto chosen = rng() % nquery;
+        starts.push_back(starts[chosen]);
+        ends.push_back(ends[chosen]);
+        types.push_back(rng() % 4 == 0 ? static_cast<nclist::OverlapType>(rng() % 6) : types[chosen]);
+        max_gaps.push_back(rng() % 4 == 0 ? rng() % 5 : max_gaps[chosen]);
+    }
+    const std::size_t ntotal = starts.size();
+
+    nclist::OverlapsBatchParameters<int> params;
+    params.num_threads = nthreads;
+    params.types = types.data();
+    params.max_gaps = max_gaps.data();
+    std::vector<std::size_t> ref_offsets;
+    std::vector<int> ref_matches;
+    nclist::overlaps_batch(index, ntotal, starts.data(), ends.data(), params, ref_offsets, ref_matches);
+
+    params.deduplicate = true;
+    std::vector<std::size_t> offsets;
+    std::vector<int> matches;
+    nclist::overlaps_batch(index, ntotal, starts.data(), ends.data(), params, offsets, matches);
+    EXPECT_EQ(offsets, ref_offsets);
+    EXPECT_EQ(matches, ref_matches);
+
+    std::vector<std::size_t> unique_indices;
+    nclist::overlaps_batch_unique(index, ntotal, starts.data(), ends.data(), params, unique_indices, offsets, matches);
+    ASSERT_EQ(unique_indices.size(), ntotal);
+
+    std::set<std::tuple<int, int, nclist::OverlapType, int> > distinct;
+    std::size_t next_unique = 0;
+    for (std::size_t q = 0; q < ntotal; ++q) {
+        auto u = unique_indices[q];
+        ASSERT_LE(u, next_unique); // unique queries are indexed by their first occurrence.
+        if (u == next_unique) {
+            ++next_unique;
+        }
+        distinct.emplace(starts[q], ends[q], types[q], max_gaps[q]);
+
+        std::vector<int> observed(matches.begin() + offsets[u], matches.begin() + offsets[u + 1]);
+        std::vector<int> expected(ref_matches.begin() + ref_offsets[q], ref_matches.begin() + ref_offsets[q + 1]);
+        EXPECT_EQ(observed, expected);
+    }
+    EXPECT_EQ(next_unique, distinct.size());
+    EXPECT_EQ(offsets.size(), distinct.size() + 1);
+}
+
+TEST_P(OverlapsBatchTest, ReuseNested) {
+    auto index = nclist::build(nsubject, subject_start.data(), subject_end.data());
+
+    // Adding queries nested within existing queries, including identical queries and zero-width queries.
+    std::mt19937_64 rng(nquery * 5 + nsubject + nthreads);
+    std::vector<int> starts(query_start), ends(query_end);
+    for (int q = 0; q < nquery; ++q) {
+        const int nnested = rng() % 4;
+        for (int n = 0; n < nnested; ++n) {
+            const int width = ends[q] - starts[q];
+            const int nstart = starts[q] + (width ? rng() % (width + 1) : 0);
+            const int nend = nstart + rng() % (ends[q] - nstart + 1);
+            starts.push_back(nstart);
+            ends.push_back(nend);
+        }
+    }
+    const std::size_t ntotal = starts.size();
+
+    std::vector<nclist::OverlapType> types(ntotal);
+    std::vector<int> max_gaps(ntotal);
+    for (std::size_t q = 0; q < ntotal; ++q) {
+        types[q] = (rng() % 4 == 0 ? static_cast<nclist::OverlapType>(rng() % 6) : nclist::OverlapType::ANY);
+        max_gaps[q] = rng() % 2 * 5;
+    }
+
+    const auto compare = [&](nclist::OverlapsBatchParameters<int> params) -> void {
+        params.num_threads = nthreads;
+        std::vector<std::size_t> ref_offsets;
+        std::vector<int> ref_matches;
+        nclist::overlaps_batch(index, ntotal, starts.data(), ends.data(), params, ref_offsets, ref_matches);
+
+        params.reuse_nested = true;
+        std::vector<std::size_t> offsets;
+        std::vector<int> matches;
+        nclist::overlaps_batch(index, ntotal, starts.data(), ends.data(), params, offsets, matches);
+        EXPECT_EQ(offsets, ref_offsets);
+        EXPECT_EQ(matches, ref_matches);
+    };
+
+    {
+        nclist::OverlapsBatchParameters<int> params;
+        compare(params);
+        params.max_gap = 10;
+        compare(params);
+        params.max_gap.reset();
+        params.min_overlap = 5;
+        compare(params);
+    }
+
+    {
+        nclist::OverlapsBatchParameters<int> params;
+        params.types = types.data();
+        params.max_gaps = max_gaps.data();
+        compare(params);
+        params.deduplicate = true;
+        compare(params);
+    }
+
+    // Unsorted results are still correct when only the first match is requested, as re-use is disabled.
+    {
+        nclist::OverlapsBatchParameters<int> params;
+        params.quit_on_first = true;
+        compare(params);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    OverlapsBatch,
+    OverlapsBatchTest,
+    ::testing::Combine(
+        ::testing::Values(10, 100, 1000), // num of query ranges
+        ::testing::Values(10, 100, 1000), // number of subject ranges
+        ::testing::Values(1, 3) // number of threads
+    )
+);
@@ -109,6 +109,116 @@ INSTANTIATE_TEST_SUITE_P(
     )
 );
 
+TEST(Build, Structure) {
+    // Using lots of nesting and duplicates to check that the working buffers are correctly re-used.
+    std::mt19937_64 rng(42);
+    std::vector<int> starts, ends;
+    for (int i = 0; i < 2000; ++i) {
+        if (i % 7 == 3) {
+            starts.push_back(starts[i - 1]);
+            ends.push_back(ends[i - 1]);
+        } else {
+            const int start = rng() % 1000;
+            starts.push_back(start);
+            ends.push_back(start + 1 + rng() % (i % 10 == 0 ? 500 : 20));
+        }
+    }
+
+    auto index = nclist::build(static_cast<int>(starts.size()), starts.data(), ends.data());
+    std::vector<int> found(starts.size());
+    std::vector<int> parent(index.nodes.size(), -1);
+    EXPECT_EQ(index.nodes.size(), index.starts.size());
+    EXPECT_EQ(index.nodes.size(), index.ends.size());
+
+    const auto check_siblings = [&](int from, int to) -> void {
+        for (int i = from; i < to; ++i) {
+            EXPECT_EQ(index.starts[i], starts[index.nodes[i].id]);
+            EXPECT_EQ(index.ends[i], ends[index.nodes[i].id]);
+            if (i > from) {
+                EXPECT_LT(index.starts[i - 1], index.starts[i]);
+                EXPECT_LT(index.ends[i - 1], index.ends[i]);
+            }
+        }
+    };
+    check_siblings(0, index.root_children);
+
+    for (int i = 0, num_nodes = index.nodes.size(); i < num_nodes; ++i) {
+        const auto& node = index.nodes[i];
+        ++found[node.id];
+        for (auto d = node.duplicates_start; d < node.duplicates_end; ++d) {
+            const auto dup = index.duplicates[d];
+            ++found[dup];
+            EXPECT_EQ(starts[dup], starts[node.id]);
+            EXPECT_EQ(ends[dup], ends[node.id]);
+        }
+
+        check_siblings(node.children_start, node.children_end);
+        for (auto c = node.children_start; c < node.children_end; ++c) {
+            EXPECT_GT(c, i); // children always come after their parents.
+            EXPECT_EQ(parent[c], -1);
+            parent[c] = i;
+            EXPECT_LE(index.starts[i], index.starts[c]);
+            EXPECT_GE(index.ends[i], index.ends[c]);
+        }
+    }
+
+    EXPECT_EQ(found, std::vector<int>(starts.size(), 1));
+    for (int i = index.root_children, num_nodes = index.nodes.size(); i < num_nodes; ++i) {
+        EXPECT_NE(parent[i], -1);
+    }
+}
+
+TEST(Build, LowMemory) {
+    std::mt19937_64 rng(69);
+    std::vector<int> starts, ends;
+    for (int i = 0; i < 2000; ++i) {
+        if (i % 5 == 2) {
+            starts.push_back(starts[i - 1]);
+            ends.push_back(ends[i - 1]);
+        } else {
+            const int start = rng() % 1000;
+            starts.push_back(start);
+            ends.push_back(start + 1 + rng() % (i % 10 == 0 ? 500 : 20));
+        }
+    }
+
+    // Duplicates might be stored in a different order, but each node should have the same set of duplicates.
+    const auto compare = [&](const nclist::Nclist<int, int>& ref, const nclist::Nclist<int, int>& low) -> void {
+        EXPECT_EQ(ref.root_children, low.root_children);
+        EXPECT_EQ(ref.starts, low.starts);
+        EXPECT_EQ(ref.ends, low.ends);
+        EXPECT_EQ(ref.duplicates.size(), low.duplicates.size());
+        ASSERT_EQ(ref.nodes.size(), low.nodes.size());
+        for (std::size_t i = 0; i < ref.nodes.size(); ++i) {
+            const auto& rnode = ref.nodes[i];
+            const auto& lnode = low.nodes[i];
+            EXPECT_EQ(rnode.id, lnode.id);
+            EXPECT_EQ(rnode.children_start, lnode.children_start);
+            EXPECT_EQ(rnode.children_end, lnode.children_end);
+            std::vector<int> rdups(ref.duplicates.begin() + rnode.duplicates_start, ref.duplicates.begin() + rnode.duplicates_end);
+            std::vector<int> ldups(low.duplicates.begin() + lnode.duplicates_start, low.duplicates.begin() + lnode.duplicates_end);
+            std::sort(rdups.begin(), rdups.end());
+            std::sort(ldups.begin(), ldups.end());
+            EXPECT_EQ(rdups, ldups);
+        }
+    };
+
+    const int n = starts.size();
+    compare(nclist::build(n, starts.data(), ends.data()), nclist::build_low_memory(n, starts.data(), ends.data()));
+
+    std::vector<int> subset;
+    for (int i = 0; i < n; i += 3) {
+        subset.push_back(i);
+    }
+    const int nsub = subset.size();
+    compare(nclist::build(nsub, subset.data(), starts.data(), ends.data()), nclist::build_low_memory(nsub, subset.data(), starts.data(), ends.data()));
+
+    // Empty inputs are handled correctly.
+    auto empty = nclist::build_low_memory(0, starts.data(), ends.data());
+    EXPECT_EQ(empty.root_children, 0);
+    EXPECT_TRUE(empty.nodes.empty());
+}
+
 TEST(Build, SafeResize) {
     struct MockVector {
         MockVector(std::uint8_t s) : s(s) {}
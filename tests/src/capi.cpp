@@ -0,0 +1,296 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <random>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include "nclist_c.h"
+#include "nclist/batch.hpp"
+#include "utils.hpp"
+
+TEST(CApi, Simple) {
+    std::vector<int32_t> test_starts { 16, 84, 32, 77, 6, 25, 58, 6 };
+    std::vector<int32_t> test_ends   { 24, 96, 45, 80, 20, 50, 70, 20 };
+    nclist_index_i32* index;
+    ASSERT_EQ(nclist_build_i32(test_starts.size(), test_starts.data(), test_ends.data(), &index), NCLIST_OK);
+
+    std::vector<int32_t> query_starts { 10, 60, 100 };
+    std::vector<int32_t> query_ends   { 30, 90, 110 };
+    nclist_results* results;
+    ASSERT_EQ(nclist_overlaps_batch_i32(index, query_starts.size(), query_starts.data(), query_ends.data(), NULL, &results), NCLIST_OK);
+    ASSERT_EQ(nclist_results_num_queries(results), 3);
+
+    const auto offsets = nclist_results_offsets(results);
+    const auto matches = nclist_results_matches(results);
+    EXPECT_EQ(std::vector<std::size_t>(offsets, offsets + 4), std::vector<std::size_t>({ 0, 4, 7, 7 }));
+    std::vector<int32_t> first(matches, matches + 4);
+    std::sort(first.begin(), first.end());
+    EXPECT_EQ(first, std::vector<int32_t>({ 0, 4, 5, 7 }));
+    std::vector<int32_t> second(matches + 4, matches + 7);
+    std::sort(second.begin(), second.end());
+    EXPECT_EQ(second, std::vector<int32_t>({ 1, 3, 6 }));
+
+    nclist_results_free(results);
+    nclist_free_i32(index);
+}
+
+TEST(CApi, Errors) {
+    std::vector<int32_t> test_starts { 0, 10 };
+    std::vector<int32_t> test_ends { 5, 20 };
+    nclist_index_i32* index;
+    EXPECT_EQ(nclist_build_i32(2, NULL, test_ends.data(), &index), NCLIST_ERROR_INVALID_ARGUMENT);
+    EXPECT_NE(std::string(nclist_last_error()).find("NULL"), std::string::npos);
+    EXPECT_EQ(nclist_build_i32(-1, test_starts.data(), test_ends.data(), &index), NCLIST_ERROR_INVALID_ARGUMENT);
+    EXPECT_NE(std::string(nclist_last_error()).find("non-negative"), std::string::npos);
+    ASSERT_EQ(nclist_build_i32(2, test_starts.data(), test_ends.data(), &index), NCLIST_OK);
+
+    nclist_results* results;
+    EXPECT_EQ(nclist_overlaps_batch_i32(NULL, 2, test_starts.data(), test_ends.data(), NULL, &results), NCLIST_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(nclist_overlaps_batch_i32(index, 2, test_starts.data(), test_ends.data(), NULL, NULL), NCLIST_ERROR_INVALID_ARGUMENT);
+
+    nclist_batch_params_i32 params;
+    nclist_batch_params_init_i32(&params);
+    params.type = static_cast<nclist_overlap_type>(10);
+    EXPECT_EQ(nclist_overlaps_batch_i32(index, 2, test_starts.data(), test_ends.data(), &params, &results), NCLIST_ERROR_INVALID_ARGUMENT);
+    EXPECT_NE(std::string(nclist_last_error()).find("type"), std::string::npos);
+
+    nclist_batch_params_init_i32(&params);
+    std::vector<int8_t> types { NCLIST_OVERLAP_ANY, -1 };
+    params.types = types.data();
+    EXPECT_EQ(nclist_overlaps_batch_i32(index, 2, test_starts.data(), test_ends.data(), &params, &results), NCLIST_ERROR_INVALID_ARGUMENT);
+
+    // Empty batches are still fine.
+    ASSERT_EQ(nclist_overlaps_batch_i32(index, 0, NULL, NULL, NULL, &results), NCLIST_OK);
+    EXPECT_EQ(nclist_results_num_queries(results), 0);
+    EXPECT_EQ(nclist_results_offsets(results)[0], 0);
+    nclist_results_free(results);
+
+    nclist_free_i32(index);
+    nclist_free_i32(NULL);
+    nclist_results_free(NULL);
+}
+
+template<typename Position_>
+std::vector<Position_> convert_positions(const std::vector<int>& positions) {
+    return std::vector<Position_>(positions.begin(), positions.end());
+}
+
+template<typename Position_>
+void compare_batch(
+    const nclist::Nclist<int32_t, Position_>& ref,
+    const std::vector<Position_>& query_starts,
+    const std::vector<Position_>& query_ends,
+    const nclist::OverlapsBatchParameters<Position_>& params,
+    nclist_results* results)
+{
+    std::vector<std::size_t> offsets;
+    std::vector<int32_t> matches;
+    nclist::overlaps_batch(ref, query_starts.size(), query_starts.data(), query_ends.data(), params, offsets, matches);
+
+    ASSERT_EQ(nclist_results_num_queries(results), query_starts.size());
+    const auto observed_offsets = nclist_results_offsets(results);
+    EXPECT_EQ(std::vector<std::size_t>(observed_offsets, observed_offsets + offsets.size()), offsets);
+    const auto observed_matches = nclist_results_matches(results);
+    EXPECT_EQ(std::vector<int32_t>(observed_matches, observed_matches + matches.size()), matches);
+    nclist_results_free(results);
+}
+
+class CApiTest : public OverlapsTestCore, public ::testing::TestWithParam<std::tuple<int, int> > {
+protected:
+    void SetUp() {
+        assemble(GetParam());
+    }
+
+    template<typename Position_, class Index_, class CParams_, class Build_, class Batch_, class Init_>
+    void run(Build_ build, Batch_ batch, Init_ init) {
+        const auto sstarts = convert_positions<Position_>(subject_start), sends = convert_positions<Position_>(subject_end);
+        const auto qstarts = convert_positions<Position_>(query_start), qends = convert_positions<Position_>(query_end);
+        auto ref = nclist::build<int32_t, Position_>(nsubject, sstarts.data(), sends.data());
+
+        Index_* index;
+        ASSERT_EQ(build(nsubject, sstarts.data(), sends.data(), &index), NCLIST_OK);
+
+        nclist_results* results;
+        ASSERT_EQ(batch(index, nquery, qstarts.data(), qends.data(), NULL, &results), NCLIST_OK);
+        compare_batch(ref, qstarts, qends, nclist::OverlapsBatchParameters<Position_>(), results);
+
+        std::mt19937_64 rng(nquery + nsubject * 3);
+        std::vector<int8_t> ctypes;
+        std::vector<nclist::OverlapType> types;
+        std::vector<Position_> max_gaps;
+        for (int q = 0; q < nquery; ++q) {
+            const auto chosen = rng() % 6;
+            ctypes.push_back(chosen);
+            types.push_back(static_cast<nclist::OverlapType>(chosen));
+            max_gaps.push_back(rng() % 10);
+        }
+
+        CParams_ cparams;
+        init(&cparams);
+        cparams.types = ctypes.data();
+        cparams.max_gaps = max_gaps.data();
+        cparams.num_threads = 2;
+        nclist::OverlapsBatchParameters<Position_> params;
+        params.types = types.data();
+        params.max_gaps = max_gaps.data();
+        params.num_threads = 2;
+        ASSERT_EQ(batch(index, nquery, qstarts.data(), qends.data(), &cparams, &results), NCLIST_OK);
+        compare_batch(ref, qstarts, qends, params, results);
+
+        init(&cparams);
+        cparams.type = NCLIST_OVERLAP_WITHIN;
+        cparams.has_max_gap = 1;
+        cparams.max_gap = 5;
+        cparams.deduplicate = 1;
+        params = nclist::OverlapsBatchParameters<Position_>();
+        params.type = nclist::OverlapType::WITHIN;
+        params.max_gap = 5;
+        ASSERT_EQ(batch(index, nquery, qstarts.data(), qends.data(), &cparams, &results), NCLIST_OK);
+        compare_batch(ref, qstarts, qends, params, results);
+
+        init(&cparams);
+        cparams.min_overlap = 10;
+        cparams.reuse_nested = 1;
+        params = nclist::OverlapsBatchParameters<Position_>();
+        params.min_overlap = 10;
+        ASSERT_EQ(batch(index, nquery, qstarts.data(), qends.data(), &cparams, &results), NCLIST_OK);
+        compare_batch(ref, qstarts, qends, params, results);
+
+        init(&cparams);
+        cparams.quit_on_first = 1;
+        params = nclist::OverlapsBatchParameters<Position_>();
+        params.quit_on_first = true;
+        ASSERT_EQ(batch(index, nquery, qstarts.data(), qends.data(), &cparams, &results), NCLIST_OK);
+        compare_batch(ref, qstarts, qends, params, results);
+    }
+};
+
+TEST_P(CApiTest, Int32) {
+    run<int32_t, nclist_index_i32, nclist_batch_params_i32>(nclist_build_i32, nclist_overlaps_batch_i32, nclist_batch_params_init_i32);
+}
+
+TEST_P(CApiTest, Int64) {
+    run<int64_t, nclist_index_i64, nclist_batch_params_i64>(nclist_build_i64, nclist_overlaps_batch_i64, nclist_batch_params_init_i64);
+}
+
+TEST_P(CApiTest, Double) {
+    run<double, nclist_index_f64, nclist_batch_params_f64>(nclist_build_f64, nclist_overlaps_batch_f64, nclist_batch_params_init_f64);
+}
+
+template<class Index_, class SaveSize_, class Save_, class Load_, class Free_, class Batch_, typename Position_>
+void check_save_load(Index_* index, SaveSize_ save_size, Save_ save, Load_ load, Free_ free, Batch_ batch, const std::vector<Position_>& qstarts, const std::vector<Position_>& qends) {
+    std::size_t size;
+    ASSERT_EQ(save_size(index, &size), NCLIST_OK);
+    std::vector<unsigned char> buffer(size + 1);
+    EXPECT_EQ(save(index, buffer.data(), size - 1), NCLIST_ERROR_BUFFER_TOO_SMALL);
+
+    // Saving to an unaligned buffer to check that no alignment is required.
+    auto saved = buffer.data() + 1;
+    ASSERT_EQ(save(index, saved, size), NCLIST_OK);
+    Index_* loaded;
+    ASSERT_EQ(load(saved, size, &loaded), NCLIST_OK);
+
+    nclist_results* expected;
+    ASSERT_EQ(batch(index, qstarts.size(), qstarts.data(), qends.data(), NULL, &expected), NCLIST_OK);
+    nclist_results* observed;
+    ASSERT_EQ(batch(loaded, qstarts.size(), qstarts.data(), qends.data(), NULL, &observed), NCLIST_OK);
+    const auto num_matches = nclist_results_offsets(expected)[qstarts.size()];
+    ASSERT_EQ(nclist_results_offsets(observed)[qstarts.size()], num_matches);
+    EXPECT_EQ(std::memcmp(nclist_results_offsets(expected), nclist_results_offsets(observed), sizeof(std::size_t) * (qstarts.size() + 1)), 0);
+    EXPECT_EQ(std::memcmp(nclist_results_matches(expected), nclist_results_matches(observed), sizeof(int32_t) * num_matches), 0);
+    nclist_results_free(expected);
+    nclist_results_free(observed);
+
+    // Re-saving the loaded index gives the same bytes.
+    std::size_t resize;
+    ASSERT_EQ(save_size(loaded, &resize), NCLIST_OK);
+    ASSERT_EQ(resize, size);
+    std::vector<unsigned char> rebuffer(size);
+    ASSERT_EQ(save(loaded, rebuffer.data(), size), NCLIST_OK);
+    EXPECT_EQ(std::memcmp(rebuffer.data(), saved, size), 0);
+    free(loaded);
+}
+
+TEST_P(CApiTest, SaveLoad) {
+    nclist_index_i32* index32;
+    ASSERT_EQ(nclist_build_i32(nsubject, subject_start.data(), subject_end.data(), &index32), NCLIST_OK);
+    check_save_load(index32, nclist_save_size_i32, nclist_save_i32, nclist_load_i32, nclist_free_i32, nclist_overlaps_batch_i32, query_start, query_end);
+
+    const auto sstarts64 = convert_positions<int64_t>(subject_start), sends64 = convert_positions<int64_t>(subject_end);
+    nclist_index_i64* index64;
+    ASSERT_EQ(nclist_build_i64(nsubject, sstarts64.data(), sends64.data(), &index64), NCLIST_OK);
+    check_save_load(index64, nclist_save_size_i64, nclist_save_i64, nclist_load_i64, nclist_free_i64, nclist_overlaps_batch_i64, convert_positions<int64_t>(query_start), convert_positions<int64_t>(query_end));
+
+    const auto sstartsf = convert_positions<double>(subject_start), sendsf = convert_positions<double>(subject_end);
+    nclist_index_f64* indexf;
+    ASSERT_EQ(nclist_build_f64(nsubject, sstartsf.data(), sendsf.data(), &indexf), NCLIST_OK);
+    check_save_load(indexf, nclist_save_size_f64, nclist_save_f64, nclist_load_f64, nclist_free_f64, nclist_overlaps_batch_f64, convert_positions<double>(query_start), convert_positions<double>(query_end));
+
+    // Loading fails if the position types differ.
+    std::size_t size;
+    ASSERT_EQ(nclist_save_size_i32(index32, &size), NCLIST_OK);
+    std::vector<unsigned char> buffer(size);
+    ASSERT_EQ(nclist_save_i32(index32, buffer.data(), size), NCLIST_OK);
+    nclist_index_i64* wrong;
+    EXPECT_EQ(nclist_load_i64(buffer.data(), size, &wrong), NCLIST_ERROR_INVALID_FORMAT);
+
+    nclist_free_i32(index32);
+    nclist_free_i64(index64);
+    nclist_free_f64(indexf);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    CApi,
+    CApiTest,
+    ::testing::Combine(
+        ::testing::Values(1, 10, 100, 1000), // number of queries
+        ::testing::Values(0, 10, 100, 1000) // number of subjects
+    )
+);
+
+TEST(CApi, Corrupted) {
+    std::vector<int32_t> test_starts { 0, 10, 12, 30, 40 };
+    std::vector<int32_t> test_ends { 100, 20, 15, 35, 50 };
+    nclist_index_i32* index;
+    ASSERT_EQ(nclist_build_i32(test_starts.size(), test_starts.data(), test_ends.data(), &index), NCLIST_OK);
+    std::size_t size;
+    ASSERT_EQ(nclist_save_size_i32(index, &size), NCLIST_OK);
+    std::vector<unsigned char> original(size);
+    ASSERT_EQ(nclist_save_i32(index, original.data(), size), NCLIST_OK);
+    nclist_free_i32(index);
+
+    nclist_index_i32* loaded;
+    EXPECT_EQ(nclist_load_i32(original.data(), size - 1, &loaded), NCLIST_ERROR_INVALID_FORMAT);
+    EXPECT_EQ(nclist_load_i32(original.data(), 10, &loaded), NCLIST_ERROR_INVALID_FORMAT);
+    EXPECT_EQ(nclist_load_i32(NULL, size, &loaded), NCLIST_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(nclist_load_i32(original.data(), size, NULL), NCLIST_ERROR_INVALID_ARGUMENT);
+
+    const auto corrupt = [&](std::size_t offset, int32_t value) -> nclist_status {
+        auto buffer = original;
+        std::memcpy(buffer.data() + offset, &value, sizeof(value));
+        nclist_index_i32* output = NULL;
+        auto status = nclist_load_i32(buffer.data(), size, &output);
+        nclist_free_i32(output);
+        return status;
+    };
+
+    EXPECT_EQ(corrupt(0, 0), NCLIST_ERROR_INVALID_FORMAT); // magic
+    EXPECT_EQ(corrupt(4, 0x04030201), NCLIST_ERROR_INVALID_FORMAT); // byte order
+    EXPECT_EQ(corrupt(8, 2), NCLIST_ERROR_INVALID_FORMAT); // version
+
+    // Node 0 is the only root, with children 1, 2 and 3; node 1 has child 4.
+    constexpr std::size_t nodes_offset = 36;
+    const auto node_field = [&](int node, int field) -> std::size_t {
+        return nodes_offset + (node * 5 + field) * sizeof(int32_t);
+    };
+    EXPECT_EQ(corrupt(node_field(0, 0), 0), NCLIST_OK);
+    EXPECT_EQ(corrupt(node_field(0, 0), -1), NCLIST_ERROR_INVALID_FORMAT); // negative id
+    EXPECT_EQ(corrupt(node_field(0, 1), 0), NCLIST_ERROR_INVALID_FORMAT); // node is its own child
+    EXPECT_EQ(corrupt(node_field(0, 2), 6), NCLIST_ERROR_INVALID_FORMAT); // children out of range
+    EXPECT_EQ(corrupt(node_field(0, 2), 3), NCLIST_ERROR_INVALID_FORMAT); // node 3 has no parent
+    EXPECT_EQ(corrupt(node_field(1, 1), 3), NCLIST_ERROR_INVALID_FORMAT); // node 3 has multiple parents
+    EXPECT_EQ(corrupt(node_field(0, 4), 1), NCLIST_ERROR_INVALID_FORMAT); // duplicates out of range
+}
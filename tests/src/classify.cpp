@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+#include "nclist/classify.hpp"
+#include "nclist/overlaps_any.hpp"
+#include "nclist/overlaps_equal.hpp"
+#include "nclist/overlaps_within.hpp"
+#include "nclist/overlaps_extend.hpp"
+#include "nclist/overlaps_start.hpp"
+#include "nclist/overlaps_end.hpp"
+#include "utils.hpp"
+
+TEST(ClassifyOverlaps, Basic) {
+    std::vector<int> test_starts { 10, 10, 15, 0, 20, 30, 25, 10 };
+    std::vector<int> test_ends   { 20, 30, 20, 50, 25, 40, 25, 20 };
+    auto index = nclist::build<int, int>(test_starts.size(), test_starts.data(), test_ends.data());
+
+    nclist::ClassifyOverlapsParameters<int> params;
+    nclist::ClassifyOverlapsWorkspace<int> workspace;
+    std::vector<int> matches;
+    std::vector<unsigned char> types;
+
+    nclist::classify_overlaps(index, 10, 20, params, workspace, matches, types);
+    ASSERT_EQ(matches.size(), types.size());
+    std::vector<int> expected(test_starts.size());
+    for (std::size_t i = 0; i < matches.size(); ++i) {
+        expected[matches[i]] = types[i];
+    }
+
+    using namespace nclist;
+    EXPECT_EQ(expected[0], OVERLAP_ANY | OVERLAP_EQUAL | OVERLAP_WITHIN | OVERLAP_EXTEND | OVERLAP_START | OVERLAP_END);
+    EXPECT_EQ(expected[1], OVERLAP_ANY | OVERLAP_WITHIN | OVERLAP_START);
+    EXPECT_EQ(expected[2], OVERLAP_ANY | OVERLAP_EXTEND | OVERLAP_END);
+    EXPECT_EQ(expected[3], OVERLAP_ANY | OVERLAP_WITHIN);
+    EXPECT_EQ(expected[4], 0); // adjacent intervals aren't reported.
+    EXPECT_EQ(expected[5], 0);
+    EXPECT_EQ(expected[6], 0);
+    EXPECT_EQ(expected[7], expected[0]); // duplicates get the same flags.
+    EXPECT_EQ(matches.size(), 5);
+
+    // Zero-width intervals can still have some types of overlaps, even when they're not reported by overlaps_any().
+    nclist::classify_overlaps(index, 25, 25, params, workspace, matches, types);
+    expected.clear();
+    expected.resize(test_starts.size());
+    for (std::size_t i = 0; i < matches.size(); ++i) {
+        expected[matches[i]] = types[i];
+    }
+    EXPECT_EQ(expected[1], OVERLAP_ANY | OVERLAP_WITHIN);
+    EXPECT_EQ(expected[3], OVERLAP_ANY | OVERLAP_WITHIN);
+    EXPECT_EQ(expected[4], OVERLAP_WITHIN | OVERLAP_END);
+    EXPECT_EQ(expected[6], OVERLAP_EQUAL | OVERLAP_WITHIN | OVERLAP_EXTEND | OVERLAP_START | OVERLAP_END);
+}
+
+class ClassifyOverlapsTest : public OverlapsTestCore, public ::testing::TestWithParam<std::tuple<int, int, int> > {
+protected:
+    int min_overlap;
+    void SetUp() {
+        auto params = GetParam();
+        assemble(params);
+        min_overlap = std::get<2>(params);
+    }
+};
+
+TEST_P(ClassifyOverlapsTest, Reference) {
+    // Adding some queries with shared starts/ends, as well as some zero-width queries.
+    for (int s = 0; s < nsubject; s += 3) {
+        query_start.push_back(subject_start[s]);
+        query_end.push_back(subject_end[s] + (s % 2));
+        query_start.push_back(std::min(subject_start[s] + (s % 5), subject_end[s]));
+        query_end.push_back(subject_end[s]);
+        query_start.push_back(subject_start[s]);
+        query_end.push_back(subject_start[s]);
+    }
+
+    auto index = nclist::build(nsubject, subject_start.data(), subject_end.data());
+
+    nclist::ClassifyOverlapsParameters<int> params;
+    params.min_overlap = min_overlap;
+    nclist::ClassifyOverlapsWorkspace<int> workspace;
+    std::vector<int> matches;
+    std::vector<unsigned char> types;
+
+    nclist::OverlapsAnyParameters<int> aparams;
+    aparams.min_overlap = min_overlap;
+    nclist::OverlapsAnyWorkspace<int> aworkspace;
+    nclist::OverlapsEqualParameters<int> eqparams;
+    eqparams.min_overlap = min_overlap;
+    nclist::OverlapsEqualWorkspace<int> eqworkspace;
+    nclist::OverlapsWithinParameters<int> wparams;
+    wparams.min_overlap = min_overlap;
+    nclist::OverlapsWithinWorkspace<int> wworkspace;
+    nclist::OverlapsExtendParameters<int> xparams;
+    xparams.min_overlap = min_overlap;
+    nclist::OverlapsExtendWorkspace<int> xworkspace;
+    nclist::OverlapsStartParameters<int> sparams;
+    sparams.min_overlap = min_overlap;
+    nclist::OverlapsStartWorkspace<int> sworkspace;
+    nclist::OverlapsEndParameters<int> enparams;
+    enparams.min_overlap = min_overlap;
+    nclist::OverlapsEndWorkspace<int> enworkspace;
+    std::vector<int> ref;
+
+    for (std::size_t q = 0; q < query_start.size(); ++q) {
+        const auto qs = query_start[q], qe = query_end[q];
+        std::vector<int> expected(nsubject);
+        nclist::overlaps_any(index, qs, qe, aparams, aworkspace, ref);
+        for (auto r : ref) { expected[r] |= nclist::OVERLAP_ANY; }
+        nclist::overlaps_equal(index, qs, qe, eqparams, eqworkspace, ref);
+        for (auto r : ref) { expected[r] |= nclist::OVERLAP_EQUAL; }
+        nclist::overlaps_within(index, qs, qe, wparams, wworkspace, ref);
+        for (auto r : ref) { expected[r] |= nclist::OVERLAP_WITHIN; }
+        nclist::overlaps_extend(index, qs, qe, xparams, xworkspace, ref);
+        for (auto r : ref) { expected[r] |= nclist::OVERLAP_EXTEND; }
+        nclist::overlaps_start(index, qs, qe, sparams, sworkspace, ref);
+        for (auto r : ref) { expected[r] |= nclist::OVERLAP_START; }
+        nclist::overlaps_end(index, qs, qe, enparams, enworkspace, ref);
+        for (auto r : ref) { expected[r] |= nclist::OVERLAP_END; }
+
+        nclist::classify_overlaps(index, qs, qe, params, workspace, matches, types);
+        ASSERT_EQ(matches.size(), types.size());
+        std::vector<int> observed(nsubject);
+        for (std::size_t i = 0; i < matches.size(); ++i) {
+            EXPECT_EQ(observed[matches[i]], 0); // each subject is only reported once.
+            EXPECT_NE(types[i], 0);
+            observed[matches[i]] = types[i];
+        }
+        EXPECT_EQ(observed, expected);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ClassifyOverlaps,
+    ClassifyOverlapsTest,
+    ::testing::Combine(
+        ::testing::Values(10, 100, 1000), // num of query ranges
+        ::testing::Values(10, 100, 1000), // number of subject ranges
+        ::testing::Values(0, 10) // min overlap
+    )
+);
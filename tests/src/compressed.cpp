@@ -0,0 +1,295 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+#include "nclist/compressed.hpp"
+#include "nclist/overlaps_any.hpp"
+#include "nclist/overlaps_within.hpp"
+#include "nclist/overlaps_extend.hpp"
+#include "nclist/overlaps_equal.hpp"
+#include "nclist/overlaps_start.hpp"
+#include "nclist/overlaps_end.hpp"
+#include "nclist/nearest.hpp"
+#include "nclist/classify.hpp"
+#include "nclist/batch.hpp"
+
+TEST(CompressedNclist, Basic) {
+    std::vector<int> starts { 10, 20, 100, 15, -5 };
+    std::vector<int> ends   { 50, 30, 150, 25, 200 };
+    auto full = nclist::build(5, starts.data(), ends.data());
+    auto comp = nclist::compress(full);
+    EXPECT_EQ(comp.root_children, full.root_children);
+    EXPECT_EQ(comp.num_nodes, full.nodes.size());
+    EXPECT_EQ(comp.block_min_starts.size(), 1);
+    EXPECT_EQ(comp.block_min_starts.front(), -5);
+    EXPECT_EQ(comp.block_max_ends.front(), 200);
+
+    nclist::CompressedNclistWorkspace<int, int> cwork;
+    EXPECT_EQ(cwork.num_decompressed(), 0);
+    nclist::OverlapsAnyWorkspace<int> workspace;
+    nclist::OverlapsAnyParameters<int> params;
+    std::vector<int> matches;
+    nclist::overlaps_any(nclist::make_view(comp, cwork), 18, 22, params, workspace, matches);
+    std::sort(matches.begin(), matches.end());
+    EXPECT_EQ(matches, std::vector<int>({ 0, 1, 3, 4 }));
+    EXPECT_EQ(cwork.num_decompressed(), 1);
+
+    cwork.clear();
+    EXPECT_EQ(cwork.num_decompressed(), 0);
+
+    // Round-tripping works correctly.
+    auto roundtrip = nclist::decompress(comp);
+    EXPECT_EQ(roundtrip.root_children, full.root_children);
+    EXPECT_EQ(roundtrip.starts, full.starts);
+    EXPECT_EQ(roundtrip.ends, full.ends);
+    EXPECT_EQ(roundtrip.duplicates, full.duplicates);
+    ASSERT_EQ(roundtrip.nodes.size(), full.nodes.size());
+    for (std::size_t i = 0; i < full.nodes.size(); ++i) {
+        EXPECT_EQ(roundtrip.nodes[i].id, full.nodes[i].id);
+        EXPECT_EQ(roundtrip.nodes[i].children_start, full.nodes[i].children_start);
+        EXPECT_EQ(roundtrip.nodes[i].children_end, full.nodes[i].children_end);
+        EXPECT_EQ(roundtrip.nodes[i].duplicates_start, full.nodes[i].duplicates_start);
+        EXPECT_EQ(roundtrip.nodes[i].duplicates_end, full.nodes[i].duplicates_end);
+    }
+
+    // Empty lists are supported.
+    auto empty = nclist::compress(nclist::build(0, starts.data(), ends.data()));
+    EXPECT_EQ(empty.num_nodes, 0);
+    nclist::overlaps_any(nclist::make_view(empty, cwork), 18, 22, params, workspace, matches);
+    EXPECT_TRUE(matches.empty());
+    nclist::overlaps_any(nclist::make_view(empty, cwork, 18, 22), 18, 22, params, workspace, matches);
+    EXPECT_TRUE(matches.empty());
+}
+
+TEST(CompressedNclist, Workspace) {
+    std::vector<int> starts, ends;
+    for (int i = 0; i < 1000; ++i) {
+        starts.push_back(i * 10);
+        ends.push_back(i * 10 + 5);
+    }
+    auto comp = nclist::compress(nclist::build(1000, starts.data(), ends.data()));
+    EXPECT_EQ(comp.block_min_starts.size(), 16);
+    EXPECT_LT(nclist::compressed_size(comp), sizeof(int) * 2000);
+
+    nclist::CompressedNclistWorkspace<int, int> cwork;
+    nclist::OverlapsAnyWorkspace<int> workspace;
+    nclist::OverlapsAnyParameters<int> params;
+    std::vector<int> matches;
+
+    // Windowed views only decompress the blocks that are needed.
+    nclist::overlaps_any(nclist::make_view(comp, cwork, 5003, 5012), 5003, 5012, params, workspace, matches);
+    EXPECT_EQ(matches, std::vector<int>({ 500, 501 }));
+    EXPECT_EQ(cwork.num_decompressed(), 1);
+
+    // Switching to a different index discards the existing blocks.
+    std::vector<int> other_starts { 1, 2, 3 }, other_ends { 4, 5, 6 };
+    auto other = nclist::compress(nclist::build(3, other_starts.data(), other_ends.data()));
+    nclist::overlaps_any(nclist::make_view(other, cwork), 0, 10, params, workspace, matches);
+    std::sort(matches.begin(), matches.end());
+    EXPECT_EQ(matches, std::vector<int>({ 0, 1, 2 }));
+    EXPECT_EQ(cwork.num_decompressed(), 1);
+
+    nclist::overlaps_any(nclist::make_view(comp, cwork), 9000, 9001, params, workspace, matches);
+    EXPECT_EQ(matches, std::vector<int>({ 900 }));
+}
+
+TEST(CompressedNclist, Eviction) {
+    std::vector<int> starts, ends;
+    for (int i = 0; i < 1000; ++i) {
+        starts.push_back(i * 10);
+        ends.push_back(i * 10 + 5);
+    }
+    starts.push_back(0); // adding a long interval so that we need to jump between blocks.
+    ends.push_back(10000);
+    auto full = nclist::build(1001, starts.data(), ends.data());
+    auto comp = nclist::compress(full);
+
+    nclist::CompressedNclistWorkspace<int, int> cwork(2);
+    EXPECT_EQ(cwork.get_max_blocks(), 2);
+    nclist::OverlapsAnyWorkspace<int> workspace;
+    nclist::OverlapsAnyParameters<int> params;
+    std::vector<int> expected, observed;
+
+    for (int q = 0; q < 10000; q += 37) {
+        nclist::overlaps_any(full, q, q + 100, params, workspace, expected);
+        nclist::overlaps_any(nclist::make_view(comp, cwork), q, q + 100, params, workspace, observed);
+        EXPECT_EQ(expected, observed);
+        EXPECT_LE(cwork.num_decompressed(), 2);
+    }
+
+    nclist::overlaps_any(nclist::make_view(comp, cwork), 0, 10000, params, workspace, observed);
+    EXPECT_EQ(observed.size(), 1001);
+    EXPECT_EQ(cwork.num_decompressed(), 2);
+
+    // Changing the limit discards all blocks.
+    cwork.set_max_blocks(0);
+    EXPECT_EQ(cwork.num_decompressed(), 0);
+    nclist::overlaps_any(nclist::make_view(comp, cwork), 0, 10000, params, workspace, observed);
+    EXPECT_EQ(observed.size(), 1001);
+    EXPECT_EQ(cwork.num_decompressed(), comp.block_min_starts.size());
+
+    cwork.set_max_blocks(1);
+    for (int q = 0; q < 10000; q += 37) {
+        nclist::overlaps_any(full, q, q + 100, params, workspace, expected);
+        nclist::overlaps_any(nclist::make_view(comp, cwork), q, q + 100, params, workspace, observed);
+        EXPECT_EQ(expected, observed);
+        EXPECT_EQ(cwork.num_decompressed(), 1);
+    }
+
+    cwork.clear();
+    EXPECT_EQ(cwork.num_decompressed(), 0);
+}
+
+class CompressedNclistTest : public ::testing::TestWithParam<std::tuple<int, int> > {
+protected:
+    std::vector<int> query_start, query_end, subject_start, subject_end;
+
+    void SetUp() {
+        auto params = GetParam();
+        const int nquery = std::get<0>(params);
+        const int nsubject = std::get<1>(params);
+        std::mt19937_64 rng(nquery * 17 + nsubject);
+
+        for (int q = 0; q < nquery; ++q) {
+            const int qstart = static_cast<int>(rng() % 2200) - 1100;
+            query_start.push_back(qstart);
+            query_end.push_back(qstart + static_cast<int>(rng() % 50));
+        }
+
+        // Using a mix of short and long intervals so that we get multiple levels of nesting.
+        for (int s = 0; s < nsubject; ++s) {
+            const int sstart = static_cast<int>(rng() % 2000) - 1000;
+            subject_start.push_back(sstart);
+            subject_end.push_back(sstart + static_cast<int>(rng() % (s % 10 == 0 ? 200 : 20) + 1));
+        }
+    }
+
+    template<class Parameters_, class Workspace_, class Search_>
+    void compare(const Parameters_& params, Search_ search, int gap) {
+        auto full = nclist::build(static_cast<int>(subject_start.size()), subject_start.data(), subject_end.data());
+        auto comp = nclist::compress(full);
+        nclist::CompressedNclistWorkspace<int, int> cwork;
+        auto cview = nclist::make_view(comp, cwork);
+        Workspace_ workspace;
+        std::vector<int> expected, observed;
+        for (std::size_t q = 0; q < query_start.size(); ++q) {
+            search(full, query_start[q], query_end[q], params, workspace, expected);
+            std::sort(expected.begin(), expected.end());
+            search(cview, query_start[q], query_end[q], params, workspace, observed);
+            std::sort(observed.begin(), observed.end());
+            EXPECT_EQ(expected, observed);
+
+            if (gap >= 0) {
+                search(nclist::make_view(comp, cwork, query_start[q] - gap - 1, query_end[q] + gap + 1), query_start[q], query_end[q], params, workspace, observed);
+                std::sort(observed.begin(), observed.end());
+                EXPECT_EQ(expected, observed);
+            }
+        }
+    }
+};
+
+TEST_P(CompressedNclistTest, Overlaps) {
+    {
+        nclist::OverlapsAnyParameters<int> params;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_any(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsAnyWorkspace<int> >(params, fun, 0);
+        params.max_gap = 10;
+        compare<decltype(params), nclist::OverlapsAnyWorkspace<int> >(params, fun, 10);
+        params.min_overlap = 5;
+        compare<decltype(params), nclist::OverlapsAnyWorkspace<int> >(params, fun, 10);
+    }
+
+    {
+        nclist::OverlapsWithinParameters<int> params;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_within(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsWithinWorkspace<int> >(params, fun, 0);
+    }
+
+    {
+        nclist::OverlapsExtendParameters<int> params;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_extend(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsExtendWorkspace<int> >(params, fun, 0);
+    }
+
+    {
+        nclist::OverlapsEqualParameters<int> params;
+        params.max_gap = 5;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_equal(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsEqualWorkspace<int> >(params, fun, 5);
+    }
+
+    {
+        nclist::OverlapsStartParameters<int> params;
+        params.max_gap = 5;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_start(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsStartWorkspace<int> >(params, fun, -1);
+    }
+
+    {
+        nclist::OverlapsEndParameters<int> params;
+        params.max_gap = 5;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_end(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsEndWorkspace<int> >(params, fun, -1);
+    }
+}
+
+TEST_P(CompressedNclistTest, Others) {
+    {
+        nclist::NearestParameters<int> params;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::nearest(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::NearestWorkspace<int> >(params, fun, -1);
+    }
+
+    {
+        nclist::ClassifyOverlapsParameters<int> params;
+        std::vector<unsigned char> types;
+        auto fun = [&](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void {
+            nclist::classify_overlaps(s, qs, qe, p, w, m, types);
+            for (std::size_t i = 0; i < m.size(); ++i) { // packing the types into the output for comparison.
+                m[i] = m[i] * 64 + types[i];
+            }
+        };
+        compare<decltype(params), nclist::ClassifyOverlapsWorkspace<int> >(params, fun, 0);
+    }
+
+    {
+        auto full = nclist::build(static_cast<int>(subject_start.size()), subject_start.data(), subject_end.data());
+        auto comp = nclist::compress(full);
+        nclist::CompressedNclistWorkspace<int, int> cwork;
+        nclist::OverlapsBatchParameters<int> params;
+        params.max_gap = 10;
+        std::vector<nclist::OverlapType> types;
+        for (std::size_t q = 0; q < query_start.size(); ++q) {
+            types.push_back(static_cast<nclist::OverlapType>(q % 6));
+        }
+        params.types = types.data();
+
+        std::vector<std::size_t> expected_offsets, observed_offsets;
+        std::vector<int> expected, observed;
+        nclist::overlaps_batch(full, query_start.size(), query_start.data(), query_end.data(), params, expected_offsets, expected);
+        nclist::overlaps_batch(nclist::make_view(comp, cwork), query_start.size(), query_start.data(), query_end.data(), params, observed_offsets, observed);
+        EXPECT_EQ(expected_offsets, observed_offsets);
+        EXPECT_EQ(expected, observed);
+
+        // Each worker uses its own workspace, which inherits the limit of the original workspace.
+        nclist::CompressedNclistWorkspace<int, int> cwork_small(3);
+        params.num_threads = 3;
+        nclist::overlaps_batch(nclist::make_view(comp, cwork_small), query_start.size(), query_start.data(), query_end.data(), params, observed_offsets, observed);
+        EXPECT_EQ(expected_offsets, observed_offsets);
+        EXPECT_EQ(expected, observed);
+        EXPECT_EQ(cwork_small.num_decompressed(), 0);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    CompressedNclist,
+    CompressedNclistTest,
+    ::testing::Combine(
+        ::testing::Values(10, 100, 1000), // num of query ranges
+        ::testing::Values(10, 100, 1000) // number of subject ranges
+    )
+);
@@ -0,0 +1,278 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstddef>
+#include <set>
+
+#include "nclist/count_reads.hpp"
+#include "utils.hpp"
+
+TEST(CountReads, FeatureMap) {
+    std::vector<int> starts { 10, 30, 50, 30, 0 };
+    std::vector<int> ends   { 20, 45, 70, 45, 5 };
+    auto index = nclist::build<int, int>(starts.size(), starts.data(), ends.data());
+
+    auto identity = nclist::build_feature_map(index, 5, static_cast<const int*>(NULL), 0);
+    EXPECT_EQ(identity.num_features, 5);
+    EXPECT_TRUE(identity.features.empty());
+    for (int i = 0; i < 5; ++i) {
+        const auto node = identity.nodes[i];
+        EXPECT_EQ(index.starts[node], starts[i]);
+        EXPECT_EQ(index.ends[node], ends[i]);
+    }
+
+    std::vector<int> genes { 0, 1, 1, 1, 0 };
+    auto grouped = nclist::build_feature_map(index, 5, genes.data(), 2);
+    EXPECT_EQ(grouped.num_features, 2);
+    EXPECT_EQ(grouped.features, genes);
+}
+
+TEST(CountReads, Assign) {
+    std::vector<int> starts { 10, 30, 50, 100 };
+    std::vector<int> ends   { 20, 45, 70, 200 };
+    std::vector<int> genes  { 0, 0, 1, 2 };
+    auto index = nclist::build<int, int>(starts.size(), starts.data(), ends.data());
+    auto features = nclist::build_feature_map(index, 4, genes.data(), 3);
+
+    nclist::CountReadsParameters<int> params;
+    nclist::AssignReadWorkspace<int, int> workspace;
+    std::vector<int> hits;
+
+    // Spliced read with blocks in two exons of the same gene.
+    std::vector<int> bstarts { 15, 35 }, bends { 20, 40 };
+    nclist::assign_read(index, features, 2, bstarts.data(), bends.data(), params, workspace, hits);
+    EXPECT_EQ(hits, std::vector<int>({ 0 }));
+
+    // Read overlapping two genes.
+    bstarts = { 40, 55 };
+    bends = { 45, 60 };
+    nclist::assign_read(index, features, 2, bstarts.data(), bends.data(), params, workspace, hits);
+    std::sort(hits.begin(), hits.end());
+    EXPECT_EQ(hits, std::vector<int>({ 0, 1 }));
+
+    // Minimum overlap is computed across all blocks.
+    params.min_overlap = 8;
+    nclist::assign_read(index, features, 2, bstarts.data(), bends.data(), params, workspace, hits);
+    EXPECT_TRUE(hits.empty());
+    bstarts = { 15, 35, 60 };
+    bends = { 20, 40, 63 };
+    nclist::assign_read(index, features, 3, bstarts.data(), bends.data(), params, workspace, hits);
+    EXPECT_EQ(hits, std::vector<int>({ 0 }));
+
+    // Read with no overlaps.
+    params.min_overlap = 0;
+    bstarts = { 80 };
+    bends = { 90 };
+    nclist::assign_read(index, features, 1, bstarts.data(), bends.data(), params, workspace, hits);
+    EXPECT_TRUE(hits.empty());
+}
+
+TEST(CountReads, OverlappingExons) {
+    // Gene 0 has two identical exon records, while gene 1 has two overlapping exons from different transcripts.
+    std::vector<int> starts { 100, 100, 300, 320 };
+    std::vector<int> ends   { 200, 200, 350, 380 };
+    std::vector<int> genes  { 0, 0, 1, 1 };
+    auto index = nclist::build<int, int>(starts.size(), starts.data(), ends.data());
+    auto features = nclist::build_feature_map(index, 4, genes.data(), 2);
+
+    nclist::CountReadsParameters<int> params;
+    params.min_overlap = 10;
+    nclist::AssignReadWorkspace<int, int> workspace;
+    std::vector<int> hits;
+
+    // Only 5 bases of the read are in gene 0, even though they are covered by both exon records.
+    std::vector<int> bstarts { 195 }, bends { 205 };
+    nclist::assign_read(index, features, 1, bstarts.data(), bends.data(), params, workspace, hits);
+    EXPECT_TRUE(hits.empty());
+
+    params.min_overlap = 5;
+    nclist::assign_read(index, features, 1, bstarts.data(), bends.data(), params, workspace, hits);
+    EXPECT_EQ(hits, std::vector<int>({ 0 }));
+
+    // The read covers [340, 360) of gene 1, which is 20 bases across both exons rather than 10 + 20.
+    bstarts = { 340 };
+    bends = { 360 };
+    params.min_overlap = 21;
+    nclist::assign_read(index, features, 1, bstarts.data(), bends.data(), params, workspace, hits);
+    EXPECT_TRUE(hits.empty());
+    params.min_overlap = 20;
+    nclist::assign_read(index, features, 1, bstarts.data(), bends.data(), params, workspace, hits);
+    EXPECT_EQ(hits, std::vector<int>({ 1 }));
+
+    // Gaps between the covered subintervals are not counted.
+    bstarts = { 190, 330 };
+    bends = { 210, 345 };
+    params.min_overlap = 25;
+    nclist::assign_read(index, features, 2, bstarts.data(), bends.data(), params, workspace, hits);
+    EXPECT_TRUE(hits.empty());
+    params.min_overlap = 15;
+    nclist::assign_read(index, features, 2, bstarts.data(), bends.data(), params, workspace, hits);
+    EXPECT_EQ(hits, std::vector<int>({ 1 }));
+}
+
+TEST(CountReads, OverlappingMates) {
+    std::vector<int> starts { 100 };
+    std::vector<int> ends   { 200 };
+    auto index = nclist::build<int, int>(starts.size(), starts.data(), ends.data());
+    auto features = nclist::build_feature_map(index, 1, static_cast<const int*>(NULL), 0);
+
+    nclist::CountReadsParameters<int> params;
+    nclist::AssignReadWorkspace<int, int> workspace;
+    std::vector<int> hits;
+
+    // Mates of a paired-end fragment overlap at [180, 190), so the fragment covers 30 bases of the feature rather than 20 + 20.
+    std::vector<int> bstarts { 170, 180 }, bends { 190, 230 };
+    params.min_overlap = 31;
+    nclist::assign_read(index, features, 2, bstarts.data(), bends.data(), params, workspace, hits);
+    EXPECT_TRUE(hits.empty());
+    params.min_overlap = 30;
+    nclist::assign_read(index, features, 2, bstarts.data(), bends.data(), params, workspace, hits);
+    EXPECT_EQ(hits, std::vector<int>({ 0 }));
+}
+
+class CountReadsTest : public OverlapsTestCore, public ::testing::TestWithParam<std::tuple<int, int, int, int> > {
+protected:
+    int min_overlap, num_threads;
+    void SetUp() {
+        auto params = GetParam();
+        assemble(params);
+        min_overlap = std::get<2>(params);
+        num_threads = std::get<3>(params);
+    }
+};
+
+TEST_P(CountReadsTest, Reference) {
+    // Treating pairs of consecutive queries as the blocks of a single read.
+    const std::size_t num_reads = nquery / 2;
+    std::vector<std::size_t> offsets(num_reads + 1);
+    for (std::size_t r = 0; r <= num_reads; ++r) {
+        offsets[r] = r * 2;
+    }
+
+    // Assigning subjects to features in an interleaved manner.
+    const int num_features = std::max(1, nsubject / 3);
+    std::vector<int> feature_of(nsubject);
+    for (int s = 0; s < nsubject; ++s) {
+        feature_of[s] = s % num_features;
+    }
+
+    auto index = nclist::build(nsubject, subject_start.data(), subject_end.data());
+    auto features = nclist::build_feature_map(index, nsubject, feature_of.data(), num_features);
+
+    // Computing the expected result with a brute-force search.
+    nclist::CountReadsParameters<int> params;
+    params.min_overlap = min_overlap;
+    std::vector<std::vector<int> > expected_hits(num_reads);
+    for (std::size_t r = 0; r < num_reads; ++r) {
+        // Each position of the read is only counted once per feature, even if it is covered by multiple blocks or subject intervals.
+        std::vector<std::set<int> > covered(num_features);
+        std::vector<char> found(num_features);
+        for (auto b = offsets[r]; b < offsets[r + 1]; ++b) {
+            for (int s = 0; s < nsubject; ++s) {
+                const int common_start = std::max(query_start[b], subject_start[s]);
+                const int common_end = std::min(query_end[b], subject_end[s]);
+                if (common_start < common_end) {
+                    found[feature_of[s]] = 1;
+                    for (int pos = common_start; pos < common_end; ++pos) {
+                        covered[feature_of[s]].insert(pos);
+                    }
+                }
+            }
+        }
+        for (int f = 0; f < num_features; ++f) {
+            if (found[f] && static_cast<int>(covered[f].size()) >= min_overlap) {
+                expected_hits[r].push_back(f);
+            }
+        }
+    }
+
+    for (auto policy : { nclist::MultiFeaturePolicy::UNIQUE, nclist::MultiFeaturePolicy::ALL, nclist::MultiFeaturePolicy::FRACTIONAL }) {
+        std::vector<double> expected(num_features);
+        std::size_t assigned = 0, ambiguous = 0, no_features = 0;
+        for (const auto& hits : expected_hits) {
+            if (hits.empty()) {
+                ++no_features;
+                continue;
+            }
+            if (hits.size() > 1) {
+                ++ambiguous;
+                if (policy == nclist::MultiFeaturePolicy::UNIQUE) {
+                    continue;
+                }
+            }
+            ++assigned;
+            for (auto h : hits) {
+                expected[h] += (policy == nclist::MultiFeaturePolicy::FRACTIONAL ? 1.0 / hits.size() : 1.0);
+            }
+        }
+
+        params.policy = policy;
+        params.num_threads = num_threads;
+        auto res = nclist::count_reads(index, features, num_reads, offsets.data(), query_start.data(), query_end.data(), params);
+        ASSERT_EQ(res.counts.size(), expected.size());
+        for (int f = 0; f < num_features; ++f) {
+            EXPECT_NEAR(res.counts[f], expected[f], 1e-8);
+        }
+        EXPECT_EQ(res.assigned, assigned);
+        EXPECT_EQ(res.ambiguous, ambiguous);
+        EXPECT_EQ(res.no_features, no_features);
+    }
+}
+
+TEST_P(CountReadsTest, Profile) {
+    const std::size_t num_reads = nquery / 2;
+    std::vector<std::size_t> offsets(num_reads + 1);
+    for (std::size_t r = 0; r <= num_reads; ++r) {
+        offsets[r] = r * 2;
+    }
+
+    auto index = nclist::build(nsubject, subject_start.data(), subject_end.data());
+    auto features = nclist::build_feature_map<int, int>(index, nsubject, NULL, 0);
+    nclist::CountReadsParameters<int> params;
+    params.min_overlap = min_overlap;
+    params.num_threads = num_threads;
+    auto ref = nclist::count_reads(index, features, num_reads, offsets.data(), query_start.data(), query_end.data(), params);
+
+    nclist::CountReadsProfile profile;
+    profile.num_slowest = 3;
+    params.profile = &profile;
+    auto res = nclist::count_reads(index, features, num_reads, offsets.data(), query_start.data(), query_end.data(), params);
+    EXPECT_EQ(res.counts, ref.counts);
+    EXPECT_EQ(res.assigned, ref.assigned);
+    EXPECT_EQ(profile.latencies.count(), num_reads);
+
+    ASSERT_EQ(profile.slowest.size(), std::min<std::size_t>(3, num_reads));
+    EXPECT_EQ(profile.slowest.front().nanoseconds, profile.latencies.max());
+    nclist::AssignReadWorkspace<int, int> workspace;
+    std::vector<int> hits;
+    for (std::size_t i = 0; i < profile.slowest.size(); ++i) {
+        const auto& slow = profile.slowest[i];
+        if (i) {
+            EXPECT_GE(profile.slowest[i - 1].nanoseconds, slow.nanoseconds);
+        }
+        EXPECT_EQ(slow.num_blocks, 2);
+        const auto r = slow.index;
+        nclist::assign_read(index, features, 2, query_start.data() + offsets[r], query_end.data() + offsets[r], params, workspace, hits);
+        EXPECT_EQ(slow.num_hits, hits.size());
+    }
+
+    // Results are accumulated across calls.
+    nclist::count_reads(index, features, num_reads, offsets.data(), query_start.data(), query_end.data(), params);
+    EXPECT_EQ(profile.latencies.count(), 2 * num_reads);
+    profile.clear();
+    EXPECT_EQ(profile.latencies.count(), 0);
+    EXPECT_TRUE(profile.slowest.empty());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    CountReads,
+    CountReadsTest,
+    ::testing::Combine(
+        ::testing::Values(10, 100, 1000), // num of query ranges
+        ::testing::Values(10, 100, 1000), // number of subject ranges
+        ::testing::Values(0, 10), // min overlap
+        ::testing::Values(1, 3) // number of threads
+    )
+);
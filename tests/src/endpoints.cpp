@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+#include "nclist/overlaps_start.hpp"
+#include "nclist/overlaps_end.hpp"
+#include "nclist/endpoints.hpp"
+#include "utils.hpp"
+
+TEST(Endpoints, Empty) {
+    auto index = nclist::build<int, int>(0, NULL, NULL);
+    auto endpoints = nclist::build_endpoint_index(index);
+    std::vector<int> output;
+
+    nclist::starts_in_range(index, endpoints, 0, 100, output);
+    EXPECT_TRUE(output.empty());
+    nclist::ends_in_range(index, endpoints, 0, 100, output);
+    EXPECT_TRUE(output.empty());
+
+    nclist::OverlapsStartParameters<int> sparams;
+    nclist::overlaps_start(index, endpoints, 100, 200, sparams, output);
+    EXPECT_TRUE(output.empty());
+    nclist::OverlapsEndParameters<int> eparams;
+    nclist::overlaps_end(index, endpoints, 100, 200, eparams, output);
+    EXPECT_TRUE(output.empty());
+}
+
+TEST(Endpoints, Ranges) {
+    std::vector<int> test_starts { 10, 30, 50, 30, 0, 50, 35 };
+    std::vector<int> test_ends   { 20, 45, 70, 45, 5, 70, 40 };
+    auto index = nclist::build<int, int>(test_starts.size(), test_starts.data(), test_ends.data());
+    auto endpoints = nclist::build_endpoint_index(index);
+    std::vector<int> output;
+
+    // Starts are nested within [0, 5) and [30, 45), so they are not sorted in 'Nclist::starts'.
+    nclist::starts_in_range(index, endpoints, 30, 50, output);
+    ASSERT_EQ(output.size(), 3);
+    EXPECT_EQ(output.back(), 6); // as the reported intervals are sorted by start position.
+    std::sort(output.begin(), output.end());
+    EXPECT_EQ(output, std::vector<int>({ 1, 3, 6 }));
+
+    nclist::starts_in_range(index, endpoints, 30, 51, output);
+    std::sort(output.begin(), output.end());
+    EXPECT_EQ(output, std::vector<int>({ 1, 2, 3, 5, 6 }));
+
+    nclist::starts_in_range(index, endpoints, 11, 30, output);
+    EXPECT_TRUE(output.empty());
+
+    nclist::ends_in_range(index, endpoints, 20, 45, output);
+    EXPECT_EQ(output, std::vector<int>({ 0, 6 }));
+
+    nclist::ends_in_range(index, endpoints, 0, 100, output);
+    EXPECT_EQ(output.size(), test_starts.size());
+    for (std::size_t i = 1; i < output.size(); ++i) {
+        EXPECT_LE(test_ends[output[i - 1]], test_ends[output[i]]);
+    }
+}
+
+class EndpointsTest : public OverlapsTestCore, public ::testing::TestWithParam<std::tuple<int, int, int, int> > {
+protected:
+    int min_overlap, max_gap;
+    void SetUp() {
+        auto params = GetParam();
+        assemble(params);
+        min_overlap = std::get<2>(params);
+        max_gap = std::get<3>(params);
+    }
+};
+
+TEST_P(EndpointsTest, Start) {
+    // Adding some queries with the same start positions as the subjects.
+    for (int s = 0; s < nsubject; s += 3) {
+        query_start.push_back(subject_start[s]);
+        query_end.push_back(subject_end[s] + s % 7);
+    }
+
+    auto index = nclist::build(nsubject, subject_start.data(), subject_end.data());
+    auto endpoints = nclist::build_endpoint_index(index);
+
+    nclist::OverlapsStartWorkspace<int> work;
+    nclist::OverlapsStartParameters<int> params;
+    params.min_overlap = min_overlap;
+    params.max_gap = max_gap;
+    std::vector<int> ref, results;
+
+    for (std::size_t q = 0; q < query_start.size(); ++q) {
+        nclist::overlaps_start(index, query_start[q], query_end[q], params, work, ref);
+        std::sort(ref.begin(), ref.end());
+        nclist::overlaps_start(index, endpoints, query_start[q], query_end[q], params, results);
+        std::sort(results.begin(), results.end());
+        EXPECT_EQ(results, ref);
+    }
+
+    params.quit_on_first = true;
+    for (std::size_t q = 0; q < query_start.size(); ++q) {
+        nclist::overlaps_start(index, query_start[q], query_end[q], params, work, ref);
+        nclist::overlaps_start(index, endpoints, query_start[q], query_end[q], params, results);
+        EXPECT_EQ(results.size(), ref.size());
+    }
+}
+
+TEST_P(EndpointsTest, End) {
+    // Adding some queries with the same end positions as the subjects.
+    for (int s = 0; s < nsubject; s += 3) {
+        query_start.push_back(subject_start[s] - s % 7);
+        query_end.push_back(subject_end[s]);
+    }
+
+    auto index = nclist::build(nsubject, subject_start.data(), subject_end.data());
+    auto endpoints = nclist::build_endpoint_index(index);
+
+    nclist::OverlapsEndWorkspace<int> work;
+    nclist::OverlapsEndParameters<int> params;
+    params.min_overlap = min_overlap;
+    params.max_gap = max_gap;
+    std::vector<int> ref, results;
+
+    for (std::size_t q = 0; q < query_start.size(); ++q) {
+        nclist::overlaps_end(index, query_start[q], query_end[q], params, work, ref);
+        std::sort(ref.begin(), ref.end());
+        nclist::overlaps_end(index, endpoints, query_start[q], query_end[q], params, results);
+        std::sort(results.begin(), results.end());
+        EXPECT_EQ(results, ref);
+    }
+
+    params.quit_on_first = true;
+    for (std::size_t q = 0; q < query_start.size(); ++q) {
+        nclist::overlaps_end(index, query_start[q], query_end[q], params, work, ref);
+        nclist::overlaps_end(index, endpoints, query_start[q], query_end[q], params, results);
+        EXPECT_EQ(results.size(), ref.size());
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Endpoints,
+    EndpointsTest,
+    ::testing::Combine(
+        ::testing::Values(10, 100, 1000), // num of query ranges
+        ::testing::Values(10, 100, 1000), // number of subject ranges
+        ::testing::Values(0, 10), // min overlap
+        ::testing::Values(0, 5) // max gap 
+    )
+);
+
+TEST(Endpoints, Unsigned) {
+    std::vector<unsigned> test_starts { 0, 2, 10, 4294967290u };
+    std::vector<unsigned> test_ends { 5, 3, 20, 4294967295u };
+    auto index = nclist::build<int, unsigned>(test_starts.size(), test_starts.data(), test_ends.data());
+    auto endpoints = nclist::build_endpoint_index(index);
+    std::vector<int> output;
+
+    nclist::OverlapsStartParameters<unsigned> sparams;
+    sparams.max_gap = 5;
+    nclist::overlaps_start(index, endpoints, 1u, 10u, sparams, output);
+    std::sort(output.begin(), output.end());
+    EXPECT_EQ(output, std::vector<int>({ 0, 1 }));
+    nclist::overlaps_start(index, endpoints, 4294967294u, 4294967295u, sparams, output);
+    EXPECT_EQ(output, std::vector<int>({ 3 }));
+
+    nclist::OverlapsEndParameters<unsigned> eparams;
+    eparams.max_gap = 10;
+    nclist::overlaps_end(index, endpoints, 4294967290u, 4294967295u, eparams, output);
+    EXPECT_EQ(output, std::vector<int>({ 3 }));
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+#include "nclist/overlaps_equal.hpp"
+#include "nclist/equal_index.hpp"
+#include "utils.hpp"
+
+TEST(EqualIndex, Empty) {
+    auto index = nclist::build<int, int>(0, NULL, NULL);
+    auto hashed = nclist::build_equal_index(index);
+    nclist::OverlapsEqualParameters<int> params;
+    nclist::OverlapsEqualWorkspace<int> workspace;
+    std::vector<int> output;
+    nclist::overlaps_equal(index, hashed, 100, 200, params, workspace, output);
+    EXPECT_TRUE(output.empty());
+}
+
+TEST(EqualIndex, Duplicates) {
+    std::vector<int> test_starts { 10, 30, 50, 30, 0, 50, 30 };
+    std::vector<int> test_ends   { 20, 45, 70, 45, 5, 70, 30 };
+    auto index = nclist::build<int, int>(test_starts.size(), test_starts.data(), test_ends.data());
+    auto hashed = nclist::build_equal_index(index);
+
+    nclist::OverlapsEqualParameters<int> params;
+    nclist::OverlapsEqualWorkspace<int> workspace;
+    std::vector<int> output;
+
+    nclist::overlaps_equal(index, hashed, 30, 45, params, workspace, output);
+    std::sort(output.begin(), output.end());
+    EXPECT_EQ(output, std::vector<int>({ 1, 3 }));
+
+    nclist::overlaps_equal(index, hashed, 30, 30, params, workspace, output);
+    EXPECT_EQ(output, std::vector<int>({ 6 }));
+
+    nclist::overlaps_equal(index, hashed, 30, 46, params, workspace, output);
+    EXPECT_TRUE(output.empty());
+
+    params.quit_on_first = true;
+    nclist::overlaps_equal(index, hashed, 50, 70, params, workspace, output);
+    ASSERT_EQ(output.size(), 1);
+    EXPECT_TRUE(output[0] == 2 || output[0] == 5);
+
+    params.quit_on_first = false;
+    params.min_overlap = 1;
+    nclist::overlaps_equal(index, hashed, 30, 30, params, workspace, output);
+    EXPECT_TRUE(output.empty());
+    params.min_overlap = 20;
+    nclist::overlaps_equal(index, hashed, 30, 45, params, workspace, output);
+    EXPECT_TRUE(output.empty());
+    nclist::overlaps_equal(index, hashed, 50, 70, params, workspace, output);
+    EXPECT_EQ(output.size(), 2);
+}
+
+class EqualIndexTest : public OverlapsTestCore, public ::testing::TestWithParam<std::tuple<int, int, int, int> > {
+protected:
+    int min_overlap, max_gap;
+    void SetUp() {
+        auto params = GetParam();
+        assemble(params);
+        min_overlap = std::get<2>(params);
+        max_gap = std::get<3>(params);
+    }
+};
+
+TEST_P(EqualIndexTest, Reference) {
+    // Adding some exact duplicates of the subjects to the queries.
+    for (int s = 0; s < nsubject; s += 3) {
+        query_start.push_back(subject_start[s]);
+        query_end.push_back(subject_end[s]);
+    }
+
+    auto index = nclist::build(nsubject, subject_start.data(), subject_end.data());
+    auto hashed = nclist::build_equal_index(index);
+
+    nclist::OverlapsEqualWorkspace<int> work;
+    nclist::OverlapsEqualParameters<int> params;
+    params.min_overlap = min_overlap;
+    params.max_gap = max_gap;
+    std::vector<int> ref, results;
+
+    for (std::size_t q = 0; q < query_start.size(); ++q) {
+        nclist::overlaps_equal(index, query_start[q], query_end[q], params, work, ref);
+        std::sort(ref.begin(), ref.end());
+        nclist::overlaps_equal(index, hashed, query_start[q], query_end[q], params, work, results);
+        std::sort(results.begin(), results.end());
+        EXPECT_EQ(results, ref);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    EqualIndex,
+    EqualIndexTest,
+    ::testing::Combine(
+        ::testing::Values(10, 100, 1000), // num of query ranges
+        ::testing::Values(10, 100, 1000), // number of subject ranges
+        ::testing::Values(0, 10), // min overlap
+        ::testing::Values(0, 5) // max gap 
+    )
+);
+
+TEST(EqualIndex, Double) {
+    std::vector<double> test_starts { 200.5, 300.1, 100.8, 500.5 };
+    std::vector<double> test_ends { 280.2, 320.9, 170.1, 510.5 };
+    auto index = nclist::build<int, double>(test_starts.size(), test_starts.data(), test_ends.data());
+    auto hashed = nclist::build_equal_index(index);
+
+    nclist::OverlapsEqualParameters<double> params;
+    nclist::OverlapsEqualWorkspace<int> workspace;
+    std::vector<int> output;
+
+    nclist::overlaps_equal(index, hashed, 100.8, 170.1, params, workspace, output);
+    EXPECT_EQ(output, std::vector<int>({ 2 }));
+
+    nclist::overlaps_equal(index, hashed, 101.0, 170.0, params, workspace, output);
+    EXPECT_TRUE(output.empty());
+    params.max_gap = 0.5;
+    nclist::overlaps_equal(index, hashed, 101.0, 170.0, params, workspace, output);
+    EXPECT_EQ(output, std::vector<int>({ 2 }));
+}
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+#include "nclist/hierarchy.hpp"
+#include "nclist/overlaps_within.hpp"
+#include "utils.hpp"
+
+TEST(Hierarchy, Simple) {
+    //                                 0   1   2   3   4   5   6
+    std::vector<int> test_starts {     0, 10, 12, 30, 12, 50, 20 };
+    std::vector<int> test_ends   {   100, 25, 15, 40, 15, 60, 25 };
+    auto index = nclist::build<int, int>(test_starts.size(), test_starts.data(), test_ends.data());
+    auto hier = nclist::build_hierarchy(index, static_cast<int>(test_starts.size()));
+
+    EXPECT_FALSE(nclist::find_parent(index, hier, 0).has_value());
+    EXPECT_EQ(*nclist::find_parent(index, hier, 1), 0);
+    EXPECT_EQ(*nclist::find_parent(index, hier, 2), 1);
+    EXPECT_EQ(*nclist::find_parent(index, hier, 4), 1);
+    EXPECT_EQ(*nclist::find_parent(index, hier, 6), 1);
+    EXPECT_EQ(*nclist::find_parent(index, hier, 5), 0);
+
+    std::vector<int> output;
+    nclist::find_children(index, hier, 0, output);
+    EXPECT_EQ(output, std::vector<int>({ 1, 3, 5 }));
+    nclist::find_children(index, hier, 1, output);
+    std::sort(output.begin(), output.begin() + 2);
+    EXPECT_EQ(output, std::vector<int>({ 2, 4, 6 }));
+    nclist::find_children(index, hier, 2, output);
+    EXPECT_TRUE(output.empty());
+
+    nclist::find_ancestors(index, hier, 6, output);
+    EXPECT_EQ(output, std::vector<int>({ 1, 0 }));
+    nclist::find_ancestors(index, hier, 0, output);
+    EXPECT_TRUE(output.empty());
+
+    nclist::find_descendants(index, hier, 0, output);
+    std::sort(output.begin() + 1, output.begin() + 3);
+    EXPECT_EQ(output, std::vector<int>({ 1, 2, 4, 6, 3, 5 }));
+    nclist::find_descendants(index, hier, 3, output);
+    EXPECT_TRUE(output.empty());
+}
+
+TEST(Hierarchy, Subset) {
+    std::vector<int> test_starts { 0, 10, 20, 30 };
+    std::vector<int> test_ends   { 100, 50, 30, 40 };
+    std::vector<int> subset { 0, 2, 3 };
+    auto index = nclist::build<int, int>(subset.size(), subset.data(), test_starts.data(), test_ends.data());
+    auto hier = nclist::build_hierarchy(index, static_cast<int>(test_starts.size()));
+
+    EXPECT_FALSE(nclist::find_parent(index, hier, 1).has_value());
+    EXPECT_EQ(*nclist::find_parent(index, hier, 2), 0);
+
+    std::vector<int> output;
+    nclist::find_children(index, hier, 1, output);
+    EXPECT_TRUE(output.empty());
+    nclist::find_ancestors(index, hier, 1, output);
+    EXPECT_TRUE(output.empty());
+    nclist::find_descendants(index, hier, 1, output);
+    EXPECT_TRUE(output.empty());
+    nclist::find_descendants(index, hier, 0, output);
+    EXPECT_EQ(output, std::vector<int>({ 2, 3 }));
+}
+
+TEST(Hierarchy, Empty) {
+    auto index = nclist::build<int, int>(0, NULL, NULL);
+    auto hier = nclist::build_hierarchy(index, 0);
+    EXPECT_TRUE(hier.nodes.empty());
+    EXPECT_TRUE(hier.parents.empty());
+}
+
+class HierarchyTest : public OverlapsTestCore, public ::testing::TestWithParam<int> {
+protected:
+    void SetUp() {
+        assemble(std::make_tuple(0, GetParam()));
+    }
+};
+
+TEST_P(HierarchyTest, Reference) {
+    auto index = nclist::build(nsubject, subject_start.data(), subject_end.data());
+    auto hier = nclist::build_hierarchy(index, nsubject);
+
+    nclist::OverlapsWithinParameters<int> wparams;
+    nclist::OverlapsWithinWorkspace<int> wwork;
+    nclist::FindDescendantsWorkspace<int> dwork;
+    std::vector<int> ancestors, children, descendants, containing;
+    std::vector<std::vector<int> > all_ancestors(nsubject);
+
+    for (int s = 0; s < nsubject; ++s) {
+        nclist::find_ancestors(index, hier, s, ancestors);
+        all_ancestors[s] = ancestors;
+
+        // Ancestors are a subset of the containing intervals.
+        nclist::overlaps_within(index, subject_start[s], subject_end[s], wparams, wwork, containing);
+        std::sort(containing.begin(), containing.end());
+        for (auto a : ancestors) {
+            EXPECT_NE(a, s);
+            EXPECT_TRUE(std::binary_search(containing.begin(), containing.end(), a));
+        }
+
+        // Ancestors are ordered from innermost to outermost.
+        for (std::size_t i = 1; i < ancestors.size(); ++i) {
+            EXPECT_LE(subject_start[ancestors[i]], subject_start[ancestors[i - 1]]);
+            EXPECT_GE(subject_end[ancestors[i]], subject_end[ancestors[i - 1]]);
+        }
+
+        auto parent = nclist::find_parent(index, hier, s);
+        EXPECT_EQ(parent.has_value(), !ancestors.empty());
+        if (parent.has_value()) {
+            EXPECT_EQ(subject_start[*parent], subject_start[ancestors.front()]);
+            EXPECT_EQ(subject_end[*parent], subject_end[ancestors.front()]);
+        }
+
+        // Children are sorted by their start positions.
+        nclist::find_children(index, hier, s, children);
+        for (std::size_t i = 1; i < children.size(); ++i) {
+            EXPECT_LE(subject_start[children[i - 1]], subject_start[children[i]]);
+        }
+    }
+
+    for (int s = 0; s < nsubject; ++s) {
+        nclist::find_descendants(index, hier, s, dwork, descendants);
+        std::sort(descendants.begin(), descendants.end());
+
+        std::vector<int> expected;
+        for (int t = 0; t < nsubject; ++t) {
+            const auto& anc = all_ancestors[t];
+            if (std::find(anc.begin(), anc.end(), s) != anc.end()) {
+                expected.push_back(t);
+            }
+        }
+        EXPECT_EQ(descendants, expected);
+
+        // Children are the descendants whose parent is 's' or one of its duplicates.
+        nclist::find_children(index, hier, s, children);
+        std::sort(children.begin(), children.end());
+        std::vector<int> expected_children;
+        for (auto t : expected) {
+            const auto parent = *nclist::find_parent(index, hier, t);
+            if (subject_start[parent] == subject_start[s] && subject_end[parent] == subject_end[s]) {
+                expected_children.push_back(t);
+            }
+        }
+        EXPECT_EQ(children, expected_children);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Hierarchy,
+    HierarchyTest,
+    ::testing::Values(10, 100, 1000) // number of subject ranges
+);
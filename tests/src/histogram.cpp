@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include "nclist/histogram.hpp"
+
+TEST(LatencyHistogram, Basic) {
+    nclist::LatencyHistogram hist;
+    EXPECT_EQ(hist.count(), 0);
+    EXPECT_EQ(hist.quantile(0.5), 0);
+    EXPECT_EQ(hist.mean(), 0);
+
+    // Small values are recorded exactly.
+    for (std::uint64_t i = 1; i <= 20; ++i) {
+        hist.add(i);
+    }
+    EXPECT_EQ(hist.count(), 20);
+    EXPECT_EQ(hist.min(), 1);
+    EXPECT_EQ(hist.max(), 20);
+    EXPECT_EQ(hist.mean(), 10.5);
+    EXPECT_EQ(hist.quantile(0.5), 10);
+    EXPECT_EQ(hist.quantile(0), 1);
+    EXPECT_EQ(hist.quantile(1), 20);
+
+    hist.clear();
+    EXPECT_EQ(hist.count(), 0);
+    hist.add(5);
+    EXPECT_EQ(hist.min(), 5);
+    EXPECT_EQ(hist.quantile(0.99), 5);
+
+    // Extreme values are handled correctly.
+    hist.add(std::numeric_limits<std::uint64_t>::max());
+    EXPECT_EQ(hist.max(), std::numeric_limits<std::uint64_t>::max());
+    EXPECT_EQ(hist.quantile(1), std::numeric_limits<std::uint64_t>::max());
+}
+
+TEST(LatencyHistogram, Precision) {
+    std::mt19937_64 rng(100);
+    std::vector<std::uint64_t> values;
+    nclist::LatencyHistogram hist;
+    for (int i = 0; i < 10000; ++i) {
+        const std::uint64_t val = rng() % (static_cast<std::uint64_t>(1) << (rng() % 40));
+        values.push_back(val);
+        hist.add(val);
+    }
+    std::sort(values.begin(), values.end());
+
+    for (double q : { 0.1, 0.5, 0.9, 0.99, 0.999 }) {
+        const auto expected = values[static_cast<std::size_t>(q * values.size() + 0.5) - 1];
+        const auto observed = hist.quantile(q);
+        EXPECT_GE(observed, expected);
+        EXPECT_LE(static_cast<double>(observed), static_cast<double>(expected) * (1 + 1.0 / 32) + 1);
+    }
+
+    // Merging is the same as adding all values to a single histogram.
+    nclist::LatencyHistogram first, second;
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        (i % 2 ? first : second).add(values[i]);
+    }
+    nclist::LatencyHistogram empty;
+    empty.merge(first);
+    empty.merge(second);
+    first.merge(second);
+    for (auto hptr : { &first, &empty }) {
+        EXPECT_EQ(hptr->count(), hist.count());
+        EXPECT_EQ(hptr->min(), hist.min());
+        EXPECT_EQ(hptr->max(), hist.max());
+        EXPECT_EQ(hptr->mean(), hist.mean());
+        for (double q : { 0.1, 0.5, 0.9, 0.99 }) {
+            EXPECT_EQ(hptr->quantile(q), hist.quantile(q));
+        }
+    }
+}
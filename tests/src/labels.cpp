@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <random>
+#include <cstdint>
+
+#include "nclist/overlaps_any.hpp"
+#include "nclist/labels.hpp"
+#include "utils.hpp"
+
+TEST(OverlapsAnyLabelled, Empty) {
+    auto index = nclist::build<int, int>(0, NULL, NULL);
+    auto summaries = nclist::build_label_summaries<int, int, int>(index, NULL);
+    nclist::OverlapsAnyWorkspace<int> workspace;
+    std::vector<int> output;
+    nclist::overlaps_any_labelled(index, summaries, 1, 100, 200, nclist::OverlapsAnyParameters<int>(), workspace, output);
+    EXPECT_TRUE(output.empty());
+}
+
+TEST(OverlapsAnyLabelled, Simple) {
+    std::vector<int> test_starts { 10, 30, 20,   0, 50, 50, 70, 30 };
+    std::vector<int> test_ends   { 50, 45, 50, 100, 60, 80, 80, 45 };
+    std::vector<int> test_labels {  0,  1,  2,   0,  1,  2,  0,  2 };
+    auto index = nclist::build<int, int>(test_starts.size(), test_starts.data(), test_ends.data());
+    auto summaries = nclist::build_label_summaries(index, test_labels.data());
+
+    nclist::OverlapsAnyParameters<int> params;
+    nclist::OverlapsAnyWorkspace<int> workspace;
+    std::vector<int> output;
+
+    nclist::overlaps_any_labelled(index, summaries, 1u << 2, 25, 55, params, workspace, output);
+    std::sort(output.begin(), output.end());
+    EXPECT_EQ(output, std::vector<int>({ 2, 5, 7 }));
+
+    nclist::overlaps_any_labelled(index, summaries, 1u << 1, 25, 55, params, workspace, output);
+    std::sort(output.begin(), output.end());
+    EXPECT_EQ(output, std::vector<int>({ 1, 4 }));
+
+    nclist::overlaps_any_labelled(index, summaries, (1u << 0) | (1u << 1), 65, 75, params, workspace, output);
+    std::sort(output.begin(), output.end());
+    EXPECT_EQ(output, std::vector<int>({ 3, 6 }));
+
+    nclist::overlaps_any_labelled(index, summaries, 0, 0, 100, params, workspace, output);
+    EXPECT_TRUE(output.empty());
+
+    params.quit_on_first = true;
+    nclist::overlaps_any_labelled(index, summaries, 1u << 2, 35, 40, params, workspace, output);
+    ASSERT_EQ(output.size(), 1);
+    EXPECT_TRUE(output[0] == 2 || output[0] == 7);
+}
+
+TEST(OverlapsAnyLabelled, QuitOnFirstNested) {
+    // The outer intervals overlap the query but do not have the requested label, so the search must continue into their children.
+    std::vector<int> test_starts { 0, 10, 20, 20 };
+    std::vector<int> test_ends   { 100, 90, 80, 80 };
+    std::vector<int> test_labels { 0, 0, 0, 1 };
+    auto index = nclist::build<int, int>(test_starts.size(), test_starts.data(), test_ends.data());
+    auto summaries = nclist::build_label_summaries(index, test_labels.data());
+
+    nclist::OverlapsAnyParameters<int> params;
+    params.quit_on_first = true;
+    nclist::OverlapsAnyWorkspace<int> workspace;
+    std::vector<int> output;
+    nclist::overlaps_any_labelled(index, summaries, 1u << 1, 50, 60, params, workspace, output);
+    EXPECT_EQ(output, std::vector<int>{ 3 });
+
+    params.quit_on_first = false;
+    nclist::overlaps_any_labelled(index, summaries, 1u << 0, 50, 60, params, workspace, output);
+    std::sort(output.begin(), output.end());
+    EXPECT_EQ(output, std::vector<int>({ 0, 1, 2 }));
+}
+
+TEST(OverlapsAnyLabelled, Errors) {
+    std::vector<int> test_starts { 10, 30 };
+    std::vector<int> test_ends   { 50, 45 };
+    auto index = nclist::build<int, int>(test_starts.size(), test_starts.data(), test_ends.data());
+
+    std::string msg;
+    try {
+        std::vector<int> test_labels { 0, 64 };
+        nclist::build_label_summaries(index, test_labels.data());
+    } catch (std::exception& e) {
+        msg = e.what();
+    }
+    EXPECT_TRUE(msg.find("less than") != std::string::npos);
+
+    msg.clear();
+    try {
+        std::vector<int> test_labels { -1, 0 };
+        nclist::build_label_summaries(index, test_labels.data());
+    } catch (std::exception& e) {
+        msg = e.what();
+    }
+    EXPECT_TRUE(msg.find("non-negative") != std::string::npos);
+}
+
+/********************************************************************/
+
+class OverlapsAnyLabelledTest : public OverlapsTestCore, public ::testing::TestWithParam<std::tuple<int, int, int> > {
+protected:
+    std::vector<unsigned char> labels;
+    int num_labels;
+    void SetUp() {
+        auto params = GetParam();
+        assemble(params);
+        num_labels = std::get<2>(params);
+        std::mt19937_64 rng(nsubject * 7 + num_labels);
+        labels.reserve(nsubject);
+        for (int s = 0; s < nsubject; ++s) {
+            labels.push_back(rng() % num_labels);
+        }
+    }
+};
+
+TEST_P(OverlapsAnyLabelledTest, Reference) {
+    auto index = nclist::build(nsubject, subject_start.data(), subject_end.data());
+    auto summaries = nclist::build_label_summaries(index, labels.data());
+
+    nclist::OverlapsAnyWorkspace<int> work;
+    std::vector<int> ref, filtered, results;
+    std::mt19937_64 rng(nquery + num_labels);
+
+    std::vector<nclist::OverlapsAnyParameters<int> > all_params(3);
+    all_params[1].max_gap = 10;
+    all_params[2].min_overlap = 10;
+
+    for (const auto& params : all_params) {
+        for (int q = 0; q < nquery; ++q) {
+            std::uint64_t label_set = 0;
+            for (int l = 0; l < num_labels; ++l) {
+                if (rng() % 3 == 0) {
+                    label_set |= static_cast<std::uint64_t>(1) << l;
+                }
+            }
+
+            nclist::overlaps_any(index, query_start[q], query_end[q], params, work, ref);
+            filtered.clear();
+            for (auto r : ref) {
+                if ((label_set >> labels[r]) & 1) {
+                    filtered.push_back(r);
+                }
+            }
+            std::sort(filtered.begin(), filtered.end());
+
+            nclist::overlaps_any_labelled(index, summaries, label_set, query_start[q], query_end[q], params, work, results);
+            std::sort(results.begin(), results.end());
+            EXPECT_EQ(results, filtered);
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    OverlapsAnyLabelled,
+    OverlapsAnyLabelledTest,
+    ::testing::Combine(
+        ::testing::Values(10, 100, 1000), // num of query ranges
+        ::testing::Values(10, 100, 1000), // number of subject ranges
+        ::testing::Values(2, 10, 64) // number of labels
+    )
+);
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "nclist/lockstep.hpp"
+
+template<typename Position_>
+void compare_lockstep(const std::vector<Position_>& values, const std::vector<Position_>& targets) {
+    std::vector<int> lower(targets.size()), upper(targets.size());
+    nclist::lockstep_lower_bound(values.data(), static_cast<int>(values.size()), targets.size(), targets.data(), lower.data());
+    nclist::lockstep_upper_bound(values.data(), static_cast<int>(values.size()), targets.size(), targets.data(), upper.data());
+    for (std::size_t t = 0; t < targets.size(); ++t) {
+        EXPECT_EQ(lower[t], std::lower_bound(values.begin(), values.end(), targets[t]) - values.begin());
+        EXPECT_EQ(upper[t], std::upper_bound(values.begin(), values.end(), targets[t]) - values.begin());
+    }
+}
+
+TEST(Lockstep, Simple) {
+    std::vector<int> values { 1, 3, 3, 3, 5, 8, 10 };
+    std::vector<int> targets { 0, 1, 2, 3, 4, 5, 8, 9, 10, 11 };
+    compare_lockstep(values, targets);
+
+    // Empty values.
+    std::vector<int> empty;
+    std::vector<int> output(targets.size(), -1);
+    nclist::lockstep_lower_bound(empty.data(), 0, targets.size(), targets.data(), output.data());
+    EXPECT_EQ(output, std::vector<int>(targets.size()));
+}
+
+class LockstepTest : public ::testing::TestWithParam<std::tuple<int, int> > {};
+
+TEST_P(LockstepTest, Reference) {
+    auto params = GetParam();
+    const int nvalues = std::get<0>(params);
+    const int ntargets = std::get<1>(params);
+    std::mt19937_64 rng(nvalues * 13 + ntargets);
+
+    // Using a variety of types to check signed, unsigned and floating-point comparisons.
+    std::vector<std::int32_t> ivalues(nvalues), itargets(ntargets);
+    std::vector<std::uint32_t> uvalues(nvalues), utargets(ntargets);
+    std::vector<double> dvalues(nvalues), dtargets(ntargets);
+    for (int v = 0; v < nvalues; ++v) {
+        ivalues[v] = static_cast<std::int32_t>(rng() % 1000) - 500;
+        uvalues[v] = rng() % 1000;
+        dvalues[v] = static_cast<double>(rng() % 1000) / 10;
+    }
+    for (int t = 0; t < ntargets; ++t) {
+        itargets[t] = static_cast<std::int32_t>(rng() % 1100) - 550;
+        utargets[t] = rng() % 1100;
+        dtargets[t] = static_cast<double>(rng() % 1100) / 10;
+    }
+    std::sort(ivalues.begin(), ivalues.end());
+    std::sort(uvalues.begin(), uvalues.end());
+    std::sort(dvalues.begin(), dvalues.end());
+
+    compare_lockstep(ivalues, itargets);
+    compare_lockstep(uvalues, utargets);
+    compare_lockstep(dvalues, dtargets);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Lockstep,
+    LockstepTest,
+    ::testing::Combine(
+        ::testing::Values(1, 2, 7, 100, 1000), // number of values
+        ::testing::Values(1, 15, 16, 17, 100) // number of targets
+    )
+);
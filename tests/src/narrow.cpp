@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+#include "nclist/narrow.hpp"
+#include "nclist/overlaps_any.hpp"
+#include "nclist/overlaps_within.hpp"
+#include "nclist/overlaps_extend.hpp"
+#include "nclist/overlaps_equal.hpp"
+#include "nclist/overlaps_start.hpp"
+#include "nclist/overlaps_end.hpp"
+#include "nclist/nearest.hpp"
+#include "nclist/classify.hpp"
+#include "nclist/batch.hpp"
+
+TEST(NarrowNclist, Basic) {
+    std::vector<std::int64_t> starts { 5000000000, 5000000010, 5000000020 };
+    std::vector<std::int64_t> ends   { 5000000008, 5000000025, 5000000030 };
+    auto narrow = nclist::build_narrow(3, starts.data(), ends.data());
+    EXPECT_EQ(narrow.base, 5000000000);
+    EXPECT_EQ(narrow.offsets.starts.size(), 3);
+
+    nclist::OverlapsAnyWorkspace<int> workspace;
+    nclist::OverlapsAnyParameters<std::int64_t> params;
+    std::vector<int> matches;
+    nclist::overlaps_any(nclist::make_view(narrow), static_cast<std::int64_t>(5000000007), static_cast<std::int64_t>(5000000012), params, workspace, matches);
+    std::sort(matches.begin(), matches.end());
+    EXPECT_EQ(matches, std::vector<int>({ 0, 1 }));
+
+    // Queries outside of the span are handled correctly.
+    nclist::overlaps_any(nclist::make_view(narrow), static_cast<std::int64_t>(-10), static_cast<std::int64_t>(5000000001), params, workspace, matches);
+    EXPECT_EQ(matches, std::vector<int>({ 0 }));
+    nclist::overlaps_any(nclist::make_view(narrow), static_cast<std::int64_t>(0), static_cast<std::int64_t>(10), params, workspace, matches);
+    EXPECT_TRUE(matches.empty());
+
+    // Works with subsets.
+    std::vector<int> subset { 2, 0 };
+    auto sub = nclist::build_narrow(2, subset.data(), starts.data(), ends.data());
+    EXPECT_EQ(sub.base, 5000000000);
+    nclist::overlaps_any(nclist::make_view(sub), static_cast<std::int64_t>(5000000007), static_cast<std::int64_t>(5000000022), params, workspace, matches);
+    std::sort(matches.begin(), matches.end());
+    EXPECT_EQ(matches, std::vector<int>({ 0, 2 }));
+
+    // Empty lists are supported.
+    auto empty = nclist::build_narrow(0, starts.data(), ends.data());
+    nclist::overlaps_any(nclist::make_view(empty), static_cast<std::int64_t>(5000000007), static_cast<std::int64_t>(5000000022), params, workspace, matches);
+    EXPECT_TRUE(matches.empty());
+}
+
+TEST(NarrowNclist, Errors) {
+    std::vector<int> starts { 0, 100, 300 };
+    std::vector<int> ends   { 10, 200, 400 };
+    EXPECT_ANY_THROW({
+        nclist::build_narrow<std::uint8_t>(3, starts.data(), ends.data());
+    });
+
+    auto narrow = nclist::build_narrow<std::uint8_t>(2, starts.data(), ends.data());
+    EXPECT_EQ(narrow.base, 0);
+
+    std::vector<int> wide_starts { -2000000000 };
+    std::vector<int> wide_ends   { 2000000000 };
+    EXPECT_ANY_THROW({
+        nclist::build_narrow(1, wide_starts.data(), wide_ends.data());
+    });
+}
+
+class NarrowNclistTest : public ::testing::TestWithParam<std::tuple<int, int> > {
+protected:
+    std::vector<std::int64_t> query_start, query_end, subject_start, subject_end;
+
+    void SetUp() {
+        auto params = GetParam();
+        const int nquery = std::get<0>(params);
+        const int nsubject = std::get<1>(params);
+        std::mt19937_64 rng(nquery * 13 + nsubject);
+
+        // Adding a large base so that positions wouldn't fit in 32 bits.
+        constexpr std::int64_t base = 10000000000;
+        for (int q = 0; q < nquery; ++q) {
+            const std::int64_t qstart = base + static_cast<std::int64_t>(rng() % 1200) - 600;
+            query_start.push_back(qstart);
+            query_end.push_back(qstart + static_cast<std::int64_t>(rng() % 50));
+        }
+        for (int s = 0; s < nsubject; ++s) {
+            const std::int64_t sstart = base + static_cast<std::int64_t>(rng() % 1000) - 500;
+            subject_start.push_back(sstart);
+            subject_end.push_back(sstart + static_cast<std::int64_t>(rng() % 50 + 1));
+        }
+    }
+
+    template<class Parameters_, class Workspace_, class Search_>
+    void compare(const Parameters_& params, Search_ search) {
+        auto full = nclist::build(static_cast<int>(subject_start.size()), subject_start.data(), subject_end.data());
+        auto narrow = nclist::build_narrow(static_cast<int>(subject_start.size()), subject_start.data(), subject_end.data());
+        auto nview = nclist::make_view(narrow);
+        Workspace_ workspace;
+        std::vector<int> expected, observed;
+        for (std::size_t q = 0; q < query_start.size(); ++q) {
+            search(full, query_start[q], query_end[q], params, workspace, expected);
+            search(nview, query_start[q], query_end[q], params, workspace, observed);
+            EXPECT_EQ(expected, observed);
+        }
+    }
+};
+
+TEST_P(NarrowNclistTest, Overlaps) {
+    {
+        nclist::OverlapsAnyParameters<std::int64_t> params;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_any(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsAnyWorkspace<int> >(params, fun);
+        params.max_gap = 10;
+        compare<decltype(params), nclist::OverlapsAnyWorkspace<int> >(params, fun);
+        params.min_overlap = 5;
+        compare<decltype(params), nclist::OverlapsAnyWorkspace<int> >(params, fun);
+    }
+
+    {
+        nclist::OverlapsWithinParameters<std::int64_t> params;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_within(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsWithinWorkspace<int> >(params, fun);
+        params.max_gap = 10;
+        compare<decltype(params), nclist::OverlapsWithinWorkspace<int> >(params, fun);
+    }
+
+    {
+        nclist::OverlapsExtendParameters<std::int64_t> params;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_extend(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsExtendWorkspace<int> >(params, fun);
+        params.min_overlap = 5;
+        compare<decltype(params), nclist::OverlapsExtendWorkspace<int> >(params, fun);
+    }
+
+    {
+        nclist::OverlapsEqualParameters<std::int64_t> params;
+        params.max_gap = 5;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_equal(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsEqualWorkspace<int> >(params, fun);
+    }
+
+    {
+        nclist::OverlapsStartParameters<std::int64_t> params;
+        params.max_gap = 5;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_start(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsStartWorkspace<int> >(params, fun);
+    }
+
+    {
+        nclist::OverlapsEndParameters<std::int64_t> params;
+        params.max_gap = 5;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_end(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsEndWorkspace<int> >(params, fun);
+    }
+}
+
+TEST_P(NarrowNclistTest, Others) {
+    {
+        nclist::NearestParameters<std::int64_t> params;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::nearest(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::NearestWorkspace<int> >(params, fun);
+    }
+
+    {
+        nclist::ClassifyOverlapsParameters<std::int64_t> params;
+        std::vector<unsigned char> types;
+        auto fun = [&](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void {
+            nclist::classify_overlaps(s, qs, qe, p, w, m, types);
+            for (std::size_t i = 0; i < m.size(); ++i) { // packing the types into the output for comparison.
+                m[i] = m[i] * 64 + types[i];
+            }
+        };
+        compare<decltype(params), nclist::ClassifyOverlapsWorkspace<int> >(params, fun);
+    }
+
+    {
+        auto full = nclist::build(static_cast<int>(subject_start.size()), subject_start.data(), subject_end.data());
+        auto narrow = nclist::build_narrow(static_cast<int>(subject_start.size()), subject_start.data(), subject_end.data());
+        nclist::OverlapsBatchParameters<std::int64_t> params;
+        params.max_gap = 10;
+        std::vector<nclist::OverlapType> types;
+        for (std::size_t q = 0; q < query_start.size(); ++q) {
+            types.push_back(static_cast<nclist::OverlapType>(q % 6));
+        }
+        params.types = types.data();
+
+        std::vector<std::size_t> expected_offsets, observed_offsets;
+        std::vector<int> expected, observed;
+        nclist::overlaps_batch(full, query_start.size(), query_start.data(), query_end.data(), params, expected_offsets, expected);
+        nclist::overlaps_batch(nclist::make_view(narrow), query_start.size(), query_start.data(), query_end.data(), params, observed_offsets, observed);
+        EXPECT_EQ(expected_offsets, observed_offsets);
+        EXPECT_EQ(expected, observed);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    NarrowNclist,
+    NarrowNclistTest,
+    ::testing::Combine(
+        ::testing::Values(10, 100, 1000), // num of query ranges
+        ::testing::Values(10, 100, 1000) // number of subject ranges
+    )
+);
@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstddef>
+
+#include "nclist/nearest_self.hpp"
+
+static std::vector<int> get_neighbors(const std::vector<std::size_t>& offsets, const std::vector<int>& neighbors, int i) {
+    std::vector<int> output(neighbors.begin() + offsets[i], neighbors.begin() + offsets[i + 1]);
+    std::sort(output.begin(), output.end());
+    return output;
+}
+
+TEST(NearestSelf, Basic) {
+    //                              0    1    2    3    4    5
+    std::vector<int> test_starts { 100, 200, 210, 400, 100, 430 };
+    std::vector<int> test_ends   { 150, 300, 220, 420, 150, 500 };
+    auto index = nclist::build<int, int>(test_starts.size(), test_starts.data(), test_ends.data());
+
+    nclist::NearestSelfParameters<int> params;
+    std::vector<std::size_t> offsets;
+    std::vector<int> neighbors, distances;
+    nclist::nearest_self(index, static_cast<int>(test_starts.size()), params, offsets, neighbors, distances);
+    ASSERT_EQ(offsets.size(), 7);
+
+    // Duplicates are neighbors of each other.
+    EXPECT_EQ(get_neighbors(offsets, neighbors, 0), std::vector<int>{ 4 });
+    EXPECT_EQ(distances[0], 0);
+    EXPECT_EQ(get_neighbors(offsets, neighbors, 4), std::vector<int>{ 0 });
+
+    // Nested intervals are neighbors of each other.
+    EXPECT_EQ(get_neighbors(offsets, neighbors, 1), std::vector<int>{ 2 });
+    EXPECT_EQ(get_neighbors(offsets, neighbors, 2), std::vector<int>{ 1 });
+    EXPECT_EQ(distances[2], 0);
+
+    // Non-overlapping intervals use the gap.
+    EXPECT_EQ(get_neighbors(offsets, neighbors, 3), std::vector<int>{ 5 });
+    EXPECT_EQ(distances[3], 10);
+    EXPECT_EQ(get_neighbors(offsets, neighbors, 5), std::vector<int>{ 3 });
+    EXPECT_EQ(distances[5], 10);
+
+    // Only one neighbor is reported.
+    params.quit_on_first = true;
+    nclist::nearest_self(index, static_cast<int>(test_starts.size()), params, offsets, neighbors, distances);
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_EQ(offsets[i + 1] - offsets[i], 1);
+    }
+    EXPECT_EQ(neighbors[offsets[0]], 4);
+    EXPECT_EQ(neighbors[offsets[4]], 0);
+    EXPECT_EQ(neighbors[offsets[3]], 5);
+}
+
+TEST(NearestSelf, Ties) {
+    std::vector<int> test_starts { 0, 35, 60, 60 };
+    std::vector<int> test_ends   { 20, 45, 70, 65 };
+    auto index = nclist::build<int, int>(test_starts.size(), test_starts.data(), test_ends.data());
+
+    nclist::NearestSelfParameters<int> params;
+    std::vector<std::size_t> offsets;
+    std::vector<int> neighbors, distances;
+    nclist::nearest_self(index, static_cast<int>(test_starts.size()), params, offsets, neighbors, distances);
+    EXPECT_EQ(get_neighbors(offsets, neighbors, 1), std::vector<int>({ 0, 2, 3 }));
+    EXPECT_EQ(distances[1], 15);
+    EXPECT_EQ(get_neighbors(offsets, neighbors, 0), std::vector<int>({ 1 }));
+    EXPECT_EQ(distances[0], 15);
+}
+
+TEST(NearestSelf, Adjacent) {
+    std::vector<int> test_starts { 0, 20, 20, 50 };
+    std::vector<int> test_ends   { 20, 25, 20, 60 };
+    auto index = nclist::build<int, int>(test_starts.size(), test_starts.data(), test_ends.data());
+
+    nclist::NearestSelfParameters<int> params;
+    std::vector<std::size_t> offsets;
+    std::vector<int> neighbors, distances;
+    nclist::nearest_self(index, static_cast<int>(test_starts.size()), params, offsets, neighbors, distances);
+    EXPECT_EQ(get_neighbors(offsets, neighbors, 0), std::vector<int>({ 1, 2 }));
+    EXPECT_EQ(get_neighbors(offsets, neighbors, 2), std::vector<int>({ 0, 1 }));
+
+    params.adjacent_equals_overlap = true;
+    nclist::nearest_self(index, static_cast<int>(test_starts.size()), params, offsets, neighbors, distances);
+    EXPECT_EQ(get_neighbors(offsets, neighbors, 0), std::vector<int>({ 1, 2 }));
+    EXPECT_EQ(get_neighbors(offsets, neighbors, 1), std::vector<int>({ 0, 2 }));
+    EXPECT_EQ(get_neighbors(offsets, neighbors, 3), std::vector<int>({ 1 }));
+    EXPECT_EQ(distances[3], 25);
+}
+
+TEST(NearestSelf, Subset) {
+    std::vector<int> test_starts { 0, 10, 100, 200 };
+    std::vector<int> test_ends   { 5, 15, 150, 250 };
+    std::vector<int> subset { 0, 2, 3 };
+    auto index = nclist::build<int, int>(subset.size(), subset.data(), test_starts.data(), test_ends.data());
+
+    nclist::NearestSelfParameters<int> params;
+    std::vector<std::size_t> offsets;
+    std::vector<int> neighbors, distances;
+    nclist::nearest_self(index, static_cast<int>(test_starts.size()), params, offsets, neighbors, distances);
+    EXPECT_EQ(get_neighbors(offsets, neighbors, 0), std::vector<int>({ 2 }));
+    EXPECT_EQ(distances[0], 95);
+    EXPECT_TRUE(get_neighbors(offsets, neighbors, 1).empty());
+    EXPECT_EQ(distances[1], 0);
+    EXPECT_EQ(get_neighbors(offsets, neighbors, 2), std::vector<int>({ 3 }));
+
+    // Single interval has no neighbors.
+    auto single = nclist::build<int, int>(1, test_starts.data(), test_ends.data());
+    nclist::nearest_self(single, 1, params, offsets, neighbors, distances);
+    EXPECT_EQ(offsets, std::vector<std::size_t>({ 0, 0 }));
+    EXPECT_EQ(distances, std::vector<int>({ 0 }));
+
+    auto empty = nclist::build<int, int>(0, NULL, NULL);
+    nclist::nearest_self(empty, 0, params, offsets, neighbors, distances);
+    EXPECT_EQ(offsets, std::vector<std::size_t>({ 0 }));
+    EXPECT_TRUE(neighbors.empty());
+    EXPECT_TRUE(distances.empty());
+}
+
+class NearestSelfTest : public ::testing::TestWithParam<std::tuple<int, bool, int> > {
+protected:
+    int nsubject;
+    bool adjacent;
+    int nthreads;
+    std::vector<int> subject_start, subject_end;
+
+    void SetUp() {
+        auto params = GetParam();
+        nsubject = std::get<0>(params);
+        adjacent = std::get<1>(params);
+        nthreads = std::get<2>(params);
+
+        // Including zero-length intervals and duplicates to check the edge cases.
+        std::mt19937_64 rng(nsubject * 7 + adjacent + nthreads);
+        for (int s = 0; s < nsubject; ++s) {
+            if (s && rng() % 10 == 0) {
+                auto chosen = rng() % s;
+                subject_start.push_back(subject_start[chosen]);
+                subject_end.push_back(subject_end[chosen]);
+                continue;
+            }
+            int sstart = rng() % (nsubject * 20);
+            int swidth = rng() % 20;
+            subject_start.push_back(sstart);
+            subject_end.push_back(sstart + swidth);
+        }
+    }
+};
+
+TEST_P(NearestSelfTest, Reference) {
+    auto index = nclist::build(nsubject, subject_start.data(), subject_end.data());
+    nclist::NearestSelfParameters<int> params;
+    params.adjacent_equals_overlap = adjacent;
+    params.num_threads = nthreads;
+    std::vector<std::size_t> offsets;
+    std::vector<int> neighbors, distances;
+    nclist::nearest_self(index, nsubject, params, offsets, neighbors, distances);
+
+    params.quit_on_first = true;
+    std::vector<std::size_t> first_offsets;
+    std::vector<int> first_neighbors, first_distances;
+    nclist::nearest_self(index, nsubject, params, first_offsets, first_neighbors, first_distances);
+    EXPECT_EQ(first_distances, distances);
+
+    for (int i = 0; i < nsubject; ++i) {
+        const int istart = subject_start[i], iend = subject_end[i];
+
+        std::vector<int> expected;
+        for (int j = 0; j < nsubject; ++j) {
+            if (j == i) {
+                continue;
+            }
+            const int jstart = subject_start[j], jend = subject_end[j];
+            if ((jstart < iend && istart < jend) || (adjacent && (jend == istart || jstart == iend))) {
+                expected.push_back(j);
+            }
+        }
+
+        int expected_distance = 0;
+        if (expected.empty()) {
+            int best = -1;
+            for (int j = 0; j < nsubject; ++j) {
+                if (j == i) {
+                    continue;
+                }
+                const int gap = (subject_end[j] <= istart ? istart - subject_end[j] : subject_start[j] - iend);
+                if (best < 0 || gap < best) {
+                    best = gap;
+                    expected.clear();
+                }
+                if (gap == best) {
+                    expected.push_back(j);
+                }
+            }
+            if (best > 0) {
+                expected_distance = best;
+            }
+        }
+
+        EXPECT_EQ(get_neighbors(offsets, neighbors, i), expected);
+        EXPECT_EQ(distances[i], expected_distance);
+
+        if (expected.empty()) {
+            EXPECT_EQ(first_offsets[i + 1], first_offsets[i]);
+        } else {
+            ASSERT_EQ(first_offsets[i + 1], first_offsets[i] + 1);
+            EXPECT_TRUE(std::binary_search(expected.begin(), expected.end(), first_neighbors[first_offsets[i]]));
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    NearestSelf,
+    NearestSelfTest,
+    ::testing::Combine(
+        ::testing::Values(1, 10, 100, 1000), // number of subject ranges
+        ::testing::Values(false, true), // whether adjacent intervals are considered to be overlapping
+        ::testing::Values(1, 3) // number of threads
+    )
+);
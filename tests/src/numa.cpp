@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <random>
+#include <cstddef>
+
+#include "nclist/numa.hpp"
+#include "utils.hpp"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+TEST(Numa, ParseCpuList) {
+    EXPECT_EQ(nclist::parse_cpu_list("0"), std::vector<int>({ 0 }));
+    EXPECT_EQ(nclist::parse_cpu_list("0-3"), std::vector<int>({ 0, 1, 2, 3 }));
+    EXPECT_EQ(nclist::parse_cpu_list("0-1,4,6-7\n"), std::vector<int>({ 0, 1, 4, 6, 7 }));
+    EXPECT_TRUE(nclist::parse_cpu_list("").empty());
+
+    // Malformed entries are skipped.
+    EXPECT_EQ(nclist::parse_cpu_list("foo,2,3-,5-4,7"), std::vector<int>({ 2, 7 }));
+}
+
+TEST(Numa, Detect) {
+    auto topology = nclist::detect_numa_topology();
+    ASSERT_FALSE(topology.node_cpus.empty());
+    for (const auto& cpus : topology.node_cpus) {
+        for (auto c : cpus) {
+            EXPECT_GE(c, 0);
+        }
+    }
+}
+
+#ifdef __linux__
+TEST(Numa, Binding) {
+    cpu_set_t original;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &original), 0);
+    int first = -1;
+    for (int c = 0; c < CPU_SETSIZE; ++c) {
+        if (CPU_ISSET(c, &original)) {
+            first = c;
+            break;
+        }
+    }
+    ASSERT_GE(first, 0);
+
+    {
+        nclist::NumaThreadBinding binding(std::vector<int>{ first });
+        EXPECT_TRUE(binding.bound());
+        cpu_set_t current;
+        ASSERT_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &current), 0);
+        EXPECT_EQ(CPU_COUNT(&current), 1);
+        EXPECT_TRUE(CPU_ISSET(first, &current));
+    }
+
+    cpu_set_t restored;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &restored), 0);
+    EXPECT_TRUE(CPU_EQUAL(&original, &restored));
+
+    // Binding fails gracefully for non-existent CPUs.
+    {
+        nclist::NumaThreadBinding binding(std::vector<int>{ -1, CPU_SETSIZE + 10 });
+        EXPECT_FALSE(binding.bound());
+    }
+    {
+        nclist::NumaThreadBinding binding(std::vector<int>{});
+        EXPECT_FALSE(binding.bound());
+    }
+    ASSERT_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &restored), 0);
+    EXPECT_TRUE(CPU_EQUAL(&original, &restored));
+}
+#endif
+
+class NumaTest : public OverlapsTestCore, public ::testing::TestWithParam<std::tuple<int, int, int> > {
+protected:
+    int nthreads;
+    void SetUp() {
+        auto params = GetParam();
+        assemble(params);
+        nthreads = std::get<2>(params);
+    }
+};
+
+TEST_P(NumaTest, SingleNode) {
+    auto index = nclist::build(nsubject, subject_start.data(), subject_end.data());
+    nclist::NumaTopology topology;
+    topology.node_cpus.resize(1);
+    nclist::NumaReplicatedNclist<int, int> replicated(index, topology);
+    EXPECT_EQ(replicated.num_nodes(), 1);
+    EXPECT_EQ(replicated.replica(0).nodes.size(), index.nodes.size());
+
+    nclist::OverlapsBatchParameters<int> params;
+    params.num_threads = nthreads;
+    params.max_gap = 5;
+    std::vector<std::size_t> ref_offsets, offsets;
+    std::vector<int> ref_matches, matches;
+    nclist::overlaps_batch(index, nquery, query_start.data(), query_end.data(), params, ref_offsets, ref_matches);
+    nclist::overlaps_batch(replicated, nquery, query_start.data(), query_end.data(), params, offsets, matches);
+    EXPECT_EQ(offsets, ref_offsets);
+    EXPECT_EQ(matches, ref_matches);
+
+    // Empty topologies are treated as a single node.
+    nclist::NumaReplicatedNclist<int, int> empty(index, nclist::NumaTopology());
+    EXPECT_EQ(empty.num_nodes(), 1);
+    EXPECT_TRUE(empty.cpus(0).empty());
+}
+
+TEST_P(NumaTest, MultipleNodes) {
+    auto index = nclist::build(nsubject, subject_start.data(), subject_end.data());
+
+    // Mocking up a topology with multiple nodes.
+    // We include a node with non-existent CPUs to check that binding failures are handled gracefully.
+    auto topology = nclist::detect_numa_topology();
+    topology.node_cpus.push_back(topology.node_cpus.front());
+    topology.node_cpus.push_back(std::vector<int>{ -1 });
+    nclist::NumaReplicatedNclist<int, int> replicated(index, topology);
+    ASSERT_EQ(replicated.num_nodes(), topology.node_cpus.size());
+    for (std::size_t n = 0; n < replicated.num_nodes(); ++n) {
+        const auto& rep = replicated.replica(n);
+        EXPECT_NE(rep.nodes.data(), index.nodes.data());
+        EXPECT_EQ(rep.starts, index.starts);
+        EXPECT_EQ(rep.ends, index.ends);
+        EXPECT_EQ(rep.duplicates, index.duplicates);
+        EXPECT_EQ(replicated.cpus(n), topology.node_cpus[n]);
+    }
+
+    std::mt19937_64 rng(nquery * 11 + nsubject + nthreads);
+    std::vector<nclist::OverlapType> types(nquery);
+    for (int q = 0; q < nquery; ++q) {
+        types[q] = static_cast<nclist::OverlapType>(rng() % 6);
+    }
+
+    nclist::OverlapsBatchParameters<int> params;
+    params.num_threads = nthreads;
+    params.types = types.data();
+    std::vector<std::size_t> ref_offsets, offsets;
+    std::vector<int> ref_matches, matches;
+    nclist::overlaps_batch(index, nquery, query_start.data(), query_end.data(), params, ref_offsets, ref_matches);
+    nclist::overlaps_batch(replicated, nquery, query_start.data(), query_end.data(), params, offsets, matches);
+    EXPECT_EQ(offsets, ref_offsets);
+    EXPECT_EQ(matches, ref_matches);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Numa,
+    NumaTest,
+    ::testing::Combine(
+        ::testing::Values(10, 1000), // num of query ranges
+        ::testing::Values(10, 1000), // number of subject ranges
+        ::testing::Values(1, 4) // number of threads
+    )
+);
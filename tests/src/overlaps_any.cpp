@@ -258,6 +258,7 @@ TEST_P(OverlapsAnyReferenceTest, Basic) {
         nclist::overlaps_any(index, query_start[q], query_end[q], params, work, results);
         std::sort(results.begin(), results.end());
         EXPECT_EQ(results, ref[q]);
+        EXPECT_EQ(nclist::has_overlaps_any(index, query_start[q], query_end[q], params), !results.empty());
     }
 }
 
@@ -300,6 +301,7 @@ TEST_P(OverlapsAnyMinOverlapTest, Basic) {
         nclist::overlaps_any(index, query_start[q], query_end[q], params, work, results);
         std::sort(results.begin(), results.end());
         EXPECT_EQ(results, filtered);
+        EXPECT_EQ(nclist::has_overlaps_any(index, query_start[q], query_end[q], params), !results.empty());
     }
 }
 
@@ -338,6 +340,7 @@ TEST_P(OverlapsAnyMaxGapTest, Basic) {
         nclist::overlaps_any(index, query_start[q], query_end[q], params, work, results);
         std::sort(results.begin(), results.end());
         EXPECT_EQ(results, default_results);
+        EXPECT_EQ(nclist::has_overlaps_any(index, query_start[q], query_end[q], params), !results.empty());
     }
 }
 
@@ -501,6 +504,35 @@ TEST(OverlapsAny, EarlyQuit) {
     EXPECT_TRUE(output.empty());
 }
 
+TEST(OverlapsAny, HasOverlaps) {
+    std::vector<int> test_starts{ 200, 300, 100, 500, 210 };
+    std::vector<int> test_ends  { 280, 320, 170, 510, 220 };
+    auto index = nclist::build<int, int>(test_starts.size(), test_starts.data(), test_ends.data());
+    nclist::OverlapsAnyParameters<int> params;
+
+    EXPECT_TRUE(nclist::has_overlaps_any(index, 250, 350, params));
+    EXPECT_TRUE(nclist::has_overlaps_any(index, 212, 215, params));
+    EXPECT_FALSE(nclist::has_overlaps_any(index, 0, 50, params));
+    EXPECT_FALSE(nclist::has_overlaps_any(index, 170, 200, params));
+    EXPECT_FALSE(nclist::has_overlaps_any(index, 600, 700, params));
+
+    params.max_gap = 0;
+    EXPECT_TRUE(nclist::has_overlaps_any(index, 170, 200, params));
+    params.max_gap = 10;
+    EXPECT_TRUE(nclist::has_overlaps_any(index, 520, 530, params));
+    EXPECT_FALSE(nclist::has_overlaps_any(index, 521, 530, params));
+
+    params.max_gap.reset();
+    params.min_overlap = 20;
+    EXPECT_TRUE(nclist::has_overlaps_any(index, 250, 350, params));
+    EXPECT_FALSE(nclist::has_overlaps_any(index, 310, 350, params));
+    EXPECT_FALSE(nclist::has_overlaps_any(index, 0, 10, params));
+
+    auto empty = nclist::build<int, int>(0, NULL, NULL);
+    params.min_overlap = 0;
+    EXPECT_FALSE(nclist::has_overlaps_any(empty, 0, 10, params));
+}
+
 TEST(OverlapsAny, ZeroWidth) {
     std::vector<int> test_starts { 200, 400 };
     std::vector<int> test_ends { 200, 500 };
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "nclist/overlaps_any.hpp"
+#include "nclist/overlaps_grouped.hpp"
+#include "utils.hpp"
+
+TEST(OverlapsAnyGrouped, Simple) {
+    std::vector<int> test_starts { 10, 30, 20,   0, 50, 50, 70 };
+    std::vector<int> test_ends   { 50, 45, 50, 100, 60, 80, 80 };
+    std::vector<int> test_groups {  0,  0,  1,   2,  1,  1,  0 };
+    auto index = nclist::build<int, int>(test_starts.size(), test_starts.data(), test_ends.data());
+
+    nclist::OverlapsAnyParameters<int> params;
+    nclist::OverlapsGroupedWorkspace<int> workspace;
+    std::vector<int> output;
+
+    nclist::overlaps_any_grouped(index, test_groups.data(), 3, 25, 55, params, workspace, output);
+    std::sort(output.begin(), output.end());
+    EXPECT_EQ(output, std::vector<int>({ 0, 1, 2 }));
+    EXPECT_EQ(nclist::count_overlaps_any_grouped(index, test_groups.data(), 3, 25, 55, params, workspace), 3);
+
+    nclist::overlaps_any_grouped(index, test_groups.data(), 3, 52, 58, params, workspace, output);
+    std::sort(output.begin(), output.end());
+    EXPECT_EQ(output, std::vector<int>({ 1, 2 }));
+    EXPECT_EQ(nclist::count_overlaps_any_grouped(index, test_groups.data(), 3, 52, 58, params, workspace), 2);
+
+    nclist::overlaps_any_grouped(index, test_groups.data(), 3, 200, 300, params, workspace, output);
+    EXPECT_TRUE(output.empty());
+
+    // Epoch wrap-around is handled correctly.
+    workspace.epoch = static_cast<std::uint32_t>(-1);
+    nclist::overlaps_any_grouped(index, test_groups.data(), 3, 52, 58, params, workspace, output);
+    std::sort(output.begin(), output.end());
+    EXPECT_EQ(output, std::vector<int>({ 1, 2 }));
+    nclist::overlaps_any_grouped(index, test_groups.data(), 3, 52, 58, params, workspace, output);
+    EXPECT_EQ(output.size(), 2);
+}
+
+class OverlapsAnyGroupedTest : public OverlapsTestCore, public ::testing::TestWithParam<std::tuple<int, int, int> > {
+protected:
+    std::vector<int> groups;
+    int ngroups;
+    void SetUp() {
+        auto params = GetParam();
+        assemble(params);
+        ngroups = std::get<2>(params);
+        std::mt19937_64 rng(nsubject + ngroups);
+        for (int s = 0; s < nsubject; ++s) {
+            groups.push_back(rng() % ngroups);
+        }
+    }
+};
+
+TEST_P(OverlapsAnyGroupedTest, Reference) {
+    auto index = nclist::build(nsubject, subject_start.data(), subject_end.data());
+
+    nclist::OverlapsAnyWorkspace<int> a_work;
+    nclist::OverlapsGroupedWorkspace<int> g_work;
+    std::vector<int> ref, results;
+
+    std::vector<nclist::OverlapsAnyParameters<int> > all_params(3);
+    all_params[1].max_gap = 10;
+    all_params[2].min_overlap = 10;
+
+    for (const auto& params : all_params) {
+        std::vector<std::size_t> batch_offsets;
+        std::vector<int> batch_matches, batch_counts(nquery);
+        nclist::overlaps_any_grouped_batch(index, groups.data(), ngroups, nquery, query_start.data(), query_end.data(), params, 1, batch_offsets, batch_matches);
+        nclist::count_overlaps_any_grouped_batch(index, groups.data(), ngroups, nquery, query_start.data(), query_end.data(), params, 1, batch_counts.data());
+        ASSERT_EQ(batch_offsets.size(), nquery + 1);
+
+        // Parallelization gives the same results.
+        std::vector<std::size_t> par_offsets;
+        std::vector<int> par_matches, par_counts(nquery);
+        nclist::overlaps_any_grouped_batch(index, groups.data(), ngroups, nquery, query_start.data(), query_end.data(), params, 3, par_offsets, par_matches);
+        nclist::count_overlaps_any_grouped_batch(index, groups.data(), ngroups, nquery, query_start.data(), query_end.data(), params, 3, par_counts.data());
+        EXPECT_EQ(par_offsets, batch_offsets);
+        EXPECT_EQ(par_matches, batch_matches);
+        EXPECT_EQ(par_counts, batch_counts);
+
+        for (int q = 0; q < nquery; ++q) {
+            nclist::overlaps_any(index, query_start[q], query_end[q], params, a_work, ref);
+            for (auto& r : ref) {
+                r = groups[r];
+            }
+            std::sort(ref.begin(), ref.end());
+            ref.erase(std::unique(ref.begin(), ref.end()), ref.end());
+
+            nclist::overlaps_any_grouped(index, groups.data(), ngroups, query_start[q], query_end[q], params, g_work, results);
+            std::sort(results.begin(), results.end());
+            EXPECT_EQ(results, ref);
+
+            EXPECT_EQ(nclist::count_overlaps_any_grouped(index, groups.data(), ngroups, query_start[q], query_end[q], params, g_work), static_cast<int>(ref.size()));
+            EXPECT_EQ(batch_counts[q], static_cast<int>(ref.size()));
+
+            std::vector<int> batch_results(batch_matches.begin() + batch_offsets[q], batch_matches.begin() + batch_offsets[q + 1]);
+            std::sort(batch_results.begin(), batch_results.end());
+            EXPECT_EQ(batch_results, ref);
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    OverlapsAnyGrouped,
+    OverlapsAnyGroupedTest,
+    ::testing::Combine(
+        ::testing::Values(10, 100, 1000), // num of query ranges
+        ::testing::Values(10, 100, 1000), // number of subject ranges
+        ::testing::Values(1, 5, 50) // number of groups
+    )
+);
@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <stdexcept>
+#include <cstddef>
+
+#include "nclist/parallelize.hpp"
+
+TEST(Parallelize, Basic) {
+    for (int workers = 1; workers <= 5; ++workers) {
+        for (std::size_t tasks : { 0, 1, 3, 10, 101 }) {
+            std::vector<int> visited(tasks);
+            std::vector<int> used(workers);
+            nclist::parallelize(workers, tasks, [&](int w, std::size_t start, std::size_t length) -> void {
+                ++used[w];
+                for (std::size_t i = start; i < start + length; ++i) {
+                    ++visited[i];
+                }
+            });
+            EXPECT_EQ(visited, std::vector<int>(tasks, 1));
+            for (auto u : used) {
+                EXPECT_LE(u, 1);
+            }
+        }
+    }
+}
+
+TEST(Parallelize, Error) {
+    EXPECT_ANY_THROW({
+        nclist::parallelize(3, 10, [&](int w, int, int) -> void {
+            if (w == 1) {
+                throw std::runtime_error("oops");
+            }
+        });
+    });
+}
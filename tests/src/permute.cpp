@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <numeric>
+#include <cstddef>
+
+#include "nclist/permute.hpp"
+
+TEST(PermuteOverlaps, Observed) {
+    std::vector<int> sstarts { 10, 50, 55 };
+    std::vector<int> sends   { 20, 70, 60 };
+    auto index = nclist::build<int, int>(sstarts.size(), sstarts.data(), sends.data());
+
+    std::vector<int> qstarts { 0, 15, 40, 56, 80 };
+    std::vector<int> qends   { 10, 16, 45, 57, 90 };
+    nclist::OverlapsAnyParameters<int> params;
+    EXPECT_EQ(nclist::count_overlapping_queries(index, qstarts.size(), qstarts.data(), qends.data(), params), 2);
+    params.max_gap = 5;
+    EXPECT_EQ(nclist::count_overlapping_queries(index, qstarts.size(), qstarts.data(), qends.data(), params), 4);
+}
+
+TEST(PermuteOverlaps, Extremes) {
+    std::vector<int> rstarts { 0, 1000 };
+    std::vector<int> rends   { 100, 1200 };
+    std::vector<int> qstarts { 5, 20, 30 };
+    std::vector<int> qends   { 10, 40, 31 };
+
+    nclist::PermuteOverlapsParameters<int> params;
+    params.num_iterations = 50;
+
+    // All shuffled queries must overlap if the subjects cover the allowed regions.
+    {
+        auto index = nclist::build<int, int>(rstarts.size(), rstarts.data(), rends.data());
+        auto null = nclist::permute_overlaps(index, qstarts.size(), qstarts.data(), qends.data(), rstarts.size(), rstarts.data(), rends.data(), params);
+        EXPECT_EQ(null, std::vector<std::size_t>(params.num_iterations, qstarts.size()));
+    }
+
+    // No shuffled query can overlap if the subjects lie outside the allowed regions. 
+    {
+        std::vector<int> sstarts { 100, 500, 1200 };
+        std::vector<int> sends   { 1000, 600, 1300 };
+        auto index = nclist::build<int, int>(sstarts.size(), sstarts.data(), sends.data());
+        auto null = nclist::permute_overlaps(index, qstarts.size(), qstarts.data(), qends.data(), rstarts.size(), rstarts.data(), rends.data(), params);
+        EXPECT_EQ(null, std::vector<std::size_t>(params.num_iterations));
+    }
+}
+
+TEST(PermuteOverlaps, Distribution) {
+    std::vector<int> rstarts { 0 };
+    std::vector<int> rends   { 1000 };
+    std::vector<int> sstarts { 0 };
+    std::vector<int> sends   { 500 };
+    auto index = nclist::build<int, int>(sstarts.size(), sstarts.data(), sends.data());
+
+    const int nqueries = 100;
+    std::vector<int> qstarts(nqueries), qends(nqueries);
+    for (int q = 0; q < nqueries; ++q) {
+        qstarts[q] = q * 10;
+        qends[q] = q * 10 + 10;
+    }
+
+    nclist::PermuteOverlapsParameters<int> params;
+    params.num_iterations = 200;
+    auto null = nclist::permute_overlaps(index, nqueries, qstarts.data(), qends.data(), 1, rstarts.data(), rends.data(), params);
+    ASSERT_EQ(null.size(), params.num_iterations);
+
+    // Each shuffled query can start anywhere in [0, 990], and overlaps the subject if it starts before 500.
+    double mean = std::accumulate(null.begin(), null.end(), 0.0) / null.size();
+    EXPECT_NEAR(mean, nqueries * 500.0 / 991, 2);
+
+    // Same results regardless of the number of threads.
+    params.num_threads = 3;
+    auto pnull = nclist::permute_overlaps(index, nqueries, qstarts.data(), qends.data(), 1, rstarts.data(), rends.data(), params);
+    EXPECT_EQ(null, pnull);
+
+    // But different results for a different seed.
+    params.seed = 42;
+    auto snull = nclist::permute_overlaps(index, nqueries, qstarts.data(), qends.data(), 1, rstarts.data(), rends.data(), params);
+    EXPECT_NE(null, snull);
+}
+
+TEST(PermuteOverlaps, Double) {
+    std::vector<double> rstarts { 0, 10 };
+    std::vector<double> rends   { 5.5, 20.5 };
+    std::vector<double> sstarts { 0 };
+    std::vector<double> sends   { 100 };
+    auto index = nclist::build<int, double>(sstarts.size(), sstarts.data(), sends.data());
+
+    std::vector<double> qstarts { 1.5, 2.5 };
+    std::vector<double> qends   { 2.5, 8.5 };
+    nclist::PermuteOverlapsParameters<double> params;
+    params.num_iterations = 20;
+    auto null = nclist::permute_overlaps(index, qstarts.size(), qstarts.data(), qends.data(), rstarts.size(), rstarts.data(), rends.data(), params);
+    EXPECT_EQ(null, std::vector<std::size_t>(params.num_iterations, 2));
+}
+
+TEST(PermuteOverlaps, Errors) {
+    std::vector<int> rstarts { 0 };
+    std::vector<int> rends   { 10 };
+    std::vector<int> qstarts { 0 };
+    std::vector<int> qends   { 20 };
+    auto index = nclist::build<int, int>(rstarts.size(), rstarts.data(), rends.data());
+
+    nclist::PermuteOverlapsParameters<int> params;
+    params.num_iterations = 5;
+    EXPECT_ANY_THROW(nclist::permute_overlaps(index, 1, qstarts.data(), qends.data(), 1, rstarts.data(), rends.data(), params));
+    EXPECT_ANY_THROW(nclist::permute_overlaps(index, 1, qstarts.data(), qends.data(), 0, rstarts.data(), rends.data(), params));
+
+    auto null = nclist::permute_overlaps(index, 0, qstarts.data(), qends.data(), 0, rstarts.data(), rends.data(), params);
+    EXPECT_EQ(null, std::vector<std::size_t>(params.num_iterations));
+}
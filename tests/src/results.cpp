@@ -0,0 +1,286 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <random>
+#include <cstddef>
+#include <algorithm>
+#include <numeric>
+#include <iterator>
+
+#include "nclist/overlaps_any.hpp"
+#include "nclist/overlaps_within.hpp"
+#include "nclist/overlaps_extend.hpp"
+#include "nclist/batch.hpp"
+#include "nclist/results.hpp"
+#include "utils.hpp"
+
+static std::vector<int> simulate_ids(int n, int range, int dense_start, int dense_len, std::mt19937_64& rng) {
+    std::vector<int> output;
+    for (int i = 0; i < n; ++i) {
+        output.push_back(rng() % range);
+    }
+    for (int i = 0; i < dense_len; ++i) {
+        output.push_back(dense_start + i);
+    }
+    std::shuffle(output.begin(), output.end(), rng);
+    return output;
+}
+
+static std::vector<int> sort_unique(std::vector<int> x) {
+    std::sort(x.begin(), x.end());
+    x.erase(std::unique(x.begin(), x.end()), x.end());
+    return x;
+}
+
+class ResultsTest : public ::testing::TestWithParam<std::tuple<int, int> > {};
+
+TEST_P(ResultsTest, Bitmap) {
+    auto params = GetParam();
+    std::mt19937_64 rng(std::get<0>(params) + std::get<1>(params));
+    auto left = simulate_ids(std::get<0>(params), 500000, 70000, std::get<1>(params), rng);
+    auto right = simulate_ids(std::get<0>(params), 500000, 75000, std::get<1>(params), rng);
+    auto uleft = sort_unique(left);
+    auto uright = sort_unique(right);
+
+    nclist::BitmapResults<int> lbits, rbits;
+    lbits.insert(left.begin(), left.end());
+    EXPECT_EQ(lbits.size(), uleft.size());
+    EXPECT_EQ(lbits.to_vector(), uleft);
+
+    // Adding one at a time.
+    for (auto r : right) {
+        rbits.insert(r);
+    }
+    EXPECT_EQ(rbits.size(), uright.size());
+    EXPECT_EQ(rbits.to_vector(), uright);
+
+    for (int i = 0; i < 100; ++i) {
+        int candidate = rng() % 500000;
+        EXPECT_EQ(lbits.contains(candidate), std::binary_search(uleft.begin(), uleft.end(), candidate));
+    }
+
+    std::vector<int> expected;
+    std::set_union(uleft.begin(), uleft.end(), uright.begin(), uright.end(), std::back_inserter(expected));
+    auto unioned = nclist::union_results(lbits, rbits);
+    EXPECT_EQ(unioned.size(), expected.size());
+    EXPECT_EQ(unioned.to_vector(), expected);
+
+    expected.clear();
+    std::set_intersection(uleft.begin(), uleft.end(), uright.begin(), uright.end(), std::back_inserter(expected));
+    auto intersected = nclist::intersect_results(lbits, rbits);
+    EXPECT_EQ(intersected.size(), expected.size());
+    EXPECT_EQ(intersected.to_vector(), expected);
+
+    lbits.clear();
+    EXPECT_TRUE(lbits.empty());
+    EXPECT_TRUE(lbits.to_vector().empty());
+}
+
+TEST_P(ResultsTest, Delta) {
+    auto params = GetParam();
+    std::mt19937_64 rng(std::get<0>(params) * 3 + std::get<1>(params));
+    auto left = simulate_ids(std::get<0>(params), 500000, 70000, std::get<1>(params), rng);
+    auto right = simulate_ids(std::get<0>(params), 500000, 75000, std::get<1>(params), rng);
+    auto uleft = sort_unique(left);
+    auto uright = sort_unique(right);
+
+    nclist::DeltaResults<int> ldelta, rdelta;
+    ldelta.assign(left.begin(), left.end());
+    EXPECT_EQ(ldelta.size(), uleft.size());
+    EXPECT_EQ(ldelta.to_vector(), uleft);
+
+    for (auto r : uright) {
+        rdelta.push_back(r);
+    }
+    EXPECT_EQ(rdelta.to_vector(), uright);
+    if (!uright.empty()) {
+        rdelta.push_back(uright.front()); // ignored as it is out of order.
+        EXPECT_EQ(rdelta.size(), uright.size());
+    }
+
+    std::vector<int> expected;
+    std::set_union(uleft.begin(), uleft.end(), uright.begin(), uright.end(), std::back_inserter(expected));
+    EXPECT_EQ(nclist::union_results(ldelta, rdelta).to_vector(), expected);
+
+    expected.clear();
+    std::set_intersection(uleft.begin(), uleft.end(), uright.begin(), uright.end(), std::back_inserter(expected));
+    EXPECT_EQ(nclist::intersect_results(ldelta, rdelta).to_vector(), expected);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Results,
+    ResultsTest,
+    ::testing::Combine(
+        ::testing::Values(0, 100, 10000), // number of random IDs
+        ::testing::Values(0, 1000, 20000) // length of the contiguous run of IDs
+    )
+);
+
+TEST(Results, Compression) {
+    std::vector<int> ids(100000);
+    std::iota(ids.begin(), ids.end(), 12345);
+
+    nclist::BitmapResults<int> bits;
+    bits.insert(ids.begin(), ids.end());
+    EXPECT_EQ(bits.size(), ids.size());
+    EXPECT_LT(bits.bytes(), ids.size() * sizeof(int) / 10);
+
+    nclist::DeltaResults<int> delta;
+    delta.assign(ids.begin(), ids.end());
+    EXPECT_EQ(delta.bytes(), ids.size() + 1); // first value takes two bytes.
+}
+
+TEST(Results, Overlaps) {
+    std::vector<int> starts, ends;
+    for (int i = 0; i < 10000; ++i) {
+        starts.push_back(i * 10);
+        ends.push_back(i * 10 + 50);
+    }
+    auto index = nclist::build<int, int>(starts.size(), starts.data(), ends.data());
+
+    nclist::OverlapsAnyWorkspace<int> workspace;
+    nclist::OverlapsAnyParameters<int> params;
+    std::vector<int> matches;
+    nclist::BitmapResults<int> bits;
+    nclist::DeltaResults<int> delta;
+
+    nclist::overlaps_any(index, 1000, 50000, params, workspace, matches);
+    bits.insert(matches.begin(), matches.end());
+    delta.assign(matches.begin(), matches.end());
+
+    std::sort(matches.begin(), matches.end());
+    EXPECT_EQ(bits.to_vector(), matches);
+    EXPECT_EQ(delta.to_vector(), matches);
+}
+
+TEST(Results, DirectOverlaps) {
+    // Using intervals in decreasing order of position, so that the traversal reports indices out of order.
+    std::vector<int> starts, ends;
+    const int n = 20000;
+    for (int i = 0; i < n; ++i) {
+        starts.push_back((n - i) * 10);
+        ends.push_back((n - i) * 10 + (i % 7 == 0 ? 500 : 50));
+    }
+    auto index = nclist::build<int, int>(starts.size(), starts.data(), ends.data());
+
+    std::vector<int> matches;
+    nclist::BitmapResults<int> bits;
+    nclist::DeltaResults<int> delta;
+
+    {
+        nclist::OverlapsAnyWorkspace<int> workspace;
+        nclist::OverlapsAnyParameters<int> params;
+        for (auto width : { 1, 100, 10000, 250000 }) {
+            nclist::overlaps_any(index, 1000, 1000 + width, params, workspace, matches);
+            nclist::overlaps_any(index, 1000, 1000 + width, params, workspace, bits);
+            nclist::overlaps_any(index, 1000, 1000 + width, params, workspace, delta);
+            std::sort(matches.begin(), matches.end());
+            EXPECT_EQ(bits.to_vector(), matches);
+            EXPECT_EQ(delta.to_vector(), matches);
+        }
+        EXPECT_GT(matches.size(), 19000);
+    }
+
+    {
+        nclist::OverlapsWithinWorkspace<int> workspace;
+        nclist::OverlapsWithinParameters<int> params;
+        nclist::overlaps_within(index, 5000, 5010, params, workspace, matches);
+        nclist::overlaps_within(index, 5000, 5010, params, workspace, bits);
+        nclist::overlaps_within(index, 5000, 5010, params, workspace, delta);
+        std::sort(matches.begin(), matches.end());
+        EXPECT_FALSE(matches.empty());
+        EXPECT_EQ(bits.to_vector(), matches);
+        EXPECT_EQ(delta.to_vector(), matches);
+    }
+
+    {
+        nclist::OverlapsExtendWorkspace<int> workspace;
+        nclist::OverlapsExtendParameters<int> params;
+        nclist::overlaps_extend(index, 0, 150000, params, workspace, matches);
+        nclist::overlaps_extend(index, 0, 150000, params, workspace, bits);
+        nclist::overlaps_extend(index, 0, 150000, params, workspace, delta);
+        std::sort(matches.begin(), matches.end());
+        EXPECT_FALSE(matches.empty());
+        EXPECT_EQ(bits.to_vector(), matches);
+        EXPECT_EQ(delta.to_vector(), matches);
+    }
+}
+
+TEST(Results, DeltaStaging) {
+    // Interleaving runs of increasing indices with out-of-order indices, to check that staged indices are correctly merged.
+    std::vector<int> starts, ends;
+    std::mt19937_64 rng(999);
+    for (int i = 0; i < 50000; ++i) {
+        const int start = rng() % 1000000;
+        starts.push_back(start);
+        ends.push_back(start + rng() % 5000 + 1);
+    }
+    auto index = nclist::build<int, int>(starts.size(), starts.data(), ends.data());
+
+    nclist::OverlapsAnyWorkspace<int> workspace;
+    nclist::OverlapsAnyParameters<int> params;
+    std::vector<int> matches;
+    nclist::DeltaResults<int> delta;
+    for (int i = 0; i < 10; ++i) {
+        const int start = rng() % 1000000;
+        const int end = start + rng() % 500000;
+        nclist::overlaps_any(index, start, end, params, workspace, matches);
+        nclist::overlaps_any(index, start, end, params, workspace, delta);
+        std::sort(matches.begin(), matches.end());
+        EXPECT_EQ(delta.size(), matches.size());
+        EXPECT_EQ(delta.to_vector(), matches);
+    }
+}
+
+TEST(Results, Batch) {
+    std::vector<int> starts, ends;
+    std::mt19937_64 rng(1000);
+    for (int i = 0; i < 5000; ++i) {
+        const int start = rng() % 100000;
+        starts.push_back(start);
+        ends.push_back(start + rng() % (i % 10 == 0 ? 5000 : 100) + 1);
+    }
+    auto index = nclist::build<int, int>(starts.size(), starts.data(), ends.data());
+
+    std::vector<int> qstarts, qends;
+    std::vector<nclist::OverlapType> types;
+    for (int q = 0; q < 1000; ++q) {
+        const int start = rng() % 100000;
+        qstarts.push_back(start);
+        qends.push_back(start + rng() % (q % 5 == 0 ? 20000 : 200));
+        types.push_back(static_cast<nclist::OverlapType>(q % 6));
+    }
+    qstarts.insert(qstarts.end(), qstarts.begin(), qstarts.begin() + 100); // adding some duplicates.
+    qends.insert(qends.end(), qends.begin(), qends.begin() + 100);
+    types.insert(types.end(), types.begin(), types.begin() + 100);
+    const std::size_t nqueries = qstarts.size();
+
+    nclist::OverlapsBatchParameters<int> params;
+    params.types = types.data();
+    params.max_gap = 10;
+
+    for (int threads = 1; threads <= 3; threads += 2) {
+        for (bool dedup : { false, true }) {
+            params.num_threads = threads;
+            params.deduplicate = dedup;
+
+            std::vector<std::size_t> offsets;
+            std::vector<int> matches;
+            nclist::overlaps_batch(index, nqueries, qstarts.data(), qends.data(), params, offsets, matches);
+
+            std::vector<nclist::BitmapResults<int> > bits;
+            nclist::overlaps_batch(index, nqueries, qstarts.data(), qends.data(), params, bits);
+            std::vector<nclist::DeltaResults<int> > delta;
+            nclist::overlaps_batch(index, nqueries, qstarts.data(), qends.data(), params, delta);
+
+            ASSERT_EQ(bits.size(), nqueries);
+            ASSERT_EQ(delta.size(), nqueries);
+            for (std::size_t q = 0; q < nqueries; ++q) {
+                std::vector<int> expected(matches.begin() + offsets[q], matches.begin() + offsets[q + 1]);
+                std::sort(expected.begin(), expected.end());
+                EXPECT_EQ(bits[q].to_vector(), expected);
+                EXPECT_EQ(delta[q].to_vector(), expected);
+            }
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include "nclist/overlaps_any.hpp"
+#include "nclist/sample_overlaps.hpp"
+#include "utils.hpp"
+
+TEST(SampleOverlaps, Empty) {
+    auto index = nclist::build<int, int>(0, NULL, NULL);
+    auto counts = nclist::build_subtree_counts(index);
+    nclist::SampleOverlapsWorkspace<int> workspace;
+    nclist::SampleOverlapsParameters params;
+    std::mt19937_64 rng(42);
+    std::vector<int> output;
+    EXPECT_EQ(nclist::sample_overlaps(index, counts, 100, 200, params, rng, workspace, output), 0);
+    EXPECT_TRUE(output.empty());
+}
+
+TEST(SampleOverlaps, Uniform) {
+    // Mixture of nested, partially-overlapping and duplicated intervals.
+    std::vector<int> test_starts { 0, 10, 20, 20, 25, 30, 40, 45, 60, 90 };
+    std::vector<int> test_ends   { 100, 50, 30, 30, 28, 80, 50, 70, 65, 95 };
+    auto index = nclist::build<int, int>(test_starts.size(), test_starts.data(), test_ends.data());
+    auto counts = nclist::build_subtree_counts(index);
+
+    nclist::SampleOverlapsWorkspace<int> workspace;
+    nclist::SampleOverlapsParameters params;
+    params.num_samples = 2;
+    std::mt19937_64 rng(42);
+    std::vector<int> output;
+
+    std::vector<int> tally(test_starts.size());
+    int niters = 20000;
+    for (int i = 0; i < niters; ++i) {
+        auto total = nclist::sample_overlaps(index, counts, 15, 62, params, rng, workspace, output);
+        EXPECT_EQ(total, 9);
+        ASSERT_EQ(output.size(), 2);
+        EXPECT_NE(output[0], output[1]);
+        for (auto o : output) {
+            ++tally[o];
+        }
+    }
+
+    EXPECT_EQ(tally[9], 0); // doesn't overlap.
+    double expected = static_cast<double>(niters * params.num_samples) / 9;
+    for (int i = 0; i < 9; ++i) {
+        EXPECT_GT(tally[i], expected * 0.9);
+        EXPECT_LT(tally[i], expected * 1.1);
+    }
+}
+
+class SampleOverlapsTest : public OverlapsTestCore, public ::testing::TestWithParam<std::tuple<int, int, int> > {
+protected:
+    int nsamples;
+    void SetUp() {
+        auto params = GetParam();
+        assemble(params);
+        nsamples = std::get<2>(params);
+    }
+};
+
+TEST_P(SampleOverlapsTest, Reference) {
+    auto index = nclist::build(nsubject, subject_start.data(), subject_end.data());
+    auto counts = nclist::build_subtree_counts(index);
+
+    nclist::OverlapsAnyWorkspace<int> a_work;
+    nclist::OverlapsAnyParameters<int> a_params;
+    std::vector<int> ref;
+
+    nclist::SampleOverlapsWorkspace<int> s_work;
+    nclist::SampleOverlapsParameters s_params;
+    s_params.num_samples = nsamples;
+    std::vector<int> results;
+    std::mt19937_64 rng(nquery + nsamples);
+
+    for (int q = 0; q < nquery; ++q) {
+        auto qstart = query_start[q];
+        auto qend = query_end[q] + q % 20 * 10; // adding some wider queries.
+        nclist::overlaps_any(index, qstart, qend, a_params, a_work, ref);
+        std::sort(ref.begin(), ref.end());
+
+        s_params.with_replacement = false;
+        auto total = nclist::sample_overlaps(index, counts, qstart, qend, s_params, rng, s_work, results);
+        EXPECT_EQ(total, ref.size());
+        EXPECT_EQ(results.size(), std::min(ref.size(), static_cast<std::size_t>(nsamples)));
+        std::sort(results.begin(), results.end());
+        EXPECT_TRUE(std::adjacent_find(results.begin(), results.end()) == results.end());
+        EXPECT_TRUE(std::includes(ref.begin(), ref.end(), results.begin(), results.end()));
+
+        s_params.with_replacement = true;
+        nclist::sample_overlaps(index, counts, qstart, qend, s_params, rng, s_work, results);
+        EXPECT_EQ(results.size(), ref.empty() ? 0 : nsamples);
+        for (auto r : results) {
+            EXPECT_TRUE(std::binary_search(ref.begin(), ref.end(), r));
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    SampleOverlaps,
+    SampleOverlapsTest,
+    ::testing::Combine(
+        ::testing::Values(10, 100, 1000), // num of query ranges
+        ::testing::Values(10, 100, 1000), // number of subject ranges
+        ::testing::Values(1, 5, 1000) // number of samples
+    )
+);
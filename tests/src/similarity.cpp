@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <random>
+#include <cstddef>
+
+#include "nclist/similarity.hpp"
+
+TEST(Similarity, Basic) {
+    std::vector<int> xstarts { 0, 5, 20, 22, 40 };
+    std::vector<int> xends   { 10, 8, 25, 30, 50 };
+    auto x = nclist::build<int, int>(xstarts.size(), xstarts.data(), xends.data());
+
+    std::vector<int> ystarts { 5, 28, 30, 45 };
+    std::vector<int> yends   { 15, 30, 35, 46 };
+    auto y = nclist::build<int, int>(ystarts.size(), ystarts.data(), yends.data());
+
+    // Unions are [0, 10), [20, 30), [40, 50) for 'x' and [5, 15), [28, 35), [45, 46) for 'y'.
+    auto stats = nclist::compute_similarity(x, y);
+    EXPECT_EQ(stats.intersection_length, 8);
+    EXPECT_EQ(stats.num_intersections, 3);
+    EXPECT_EQ(stats.union_length, 30 + 18 - 8);
+    EXPECT_DOUBLE_EQ(stats.jaccard, 8.0 / 40);
+
+    auto self = nclist::compute_similarity(x, x);
+    EXPECT_EQ(self.intersection_length, 30);
+    EXPECT_EQ(self.union_length, 30);
+    EXPECT_EQ(self.num_intersections, 3);
+    EXPECT_DOUBLE_EQ(self.jaccard, 1);
+}
+
+TEST(Similarity, Empty) {
+    auto empty = nclist::build<int, int>(0, NULL, NULL);
+    auto stats = nclist::compute_similarity(empty, empty);
+    EXPECT_EQ(stats.intersection_length, 0);
+    EXPECT_EQ(stats.union_length, 0);
+    EXPECT_EQ(stats.jaccard, 0);
+
+    std::vector<int> xstarts { 0, 5 };
+    std::vector<int> xends   { 10, 8 };
+    auto x = nclist::build<int, int>(xstarts.size(), xstarts.data(), xends.data());
+    stats = nclist::compute_similarity(x, empty);
+    EXPECT_EQ(stats.intersection_length, 0);
+    EXPECT_EQ(stats.union_length, 10);
+    EXPECT_EQ(stats.num_intersections, 0);
+    EXPECT_EQ(stats.jaccard, 0);
+}
+
+TEST(Similarity, Reference) {
+    std::mt19937_64 rng(1234);
+    const int num_sets = 6;
+    const int span = 500;
+    std::vector<nclist::Nclist<int, int> > sets;
+    std::vector<std::vector<char> > covered;
+
+    for (int s = 0; s < num_sets; ++s) {
+        const int n = 10 + 20 * s;
+        std::vector<int> starts, ends;
+        std::vector<char> cov(span);
+        for (int i = 0; i < n; ++i) {
+            int start = rng() % (span - 20);
+            int end = start + rng() % 20;
+            starts.push_back(start);
+            ends.push_back(end);
+            for (int j = start; j < end; ++j) {
+                cov[j] = 1;
+            }
+        }
+        sets.push_back(nclist::build<int, int>(n, starts.data(), ends.data()));
+        covered.push_back(std::move(cov));
+    }
+
+    std::vector<std::size_t> first, second;
+    for (int i = 0; i < num_sets; ++i) {
+        for (int j = 0; j < num_sets; ++j) {
+            first.push_back(i);
+            second.push_back(j);
+        }
+    }
+
+    for (int threads : { 1, 3 }) {
+        std::vector<nclist::SimilarityStatistics<int> > output(first.size());
+        nclist::compute_similarity(sets.data(), first.size(), first.data(), second.data(), threads, output.data());
+
+        for (std::size_t p = 0; p < first.size(); ++p) {
+            const auto& left = covered[first[p]];
+            const auto& right = covered[second[p]];
+            int intersection = 0, uni = 0;
+            std::size_t runs = 0;
+            bool previous = false;
+            for (int j = 0; j < span; ++j) {
+                const bool both = left[j] && right[j];
+                intersection += both;
+                uni += left[j] || right[j];
+                runs += (both && !previous);
+                previous = both;
+            }
+
+            const auto& stats = output[p];
+            EXPECT_EQ(stats.intersection_length, intersection);
+            EXPECT_EQ(stats.union_length, uni);
+            EXPECT_EQ(stats.num_intersections, runs);
+            EXPECT_DOUBLE_EQ(stats.jaccard, static_cast<double>(intersection) / uni);
+        }
+    }
+}
+
+TEST(Similarity, Double) {
+    std::vector<double> xstarts { 0.5, 20.5 };
+    std::vector<double> xends   { 10.5, 30.5 };
+    auto x = nclist::build<int, double>(xstarts.size(), xstarts.data(), xends.data());
+    std::vector<double> ystarts { 5.5 };
+    std::vector<double> yends   { 25.5 };
+    auto y = nclist::build<int, double>(ystarts.size(), ystarts.data(), yends.data());
+
+    auto stats = nclist::compute_similarity(x, y);
+    EXPECT_DOUBLE_EQ(stats.intersection_length, 10);
+    EXPECT_DOUBLE_EQ(stats.union_length, 30);
+    EXPECT_EQ(stats.num_intersections, 2);
+}
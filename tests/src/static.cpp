@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstddef>
+
+#include "nclist/static.hpp"
+#include "nclist/overlaps_any.hpp"
+#include "nclist/overlaps_within.hpp"
+#include "nclist/overlaps_extend.hpp"
+#include "nclist/overlaps_equal.hpp"
+#include "nclist/overlaps_start.hpp"
+#include "nclist/overlaps_end.hpp"
+#include "nclist/nearest.hpp"
+
+constexpr std::array<int, 6> basic_starts { 10, 30, 20,  0, 50, 30 };
+constexpr std::array<int, 6> basic_ends   { 50, 45, 50, 100, 60, 45 };
+constexpr auto basic_index = nclist::build_static<int>(basic_starts, basic_ends);
+
+// Checking that everything is computed at compile time.
+static_assert(basic_index.root_children == 1);
+static_assert(basic_index.num_nodes == 5);
+static_assert(basic_index.num_duplicates == 1);
+static_assert(basic_index.nodes[0].id == 3);
+
+TEST(StaticNclist, Basic) {
+    nclist::OverlapsAnyWorkspace<int> workspace;
+    nclist::OverlapsAnyParameters<int> params;
+    std::vector<int> matches;
+    nclist::overlaps_any(nclist::make_view(basic_index), 40, 55, params, workspace, matches);
+    std::sort(matches.begin(), matches.end());
+    EXPECT_EQ(matches, std::vector<int>({ 0, 1, 2, 3, 4, 5 }));
+
+    nclist::overlaps_any(nclist::make_view(basic_index), 46, 48, params, workspace, matches);
+    std::sort(matches.begin(), matches.end());
+    EXPECT_EQ(matches, std::vector<int>({ 0, 2, 3 }));
+
+    // Empty tables are supported.
+    constexpr std::array<int, 0> empty{};
+    constexpr auto empty_index = nclist::build_static<int>(empty, empty);
+    static_assert(empty_index.root_children == 0);
+    nclist::overlaps_any(nclist::make_view(empty_index), 40, 55, params, workspace, matches);
+    EXPECT_TRUE(matches.empty());
+}
+
+template<std::size_t num_intervals_>
+constexpr std::array<int, num_intervals_> mock_positions(unsigned long long seed, bool is_end) {
+    std::array<int, num_intervals_> output{};
+    unsigned long long state = seed;
+    for (std::size_t i = 0; i < num_intervals_; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        const int start = static_cast<int>((state >> 33) % 1000);
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        const int width = static_cast<int>((state >> 33) % (i % 10 == 0 ? 200 : 20));
+        output[i] = (is_end ? start + width + 1 : start);
+        if (i % 13 == 5) { // injecting some duplicates.
+            output[i] = output[i - 1];
+        }
+    }
+    return output;
+}
+
+constexpr auto mock_starts = mock_positions<500>(42, false);
+constexpr auto mock_ends = mock_positions<500>(42, true);
+constexpr auto mock_index = nclist::build_static<int>(mock_starts, mock_ends);
+
+class StaticNclistTest : public ::testing::TestWithParam<int> {
+protected:
+    std::vector<int> query_start, query_end;
+
+    void SetUp() {
+        const int nquery = GetParam();
+        std::mt19937_64 rng(nquery);
+        for (int q = 0; q < nquery; ++q) {
+            const int qstart = static_cast<int>(rng() % 1200) - 100;
+            query_start.push_back(qstart);
+            query_end.push_back(qstart + static_cast<int>(rng() % 50));
+        }
+    }
+
+    template<class Parameters_, class Workspace_, class Search_>
+    void compare(const Parameters_& params, Search_ search) {
+        auto ref = nclist::build(static_cast<int>(mock_starts.size()), mock_starts.data(), mock_ends.data());
+        auto view = nclist::make_view(mock_index);
+        Workspace_ workspace;
+        std::vector<int> expected, observed;
+        for (std::size_t q = 0; q < query_start.size(); ++q) {
+            search(ref, query_start[q], query_end[q], params, workspace, expected);
+            std::sort(expected.begin(), expected.end());
+            search(view, query_start[q], query_end[q], params, workspace, observed);
+            std::sort(observed.begin(), observed.end());
+            EXPECT_EQ(expected, observed);
+        }
+    }
+};
+
+TEST_P(StaticNclistTest, Reference) {
+    {
+        nclist::OverlapsAnyParameters<int> params;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_any(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsAnyWorkspace<int> >(params, fun);
+        params.max_gap = 10;
+        compare<decltype(params), nclist::OverlapsAnyWorkspace<int> >(params, fun);
+    }
+
+    {
+        nclist::OverlapsWithinParameters<int> params;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_within(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsWithinWorkspace<int> >(params, fun);
+    }
+
+    {
+        nclist::OverlapsExtendParameters<int> params;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_extend(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsExtendWorkspace<int> >(params, fun);
+    }
+
+    {
+        nclist::OverlapsEqualParameters<int> params;
+        params.max_gap = 5;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_equal(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsEqualWorkspace<int> >(params, fun);
+    }
+
+    {
+        nclist::OverlapsStartParameters<int> params;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_start(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsStartWorkspace<int> >(params, fun);
+    }
+
+    {
+        nclist::OverlapsEndParameters<int> params;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_end(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsEndWorkspace<int> >(params, fun);
+    }
+
+    {
+        nclist::NearestParameters<int> params;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::nearest(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::NearestWorkspace<int> >(params, fun);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    StaticNclist,
+    StaticNclistTest,
+    ::testing::Values(10, 100, 1000) // num of query ranges
+);
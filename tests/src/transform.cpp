@@ -0,0 +1,334 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <cstddef>
+
+#include "nclist/transform.hpp"
+#include "nclist/narrow.hpp"
+#include "nclist/overlaps_any.hpp"
+#include "nclist/overlaps_within.hpp"
+#include "nclist/overlaps_extend.hpp"
+#include "nclist/overlaps_equal.hpp"
+#include "nclist/overlaps_start.hpp"
+#include "nclist/overlaps_end.hpp"
+#include "nclist/nearest.hpp"
+#include "nclist/classify.hpp"
+#include "nclist/batch.hpp"
+
+TEST(SubjectTransform, Basic) {
+    std::vector<int> starts { 100, 200, 150 };
+    std::vector<int> ends   { 120, 300, 160 };
+    auto index = nclist::build(3, starts.data(), ends.data());
+
+    nclist::OverlapsAnyWorkspace<int> workspace;
+    nclist::OverlapsAnyParameters<int> params;
+    std::vector<int> matches;
+
+    nclist::SubjectTransform<int> transform;
+    transform.flank_start = 50;
+    transform.flank_end = 10;
+    nclist::overlaps_any(nclist::make_view(index, transform), 60, 70, params, workspace, matches);
+    EXPECT_EQ(matches, std::vector<int>({ 0 }));
+    nclist::overlaps_any(nclist::make_view(index, transform), 125, 135, params, workspace, matches);
+    std::sort(matches.begin(), matches.end());
+    EXPECT_EQ(matches, std::vector<int>({ 0, 2 }));
+
+    transform = nclist::SubjectTransform<int>();
+    transform.shift = -100;
+    nclist::overlaps_any(nclist::make_view(index, transform), 0, 10, params, workspace, matches);
+    EXPECT_EQ(matches, std::vector<int>({ 0 }));
+    nclist::overlaps_any(nclist::make_view(index, transform), 100, 110, params, workspace, matches);
+    EXPECT_EQ(matches, std::vector<int>({ 1 }));
+
+    // Transformations are combined for nested views.
+    nclist::SubjectTransform<int> extra;
+    extra.flank_end = 5;
+    nclist::overlaps_any(nclist::make_view(nclist::make_view(index, transform), extra), 22, 24, params, workspace, matches);
+    EXPECT_EQ(matches, std::vector<int>({ 0 }));
+    nclist::overlaps_any(nclist::make_view(nclist::make_view(index, transform), extra), 25, 30, params, workspace, matches);
+    EXPECT_TRUE(matches.empty());
+}
+
+class SubjectTransformTest : public ::testing::TestWithParam<std::tuple<int, int, int> > {
+protected:
+    std::vector<std::int64_t> query_start, query_end, subject_start, subject_end;
+    nclist::SubjectTransform<std::int64_t> transform;
+
+    void SetUp() {
+        auto params = GetParam();
+        const int nquery = std::get<0>(params);
+        const int nsubject = std::get<1>(params);
+        const int choice = std::get<2>(params);
+        std::mt19937_64 rng(nquery * 13 + nsubject + choice);
+
+        for (int q = 0; q < nquery; ++q) {
+            const std::int64_t qstart = static_cast<std::int64_t>(rng() % 1200) - 600;
+            query_start.push_back(qstart);
+            query_end.push_back(qstart + static_cast<std::int64_t>(rng() % 50));
+        }
+        for (int s = 0; s < nsubject; ++s) {
+            const std::int64_t sstart = static_cast<std::int64_t>(rng() % 1000) - 500;
+            subject_start.push_back(sstart);
+            subject_end.push_back(sstart + static_cast<std::int64_t>(rng() % (s % 10 == 0 ? 200 : 30) + 1));
+        }
+
+        if (choice == 0) {
+            transform.shift = 37;
+        } else if (choice == 1) {
+            transform.flank_start = 20;
+            transform.flank_end = 20;
+        } else {
+            transform.shift = -15;
+            transform.flank_start = 5;
+            transform.flank_end = 30;
+        }
+    }
+
+    template<class Parameters_, class Workspace_, class Search_>
+    void compare(const Parameters_& params, Search_ search) {
+        // Reference is a new index built from the transformed coordinates.
+        auto trans_start = subject_start, trans_end = subject_end;
+        for (auto& s : trans_start) {
+            s += transform.shift - transform.flank_start;
+        }
+        for (auto& e : trans_end) {
+            e += transform.shift + transform.flank_end;
+        }
+        auto ref = nclist::build(static_cast<int>(trans_start.size()), trans_start.data(), trans_end.data());
+
+        auto full = nclist::build(static_cast<int>(subject_start.size()), subject_start.data(), subject_end.data());
+        auto tview = nclist::make_view(full, transform);
+        auto narrow = nclist::build_narrow(static_cast<int>(subject_start.size()), subject_start.data(), subject_end.data());
+        auto nview = nclist::make_view(nclist::make_view(narrow), transform);
+
+        Workspace_ workspace;
+        std::vector<int> expected, observed;
+        for (std::size_t q = 0; q < query_start.size(); ++q) {
+            search(ref, query_start[q], query_end[q], params, workspace, expected);
+            std::sort(expected.begin(), expected.end());
+            search(tview, query_start[q], query_end[q], params, workspace, observed);
+            std::sort(observed.begin(), observed.end());
+            EXPECT_EQ(expected, observed);
+            search(nview, query_start[q], query_end[q], params, workspace, observed);
+            std::sort(observed.begin(), observed.end());
+            EXPECT_EQ(expected, observed);
+        }
+    }
+};
+
+TEST_P(SubjectTransformTest, Overlaps) {
+    {
+        nclist::OverlapsAnyParameters<std::int64_t> params;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_any(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsAnyWorkspace<int> >(params, fun);
+        params.max_gap = 10;
+        compare<decltype(params), nclist::OverlapsAnyWorkspace<int> >(params, fun);
+        params.min_overlap = 5;
+        compare<decltype(params), nclist::OverlapsAnyWorkspace<int> >(params, fun);
+    }
+
+    {
+        nclist::OverlapsWithinParameters<std::int64_t> params;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_within(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsWithinWorkspace<int> >(params, fun);
+        params.max_gap = 10;
+        compare<decltype(params), nclist::OverlapsWithinWorkspace<int> >(params, fun);
+    }
+
+    {
+        nclist::OverlapsExtendParameters<std::int64_t> params;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_extend(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsExtendWorkspace<int> >(params, fun);
+        params.min_overlap = 5;
+        compare<decltype(params), nclist::OverlapsExtendWorkspace<int> >(params, fun);
+    }
+
+    {
+        nclist::OverlapsEqualParameters<std::int64_t> params;
+        params.max_gap = 5;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_equal(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsEqualWorkspace<int> >(params, fun);
+    }
+
+    {
+        nclist::OverlapsStartParameters<std::int64_t> params;
+        params.max_gap = 5;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_start(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsStartWorkspace<int> >(params, fun);
+    }
+
+    {
+        nclist::OverlapsEndParameters<std::int64_t> params;
+        params.max_gap = 5;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::overlaps_end(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::OverlapsEndWorkspace<int> >(params, fun);
+    }
+}
+
+TEST_P(SubjectTransformTest, Others) {
+    {
+        nclist::NearestParameters<std::int64_t> params;
+        auto fun = [](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void { nclist::nearest(s, qs, qe, p, w, m); };
+        compare<decltype(params), nclist::NearestWorkspace<int> >(params, fun);
+    }
+
+    {
+        nclist::ClassifyOverlapsParameters<std::int64_t> params;
+        std::vector<unsigned char> types;
+        auto fun = [&](const auto& s, auto qs, auto qe, const auto& p, auto& w, auto& m) -> void {
+            nclist::classify_overlaps(s, qs, qe, p, w, m, types);
+            for (std::size_t i = 0; i < m.size(); ++i) { // packing the types into the output for comparison.
+                m[i] = m[i] * 64 + types[i];
+            }
+        };
+        compare<decltype(params), nclist::ClassifyOverlapsWorkspace<int> >(params, fun);
+    }
+
+    {
+        auto full = nclist::build(static_cast<int>(subject_start.size()), subject_start.data(), subject_end.data());
+        auto narrow = nclist::build_narrow(static_cast<int>(subject_start.size()), subject_start.data(), subject_end.data());
+        nclist::OverlapsBatchParameters<std::int64_t> params;
+        params.max_gap = 10;
+        std::vector<nclist::OverlapType> types;
+        for (std::size_t q = 0; q < query_start.size(); ++q) {
+            types.push_back(static_cast<nclist::OverlapType>(q % 6));
+        }
+        params.types = types.data();
+
+        std::vector<std::size_t> expected_offsets, observed_offsets;
+        std::vector<int> expected, observed;
+        nclist::overlaps_batch(full, query_start.size(), query_start.data(), query_end.data(), params, expected_offsets, expected);
+        for (std::size_t q = 0; q < query_start.size(); ++q) {
+            std::sort(expected.begin() + expected_offsets[q], expected.begin() + expected_offsets[q + 1]);
+        }
+
+        // Applying the inverse shift to the queries, which should give the same results as the transformed subjects.
+        nclist::SubjectTransform<std::int64_t> shift;
+        shift.shift = 1000;
+        auto shifted_start = query_start, shifted_end = query_end;
+        for (auto& s : shifted_start) {
+            s += 1000;
+        }
+        for (auto& e : shifted_end) {
+            e += 1000;
+        }
+
+        nclist::overlaps_batch(nclist::make_view(full, shift), query_start.size(), shifted_start.data(), shifted_end.data(), params, observed_offsets, observed);
+        EXPECT_EQ(expected_offsets, observed_offsets);
+        for (std::size_t q = 0; q < query_start.size(); ++q) {
+            std::sort(observed.begin() + observed_offsets[q], observed.begin() + observed_offsets[q + 1]);
+        }
+        EXPECT_EQ(expected, observed);
+
+        nclist::overlaps_batch(nclist::make_view(nclist::make_view(narrow), shift), query_start.size(), shifted_start.data(), shifted_end.data(), params, observed_offsets, observed);
+        EXPECT_EQ(expected_offsets, observed_offsets);
+        for (std::size_t q = 0; q < query_start.size(); ++q) {
+            std::sort(observed.begin() + observed_offsets[q], observed.begin() + observed_offsets[q + 1]);
+        }
+        EXPECT_EQ(expected, observed);
+    }
+}
+
+TEST(SubjectTransform, Limits) {
+    // Checking that the batch narrowing saturates correctly when the bounds are near the limits of the position type.
+    std::vector<int> starts { -10, 0, 10 };
+    std::vector<int> ends   { 5, 15, 25 };
+    auto index = nclist::build(3, starts.data(), ends.data());
+    nclist::SubjectTransform<int> transform;
+    transform.shift = 1000;
+
+    std::vector<int> qs { std::numeric_limits<int>::min(), 995, std::numeric_limits<int>::max() - 10 };
+    std::vector<int> qe { std::numeric_limits<int>::min() + 10, 1005, std::numeric_limits<int>::max() };
+    nclist::OverlapsBatchParameters<int> params;
+    std::vector<std::size_t> offsets;
+    std::vector<int> matches;
+    nclist::overlaps_batch(nclist::make_view(index, transform), 3, qs.data(), qe.data(), params, offsets, matches);
+    EXPECT_EQ(offsets, std::vector<std::size_t>({ 0, 0, 2, 2 }));
+    std::sort(matches.begin(), matches.end());
+    EXPECT_EQ(matches, std::vector<int>({ 0, 1 }));
+
+    transform.shift = -1000;
+    qs[1] = -1005;
+    qe[1] = -995;
+    nclist::overlaps_batch(nclist::make_view(index, transform), 3, qs.data(), qe.data(), params, offsets, matches);
+    EXPECT_EQ(offsets, std::vector<std::size_t>({ 0, 0, 2, 2 }));
+    std::sort(matches.begin(), matches.end());
+    EXPECT_EQ(matches, std::vector<int>({ 0, 1 }));
+}
+
+TEST(SubjectTransform, UnsignedFlank) {
+    // Promoter flanks reduce the base of the view, which wraps around for unsigned positions.
+    std::vector<unsigned> starts { 5000 };
+    std::vector<unsigned> ends { 6000 };
+    auto index = nclist::build(1, starts.data(), ends.data());
+    nclist::SubjectTransform<unsigned> transform;
+    transform.flank_start = 2000;
+
+    std::vector<unsigned> qs { 3500 }, qe { 4000 };
+    nclist::OverlapsBatchParameters<unsigned> params;
+    std::vector<std::size_t> offsets;
+    std::vector<int> matches;
+    nclist::overlaps_batch(nclist::make_view(index, transform), 1, qs.data(), qe.data(), params, offsets, matches);
+    EXPECT_EQ(matches, std::vector<int>({ 0 }));
+
+    // Comparing against the per-query search for many promoters, including queries beyond the ends of the transformed intervals.
+    std::mt19937_64 rng(42);
+    std::vector<unsigned> gene_starts, gene_ends;
+    for (int g = 0; g < 500; ++g) {
+        const unsigned gstart = 2000 + rng() % 50000;
+        gene_starts.push_back(gstart);
+        gene_ends.push_back(gstart + rng() % 10000 + 1);
+    }
+    auto genes = nclist::build(static_cast<int>(gene_starts.size()), gene_starts.data(), gene_ends.data());
+    auto narrow = nclist::build_narrow<std::uint16_t>(static_cast<int>(gene_starts.size()), gene_starts.data(), gene_ends.data());
+    transform.flank_end = 500;
+
+    qs.clear();
+    qe.clear();
+    for (int q = 0; q < 1000; ++q) {
+        const unsigned qstart = rng() % 65000;
+        qs.push_back(qstart);
+        qe.push_back(qstart + rng() % 1000);
+    }
+    qs.push_back(0);
+    qe.push_back(10);
+    qs.push_back(std::numeric_limits<unsigned>::max() - 10);
+    qe.push_back(std::numeric_limits<unsigned>::max());
+
+    const auto compare = [&](const auto& view) -> void {
+        for (int gap = 0; gap < 2; ++gap) {
+            if (gap) {
+                params.max_gap = 100;
+            }
+            nclist::overlaps_batch(view, qs.size(), qs.data(), qe.data(), params, offsets, matches);
+            ASSERT_EQ(offsets.size(), qs.size() + 1);
+
+            nclist::OverlapsAnyParameters<unsigned> aparams;
+            aparams.max_gap = params.max_gap;
+            nclist::OverlapsAnyWorkspace<int> workspace;
+            std::vector<int> expected;
+            for (std::size_t q = 0; q < qs.size(); ++q) {
+                nclist::overlaps_any(view, qs[q], qe[q], aparams, workspace, expected);
+                std::vector<int> observed(matches.begin() + offsets[q], matches.begin() + offsets[q + 1]);
+                EXPECT_EQ(observed, expected);
+            }
+        }
+        params.max_gap.reset();
+    };
+    compare(nclist::make_view(genes, transform));
+    compare(nclist::make_view(nclist::make_view(narrow), transform));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    SubjectTransform,
+    SubjectTransformTest,
+    ::testing::Combine(
+        ::testing::Values(10, 100, 1000), // num of query ranges
+        ::testing::Values(10, 100, 1000), // number of subject ranges
+        ::testing::Values(0, 1, 2) // type of transform
+    )
+);
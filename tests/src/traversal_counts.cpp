@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <cstddef>
+
+#ifndef NCLIST_COUNT_TRAVERSAL
+#error "NCLIST_COUNT_TRAVERSAL should be defined for this test"
+#endif
+
+#include "nclist/overlaps_any.hpp"
+#include "nclist/batch.hpp"
+#include "nclist/count_reads.hpp"
+
+class TraversalCountsTest : public ::testing::Test {
+protected:
+    // Each interval contains the next one, so queries must descend all the way down.
+    std::vector<int> starts { 0, 10, 20, 30, 100, 200 };
+    std::vector<int> ends { 90, 80, 70, 60, 150, 250 };
+};
+
+TEST_F(TraversalCountsTest, OverlapsAny) {
+    auto index = nclist::build<int, int>(starts.size(), starts.data(), ends.data());
+    nclist::OverlapsAnyWorkspace<int> workspace;
+    nclist::OverlapsAnyParameters<int> params;
+    std::vector<int> matches;
+
+    nclist::overlaps_any(index, 40, 50, params, workspace, matches);
+    EXPECT_EQ(matches.size(), 4);
+    EXPECT_EQ(workspace.num_visited, 4);
+    EXPECT_EQ(workspace.num_searches, 3); // three nested child ranges, the first root is already the start of the root search.
+
+    // Counts accumulate across calls.
+    nclist::overlaps_any(index, 120, 130, params, workspace, matches);
+    EXPECT_EQ(matches.size(), 1);
+    EXPECT_EQ(workspace.num_visited, 5);
+    EXPECT_EQ(workspace.num_searches, 4);
+
+    nclist::overlaps_any(index, 300, 400, params, workspace, matches);
+    EXPECT_TRUE(matches.empty());
+    EXPECT_EQ(workspace.num_visited, 5);
+    EXPECT_EQ(workspace.num_searches, 5);
+}
+
+TEST_F(TraversalCountsTest, Batch) {
+    auto index = nclist::build<int, int>(starts.size(), starts.data(), ends.data());
+    std::vector<int> qstarts { 40, 120 };
+    std::vector<int> qends { 50, 130 };
+
+    nclist::OverlapsBatchProfile<int> profile;
+    nclist::OverlapsBatchParameters<int> params;
+    params.profile = &profile;
+    std::vector<std::size_t> offsets;
+    std::vector<int> matches;
+    nclist::overlaps_batch(index, qstarts.size(), qstarts.data(), qends.data(), params, offsets, matches);
+    EXPECT_EQ(offsets[1], 4);
+
+    ASSERT_EQ(profile.slowest.size(), 2);
+    for (const auto& slow : profile.slowest) {
+        if (slow.index == 0) {
+            EXPECT_EQ(slow.num_visited, 4);
+            EXPECT_EQ(slow.num_searches, 3);
+        } else {
+            // Roots are narrowed before the traversal, so no search is needed on the roots or the (childless) matching root.
+            EXPECT_EQ(slow.num_visited, 1);
+            EXPECT_EQ(slow.num_searches, 0);
+        }
+    }
+}
+
+TEST_F(TraversalCountsTest, CountReads) {
+    auto index = nclist::build<int, int>(starts.size(), starts.data(), ends.data());
+    auto features = nclist::build_feature_map(index, static_cast<int>(starts.size()), static_cast<const int*>(NULL), 0);
+    std::vector<std::size_t> offsets { 0, 2, 3 };
+    std::vector<int> qstarts { 40, 120, 300 };
+    std::vector<int> qends { 50, 130, 400 };
+
+    nclist::CountReadsProfile profile;
+    nclist::CountReadsParameters<int> params;
+    params.policy = nclist::MultiFeaturePolicy::ALL;
+    params.profile = &profile;
+    nclist::count_reads(index, features, 2, offsets.data(), qstarts.data(), qends.data(), params);
+
+    ASSERT_EQ(profile.slowest.size(), 2);
+    for (const auto& slow : profile.slowest) {
+        if (slow.index == 0) {
+            EXPECT_EQ(slow.num_hits, 5);
+            EXPECT_EQ(slow.num_visited, 5);
+            EXPECT_EQ(slow.num_searches, 4);
+        } else {
+            EXPECT_EQ(slow.num_hits, 0);
+            EXPECT_EQ(slow.num_visited, 0);
+            EXPECT_EQ(slow.num_searches, 1);
+        }
+    }
+}
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+#include "nclist/view.hpp"
+#include "nclist/overlaps_any.hpp"
+#include "nclist/overlaps_within.hpp"
+#include "nclist/overlaps_extend.hpp"
+#include "nclist/overlaps_equal.hpp"
+#include "nclist/overlaps_start.hpp"
+#include "nclist/overlaps_end.hpp"
+#include "nclist/nearest.hpp"
+#include "utils.hpp"
+
+TEST(View, Window) {
+    std::vector<int> test_starts { 0, 10, 15, 30, 50, 52, 80 };
+    std::vector<int> test_ends   { 5, 20, 25, 40, 60, 55, 90 };
+    auto index = nclist::build<int, int>(test_starts.size(), test_starts.data(), test_ends.data());
+
+    auto full = nclist::make_view(index);
+    EXPECT_EQ(full.root_start, 0);
+    EXPECT_EQ(full.root_end, index.root_children);
+
+    nclist::OverlapsAnyParameters<int> params;
+    nclist::OverlapsAnyWorkspace<int> workspace;
+    std::vector<int> output;
+
+    auto view = nclist::make_view(index, 18, 51);
+    EXPECT_EQ(view.root_end - view.root_start, 4); // [10, 20), [15, 25), [30, 40) and [50, 60).
+    nclist::overlaps_any(view, 0, 100, params, workspace, output);
+    std::sort(output.begin(), output.end());
+    EXPECT_EQ(output, std::vector<int>({ 1, 2, 3, 4, 5 }));
+
+    // Only intervals in the view are reported.
+    nclist::overlaps_any(view, 0, 12, params, workspace, output);
+    EXPECT_EQ(output, std::vector<int>({ 1 }));
+    EXPECT_TRUE(nclist::has_overlaps_any(view, 80, 85, params) == false);
+    EXPECT_TRUE(nclist::has_overlaps_any(index, 80, 85, params));
+
+    // Empty windows are also supported.
+    auto empty = nclist::make_view(index, 60, 80);
+    EXPECT_EQ(empty.root_start, empty.root_end);
+    nclist::overlaps_any(empty, 0, 100, params, workspace, output);
+    EXPECT_TRUE(output.empty());
+
+    nclist::NearestParameters<int> nparams;
+    nclist::NearestWorkspace<int> nworkspace;
+    nclist::nearest(empty, 0, 100, nparams, nworkspace, output);
+    EXPECT_TRUE(output.empty());
+}
+
+class ViewTest : public OverlapsTestCore, public ::testing::TestWithParam<std::tuple<int, int, int> > {
+protected:
+    int window_width;
+    void SetUp() {
+        auto params = GetParam();
+        assemble(params);
+        window_width = std::get<2>(params);
+    }
+
+    template<class Function_>
+    void compare(Function_ fun) {
+        auto index = nclist::build(nsubject, subject_start.data(), subject_end.data());
+        std::vector<int> ref, results;
+
+        // Splitting the coordinate space into windows and only checking queries that lie within each window.
+        for (int wstart = -500; wstart < 550; wstart += window_width) {
+            const int wend = wstart + window_width;
+            auto view = nclist::make_view(index, wstart, wend);
+            for (std::size_t q = 0; q < query_start.size(); ++q) {
+                if (query_start[q] < wstart || query_end[q] > wend) {
+                    continue;
+                }
+                fun(index, query_start[q], query_end[q], ref);
+                std::sort(ref.begin(), ref.end());
+                fun(view, query_start[q], query_end[q], results);
+                std::sort(results.begin(), results.end());
+                EXPECT_EQ(ref, results);
+            }
+        }
+    }
+};
+
+TEST_P(ViewTest, Any) {
+    nclist::OverlapsAnyParameters<int> params;
+    nclist::OverlapsAnyWorkspace<int> workspace;
+    compare([&](const auto& subject, int qs, int qe, std::vector<int>& matches) -> void {
+        nclist::overlaps_any(subject, qs, qe, params, workspace, matches);
+        EXPECT_EQ(nclist::has_overlaps_any(subject, qs, qe, params), !matches.empty());
+    });
+}
+
+TEST_P(ViewTest, Within) {
+    nclist::OverlapsWithinParameters<int> params;
+    nclist::OverlapsWithinWorkspace<int> workspace;
+    compare([&](const auto& subject, int qs, int qe, std::vector<int>& matches) -> void {
+        nclist::overlaps_within(subject, qs, qe, params, workspace, matches);
+    });
+}
+
+TEST_P(ViewTest, Extend) {
+    nclist::OverlapsExtendParameters<int> params;
+    nclist::OverlapsExtendWorkspace<int> workspace;
+    compare([&](const auto& subject, int qs, int qe, std::vector<int>& matches) -> void {
+        nclist::overlaps_extend(subject, qs, qe, params, workspace, matches);
+    });
+}
+
+TEST_P(ViewTest, Equal) {
+    nclist::OverlapsEqualParameters<int> params;
+    nclist::OverlapsEqualWorkspace<int> workspace;
+    compare([&](const auto& subject, int qs, int qe, std::vector<int>& matches) -> void {
+        nclist::overlaps_equal(subject, qs, qe, params, workspace, matches);
+    });
+}
+
+TEST_P(ViewTest, Start) {
+    nclist::OverlapsStartParameters<int> params;
+    nclist::OverlapsStartWorkspace<int> workspace;
+    compare([&](const auto& subject, int qs, int qe, std::vector<int>& matches) -> void {
+        nclist::overlaps_start(subject, qs, qe, params, workspace, matches);
+    });
+}
+
+TEST_P(ViewTest, End) {
+    nclist::OverlapsEndParameters<int> params;
+    nclist::OverlapsEndWorkspace<int> workspace;
+    compare([&](const auto& subject, int qs, int qe, std::vector<int>& matches) -> void {
+        nclist::overlaps_end(subject, qs, qe, params, workspace, matches);
+    });
+}
+
+TEST_P(ViewTest, Nearest) {
+    // Only checking overlaps as the nearest non-overlapping interval might not be in the view.
+    nclist::NearestParameters<int> params;
+    nclist::NearestWorkspace<int> workspace;
+    nclist::OverlapsAnyParameters<int> aparams;
+    compare([&](const auto& subject, int qs, int qe, std::vector<int>& matches) -> void {
+        if (nclist::has_overlaps_any(subject, qs, qe, aparams)) {
+            nclist::nearest(subject, qs, qe, params, workspace, matches);
+        } else {
+            matches.clear();
+        }
+    });
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    View,
+    ViewTest,
+    ::testing::Combine(
+        ::testing::Values(10, 100, 1000), // num of query ranges
+        ::testing::Values(10, 100, 1000), // number of subject ranges
+        ::testing::Values(100, 250) // window width
+    )
+);